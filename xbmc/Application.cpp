@@ -134,6 +134,7 @@
 
 // Windows includes
 #include "guilib/GUIWindowManager.h"
+#include "guilib/GUIWindowXMLCache.h"
 #include "video/dialogs/GUIDialogVideoInfo.h"
 #include "windows/GUIWindowScreensaver.h"
 #include "video/VideoInfoScanner.h"
@@ -1652,6 +1653,7 @@ bool CApplication::LoadSkin(const SkinPtr& skin)
   g_localizeStrings.LoadSkinStrings(langPath, CSettings::GetInstance().GetString(CSettings::SETTING_LOCALE_LANGUAGE));
 
   g_SkinInfo->LoadIncludes();
+  CGUIWindowXMLCache::GetInstance().Initialize();
 
   int64_t start;
   start = CurrentHostCounter();
@@ -1730,6 +1732,7 @@ void CApplication::UnloadSkin(bool forReload /* = false */)
 
   g_windowManager.DeInitialize();
   CTextureCache::GetInstance().Deinitialize();
+  CGUIWindowXMLCache::GetInstance().Deinitialize();
 
   // remove the skin-dependent window
   g_windowManager.Delete(WINDOW_DIALOG_FULLSCREEN_INFO);
@@ -1954,8 +1957,8 @@ void CApplication::Render()
 
   // reset our info cache - we do this at the end of Render so that it is
   // fresh for the next process(), or after a windowclose animation (where process()
-  // isn't called)
-  g_infoManager.ResetCache();
+  // isn't called). Conditions that only change with other sources are invalidated by them.
+  g_infoManager.ResetCache(INFO::INFO_SOURCE_FRAME);
 
 
   unsigned int now = XbmcThreads::SystemClockMillis();
@@ -4562,7 +4565,7 @@ void CApplication::ProcessSlow()
   if (!m_pPlayer->IsPlayingVideo())
     g_largeTextureManager.CleanupUnusedImages();
 
-  g_TextureManager.FreeUnusedTextures(5000);
+  g_TextureManager.TrimUnusedTextures();
 
 #ifdef HAS_DVD_DRIVE
   // checks whats in the DVD drive and tries to autostart the content (xbox games, dvd, cdda, avi files...)
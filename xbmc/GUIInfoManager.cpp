@@ -2454,6 +2454,50 @@ INFO::InfoPtr CGUIInfoManager::Register(const std::string &expression, int conte
   return m_bools.back();
 }
 
+// the sources a condition depends upon, anything not listed here may change every frame
+int CGUIInfoManager::GetInfoSources(int condition) const
+{
+  condition = abs(condition);
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    switch (m_multiInfo[condition - MULTI_INFO_START].m_info)
+    {
+      case SKIN_BOOL:
+      case SKIN_STRING:
+        return INFO_SOURCE_SKIN_SETTINGS;
+      case LIBRARY_HAS_ROLE:
+        return INFO_SOURCE_LIBRARY;
+      default:
+        return INFO_SOURCE_FRAME;
+    }
+  }
+
+  switch (condition)
+  {
+    case SYSTEM_ALWAYS_TRUE:
+    case SYSTEM_ALWAYS_FALSE:
+    case SYSTEM_PLATFORM_LINUX:
+    case SYSTEM_PLATFORM_WINDOWS:
+    case SYSTEM_PLATFORM_DARWIN:
+    case SYSTEM_PLATFORM_DARWIN_OSX:
+    case SYSTEM_PLATFORM_DARWIN_IOS:
+    case SYSTEM_PLATFORM_ANDROID:
+    case SYSTEM_PLATFORM_LINUX_RASPBERRY_PI:
+      return INFO_SOURCE_NONE;
+    case LIBRARY_HAS_MUSIC:
+    case LIBRARY_HAS_VIDEO:
+    case LIBRARY_HAS_MOVIES:
+    case LIBRARY_HAS_MOVIE_SETS:
+    case LIBRARY_HAS_TVSHOWS:
+    case LIBRARY_HAS_MUSICVIDEOS:
+    case LIBRARY_HAS_SINGLES:
+    case LIBRARY_HAS_COMPILATIONS:
+      return INFO_SOURCE_LIBRARY;
+    default:
+      return INFO_SOURCE_FRAME;
+  }
+}
+
 bool CGUIInfoManager::EvaluateBool(const std::string &expression, int contextWindow /* = 0 */, const CGUIListItemPtr &item /* = NULL */)
 {
   bool result = false;
@@ -6232,14 +6276,15 @@ bool CGUIInfoManager::GetItemBool(const CGUIListItem *item, int condition) const
   return false;
 }
 
-void CGUIInfoManager::ResetCache()
+void CGUIInfoManager::ResetCache(int sources /* = INFO_SOURCE_ALL */)
 {
   // reset any animation triggers as well
-  m_containerMoves.clear();
+  if (sources & INFO_SOURCE_FRAME)
+    m_containerMoves.clear();
   // mark our infobools as dirty
   CSingleLock lock(m_critInfo);
   for (std::vector<InfoPtr>::iterator i = m_bools.begin(); i != m_bools.end(); ++i)
-    (*i)->SetDirty();
+    (*i)->SetDirty(sources);
 }
 
 std::string CGUIInfoManager::GetPictureLabel(int info)
@@ -6409,6 +6454,7 @@ void CGUIInfoManager::SetLibraryBool(int condition, bool value)
     default:
       break;
   }
+  ResetCache(INFO_SOURCE_LIBRARY);
 }
 
 void CGUIInfoManager::ResetLibraryBools()
@@ -6421,6 +6467,7 @@ void CGUIInfoManager::ResetLibraryBools()
   m_libraryHasSingles = -1;
   m_libraryHasCompilations = -1;
   m_libraryRoleCounts.clear();
+  ResetCache(INFO_SOURCE_LIBRARY);
 }
 
 bool CGUIInfoManager::GetLibraryBool(int condition)
@@ -213,7 +213,11 @@ public:
   void SetNextWindow(int windowID) { m_nextWindowID = windowID; };
   void SetPreviousWindow(int windowID) { m_prevWindowID = windowID; };
 
-  void ResetCache();
+  /*! \brief Mark the boolean conditions depending on the given sources for re-evaluation.
+   \param sources the INFO::INFO_SOURCE_* flags of the sources that changed. Animation triggers
+   are reset as well when INFO::INFO_SOURCE_FRAME is included.
+   */
+  void ResetCache(int sources = INFO::INFO_SOURCE_ALL);
   bool GetItemInt(int &value, const CGUIListItem *item, int info) const;
   std::string GetItemLabel(const CFileItem *item, int info, std::string *fallback = NULL);
   std::string GetItemImage(const CFileItem *item, int info, std::string *fallback = NULL);
@@ -247,6 +251,7 @@ protected:
   friend class INFO::InfoSingle;
   bool GetBool(int condition, int contextWindow = 0, const CGUIListItem *item=NULL);
   int TranslateSingleString(const std::string &strCondition, bool &listItemDependent);
+  int GetInfoSources(int condition) const;
 
   // routines for window retrieval
   bool CheckWindowCondition(CGUIWindow *window, int condition) const;
@@ -58,7 +58,14 @@ bool CImageLoader::DoWork()
   {
     // direct route - load the image
     unsigned int start = XbmcThreads::SystemClockMillis();
-    m_texture = CBaseTexture::LoadFromFile(loadPath, g_graphicsContext.GetWidth(), g_graphicsContext.GetHeight());
+    if (m_use_cache)
+    { // pre-built DXT mip levels skip the decode and upload at a fraction of the size
+      std::string compressedPath = CTextureCache::GetInstance().CheckCompressedImage(loadPath);
+      if (!compressedPath.empty())
+        m_texture = CBaseTexture::LoadFromFile(compressedPath);
+    }
+    if (!m_texture)
+      m_texture = CBaseTexture::LoadFromFile(loadPath, g_graphicsContext.GetWidth(), g_graphicsContext.GetHeight());
 
     if (XbmcThreads::SystemClockMillis() - start > 100)
       CLog::Log(LOGDEBUG, "%s - took %u ms to load %s", __FUNCTION__, XbmcThreads::SystemClockMillis() - start, loadPath.c_str());
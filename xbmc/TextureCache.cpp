@@ -20,7 +20,9 @@
 
 #include "TextureCache.h"
 #include "TextureCacheJob.h"
+#include "Application.h"
 #include "filesystem/File.h"
+#include "pictures/Picture.h"
 #include "profiles/ProfilesManager.h"
 #include "threads/SingleLock.h"
 #include "utils/Crc32.h"
@@ -28,17 +30,79 @@
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "utils/StringUtils.h"
+#include "windowing/WindowingFactory.h"
 #include "URL.h"
 
 using namespace XFILE;
 
+const CJob::PRIORITY CTextureCache::PRECACHE_PRIORITY;
+const unsigned int CTextureCache::PRECACHE_FETCH_JOBS;
+const unsigned int CTextureCache::PRECACHE_DECODE_JOBS;
+
+static const unsigned int PRECACHE_MAX_PENDING = 8;  ///< images being read or read but not yet cached
+static const char *kJobTypeFetchImage = "fetchimage";
+
+/*! \brief Fetch stage of the precache pipeline
+ Skips images that are already cached and reads the others into memory.
+ */
+class CTextureCache::CFetchJob : public CJob
+{
+public:
+  CFetchJob(const std::string &url) : m_url(url), m_job(NULL) {}
+  virtual ~CFetchJob() { delete m_job; }
+
+  virtual const char* GetType() const { return kJobTypeFetchImage; };
+  virtual bool DoWork()
+  {
+    CTextureDetails details;
+    std::string path(CTextureCache::GetInstance().GetCachedImage(m_url, details));
+    if (!path.empty() && details.hash.empty())
+      return false; // image is already cached and doesn't need to be checked further
+
+    m_job = new CTextureCacheJob(m_url, details.hash);
+    return m_job->FetchImage();
+  }
+
+  std::string m_url;
+  CTextureCacheJob *m_job;
+};
+
+CTextureCache::CPrecacheQueue::CPrecacheQueue(CTextureCache &cache, unsigned int jobsAtOnce)
+  : CJobQueue(false, jobsAtOnce, PRECACHE_PRIORITY),
+    m_cache(cache)
+{
+}
+
+void CTextureCache::CPrecacheQueue::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  if (strcmp(job->GetType(), kJobTypeFetchImage) == 0)
+    m_cache.OnFetchComplete(success, static_cast<CFetchJob *>(job));
+  else if (strcmp(job->GetType(), kJobTypeCacheImage) == 0)
+    m_cache.OnCachingFinished(success, static_cast<CTextureCacheJob *>(job));
+  CJobQueue::OnJobComplete(jobID, success, job);
+}
+
+void CTextureCache::CPrecacheQueue::OnJobProgress(unsigned int jobID, unsigned int progress, unsigned int total, const CJob *job)
+{
+  if (strcmp(job->GetType(), kJobTypeCacheImage) == 0 && !progress)
+  {
+    if (!m_cache.OnCachingStarted(static_cast<const CTextureCacheJob *>(job)))
+      CancelJob(job);
+  }
+  else
+    CJobQueue::OnJobProgress(jobID, progress, total, job);
+}
+
 CTextureCache &CTextureCache::GetInstance()
 {
   static CTextureCache s_cache;
   return s_cache;
 }
 
-CTextureCache::CTextureCache() : CJobQueue(false, 1, CJob::PRIORITY_LOW_PAUSABLE)
+CTextureCache::CTextureCache() : CJobQueue(false, 1, CJob::PRIORITY_LOW_PAUSABLE),
+  m_fetchQueue(*this, PRECACHE_FETCH_JOBS),
+  m_decodeQueue(*this, PRECACHE_DECODE_JOBS),
+  m_precacheInFlight(0)
 {
 }
 
@@ -55,7 +119,15 @@ void CTextureCache::Initialize()
 
 void CTextureCache::Deinitialize()
 {
+  m_fetchQueue.CancelJobs();
+  m_decodeQueue.CancelJobs();
   CancelJobs();
+  {
+    CSingleLock lock(m_precacheSection);
+    m_precacheQueue.clear();
+    m_precaching.clear();
+    m_precacheInFlight = 0;
+  }
   CSingleLock lock(m_databaseSection);
   m_database.Close();
 }
@@ -112,6 +184,17 @@ std::string CTextureCache::CheckCachedImage(const std::string &url, bool &needsR
   return "";
 }
 
+std::string CTextureCache::CheckCompressedImage(const std::string &cachedImage) const
+{
+  if (!g_advancedSettings.m_imageCacheCompressed || !g_Windowing.SupportsDXT())
+    return "";
+
+  std::string path = CPicture::GetCompressedCachePath(cachedImage);
+  if (!CFile::Exists(path))
+    return "";
+  return path;
+}
+
 void CTextureCache::BackgroundCacheImage(const std::string &url)
 {
   CTextureDetails details;
@@ -123,6 +206,62 @@ void CTextureCache::BackgroundCacheImage(const std::string &url)
   AddJob(new CTextureCacheJob(CTextureUtils::UnwrapImageURL(url), details.hash));
 }
 
+void CTextureCache::PrecacheImage(const std::string &image)
+{
+  std::string url = CTextureUtils::UnwrapImageURL(image);
+  if (url.empty() || IsCachedImage(url))
+    return;
+
+  CSingleLock lock(m_precacheSection);
+  if (!m_precaching.insert(url).second)
+    return; // already on its way
+
+  m_precacheQueue.push_back(url);
+  QueueFetchJobs();
+}
+
+void CTextureCache::QueueFetchJobs()
+{
+  CSingleLock lock(m_precacheSection);
+  // keep out of the way of whatever is playing
+  unsigned int maxPending = g_application.m_pPlayer->IsPlaying() ? 1 : PRECACHE_MAX_PENDING;
+  while (m_precacheInFlight < maxPending && !m_precacheQueue.empty())
+  {
+    std::string url = m_precacheQueue.front();
+    m_precacheQueue.pop_front();
+    m_precacheInFlight++;
+    m_fetchQueue.AddJob(new CFetchJob(url));
+  }
+}
+
+void CTextureCache::OnFetchComplete(bool success, CFetchJob *fetchJob)
+{
+  CTextureCacheJob *job = fetchJob->m_job;
+  fetchJob->m_job = NULL;
+  if (success && job)
+  {
+    if (job->m_details.hash == job->m_oldHash)
+      OnCachingComplete(true, job); // unchanged, just mark it as checked
+    else
+    {
+      // hand it over to the decode stage, which finishes it off in OnCachingFinished
+      if (m_decodeQueue.AddJob(job))
+        return;
+      job = NULL; // already queued by someone else and deleted by AddJob
+    }
+  }
+  delete job;
+  OnPrecacheComplete(fetchJob->m_url);
+}
+
+void CTextureCache::OnPrecacheComplete(const std::string &url)
+{
+  CSingleLock lock(m_precacheSection);
+  if (m_precaching.erase(url) && m_precacheInFlight)
+    m_precacheInFlight--;
+  QueueFetchJobs();
+}
+
 std::string CTextureCache::CacheImage(const std::string &image, CBaseTexture **texture /* = NULL */, CTextureDetails *details /* = NULL */)
 {
   std::string url = CTextureUtils::UnwrapImageURL(image);
@@ -175,7 +314,7 @@ void CTextureCache::ClearCachedImage(const std::string &url, bool deleteSource /
     path = GetCachedPath(cachedFile);
   if (CFile::Exists(path))
     CFile::Delete(path);
-  path = URIUtils::ReplaceExtension(path, ".dds");
+  path = CPicture::GetCompressedCachePath(path);
   if (CFile::Exists(path))
     CFile::Delete(path);
 }
@@ -188,7 +327,7 @@ bool CTextureCache::ClearCachedImage(int id)
     cachedFile = GetCachedPath(cachedFile);
     if (CFile::Exists(cachedFile))
       CFile::Delete(cachedFile);
-    cachedFile = URIUtils::ReplaceExtension(cachedFile, ".dds");
+    cachedFile = CPicture::GetCompressedCachePath(cachedFile);
     if (CFile::Exists(cachedFile))
       CFile::Delete(cachedFile);
     return true;
@@ -273,28 +412,39 @@ void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
   m_completeEvent.Set();
 }
 
+bool CTextureCache::OnCachingStarted(const CTextureCacheJob *job)
+{
+  { // check our processing list
+    CSingleLock lock(m_processingSection);
+    if (m_processinglist.insert(job->m_url).second)
+      return true;
+  }
+  // someone else is caching it, which also takes care of a precached image
+  if (job->IsFetched())
+    OnPrecacheComplete(job->m_url);
+  return false;
+}
+
+void CTextureCache::OnCachingFinished(bool success, CTextureCacheJob *job)
+{
+  OnCachingComplete(success, job);
+  if (job->IsFetched())
+    OnPrecacheComplete(job->m_url);
+}
+
 void CTextureCache::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
   if (strcmp(job->GetType(), kJobTypeCacheImage) == 0)
-    OnCachingComplete(success, (CTextureCacheJob *)job);
+    OnCachingFinished(success, (CTextureCacheJob *)job);
   return CJobQueue::OnJobComplete(jobID, success, job);
 }
 
 void CTextureCache::OnJobProgress(unsigned int jobID, unsigned int progress, unsigned int total, const CJob *job)
 {
   if (strcmp(job->GetType(), kJobTypeCacheImage) == 0 && !progress)
-  { // check our processing list
-    {
-      CSingleLock lock(m_processingSection);
-      const CTextureCacheJob *cacheJob = (CTextureCacheJob *)job;
-      std::set<std::string>::iterator i = m_processinglist.find(cacheJob->m_url);
-      if (i == m_processinglist.end())
-      {
-        m_processinglist.insert(cacheJob->m_url);
-        return;
-      }
-    }
-    CancelJob(job);
+  {
+    if (!OnCachingStarted((const CTextureCacheJob *)job))
+      CancelJob(job);
   }
   else
     CJobQueue::OnJobProgress(jobID, progress, total, job);
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <deque>
 #include <set>
 #include <string>
 #include <vector>
@@ -69,6 +70,17 @@ public:
    */ 
   std::string CheckCachedImage(const std::string &image, bool &needsRecaching);
 
+  /*! \brief Check whether a cached image has a compressed texture we can load instead
+
+   The compressed texture holds pre-built DXT mip levels that are uploaded without decoding.
+   Only used when the imagecachecompressed advanced setting is on and the GPU supports DXT.
+
+   \param cachedImage url of the cached image, as returned from CheckCachedImage
+   \return url of the compressed texture, empty if there isn't one we can use
+   \sa CheckCachedImage
+   */
+  std::string CheckCompressedImage(const std::string &cachedImage) const;
+
   /*! \brief Cache image (if required) using a background job
 
    Checks firstly whether an image is already cached, and return URL if so [see CheckCacheImage]
@@ -80,6 +92,18 @@ public:
    */
   void BackgroundCacheImage(const std::string &image);
 
+  /*! \brief Cache an image ahead of it being displayed
+
+   Meant for art found by the library scanners. Images are checked against the texture
+   database and read into memory by a fetch stage that runs alongside the decode and
+   encode of previously read images. Only a limited number of images are in the pipeline
+   at once, a single one while something is playing.
+
+   \param image url of the image to cache
+   \sa BackgroundCacheImage
+   */
+  void PrecacheImage(const std::string &image);
+
   /*! \brief Cache an image to image cache, optionally return the texture
 
    Caches the given image, returning the texture if the caller wants it.
@@ -155,6 +179,15 @@ public:
    */
   bool Export(const std::string &image, const std::string &destination, bool overwrite);
   bool Export(const std::string &image, const std::string &destination); // TODO: BACKWARD COMPATIBILITY FOR MUSIC THUMBS
+
+  /*! \brief Job settings of the precache pipeline stages.
+   PRIORITY_LOW_PAUSABLE only runs while at most one other job is processing, so during a
+   library scan its two stages would take turns at best. At PRIORITY_LOW (3 jobs at once)
+   there is a worker for each stage next to the scan that feeds them.
+   */
+  static const CJob::PRIORITY PRECACHE_PRIORITY = CJob::PRIORITY_LOW;
+  static const unsigned int PRECACHE_FETCH_JOBS = 1;   ///< images read at once
+  static const unsigned int PRECACHE_DECODE_JOBS = 1;  ///< read images decoded and encoded at once
 private:
   // private construction, and no assignements; use the provided singleton methods
   CTextureCache();
@@ -162,6 +195,21 @@ private:
   CTextureCache const& operator=(CTextureCache const&);
   virtual ~CTextureCache();
 
+  class CFetchJob;
+
+  /*! \brief Job queue for a stage of the precache pipeline, which hands
+   finished jobs back to the texture cache.
+   */
+  class CPrecacheQueue : public CJobQueue
+  {
+  public:
+    CPrecacheQueue(CTextureCache &cache, unsigned int jobsAtOnce);
+    virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+    virtual void OnJobProgress(unsigned int jobID, unsigned int progress, unsigned int total, const CJob *job);
+  private:
+    CTextureCache &m_cache;
+  };
+
   /*! \brief Check if the given image is a cached image
    \param image url of the image
    \return true if this is a cached image, false otherwise.
@@ -219,6 +267,32 @@ private:
    */
   void OnCachingComplete(bool success, CTextureCacheJob *job);
 
+  /*! \brief Called when a caching job starts, on whichever queue it runs.
+   \param job the caching job.
+   \return false if the image is already being cached by another job, which then also
+   finishes off a precached image. The caller should cancel the job.
+   */
+  bool OnCachingStarted(const CTextureCacheJob *job);
+
+  /*! \brief Called when a caching job finished, on whichever queue it ran.
+   \param success whether the job was successful.
+   \param job the caching job.
+   */
+  void OnCachingFinished(bool success, CTextureCacheJob *job);
+
+  /*! \brief Called when the fetch stage of the precache pipeline has completed.
+   Queues the read image for decoding, or finishes it off if it is unchanged or unreadable.
+   */
+  void OnFetchComplete(bool success, CFetchJob *job);
+
+  /*! \brief Called when a precached image has left the pipeline. Starts fetching the next ones.
+   */
+  void OnPrecacheComplete(const std::string &url);
+
+  /*! \brief Start fetch jobs for waiting images while the pipeline has room.
+   */
+  void QueueFetchJobs();
+
   CCriticalSection m_databaseSection;
   CTextureDatabase m_database;
   std::set<std::string> m_processinglist; ///< currently processing list to avoid 2 jobs being processed at once
@@ -226,5 +300,12 @@ private:
   CEvent               m_completeEvent; ///< Set whenever a job has finished
   std::vector<CTextureDetails> m_useCounts; ///< Use count tracking
   CCriticalSection             m_useCountSection;
+
+  CPrecacheQueue               m_fetchQueue;
+  CPrecacheQueue               m_decodeQueue;
+  std::deque<std::string>      m_precacheQueue;    ///< images waiting to be fetched
+  std::set<std::string>        m_precaching;       ///< images waiting or in the pipeline, to avoid queueing them twice
+  unsigned int                 m_precacheInFlight; ///< images being fetched or waiting to be decoded
+  CCriticalSection             m_precacheSection;
 };
 
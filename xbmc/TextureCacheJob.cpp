@@ -39,7 +39,8 @@
 CTextureCacheJob::CTextureCacheJob(const std::string &url, const std::string &oldHash):
   m_url(url),
   m_oldHash(oldHash),
-  m_cachePath(CTextureCache::GetCacheFile(m_url))
+  m_cachePath(CTextureCache::GetCacheFile(m_url)),
+  m_fetched(false)
 {
 }
 
@@ -83,8 +84,9 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
 
   m_details.updateable = additional_info != "music" && UpdateableURL(image);
 
-  // generate the hash
-  m_details.hash = GetImageHash(image);
+  // generate the hash, unless FetchImage already did
+  if (!m_fetched)
+    m_details.hash = GetImageHash(image);
   if (m_details.hash.empty())
     return false;
   else if (m_details.hash == m_oldHash)
@@ -102,7 +104,14 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
     return true;
   }
 #endif
-  CBaseTexture *texture = LoadImage(image, width, height, additional_info, true);
+  // nothing larger than the cache limits gets stored, so don't decode more than that
+  unsigned int loadWidth = width, loadHeight = height;
+  if (!loadWidth && !loadHeight)
+    CPicture::GetMaxCacheSize(loadWidth, loadHeight);
+
+  CBaseTexture *texture = LoadImage(image, loadWidth, loadHeight, additional_info, true,
+                                    reinterpret_cast<unsigned char*>(m_data.get()), m_data.size());
+  m_data.clear();
   if (texture)
   {
     if (texture->HasAlpha())
@@ -127,6 +136,36 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
   return false;
 }
 
+bool CTextureCacheJob::FetchImage()
+{
+  std::string additional_info;
+  unsigned int width, height;
+  CPictureScalingAlgorithm::Algorithm scalingAlgorithm;
+  std::string image = DecodeImageURL(m_url, width, height, scalingAlgorithm, additional_info);
+  if (image.empty())
+    return false;
+
+  m_details.updateable = additional_info != "music" && UpdateableURL(image);
+  m_details.hash = GetImageHash(image);
+  if (m_details.hash.empty())
+    return false;
+  m_fetched = true;
+  if (m_details.hash == m_oldHash)
+    return true;
+
+  // embedded music art and dds images are read by the loaders themselves
+  if (additional_info == "music" || URIUtils::HasExtension(image, ".dds"))
+    return true;
+
+  XFILE::CFile file;
+  if (file.LoadFile(image, m_data) <= 0)
+  {
+    m_data.clear();
+    return false;
+  }
+  return true;
+}
+
 bool CTextureCacheJob::ResizeTexture(const std::string &url, uint8_t* &result, size_t &result_size)
 {
   result = NULL;
@@ -191,7 +230,8 @@ std::string CTextureCacheJob::DecodeImageURL(const std::string &url, unsigned in
   return image;
 }
 
-CBaseTexture *CTextureCacheJob::LoadImage(const std::string &image, unsigned int width, unsigned int height, const std::string &additional_info, bool requirePixels)
+CBaseTexture *CTextureCacheJob::LoadImage(const std::string &image, unsigned int width, unsigned int height, const std::string &additional_info, bool requirePixels,
+                                          unsigned char *data /* = NULL */, size_t dataSize /* = 0 */)
 {
   if (additional_info == "music")
   { // special case for embedded music images
@@ -207,7 +247,11 @@ CBaseTexture *CTextureCacheJob::LoadImage(const std::string &image, unsigned int
       && !StringUtils::StartsWithNoCase(file.GetMimeType(), "image/") && !StringUtils::EqualsNoCase(file.GetMimeType(), "application/octet-stream")) // ignore non-pictures
     return NULL;
 
-  CBaseTexture *texture = CBaseTexture::LoadFromFile(image, width, height, requirePixels, file.GetMimeType());
+  CBaseTexture *texture;
+  if (data && dataSize && !file.GetMimeType().empty())
+    texture = CBaseTexture::LoadFromFileInMemory(data, dataSize, file.GetMimeType(), width, height);
+  else
+    texture = CBaseTexture::LoadFromFile(image, width, height, requirePixels, file.GetMimeType());
   if (!texture)
     return NULL;
 
@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "pictures/PictureScalingAlgorithm.h"
+#include "utils/auto_buffer.h"
 #include "utils/Job.h"
 
 class CBaseTexture;
@@ -79,6 +80,17 @@ public:
    */
   bool CacheTexture(CBaseTexture **texture = NULL);
 
+  /*! \brief Read the image into memory ahead of caching it
+   Works out the image hash and, if the image has changed, reads the source so that a
+   following CacheTexture() only has to decode and encode it.
+   \return true if the image is unchanged or was read, false if it can't be cached
+   \sa CacheTexture, IsFetched
+   */
+  bool FetchImage();
+
+  /*! \brief Whether the image was read by FetchImage() */
+  bool IsFetched() const { return m_fetched; };
+
   static bool ResizeTexture(const std::string &url, uint8_t* &result, size_t &result_size);
 
   std::string m_url;
@@ -120,11 +132,16 @@ private:
    \param width the desired maximum width.
    \param height the desired maximum height.
    \param additional_info extra info for loading, such as whether to flip horizontally.
+   \param data the contents of the image file if already read, NULL to read it.
+   \param dataSize the size of data.
    \return a pointer to a CBaseTexture object, NULL if failed.
    */
-  static CBaseTexture *LoadImage(const std::string &image, unsigned int width, unsigned int height, const std::string &additional_info, bool requirePixels = false);
+  static CBaseTexture *LoadImage(const std::string &image, unsigned int width, unsigned int height, const std::string &additional_info, bool requirePixels = false,
+                                 unsigned char *data = NULL, size_t dataSize = 0);
 
   std::string    m_cachePath;
+  XUTILS::auto_buffer m_data; ///< image file contents read by FetchImage
+  bool           m_fetched;
 };
 
 /* \brief Job class for storing the use count of textures
@@ -578,6 +578,16 @@ unsigned int CActiveAEDSP::GetActiveStreamId(void)
   return m_activeProcessId;
 }
 
+bool CActiveAEDSP::GetStageTimings(unsigned int streamId, std::vector<sDSPStageTiming> &timings)
+{
+  CActiveAEDSPProcessPtr process = GetDSPProcess(streamId);
+  if (!process)
+    return false;
+
+  process->GetStageTimings(timings);
+  return true;
+}
+
 const AE_DSP_MODELIST &CActiveAEDSP::GetAvailableModes(AE_DSP_MODE_TYPE modeType)
 {
   static AE_DSP_MODELIST emptyArray;
@@ -30,6 +30,7 @@
 #include "ActiveAEDSPAddon.h"
 #include "ActiveAEDSPDatabase.h"
 #include "ActiveAEDSPMode.h"
+#include "ActiveAEDSPPipeline.h"
 
 #define ACTIVE_AE_DSP_STATE_OFF       0
 #define ACTIVE_AE_DSP_STATE_ON        1
@@ -328,6 +329,14 @@ namespace ActiveAE
      */
     unsigned int GetActiveStreamId(void);
 
+    /*!>
+     * Get the timing counters of the processing segments of a stream
+     * @param streamId The id of this stream
+     * @param timings Return the counters, one entry per segment
+     * @return True if the stream is processed by dsp's
+     */
+    bool GetStageTimings(unsigned int streamId, std::vector<sDSPStageTiming> &timings);
+
     /*!>
      * Used to get all available modes on currently enabled add-ons
      * It is used from CActiveAEDSPProcess to get a sorted modes list for a processing
@@ -0,0 +1,279 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ActiveAEDSPPipeline.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/TimeUtils.h"
+
+namespace ActiveAE
+{
+
+class CActiveAEDSPPipelineWorker : public CThread
+{
+public:
+  CActiveAEDSPPipelineWorker(CActiveAEDSPPipeline *pipeline, unsigned int stage)
+    : CThread("ActiveAEDSPPipeline"), m_pipeline(pipeline), m_stage(stage), m_slot(0) {};
+
+  void Begin(unsigned int slot)
+  {
+    m_slot = slot;
+    m_startEvent.Set();
+  }
+
+  void Wait()
+  {
+    m_doneEvent.Wait();
+  }
+
+  void Quit()
+  {
+    m_bStop = true;
+    m_startEvent.Set();
+    StopThread(true);
+  }
+
+protected:
+  virtual void Process()
+  {
+    while (true)
+    {
+      m_startEvent.Wait();
+      if (m_bStop)
+        break;
+      m_pipeline->RunStage(m_stage, m_slot);
+      m_doneEvent.Set();
+    }
+  }
+
+  CActiveAEDSPPipeline *m_pipeline;
+  unsigned int m_stage;
+  unsigned int m_slot;
+  CEvent m_startEvent;
+  CEvent m_doneEvent;
+};
+
+/*!
+ * True if an addon serves segments on both sides of the boundary before segment cut
+ */
+static bool SpansCut(const std::vector< std::set<int> > &addons, unsigned int cut)
+{
+  for (unsigned int before = 0; before < cut && before < addons.size(); ++before)
+  {
+    for (unsigned int after = cut; after < addons.size(); ++after)
+    {
+      for (std::set<int>::const_iterator id = addons[before].begin(); id != addons[before].end(); ++id)
+      {
+        if (addons[after].count(*id))
+          return true;
+      }
+    }
+  }
+  return false;
+}
+
+}
+
+using namespace ActiveAE;
+
+CActiveAEDSPPipeline::CActiveAEDSPPipeline()
+  : m_callback(NULL),
+    m_tick(0)
+{
+}
+
+CActiveAEDSPPipeline::~CActiveAEDSPPipeline()
+{
+  Stop();
+}
+
+void CActiveAEDSPPipeline::Start(IActiveAEDSPPipelineCallback *callback, const std::vector<std::string> &segments, unsigned int stages,
+                                 const std::vector< std::set<int> > &addons)
+{
+  Stop();
+
+  // the boundaries a stage may begin at, no addon is called from two stages
+  std::vector<unsigned int> cuts;
+  for (unsigned int cut = 1; cut < segments.size(); ++cut)
+  {
+    if (!SpansCut(addons, cut))
+      cuts.push_back(cut);
+  }
+  stages = std::max(1u, std::min(stages, (unsigned int)cuts.size() + 1));
+
+  m_callback = callback;
+  m_stageBegin.assign(1, 0);
+  unsigned int next = 0;
+  for (unsigned int stage = 1; stage < stages; ++stage)
+  {
+    // the boundary closest to an even split that leaves enough for the remaining stages
+    unsigned int even = stage * segments.size() / stages;
+    unsigned int best = next;
+    for (unsigned int i = next; i + (stages - stage) <= cuts.size(); ++i)
+    {
+      if (std::abs((int)cuts[i] - (int)even) < std::abs((int)cuts[best] - (int)even))
+        best = i;
+    }
+    m_stageBegin.push_back(cuts[best]);
+    next = best + 1;
+  }
+  m_stageBegin.push_back(segments.size());
+
+  {
+    CSingleLock lock(m_timingSection);
+    m_timings.assign(segments.size(), sDSPStageTiming());
+    for (unsigned int stage = 0; stage < stages; ++stage)
+    {
+      for (unsigned int i = m_stageBegin[stage]; i < m_stageBegin[stage + 1]; ++i)
+      {
+        m_timings[i].strName = segments[i];
+        m_timings[i].iThread = stage;
+      }
+    }
+  }
+  ResetTimings();
+
+  for (unsigned int stage = 1; stage < stages; ++stage)
+  {
+    CActiveAEDSPPipelineWorker *worker = new CActiveAEDSPPipelineWorker(this, stage);
+    worker->Create();
+    m_workers.push_back(worker);
+  }
+
+  Reset();
+}
+
+void CActiveAEDSPPipeline::Stop()
+{
+  for (unsigned int i = 0; i < m_workers.size(); ++i)
+  {
+    m_workers[i]->Quit();
+    delete m_workers[i];
+  }
+  m_workers.clear();
+  m_stageBegin.clear();
+  m_failed.clear();
+  m_callback = NULL;
+  m_tick = 0;
+}
+
+void CActiveAEDSPPipeline::Reset()
+{
+  m_failed.assign(GetSlots(), 0);
+  m_tick = 0;
+}
+
+unsigned int CActiveAEDSPPipeline::GetInputSlot() const
+{
+  return GetSlots() ? m_tick % GetSlots() : 0;
+}
+
+unsigned int CActiveAEDSPPipeline::GetSlots() const
+{
+  return m_stageBegin.empty() ? 1 : m_stageBegin.size() - 1;
+}
+
+unsigned int CActiveAEDSPPipeline::GetLatency() const
+{
+  return GetSlots() - 1;
+}
+
+bool CActiveAEDSPPipeline::Run(int &outSlot)
+{
+  outSlot = -1;
+  if (!m_callback)
+    return false;
+
+  unsigned int stages = GetSlots();
+  unsigned int slot = m_tick % stages;
+  m_failed[slot] = 0;
+
+  // stage n works on the packet that entered n calls ago, if there is one yet
+  for (unsigned int stage = 1; stage < stages && stage <= m_tick; ++stage)
+    m_workers[stage - 1]->Begin((m_tick - stage) % stages);
+
+  RunStage(0, slot);
+
+  for (unsigned int stage = 1; stage < stages && stage <= m_tick; ++stage)
+    m_workers[stage - 1]->Wait();
+
+  bool ok = true;
+  if (m_tick >= stages - 1)
+  {
+    outSlot = (m_tick - (stages - 1)) % stages;
+    ok = !m_failed[outSlot];
+  }
+  m_tick++;
+
+  return ok;
+}
+
+void CActiveAEDSPPipeline::RunStage(unsigned int stage, unsigned int slot)
+{
+  int64_t hostFrequency = CurrentHostFrequency();
+
+  for (unsigned int segment = m_stageBegin[stage]; segment < m_stageBegin[stage + 1] && !m_failed[slot]; ++segment)
+  {
+    int64_t startTime = CurrentHostCounter();
+
+    if (!m_callback->ProcessSegment(segment, slot))
+      m_failed[slot] = 1;
+
+    uint64_t time = 1000 * 10000 * (CurrentHostCounter() - startTime) / hostFrequency;
+
+    CSingleLock lock(m_timingSection);
+    sDSPStageTiming &timing = m_timings[segment];
+    timing.iLastTime   = time;
+    timing.iMaxTime    = std::max(timing.iMaxTime, time);
+    timing.iTotalTime += time;
+    timing.iCalls++;
+  }
+}
+
+int64_t CActiveAEDSPPipeline::GetWorkerUsage()
+{
+  int64_t usage = 0;
+  for (unsigned int i = 0; i < m_workers.size(); ++i)
+    usage += m_workers[i]->GetAbsoluteUsage();
+  return usage;
+}
+
+void CActiveAEDSPPipeline::GetTimings(std::vector<sDSPStageTiming> &timings)
+{
+  CSingleLock lock(m_timingSection);
+  timings = m_timings;
+}
+
+void CActiveAEDSPPipeline::ResetTimings()
+{
+  CSingleLock lock(m_timingSection);
+  for (unsigned int i = 0; i < m_timings.size(); ++i)
+  {
+    m_timings[i].iLastTime  = 0;
+    m_timings[i].iMaxTime   = 0;
+    m_timings[i].iTotalTime = 0;
+    m_timings[i].iCalls     = 0;
+  }
+}
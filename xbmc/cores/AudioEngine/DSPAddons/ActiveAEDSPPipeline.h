@@ -0,0 +1,139 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <set>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+
+namespace ActiveAE
+{
+  class CActiveAEDSPPipelineWorker;
+
+  /*!
+   * Timing counters of one dsp chain segment, times are in 100ns units
+   */
+  struct sDSPStageTiming
+  {
+    std::string   strName;
+    unsigned int  iThread;                    /*!< 0 if the segment runs on the calling thread, else the pipeline worker */
+    uint64_t      iLastTime;                  /*!< processing time of the last packet */
+    uint64_t      iMaxTime;                   /*!< longest processing time since the last reset */
+    uint64_t      iTotalTime;
+    uint64_t      iCalls;
+  };
+
+  /*!
+   * Implemented by the owner of the packets, processes one segment of the chain on the
+   * packet stored in the given slot.
+   */
+  class IActiveAEDSPPipelineCallback
+  {
+  public:
+    virtual ~IActiveAEDSPPipelineCallback() {};
+    virtual bool ProcessSegment(unsigned int segment, unsigned int slot) = 0;
+  };
+
+  //@{
+  /*!
+   * Runs the segments of a dsp chain pipelined over worker threads.
+   *
+   * The segments are split in a fixed number of stages. Every Run() moves all packets one
+   * stage further in lockstep: the first stage processes the packet just stored in the input
+   * slot on the calling thread, while every later stage works on an older packet on its own
+   * worker. A packet therefore leaves the pipeline after exactly stages - 1 further calls,
+   * the latency never depends on the load. Each segment is always executed by the same
+   * thread and sees the packets in order.
+   *
+   * All stages run at the same time, so segments served by the same dsp addon are always
+   * kept in one stage: the addon API promises an addon serial calls on its stream handle.
+   */
+  class CActiveAEDSPPipeline
+  {
+  public:
+    CActiveAEDSPPipeline();
+    ~CActiveAEDSPPipeline();
+
+    /*!>
+     * Start the pipeline, stages - 1 worker threads are created
+     * @param callback processes the segments
+     * @param segments names of the segments in processing order
+     * @param stages number of pipeline stages, 1 runs everything serially on the calling thread.
+     * Fewer are used if the addons don't allow as many, see addons.
+     * @param addons ids of the addons serving each segment, a stage never begins between two
+     * segments sharing an addon
+     */
+    void Start(IActiveAEDSPPipelineCallback *callback, const std::vector<std::string> &segments, unsigned int stages,
+               const std::vector< std::set<int> > &addons = std::vector< std::set<int> >());
+    void Stop();
+
+    /*!>
+     * Drop all packets in flight, the next one is stored in slot 0
+     */
+    void Reset();
+
+    /*!>
+     * @return slot the next packet has to be stored in before Run() is called
+     */
+    unsigned int GetInputSlot() const;
+
+    /*!>
+     * Amount of slots the owner has to provide, equal to the number of stages
+     */
+    unsigned int GetSlots() const;
+
+    /*!>
+     * @return packets a packet stays in the pipeline before it is returned
+     */
+    unsigned int GetLatency() const;
+
+    /*!>
+     * Process one step of all stages
+     * @param outSlot the slot of the packet that finished all segments, -1 while the pipeline fills
+     * @return false if a segment failed on the returned packet
+     */
+    bool Run(int &outSlot);
+
+    /*!>
+     * Cpu time of the worker threads in 100ns units
+     */
+    int64_t GetWorkerUsage();
+
+    void GetTimings(std::vector<sDSPStageTiming> &timings);
+    void ResetTimings();
+
+  protected:
+    friend class CActiveAEDSPPipelineWorker;
+
+    void RunStage(unsigned int stage, unsigned int slot);
+
+    IActiveAEDSPPipelineCallback             *m_callback;
+    std::vector<unsigned int>                 m_stageBegin;       /*!< first segment of every stage, plus the end */
+    std::vector<CActiveAEDSPPipelineWorker*>  m_workers;          /*!< worker of stage i + 1 */
+    std::vector<char>                         m_failed;           /*!< per slot, a segment failed on the packet */
+    uint64_t                                  m_tick;
+    std::vector<sDSPStageTiming>              m_timings;
+    CCriticalSection                          m_timingSection;
+  };
+  //@}
+}
@@ -20,6 +20,8 @@
 
 #include "ActiveAEDSPProcess.h"
 
+#include <algorithm>
+#include <set>
 #include <utility>
 
 extern "C" {
@@ -33,6 +35,7 @@ extern "C" {
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/IPlayer.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/MediaSettings.h"
 #include "utils/TimeUtils.h"
 
@@ -54,6 +57,9 @@ CActiveAEDSPProcess::CActiveAEDSPProcess(AE_DSP_STREAM_ID streamId)
   m_convertInput            = NULL;
   m_convertOutput           = NULL;
   m_iLastProcessTime        = 0;
+  m_packetDuration          = 0.0f;
+  m_packetFrames            = 0;
+  m_pendingPackets          = 0;
 
   /*!
    * Create predefined process arrays on every supported channel for audio dsp's.
@@ -62,15 +68,17 @@ CActiveAEDSPProcess::CActiveAEDSPProcess(AE_DSP_STREAM_ID streamId)
    * If a bigger size is neeeded it becomes reallocated during DSP processing.
    */
   m_processArraySize = MIN_DSP_ARRAY_SIZE;
+  memset(m_slots, 0, sizeof(m_slots));
   for (int i = 0; i < AE_DSP_CH_MAX; ++i)
   {
-    m_processArray[0][i] = (float*)calloc(m_processArraySize, sizeof(float));
-    m_processArray[1][i] = (float*)calloc(m_processArraySize, sizeof(float));
+    m_slots[0].array[0][i] = (float*)calloc(m_processArraySize, sizeof(float));
+    m_slots[0].array[1][i] = (float*)calloc(m_processArraySize, sizeof(float));
   }
 }
 
 CActiveAEDSPProcess::~CActiveAEDSPProcess()
 {
+  m_pipeline.Stop();
   ResetStreamFunctionsSelection();
 
   if (m_resamplerDSPProcessor)
@@ -80,12 +88,15 @@ CActiveAEDSPProcess::~CActiveAEDSPProcess()
   }
 
   /* Clear the buffer arrays */
-  for (int i = 0; i < AE_DSP_CH_MAX; ++i)
+  for (unsigned int slot = 0; slot < DSP_SEGMENT_MAX; ++slot)
   {
-    if(m_processArray[0][i])
-      free(m_processArray[0][i]);
-    if(m_processArray[1][i])
-      free(m_processArray[1][i]);
+    for (int i = 0; i < AE_DSP_CH_MAX; ++i)
+    {
+      if(m_slots[slot].array[0][i])
+        free(m_slots[slot].array[0][i]);
+      if(m_slots[slot].array[1][i])
+        free(m_slots[slot].array[1][i]);
+    }
   }
 
   if (m_convertInput)
@@ -585,6 +596,49 @@ bool CActiveAEDSPProcess::Create(const AEAudioFormat &inputFormat, const AEAudio
     }
   }
 
+  /*!
+   * Optional pipelining of the processing segments over worker threads, every further
+   * stage adds the duration of one packet as fixed latency. The stages run at the same
+   * time, so the addons of every segment are handed over and segments sharing an addon
+   * stay in one stage, the addon API promises serial calls on a stream handle. All master
+   * modes count, the active one can change while the stream plays. The process arrays of
+   * the additional packets in flight are allocated here.
+   */
+  std::vector<std::string> segments(DSP_SEGMENT_MAX);
+  segments[DSP_SEGMENT_PRE]    = "pre";
+  segments[DSP_SEGMENT_MASTER] = "master";
+  segments[DSP_SEGMENT_POST]   = "post";
+  std::vector< std::set<int> > segmentAddons(DSP_SEGMENT_MAX);
+  for (unsigned int i = 0; i < m_addons_InputProc.size(); ++i)
+    segmentAddons[DSP_SEGMENT_PRE].insert(m_addons_InputProc[i].pAddon->GetID());
+  if (m_addon_InputResample.pAddon)
+    segmentAddons[DSP_SEGMENT_PRE].insert(m_addon_InputResample.pAddon->GetID());
+  for (unsigned int i = 0; i < m_addons_PreProc.size(); ++i)
+    segmentAddons[DSP_SEGMENT_PRE].insert(m_addons_PreProc[i].pAddon->GetID());
+  for (unsigned int i = 0; i < m_addons_MasterProc.size(); ++i)
+  {
+    if (m_addons_MasterProc[i].pAddon)
+      segmentAddons[DSP_SEGMENT_MASTER].insert(m_addons_MasterProc[i].pAddon->GetID());
+  }
+  for (unsigned int i = 0; i < m_addons_PostProc.size(); ++i)
+    segmentAddons[DSP_SEGMENT_POST].insert(m_addons_PostProc[i].pAddon->GetID());
+  if (m_addon_OutputResample.pAddon)
+    segmentAddons[DSP_SEGMENT_POST].insert(m_addon_OutputResample.pAddon->GetID());
+
+  m_pipeline.Start(this, segments, g_advancedSettings.m_audioDSPPipelineStages, segmentAddons);
+  for (unsigned int slot = 1; slot < m_pipeline.GetSlots(); ++slot)
+  {
+    for (int i = 0; i < AE_DSP_CH_MAX; ++i)
+    {
+      m_slots[slot].array[0][i] = (float*)realloc(m_slots[slot].array[0][i], m_processArraySize*sizeof(float));
+      m_slots[slot].array[1][i] = (float*)realloc(m_slots[slot].array[1][i], m_processArraySize*sizeof(float));
+    }
+  }
+  if (m_pipeline.GetLatency() > 0)
+    CLog::Log(LOGDEBUG, "ActiveAE DSP - %s - processing pipelined over %u threads", __FUNCTION__, m_pipeline.GetSlots());
+  else if (g_advancedSettings.m_audioDSPPipelineStages > 1)
+    CLog::Log(LOGDEBUG, "ActiveAE DSP - %s - dsp addons span every processing segment boundary, not pipelined", __FUNCTION__);
+
   /*!
    * Initialize fallback matrix mixer
    */
@@ -820,6 +874,8 @@ void CActiveAEDSPProcess::Destroy()
 {
   CSingleLock lock(m_restartSection);
 
+  m_pipeline.Stop();
+
   if (!CActiveAEDSP::GetInstance().IsActivated())
     return;
 
@@ -1120,7 +1176,6 @@ bool CActiveAEDSPProcess::Process(CSampleBuffer *in, CSampleBuffer *out)
 
   bool needDSPAddonsReinit  = m_forceInit;
   uint64_t iTime            = static_cast<uint64_t>(XbmcThreads::SystemClockMillis()) * 10000;
-  int64_t hostFrequency     = CurrentHostFrequency();
   unsigned int frames       = in->pkt->nb_samples;
 
   /* Detect interleaved input stream channel positions if unknown or changed */
@@ -1243,27 +1298,34 @@ bool CActiveAEDSPProcess::Process(CSampleBuffer *in, CSampleBuffer *out)
     }
 
     RecheckProcessArray(frames);
-    ClearArray(m_processArray[0], m_processArraySize);
-    ClearArray(m_processArray[1], m_processArraySize);
+    for (unsigned int slot = 0; slot < m_pipeline.GetSlots(); ++slot)
+    {
+      ClearArray(m_slots[slot].array[0], m_processArraySize);
+      ClearArray(m_slots[slot].array[1], m_processArraySize);
+    }
+
+    /**
+     * Packets in flight were processed with the old setup, drop them
+     */
+    m_pipeline.Reset();
+    m_pendingPackets = 0;
 
     m_forceInit         = false;
     m_iLastProcessTime  = static_cast<uint64_t>(XbmcThreads::SystemClockMillis()) * 10000;
     m_iLastProcessUsage = 0;
     m_fLastProcessUsage = 0.0f;
-
-    /**
-     * Setup ffmpeg convert array for input stream
-     */
-    SetFFMpegDSPProcessorArray(m_ffMpegConvertArray, m_processArray[0], NULL);
   }
 
-  int64_t startTime;
-  float **lastOutArray    = m_processArray[0];
-  unsigned int togglePtr  = 1;
+  m_packetDuration = (float)frames / in->pkt->config.sample_rate;
+  m_packetFrames   = frames;
 
   /**
    * Convert to required planar float format inside dsp system
    */
+  sDSPSlot &input = m_slots[m_pipeline.GetInputSlot()];
+  input.current = 0;
+  input.frames  = frames;
+  SetFFMpegDSPProcessorArray(m_ffMpegConvertArray, input.array[0], NULL);
   if (swr_convert(m_convertInput, (uint8_t **)m_ffMpegConvertArray[0], m_processArraySize, (const uint8_t **)in->pkt->data , frames) < 0)
   {
     CLog::Log(LOGERROR, "ActiveAE DSP - %s - input audio convert failed", __FUNCTION__);
@@ -1274,6 +1336,112 @@ bool CActiveAEDSPProcess::Process(CSampleBuffer *in, CSampleBuffer *out)
    /** DSP Processing Algorithms following here **/
   /**********************************************/
 
+  m_pendingPackets = std::min(m_pendingPackets + 1, m_pipeline.GetLatency());
+  if (!RunPipeline(out, frames))
+    return false;
+
+  /**
+   * Update cpu process percent usage values for modes and total (every second)
+   */
+  if (iTime >= m_iLastProcessTime + 1000*10000)
+    CalculateCPUUsage(iTime);
+
+  return true;
+}
+
+bool CActiveAEDSPProcess::Drain(CSampleBuffer *out)
+{
+  CSingleLock lock(m_restartSection);
+
+  if (m_pendingPackets == 0)
+    return false;
+
+  /**
+   * Feed silence behind the last packet to move it through the remaining stages
+   */
+  sDSPSlot &input = m_slots[m_pipeline.GetInputSlot()];
+  input.current = 0;
+  input.frames  = m_packetFrames;
+  ClearArray(input.array[0], m_processArraySize);
+
+  m_pendingPackets--;
+  return RunPipeline(out, m_packetFrames);
+}
+
+void CActiveAEDSPProcess::Flush()
+{
+  CSingleLock lock(m_restartSection);
+
+  m_pipeline.Reset();
+  m_pendingPackets = 0;
+  for (unsigned int slot = 0; slot < m_pipeline.GetSlots(); ++slot)
+  {
+    ClearArray(m_slots[slot].array[0], m_processArraySize);
+    ClearArray(m_slots[slot].array[1], m_processArraySize);
+  }
+}
+
+bool CActiveAEDSPProcess::RunPipeline(CSampleBuffer *out, unsigned int frames)
+{
+  /**
+   * Runs the pre, master and post processing segments, see ProcessSegment. If the
+   * segments are pipelined the packet returned entered some calls before.
+   */
+  int outSlot;
+  if (!m_pipeline.Run(outSlot))
+    return false;
+
+  if (outSlot < 0)
+  {
+    /**
+     * The pipeline is still filling, return silence to keep the latency fixed
+     */
+    frames = std::min((unsigned int)out->pkt->max_nb_samples,
+                      (unsigned int)((uint64_t)frames * m_addonSettings.iOutSamplerate / m_addonSettings.iInSamplerate));
+    for (int i = 0; i < out->pkt->planes; i++)
+      memset(out->pkt->data[i], 0, out->pkt->linesize);
+  }
+  else
+  {
+    sDSPSlot &output = m_slots[outSlot];
+    frames = output.frames;
+
+    /**
+     * Convert back to required output format
+     */
+    SetFFMpegDSPProcessorArray(m_ffMpegConvertArray, NULL, output.array[output.current]);
+    if (swr_convert(m_convertOutput, (uint8_t **)out->pkt->data, m_processArraySize, (const uint8_t **)m_ffMpegConvertArray[1], frames) < 0)
+    {
+      CLog::Log(LOGERROR, "ActiveAE DSP - %s - output audio convert failed", __FUNCTION__);
+      return false;
+    }
+  }
+  out->pkt->nb_samples = frames;
+
+  return true;
+}
+
+bool CActiveAEDSPProcess::ProcessSegment(unsigned int segment, unsigned int slot)
+{
+  switch (segment)
+  {
+    case DSP_SEGMENT_PRE:
+      return ProcessPreSegment(slot);
+    case DSP_SEGMENT_MASTER:
+      return ProcessMasterSegment(slot);
+    case DSP_SEGMENT_POST:
+      return ProcessPostSegment(slot);
+    default:
+      return false;
+  }
+}
+
+bool CActiveAEDSPProcess::ProcessPreSegment(unsigned int slot)
+{
+  sDSPSlot &data          = m_slots[slot];
+  int64_t hostFrequency   = CurrentHostFrequency();
+  int64_t startTime;
+
   /**
    * DSP input processing
    * Can be used to have unchanged input stream..
@@ -1281,7 +1449,7 @@ bool CActiveAEDSPProcess::Process(CSampleBuffer *in, CSampleBuffer *out)
    */
   for (unsigned int i = 0; i < m_addons_InputProc.size(); ++i)
   {
-    if (!m_addons_InputProc[i].pAddon->InputProcess(&m_addons_InputProc[i].handle, (const float **)lastOutArray, frames))
+    if (!m_addons_InputProc[i].pAddon->InputProcess(&m_addons_InputProc[i].handle, (const float **)data.array[data.current], data.frames))
     {
       CLog::Log(LOGERROR, "ActiveAE DSP - %s - input process failed on addon No. %i", __FUNCTION__, i);
       return false;
@@ -1297,14 +1465,13 @@ bool CActiveAEDSPProcess::Process(CSampleBuffer *in, CSampleBuffer *out)
   {
     startTime = CurrentHostCounter();
 
-    frames = m_addon_InputResample.pAddon->InputResampleProcess(&m_addon_InputResample.handle, lastOutArray, m_processArray[togglePtr], frames);
-    if (frames == 0)
+    data.frames = m_addon_InputResample.pAddon->InputResampleProcess(&m_addon_InputResample.handle, data.array[data.current], data.array[data.current ^ 1], data.frames);
+    if (data.frames == 0)
       return false;
 
     m_addon_InputResample.iLastTime += 1000 * 10000 * (CurrentHostCounter() - startTime) / hostFrequency;
 
-    lastOutArray = m_processArray[togglePtr];
-    togglePtr ^= 1;
+    data.current ^= 1;
   }
 
   /**
@@ -1315,16 +1482,24 @@ bool CActiveAEDSPProcess::Process(CSampleBuffer *in, CSampleBuffer *out)
   {
     startTime = CurrentHostCounter();
 
-    frames = m_addons_PreProc[i].pAddon->PreProcess(&m_addons_PreProc[i].handle, m_addons_PreProc[i].iAddonModeNumber, lastOutArray, m_processArray[togglePtr], frames);
-    if (frames == 0)
+    data.frames = m_addons_PreProc[i].pAddon->PreProcess(&m_addons_PreProc[i].handle, m_addons_PreProc[i].iAddonModeNumber, data.array[data.current], data.array[data.current ^ 1], data.frames);
+    if (data.frames == 0)
       return false;
 
     m_addons_PreProc[i].iLastTime += 1000 * 10000 * (CurrentHostCounter() - startTime) / hostFrequency;
 
-    lastOutArray = m_processArray[togglePtr];
-    togglePtr ^= 1;
+    data.current ^= 1;
   }
 
+  return true;
+}
+
+bool CActiveAEDSPProcess::ProcessMasterSegment(unsigned int slot)
+{
+  sDSPSlot &data          = m_slots[slot];
+  int64_t hostFrequency   = CurrentHostFrequency();
+  int64_t startTime;
+
   /**
    * DSP master processing
    * Here a channel upmix/downmix for stereo surround sound can be performed
@@ -1334,14 +1509,13 @@ bool CActiveAEDSPProcess::Process(CSampleBuffer *in, CSampleBuffer *out)
   {
     startTime = CurrentHostCounter();
 
-    frames = m_addons_MasterProc[m_activeMode].pAddon->MasterProcess(&m_addons_MasterProc[m_activeMode].handle, lastOutArray, m_processArray[togglePtr], frames);
-    if (frames == 0)
+    data.frames = m_addons_MasterProc[m_activeMode].pAddon->MasterProcess(&m_addons_MasterProc[m_activeMode].handle, data.array[data.current], data.array[data.current ^ 1], data.frames);
+    if (data.frames == 0)
       return false;
 
     m_addons_MasterProc[m_activeMode].iLastTime += 1000 * 10000 * (CurrentHostCounter() - startTime) / hostFrequency;
 
-    lastOutArray = m_processArray[togglePtr];
-    togglePtr ^= 1;
+    data.current ^= 1;
   }
 
   /**
@@ -1353,22 +1527,33 @@ bool CActiveAEDSPProcess::Process(CSampleBuffer *in, CSampleBuffer *out)
   {
     startTime = CurrentHostCounter();
 
-    if (needDSPAddonsReinit)
-      SetFFMpegDSPProcessorArray(m_ffMpegProcessArray, lastOutArray, m_processArray[togglePtr]);
+    /**
+     * The arrays differ for every packet in flight, so the ffmpeg channel alignment is set each time
+     */
+    SetFFMpegDSPProcessorArray(m_ffMpegProcessArray, data.array[data.current], data.array[data.current ^ 1]);
 
-    frames = m_resamplerDSPProcessor->Resample((uint8_t**)m_ffMpegProcessArray[FFMPEG_PROC_ARRAY_OUT], frames, (uint8_t**)m_ffMpegProcessArray[FFMPEG_PROC_ARRAY_IN], frames, 1.0);
+    int frames = m_resamplerDSPProcessor->Resample((uint8_t**)m_ffMpegProcessArray[FFMPEG_PROC_ARRAY_OUT], data.frames, (uint8_t**)m_ffMpegProcessArray[FFMPEG_PROC_ARRAY_IN], data.frames, 1.0);
     if (frames <= 0)
     {
       CLog::Log(LOGERROR, "CActiveAEResample::Resample - resample failed");
       return false;
     }
+    data.frames = frames;
 
     m_addons_MasterProc[m_activeMode].iLastTime += 1000 * 10000 * (CurrentHostCounter() - startTime) / hostFrequency;
 
-    lastOutArray = m_processArray[togglePtr];
-    togglePtr ^= 1;
+    data.current ^= 1;
   }
 
+  return true;
+}
+
+bool CActiveAEDSPProcess::ProcessPostSegment(unsigned int slot)
+{
+  sDSPSlot &data          = m_slots[slot];
+  int64_t hostFrequency   = CurrentHostFrequency();
+  int64_t startTime;
+
   /**
    * DSP post processing
    * On the post processing can be things performed with additional channel upmix like 6.1 to 7.1
@@ -1379,14 +1564,13 @@ bool CActiveAEDSPProcess::Process(CSampleBuffer *in, CSampleBuffer *out)
   {
     startTime = CurrentHostCounter();
 
-    frames = m_addons_PostProc[i].pAddon->PostProcess(&m_addons_PostProc[i].handle, m_addons_PostProc[i].iAddonModeNumber, lastOutArray, m_processArray[togglePtr], frames);
-    if (frames == 0)
+    data.frames = m_addons_PostProc[i].pAddon->PostProcess(&m_addons_PostProc[i].handle, m_addons_PostProc[i].iAddonModeNumber, data.array[data.current], data.array[data.current ^ 1], data.frames);
+    if (data.frames == 0)
       return false;
 
     m_addons_PostProc[i].iLastTime += 1000 * 10000 * (CurrentHostCounter() - startTime) / hostFrequency;
 
-    lastOutArray = m_processArray[togglePtr];
-    togglePtr ^= 1;
+    data.current ^= 1;
   }
 
   /**
@@ -1398,37 +1582,14 @@ bool CActiveAEDSPProcess::Process(CSampleBuffer *in, CSampleBuffer *out)
   {
     startTime = CurrentHostCounter();
 
-    frames = m_addon_OutputResample.pAddon->OutputResampleProcess(&m_addon_OutputResample.handle, lastOutArray, m_processArray[togglePtr], frames);
-    if (frames == 0)
+    data.frames = m_addon_OutputResample.pAddon->OutputResampleProcess(&m_addon_OutputResample.handle, data.array[data.current], data.array[data.current ^ 1], data.frames);
+    if (data.frames == 0)
       return false;
 
     m_addon_OutputResample.iLastTime += 1000 * 10000 * (CurrentHostCounter() - startTime) / hostFrequency;
 
-    lastOutArray = m_processArray[togglePtr];
-    togglePtr ^= 1;
-  }
-
-  /**
-   * Setup ffmpeg convert array for output stream, performed here to now last array
-   */
-  if (needDSPAddonsReinit)
-    SetFFMpegDSPProcessorArray(m_ffMpegConvertArray, NULL, lastOutArray);
-
-  /**
-   * Convert back to required output format
-   */
-  if (swr_convert(m_convertOutput, (uint8_t **)out->pkt->data, m_processArraySize, (const uint8_t **)m_ffMpegConvertArray[1], frames) < 0)
-  {
-    CLog::Log(LOGERROR, "ActiveAE DSP - %s - output audio convert failed", __FUNCTION__);
-    return false;
+    data.current ^= 1;
   }
-  out->pkt->nb_samples = frames;
-
-  /**
-   * Update cpu process percent usage values for modes and total (every second)
-   */
-  if (iTime >= m_iLastProcessTime + 1000*10000)
-    CalculateCPUUsage(iTime);
 
   return true;
 }
@@ -1490,14 +1651,18 @@ bool CActiveAEDSPProcess::RecheckProcessArray(unsigned int inputFrames)
 bool CActiveAEDSPProcess::ReallocProcessArray(unsigned int requestSize)
 {
   m_processArraySize = requestSize + MIN_DSP_ARRAY_SIZE / 10;
-  for (int i = 0; i < AE_DSP_CH_MAX; ++i)
+  for (unsigned int slot = 0; slot < m_pipeline.GetSlots(); ++slot)
   {
-    m_processArray[0][i] = (float*)realloc(m_processArray[0][i], m_processArraySize*sizeof(float));
-    m_processArray[1][i] = (float*)realloc(m_processArray[1][i], m_processArraySize*sizeof(float));
-    if (m_processArray[0][i] == NULL || m_processArray[1][i] == NULL)
+    float **processArray[2] = { m_slots[slot].array[0], m_slots[slot].array[1] };
+    for (int i = 0; i < AE_DSP_CH_MAX; ++i)
     {
-      CLog::Log(LOGERROR, "ActiveAE DSP - %s - realloc of process data array failed", __FUNCTION__);
-      return false;
+      processArray[0][i] = (float*)realloc(processArray[0][i], m_processArraySize*sizeof(float));
+      processArray[1][i] = (float*)realloc(processArray[1][i], m_processArraySize*sizeof(float));
+      if (processArray[0][i] == NULL || processArray[1][i] == NULL)
+      {
+        CLog::Log(LOGERROR, "ActiveAE DSP - %s - realloc of process data array failed", __FUNCTION__);
+        return false;
+      }
     }
   }
   return true;
@@ -1506,7 +1671,7 @@ bool CActiveAEDSPProcess::ReallocProcessArray(unsigned int requestSize)
 // in this function the usage for each adsp-mode in percent is calculated
 void CActiveAEDSPProcess::CalculateCPUUsage(uint64_t iTime)
 {
-  int64_t iUsage = CThread::GetCurrentThread()->GetAbsoluteUsage();
+  int64_t iUsage = CThread::GetCurrentThread()->GetAbsoluteUsage() + m_pipeline.GetWorkerUsage();
 
   if (iTime != m_iLastProcessTime)
   {
@@ -1704,9 +1869,16 @@ float CActiveAEDSPProcess::GetDelay()
   if (m_addon_OutputResample.pAddon)
     delay += m_addon_OutputResample.pAddon->OutputResampleGetDelay(&m_addon_OutputResample.handle);
 
+  delay += m_pipeline.GetLatency() * m_packetDuration;
+
   return delay;
 }
 
+void CActiveAEDSPProcess::GetStageTimings(std::vector<sDSPStageTiming> &timings)
+{
+  m_pipeline.GetTimings(timings);
+}
+
 bool CActiveAEDSPProcess::HasActiveModes(AE_DSP_MODE_TYPE type)
 {
   bool bReturn(false);
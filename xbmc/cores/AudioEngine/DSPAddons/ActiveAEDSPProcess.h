@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "ActiveAEDSP.h"
+#include "ActiveAEDSPPipeline.h"
 
 extern "C" {
 #include "libavcodec/avcodec.h"
@@ -38,7 +39,7 @@ namespace ActiveAE
   /*!
    * Individual DSP Processing class
    */
-  class CActiveAEDSPProcess
+  class CActiveAEDSPProcess : public IActiveAEDSPPipelineCallback
   {
     public:
       CActiveAEDSPProcess(AE_DSP_STREAM_ID streamId);
@@ -227,6 +228,12 @@ namespace ActiveAE
        */
       bool IsMenuHookModeActive(AE_DSP_MENUHOOK_CAT category, int iAddonId, unsigned int iModeNumber);
 
+      /*!>
+       * Get the timing counters of the pre, master and post processing segments
+       * @param timings Return the counters, one entry per segment
+       */
+      void GetStageTimings(std::vector<sDSPStageTiming> &timings);
+
     protected:
       friend class CActiveAEBufferPoolResample;
 
@@ -238,12 +245,29 @@ namespace ActiveAE
        */
       bool Process(CSampleBuffer *in, CSampleBuffer *out);
 
+      /*!>
+       * Push the packets still in flight out of the processing pipeline
+       * @param out the processed ActiveAE output samples
+       * @return true if a packet was returned, false if the pipeline is empty
+       */
+      bool Drain(CSampleBuffer *out);
+
+      /*!>
+       * Drop the packets in flight, e.g. on seek
+       */
+      void Flush();
+
       /*!>
        * Returns the time in seconds that it will take
        * for the next added packet to be heard from the speakers.
        * @return seconds
        */
       float GetDelay();
+
+      /*!>
+       * Pipeline callback, run one processing segment on the packet in the slot
+       */
+      virtual bool ProcessSegment(unsigned int segment, unsigned int slot);
     //@}
     private:
     //@{
@@ -261,7 +285,11 @@ namespace ActiveAE
       bool RecheckProcessArray(unsigned int inputFrames);
       bool ReallocProcessArray(unsigned int requestSize);
       void CalculateCPUUsage(uint64_t iTime);
+      bool RunPipeline(CSampleBuffer *out, unsigned int frames);
       void SetFFMpegDSPProcessorArray(float *array_ffmpeg[2][AE_DSP_CH_MAX], float **array_in, float **array_out);
+      bool ProcessPreSegment(unsigned int slot);
+      bool ProcessMasterSegment(unsigned int slot);
+      bool ProcessPostSegment(unsigned int slot);
     //@}
     //@{
       /*!
@@ -319,9 +347,30 @@ namespace ActiveAE
       std::map<int,ADDON_HANDLE_STRUCT> m_addon_Handles;            /*!< Handle identifier for the called dsp functions */
 
       /*!>
-       * Process arrays
+       * Processing segments, with pipelining enabled they run on different packets in parallel
+       */
+      enum
+      {
+        DSP_SEGMENT_PRE = 0,                                        /*!< input processing, input resample and pre processing */
+        DSP_SEGMENT_MASTER,                                         /*!< master processing and internal channel mixing */
+        DSP_SEGMENT_POST,                                           /*!< post processing and output resample */
+        DSP_SEGMENT_MAX
+      };
+      CActiveAEDSPPipeline              m_pipeline;
+      float                             m_packetDuration;           /*!< duration of the last input packet in seconds, the latency of one pipeline stage */
+      unsigned int                      m_packetFrames;             /*!< frames of the last input packet, used for the silence pushed on drain */
+      unsigned int                      m_pendingPackets;           /*!< input packets in the pipeline which were not returned yet */
+
+      /*!>
+       * Process arrays, one pair per packet in flight
        */
-      float                            *m_processArray[2][AE_DSP_CH_MAX];
+      struct sDSPSlot
+      {
+        float                          *array[2][AE_DSP_CH_MAX];
+        unsigned int                    current;                    /*!< index of the array with the output of the last processing step */
+        unsigned int                    frames;
+      };
+      sDSPSlot                          m_slots[DSP_SEGMENT_MAX];
       unsigned int                      m_processArraySize;
 
       /*!>
@@ -0,0 +1,267 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/DSPAddons/ActiveAEDSPPipeline.h"
+
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace ActiveAE;
+
+namespace
+{
+
+/*!
+ * Dummy dsp chain, every packet is a number. Segment n adds 10^n, so the
+ * output tells which segments ran, and every segment logs what it saw.
+ */
+class CDummyDSPChain : public IActiveAEDSPPipelineCallback
+{
+public:
+  CDummyDSPChain(unsigned int segments, unsigned int sleepMs = 0)
+    : m_packets(segments, 0), m_seen(segments), m_threads(segments),
+      m_sleepMs(sleepMs), m_failPacket(-1) {}
+
+  virtual bool ProcessSegment(unsigned int segment, unsigned int slot)
+  {
+    m_seen[segment].push_back(m_packets[slot] / 1000);
+    m_threads[segment].push_back(std::this_thread::get_id());
+    if (m_sleepMs)
+      std::this_thread::sleep_for(std::chrono::milliseconds(m_sleepMs));
+    if (segment == 1 && m_packets[slot] / 1000 == m_failPacket)
+      return false;
+    int add = 1;
+    for (unsigned int i = 0; i < segment; ++i)
+      add *= 10;
+    m_packets[slot] += add;
+    return true;
+  }
+
+  std::vector<std::string> Names() const
+  {
+    std::vector<std::string> names;
+    for (unsigned int i = 0; i < m_seen.size(); ++i)
+      names.push_back(i == 0 ? "pre" : i == 1 ? "master" : "post");
+    return names;
+  }
+
+  std::vector<int> m_packets;                             // per slot, packet number * 1000 + segment marks
+  std::vector< std::vector<int> > m_seen;                 // per segment, packet numbers in processing order
+  std::vector< std::vector<std::thread::id> > m_threads;  // per segment
+  unsigned int m_sleepMs;
+  int m_failPacket;
+};
+
+/*! Feed packets 1..count, return the output packets, 0 while the pipeline fills, -1 for failed ones */
+std::vector<int> Feed(CActiveAEDSPPipeline &pipeline, CDummyDSPChain &chain, int count)
+{
+  std::vector<int> output;
+  for (int packet = 1; packet <= count; ++packet)
+  {
+    chain.m_packets[pipeline.GetInputSlot()] = packet * 1000;
+    int outSlot;
+    bool ok = pipeline.Run(outSlot);
+    output.push_back(!ok ? -1 : outSlot < 0 ? 0 : chain.m_packets[outSlot]);
+  }
+  return output;
+}
+
+}
+
+TEST(TestActiveAEDSPPipeline, Serial)
+{
+  CDummyDSPChain chain(3);
+  CActiveAEDSPPipeline pipeline;
+  pipeline.Start(&chain, chain.Names(), 1);
+
+  EXPECT_EQ(0u, pipeline.GetLatency());
+  std::vector<int> output = Feed(pipeline, chain, 5);
+  for (int i = 0; i < 5; ++i)
+    EXPECT_EQ((i + 1) * 1000 + 111, output[i]);
+  for (unsigned int segment = 0; segment < 3; ++segment)
+  {
+    for (unsigned int i = 0; i < chain.m_threads[segment].size(); ++i)
+      EXPECT_EQ(std::this_thread::get_id(), chain.m_threads[segment][i]);
+  }
+}
+
+TEST(TestActiveAEDSPPipeline, FixedLatency)
+{
+  CDummyDSPChain chain(3);
+  CActiveAEDSPPipeline pipeline;
+  pipeline.Start(&chain, chain.Names(), 3);
+
+  EXPECT_EQ(3u, pipeline.GetSlots());
+  EXPECT_EQ(2u, pipeline.GetLatency());
+
+  std::vector<int> output = Feed(pipeline, chain, 20);
+  EXPECT_EQ(0, output[0]);
+  EXPECT_EQ(0, output[1]);
+  for (int i = 2; i < 20; ++i)
+    EXPECT_EQ((i - 1) * 1000 + 111, output[i]);
+
+  for (unsigned int segment = 0; segment < 3; ++segment)
+  {
+    // every segment sees the packets in order, always on the same thread
+    for (unsigned int i = 0; i < chain.m_seen[segment].size(); ++i)
+      EXPECT_EQ((int)i + 1, chain.m_seen[segment][i]);
+    for (unsigned int i = 1; i < chain.m_threads[segment].size(); ++i)
+      EXPECT_EQ(chain.m_threads[segment][0], chain.m_threads[segment][i]);
+  }
+  EXPECT_EQ(std::this_thread::get_id(), chain.m_threads[0][0]);
+  EXPECT_NE(chain.m_threads[0][0], chain.m_threads[1][0]);
+  EXPECT_NE(chain.m_threads[1][0], chain.m_threads[2][0]);
+
+  // packets in flight are dropped
+  pipeline.Reset();
+  output = Feed(pipeline, chain, 3);
+  EXPECT_EQ(0, output[0]);
+  EXPECT_EQ(0, output[1]);
+  EXPECT_EQ(1111, output[2]);
+}
+
+TEST(TestActiveAEDSPPipeline, SegmentsGrouped)
+{
+  CDummyDSPChain chain(3);
+  CActiveAEDSPPipeline pipeline;
+  pipeline.Start(&chain, chain.Names(), 2);
+
+  EXPECT_EQ(1u, pipeline.GetLatency());
+  std::vector<int> output = Feed(pipeline, chain, 4);
+  EXPECT_EQ(0, output[0]);
+  for (int i = 1; i < 4; ++i)
+    EXPECT_EQ(i * 1000 + 111, output[i]);
+
+  std::vector<sDSPStageTiming> timings;
+  pipeline.GetTimings(timings);
+  ASSERT_EQ(3u, timings.size());
+  EXPECT_EQ("pre", timings[0].strName);
+  EXPECT_EQ(0u, timings[0].iThread);
+  EXPECT_EQ(1u, timings[1].iThread);
+  EXPECT_EQ(1u, timings[2].iThread);
+}
+
+TEST(TestActiveAEDSPPipeline, SharedAddonsStayInOneStage)
+{
+  // pre and post served by the same addon, no boundary is left
+  {
+    CDummyDSPChain chain(3);
+    CActiveAEDSPPipeline pipeline;
+    std::vector< std::set<int> > addons(3);
+    addons[0].insert(1);
+    addons[1].insert(2);
+    addons[2].insert(1);
+    pipeline.Start(&chain, chain.Names(), 3, addons);
+
+    EXPECT_EQ(0u, pipeline.GetLatency());
+    std::vector<int> output = Feed(pipeline, chain, 3);
+    for (int i = 0; i < 3; ++i)
+      EXPECT_EQ((i + 1) * 1000 + 111, output[i]);
+  }
+
+  // pre and master share an addon, only post gets a worker
+  {
+    CDummyDSPChain chain(3);
+    CActiveAEDSPPipeline pipeline;
+    std::vector< std::set<int> > addons(3);
+    addons[0].insert(1);
+    addons[1].insert(1);
+    addons[1].insert(2);
+    addons[2].insert(3);
+    pipeline.Start(&chain, chain.Names(), 3, addons);
+
+    EXPECT_EQ(1u, pipeline.GetLatency());
+    std::vector<int> output = Feed(pipeline, chain, 4);
+    EXPECT_EQ(0, output[0]);
+    for (int i = 1; i < 4; ++i)
+      EXPECT_EQ(i * 1000 + 111, output[i]);
+
+    std::vector<sDSPStageTiming> timings;
+    pipeline.GetTimings(timings);
+    ASSERT_EQ(3u, timings.size());
+    EXPECT_EQ(0u, timings[0].iThread);
+    EXPECT_EQ(0u, timings[1].iThread);
+    EXPECT_EQ(1u, timings[2].iThread);
+    EXPECT_EQ(chain.m_threads[0], chain.m_threads[1]);
+  }
+}
+
+TEST(TestActiveAEDSPPipeline, FailedPacket)
+{
+  CDummyDSPChain chain(3);
+  chain.m_failPacket = 3;
+  CActiveAEDSPPipeline pipeline;
+  pipeline.Start(&chain, chain.Names(), 3);
+
+  std::vector<int> output = Feed(pipeline, chain, 6);
+  EXPECT_EQ(1111, output[2]);
+  EXPECT_EQ(2111, output[3]);
+  EXPECT_EQ(-1, output[4]);
+  EXPECT_EQ(4111, output[5]);
+
+  // the post segment never saw the failed packet
+  for (unsigned int i = 0; i < chain.m_seen[2].size(); ++i)
+    EXPECT_NE(3, chain.m_seen[2][i]);
+}
+
+/* Benchmark, run with --gtest_also_run_disabled_tests */
+TEST(TestActiveAEDSPPipeline, DISABLED_Timings)
+{
+  static const int packets = 40;
+  std::chrono::duration<double> elapsed[2];
+  unsigned int stages[2] = { 1, 3 };
+
+  for (int run = 0; run < 2; ++run)
+  {
+    CDummyDSPChain chain(3, 2);
+    CActiveAEDSPPipeline pipeline;
+    pipeline.Start(&chain, chain.Names(), stages[run]);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Feed(pipeline, chain, packets);
+    elapsed[run] = std::chrono::steady_clock::now() - start;
+
+    std::vector<sDSPStageTiming> timings;
+    pipeline.GetTimings(timings);
+    ASSERT_EQ(3u, timings.size());
+    for (unsigned int segment = 0; segment < 3; ++segment)
+    {
+      // the last two packets of the pipelined run did not reach every segment yet
+      EXPECT_EQ(run ? (uint64_t)(packets - segment) : (uint64_t)packets, timings[segment].iCalls);
+      // 2ms of sleep in 100ns units
+      EXPECT_GE(timings[segment].iMaxTime, 20000u);
+      EXPECT_GE(timings[segment].iMaxTime, timings[segment].iLastTime);
+      EXPECT_GE(timings[segment].iTotalTime, timings[segment].iCalls * 20000);
+    }
+
+    pipeline.ResetTimings();
+    pipeline.GetTimings(timings);
+    EXPECT_EQ(0u, timings[0].iCalls);
+  }
+
+  std::cout << "serial: " << elapsed[0].count() * 1000 / packets << "ms/packet, pipelined: "
+            << elapsed[1].count() * 1000 / packets << "ms/packet" << std::endl;
+  EXPECT_LT(elapsed[1].count(), elapsed[0].count());
+}
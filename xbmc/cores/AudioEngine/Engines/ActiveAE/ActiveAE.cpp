@@ -25,6 +25,7 @@ using namespace ActiveAE;
 #include "ActiveAEStream.h"
 #include "cores/AudioEngine/DSPAddons/ActiveAEDSP.h"
 #include "cores/AudioEngine/DSPAddons/ActiveAEDSPProcess.h"
+#include "cores/AudioEngine/Utils/AEKernels.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/Utils/AEStreamInfo.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
@@ -37,6 +38,7 @@ using namespace ActiveAE;
 #define MAX_CACHE_LEVEL 0.4   // total cache time of stream in seconds
 #define MAX_WATER_LEVEL 0.2   // buffered time after stream stages in seconds
 #define MAX_BUFFER_TIME 0.1   // max time of a buffer in seconds
+#define BUFFER_STATS_INTERVAL 50 // ms between samples of the buffer pools
 
 void CEngineStats::Reset(unsigned int sampleRate, bool pcm)
 {
@@ -47,6 +49,9 @@ void CEngineStats::Reset(unsigned int sampleRate, bool pcm)
   m_suspended = false;
   m_hasDSP = false;
   m_pcmOutput = pcm;
+  m_buffersUsed = 0;
+  m_buffersTotal = 0;
+  m_buffersPeak = 0;
 }
 
 void CEngineStats::UpdateSinkDelay(const AEDelayStatus& status, int samples)
@@ -125,17 +130,9 @@ void CEngineStats::UpdateStream(CActiveAEStream *stream)
         str.m_resampleRatio = 1.0;
       }
 
-      CSingleLock lock(stream->m_statsLock);
-      std::deque<CSampleBuffer*>::iterator itBuf;
-      for(itBuf=stream->m_processingSamples.begin(); itBuf!=stream->m_processingSamples.end(); ++itBuf)
-      {
-        if (m_pcmOutput)
-          delay += (float)(*itBuf)->pkt->nb_samples / (*itBuf)->pkt->config.sample_rate;
-        else
-          delay += m_sinkFormat.m_streamInfo.GetDuration() / 1000;
-      }
-      str.m_bufferedTime = delay;
-      stream->m_bufferedTime = 0;
+      // the stream only counts what it added, so whatever it has not handed over yet
+      // is the added time minus the time the engine received
+      str.m_bufferedTime = delay - stream->m_receivedTime;
       break;
     }
   }
@@ -156,8 +153,7 @@ void CEngineStats::GetDelay(AEDelayStatus& status, CActiveAEStream *stream)
   {
     if (str.m_streamId == stream->m_id)
     {
-      CSingleLock lock(stream->m_statsLock);
-      float buffertime = str.m_bufferedTime + stream->m_bufferedTime;
+      double buffertime = str.m_bufferedTime + stream->m_addedTime;
       status.delay += buffertime / str.m_resampleRatio;
       return;
     }
@@ -181,8 +177,7 @@ void CEngineStats::GetSyncInfo(CAESyncInfo& info, CActiveAEStream *stream)
   {
     if (str.m_streamId == stream->m_id)
     {
-      CSingleLock lock(stream->m_statsLock);
-      float buffertime = str.m_bufferedTime + stream->m_bufferedTime;
+      double buffertime = str.m_bufferedTime + stream->m_addedTime;
       status.delay += buffertime / str.m_resampleRatio;
       info.delay = status.GetDelay();
       info.error = str.m_syncError;
@@ -205,8 +200,7 @@ float CEngineStats::GetCacheTime(CActiveAEStream *stream)
   {
     if (str.m_streamId == stream->m_id)
     {
-      CSingleLock lock(stream->m_statsLock);
-      float buffertime = str.m_bufferedTime + stream->m_bufferedTime;
+      double buffertime = str.m_bufferedTime + stream->m_addedTime;
       delay += buffertime / str.m_resampleRatio;
       break;
     }
@@ -264,6 +258,29 @@ AEAudioFormat CEngineStats::GetCurrentSinkFormat()
   return m_sinkFormat;
 }
 
+void CEngineStats::UpdateBufferPools(unsigned int used, unsigned int total)
+{
+  CSingleLock lock(m_lock);
+  m_buffersUsed = used;
+  m_buffersTotal = total;
+  if (used > m_buffersPeak)
+    m_buffersPeak = used;
+}
+
+void CEngineStats::GetBufferPools(unsigned int &used, unsigned int &total, unsigned int &peak)
+{
+  CSingleLock lock(m_lock);
+  used = m_buffersUsed;
+  total = m_buffersTotal;
+  peak = m_buffersPeak;
+}
+
+void CEngineStats::ResetBufferPeak()
+{
+  CSingleLock lock(m_lock);
+  m_buffersPeak = m_buffersUsed;
+}
+
 CActiveAE::CActiveAE() :
   CThread("ActiveAE"),
   m_controlPort("OutputControlPort", &m_inMsgEvent, &m_outMsgEvent),
@@ -287,6 +304,7 @@ CActiveAE::CActiveAE() :
   m_aeGUISoundForce = false;
   m_stats.Reset(44100, true);
   m_streamIdGen = 0;
+  m_waitingForData = false;
 }
 
 CActiveAE::~CActiveAE()
@@ -715,21 +733,6 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
           else
             msg->Reply(CActiveAEDataProtocol::ERR);
           return;
-        case CActiveAEDataProtocol::STREAMSAMPLE:
-          MsgStreamSample *msgData;
-          CSampleBuffer *samples;
-          msgData = (MsgStreamSample*)msg->data;
-          samples = msgData->stream->m_processingSamples.front();
-          msgData->stream->m_processingSamples.pop_front();
-          if (samples != msgData->buffer)
-            CLog::Log(LOGERROR, "CActiveAE - inconsistency in stream sample message");
-          if (msgData->buffer->pkt->nb_samples == 0)
-            msgData->buffer->Return();
-          else
-            msgData->stream->m_resampleBuffers->m_inputSamples.push_back(msgData->buffer);
-          m_extTimeout = 0;
-          m_state = AE_TOP_CONFIGURED_PLAY;
-          return;
         case CActiveAEDataProtocol::FREESTREAM:
           stream = *(CActiveAEStream**)msg->data;
           DiscardStream(stream);
@@ -1009,11 +1012,17 @@ void CActiveAE::Process()
         {
           if((*it)->m_streamPort->ReceiveOutMessage(&msg))
           {
+            // take the samples a stream queued before sending the message first
+            if (CanReceiveStreamSamples())
+              ReceiveStreamSamples();
             gotMsg = true;
             port = &m_dataPort;
             break;
           }
         }
+        // stream sample rings
+        if (!gotMsg && CanReceiveStreamSamples() && ReceiveStreamSamples())
+          continue;
       }
     }
 
@@ -1028,15 +1037,26 @@ void CActiveAE::Process()
       continue;
     }
 
+    // streams only signal the event for new samples while we wait, check the rings
+    // again after announcing it so a sample queued meanwhile isn't missed
+    m_waitingForData = true;
+    if (HasStreamSamples())
+    {
+      m_waitingForData = false;
+      continue;
+    }
+
     // wait for message
     else if (m_outMsgEvent.WaitMSec(m_extTimeout))
     {
+      m_waitingForData = false;
       m_extTimeout = timer.MillisLeft();
       continue;
     }
     // time out
     else
     {
+      m_waitingForData = false;
       msg = m_controlPort.GetMessage();
       msg->signal = CActiveAEControlProtocol::TIMEOUT;
       port = 0;
@@ -1264,6 +1284,8 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
         // create buffer pool
         (*it)->m_inputBuffers = new CActiveAEBufferPool((*it)->m_format);
         (*it)->m_inputBuffers->Create(MAX_CACHE_LEVEL*1000);
+        (*it)->m_freeBuffers.Init((*it)->m_inputBuffers->m_allSamples.size());
+        (*it)->m_filledBuffers.Init((*it)->m_inputBuffers->m_allSamples.size());
         (*it)->m_streamSpace = (*it)->m_format.m_frameSize * (*it)->m_format.m_frames;
 
         // if input format does not follow ffmpeg channel mask, we may need to remap channels
@@ -1449,6 +1471,73 @@ void CActiveAE::DiscardStream(CActiveAEStream *stream)
   ClearDiscardedBuffers();
 }
 
+void CActiveAE::SStreamSample(CActiveAEStream *stream, CSampleBuffer *buffer)
+{
+  CSampleBuffer *samples = stream->m_processingSamples.front();
+  stream->m_processingSamples.pop_front();
+  if (samples != buffer)
+    CLog::Log(LOGERROR, "CActiveAE - inconsistency in stream sample message");
+
+  if (buffer->pkt->nb_samples == 0)
+    buffer->Return();
+  else
+  {
+    if (stream->m_format.m_dataFormat == AE_FMT_RAW)
+      stream->m_receivedTime += stream->m_format.m_streamInfo.GetDuration() / 1000;
+    else
+      stream->m_receivedTime += (double)buffer->pkt->nb_samples / buffer->pkt->config.sample_rate;
+    stream->m_resampleBuffers->m_inputSamples.push_back(buffer);
+  }
+}
+
+bool CActiveAE::ReceiveStreamSamples()
+{
+  bool received = false;
+  CSampleBuffer *buffer;
+  for (auto stream : m_streams)
+  {
+    while ((buffer = stream->m_filledBuffers.Pop()) != NULL)
+    {
+      SStreamSample(stream, buffer);
+      received = true;
+    }
+  }
+
+  if (received)
+  {
+    m_extTimeout = 0;
+    m_state = AE_TOP_CONFIGURED_PLAY;
+  }
+  return received;
+}
+
+bool CActiveAE::HasStreamSamples()
+{
+  if (!CanReceiveStreamSamples())
+    return false;
+
+  for (auto stream : m_streams)
+  {
+    if (!stream->m_filledBuffers.IsEmpty())
+      return true;
+  }
+  return false;
+}
+
+bool CActiveAE::CanReceiveStreamSamples()
+{
+  // stream samples are only taken in the configured states
+  return !m_extDeferData && (m_state == AE_TOP_CONFIGURED ||
+                             m_state == AE_TOP_CONFIGURED_IDLE ||
+                             m_state == AE_TOP_CONFIGURED_PLAY);
+}
+
+void CActiveAE::SignalStreamSample()
+{
+  if (m_waitingForData)
+    m_outMsgEvent.Set();
+}
+
 void CActiveAE::SFlushStream(CActiveAEStream *stream)
 {
   while (!stream->m_processingSamples.empty())
@@ -1458,7 +1547,10 @@ void CActiveAE::SFlushStream(CActiveAEStream *stream)
   }
   stream->m_resampleBuffers->Flush();
   stream->m_streamPort->Purge();
-  stream->m_bufferedTime = 0.0;
+  stream->m_freeBuffers.Reset();
+  stream->m_filledBuffers.Reset();
+  stream->m_addedTime = 0.0;
+  stream->m_receivedTime = 0.0;
   stream->m_paused = false;
   stream->m_syncState = CAESyncInfo::AESyncState::SYNC_START;
   stream->m_syncError.Flush();
@@ -1869,8 +1961,11 @@ bool CActiveAE::RunStages()
       {
         buffer = (*it)->m_inputBuffers->GetFreeBuffer();
         (*it)->m_processingSamples.push_back(buffer);
-        (*it)->m_streamPort->SendInMessage(CActiveAEDataProtocol::STREAMBUFFER, &buffer, sizeof(CSampleBuffer*));
         (*it)->IncFreeBuffers();
+        // the ring holds the whole input pool, so it can't be full
+        (*it)->m_freeBuffers.Push(buffer);
+        if ((*it)->m_waitingForBuffer)
+          (*it)->m_inMsgEvent.Set();
         time += buftime;
       }
     }
@@ -2023,38 +2118,40 @@ bool CActiveAE::RunStages()
               nb_loops = out->pkt->nb_samples;
             }
 
-            for(int i=0; i<nb_loops; i++)
+            if (nb_loops > 1)
             {
-              if ((*it)->m_fadingSamples > 0)
+              // work out the gain of every frame first, so it can be applied in one go
+              m_frameGains.resize(nb_loops);
+              for(int i=0; i<nb_loops; i++)
               {
-                (*it)->m_volume += fadingStep;
-                (*it)->m_fadingSamples--;
-
-                if ((*it)->m_fadingSamples == 0)
+                if ((*it)->m_fadingSamples > 0)
                 {
-                  // set variables being polled via stream interface
-                  CSingleLock lock((*it)->m_streamLock);
-                  (*it)->m_streamFading = false;
+                  (*it)->m_volume += fadingStep;
+                  (*it)->m_fadingSamples--;
+
+                  if ((*it)->m_fadingSamples == 0)
+                  {
+                    // set variables being polled via stream interface
+                    CSingleLock lock((*it)->m_streamLock);
+                    (*it)->m_streamFading = false;
+                  }
                 }
+
+                // volume for stream
+                float volume = (*it)->m_volume * (*it)->m_rgain;
+                volume *= (*it)->m_limiter.Run((float**)out->pkt->data, out->pkt->config.channels, i*nb_floats, out->pkt->planes > 1);
+                m_frameGains[i] = volume;
               }
 
+              for(int j=0; j<out->pkt->planes; j++)
+                CAEKernels::Get().MulFrames((float*)out->pkt->data[j], m_frameGains.data(), nb_floats, nb_loops);
+            }
+            else
+            {
               // volume for stream
               float volume = (*it)->m_volume * (*it)->m_rgain;
-              if(nb_loops > 1)
-                volume *= (*it)->m_limiter.Run((float**)out->pkt->data, out->pkt->config.channels, i*nb_floats, out->pkt->planes > 1);
-
               for(int j=0; j<out->pkt->planes; j++)
-              {
-#ifdef __SSE__
-                CAEUtil::SSEMulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
-#else
-                float* fbuffer = (float*) out->pkt->data[j]+i*nb_floats;
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  fbuffer[k] *= volume;
-                }
-#endif
-              }
+                CAEKernels::Get().Mul((float*)out->pkt->data[j], volume, nb_floats);
             }
           }
           else
@@ -2090,50 +2187,45 @@ bool CActiveAE::RunStages()
               nb_loops = out->pkt->nb_samples;
             }
 
-            for(int i=0; i<nb_loops; i++)
+            float peak = 0.0f;
+            if (nb_loops > 1)
             {
-              if ((*it)->m_fadingSamples > 0)
+              // work out the gain of every frame first, so it can be applied in one go
+              m_frameGains.resize(nb_loops);
+              for(int i=0; i<nb_loops; i++)
               {
-                (*it)->m_volume += fadingStep;
-                (*it)->m_fadingSamples--;
-
-                if ((*it)->m_fadingSamples == 0)
+                if ((*it)->m_fadingSamples > 0)
                 {
-                  // set variables being polled via stream interface
-                  CSingleLock lock((*it)->m_streamLock);
-                  (*it)->m_streamFading = false;
+                  (*it)->m_volume += fadingStep;
+                  (*it)->m_fadingSamples--;
+
+                  if ((*it)->m_fadingSamples == 0)
+                  {
+                    // set variables being polled via stream interface
+                    CSingleLock lock((*it)->m_streamLock);
+                    (*it)->m_streamFading = false;
+                  }
                 }
+
+                // volume for stream
+                float volume = (*it)->m_volume * (*it)->m_rgain;
+                volume *= (*it)->m_limiter.Run((float**)mix->pkt->data, mix->pkt->config.channels, i*nb_floats, mix->pkt->planes > 1);
+                m_frameGains[i] = volume;
               }
 
+              for(int j=0; j<out->pkt->planes && j<mix->pkt->planes; j++)
+                peak = std::max(peak, CAEKernels::Get().MulAddFrames((float*)out->pkt->data[j], (float*)mix->pkt->data[j],
+                                                                     m_frameGains.data(), nb_floats, nb_loops));
+            }
+            else
+            {
               // volume for stream
               float volume = (*it)->m_volume * (*it)->m_rgain;
-              if(nb_loops > 1)
-                volume *= (*it)->m_limiter.Run((float**)mix->pkt->data, mix->pkt->config.channels, i*nb_floats, mix->pkt->planes > 1);
-
               for(int j=0; j<out->pkt->planes && j<mix->pkt->planes; j++)
-              {
-                float *dst = (float*)out->pkt->data[j]+i*nb_floats;
-                float *src = (float*)mix->pkt->data[j]+i*nb_floats;
-#ifdef __SSE__
-                CAEUtil::SSEMulAddArray(dst, src, volume, nb_floats);
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  if (fabs(dst[k]) > 1.0f)
-                  {
-                    needClamp = true;
-                    break;
-                  }
-                }
-#else
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  dst[k] += src[k] * volume;
-                  if (fabs(dst[k]) > 1.0f)
-                    needClamp = true;
-                }
-#endif
-              }
+                peak = std::max(peak, CAEKernels::Get().MulAdd((float*)out->pkt->data[j], (float*)mix->pkt->data[j], volume, nb_floats));
             }
+            if (peak > 1.0f)
+              needClamp = true;
             mix->Return();
           }
           busy = true;
@@ -2146,7 +2238,7 @@ bool CActiveAE::RunStages()
         int nb_floats = out->pkt->nb_samples * out->pkt->config.channels / out->pkt->planes;
         for(int i=0; i<out->pkt->planes; i++)
         {
-          CAEUtil::ClampArray((float*)out->pkt->data[i], nb_floats);
+          CAEKernels::Get().SoftClamp((float*)out->pkt->data[i], nb_floats);
         }
       }
 
@@ -2270,9 +2362,42 @@ bool CActiveAE::RunStages()
     busy = true;
   }
 
+  UpdateBufferStats();
+
   return busy;
 }
 
+void CActiveAE::UpdateBufferStats()
+{
+  // sampled on a timer, publishing takes the stats lock
+  if (!m_bufferStatsTimer.IsTimePast())
+    return;
+  m_bufferStatsTimer.Set(BUFFER_STATS_INTERVAL);
+
+  unsigned int used = 0;
+  unsigned int total = 0;
+  auto count = [&used, &total](CActiveAEBufferPool *pool)
+  {
+    if (!pool)
+      return;
+    total += pool->m_allSamples.size();
+    used += pool->m_allSamples.size() - pool->m_freeSamples.size();
+  };
+
+  count(m_sinkBuffers);
+  count(m_vizBuffers);
+  count(m_vizBuffersInput);
+  count(m_silenceBuffers);
+  count(m_encoderBuffers);
+  for (auto stream : m_streams)
+  {
+    count(stream->m_inputBuffers);
+    count(stream->m_resampleBuffers);
+  }
+
+  m_stats.UpdateBufferPools(used, total);
+}
+
 bool CActiveAE::HasWork()
 {
   if (!m_sounds_playing.empty())
@@ -2505,12 +2630,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
       out = (float*)dstSample.data[j];
       sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
-#ifdef __SSE__
-      CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
-#else
-      for (int k = 0; k < nb_floats; ++k)
-        *out++ += *sample_buffer++ * volume;
-#endif
+      CAEKernels::Get().MulAdd(out, sample_buffer, volume, nb_floats);
     }
 
     it->samples_played += mix_samples;
@@ -2536,13 +2656,7 @@ void CActiveAE::Deamplify(CSoundPacket &dstSample)
     for(int j=0; j<dstSample.planes; j++)
     {
       buffer = (float*)dstSample.data[j];
-#ifdef __SSE__
-      CAEUtil::SSEMulArray(buffer, volume, nb_floats);
-#else
-      float *fbuffer = buffer;
-      for (int i = 0; i < nb_floats; i++)
-        *fbuffer++ *= volume;
-#endif
+      CAEKernels::Get().Mul(buffer, volume, nb_floats);
     }
   }
 }
@@ -3361,3 +3475,14 @@ void CActiveAE::UnregisterAudioCallback(IAudioCallback* pCallback)
   if (it != m_audioCallback.end())
     m_audioCallback.erase(it);
 }
+
+void CActiveAE::GetEngineInfo(AEEngineInfo &info)
+{
+  info.cpuTime = GetAbsoluteUsage();
+  m_stats.GetBufferPools(info.buffersUsed, info.buffersTotal, info.buffersPeak);
+}
+
+void CActiveAE::ResetEngineInfo()
+{
+  m_stats.ResetBufferPeak();
+}
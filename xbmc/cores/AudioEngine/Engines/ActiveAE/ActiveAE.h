@@ -29,6 +29,7 @@
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
 
 #include "guilib/DispResource.h"
+#include <atomic>
 #include <queue>
 
 // ffmpeg
@@ -118,14 +119,12 @@ public:
     FREESOUND,
     NEWSTREAM,
     FREESTREAM,
-    STREAMSAMPLE,
     DRAINSTREAM,
   };
   enum InSignal
   {
     ACC,
     ERR,
-    STREAMBUFFER,
     STREAMDRAINED,
   };
 };
@@ -137,12 +136,6 @@ struct MsgStreamNew
   IAEClockCallback *clock;
 };
 
-struct MsgStreamSample
-{
-  CSampleBuffer *buffer;
-  CActiveAEStream *stream;
-};
-
 struct MsgStreamParameter
 {
   CActiveAEStream *stream;
@@ -170,6 +163,17 @@ struct MsgStreamFFmpegInfo
   enum AVAudioServiceType audio_service_type;
 };
 
+/*!
+ \brief Counters of the engine thread, for tests and benchmarks
+ */
+struct AEEngineInfo
+{
+  int64_t cpuTime;            ///< cpu time used by the engine thread, in 100ns units
+  unsigned int buffersUsed;   ///< sample buffers of the engine and stream pools that are in use, sampled every 50ms
+  unsigned int buffersTotal;  ///< sample buffers allocated by the engine and stream pools
+  unsigned int buffersPeak;   ///< highest buffersUsed since the last ResetEngineInfo
+};
+
 class CEngineStats
 {
 public:
@@ -193,6 +197,9 @@ public:
   bool IsSuspended();
   bool HasDSP();
   AEAudioFormat GetCurrentSinkFormat();
+  void UpdateBufferPools(unsigned int used, unsigned int total);
+  void GetBufferPools(unsigned int &used, unsigned int &total, unsigned int &peak);
+  void ResetBufferPeak();
 protected:
   float m_sinkCacheTotal;
   float m_sinkLatency;
@@ -203,6 +210,9 @@ protected:
   bool m_hasDSP;
   AEAudioFormat m_sinkFormat;
   bool m_pcmOutput;
+  unsigned int m_buffersUsed;
+  unsigned int m_buffersTotal;
+  unsigned int m_buffersPeak;
   CCriticalSection m_lock;
   struct StreamStats
   {
@@ -271,6 +281,9 @@ public:
   virtual void RegisterAudioCallback(IAudioCallback* pCallback);
   virtual void UnregisterAudioCallback(IAudioCallback* pCallback);
 
+  void GetEngineInfo(AEEngineInfo &info);
+  void ResetEngineInfo();
+
   virtual void OnLostDisplay();
   virtual void OnResetDisplay();
   virtual void OnAppFocusChange(bool focus);
@@ -293,6 +306,7 @@ protected:
   void SetStreamResampleMode(CActiveAEStream *stream, int mode);
   void SetStreamFFmpegInfo(CActiveAEStream *stream, int profile, enum AVMatrixEncoding matrix_encoding, enum AVAudioServiceType audio_service_type);
   void SetStreamFade(CActiveAEStream *stream, float from, float target, unsigned int millis);
+  void SignalStreamSample();
 
 protected:
   void Process();
@@ -310,6 +324,10 @@ protected:
   AEAudioFormat GetInputFormat(AEAudioFormat *desiredFmt = NULL);
   CActiveAEStream* CreateStream(MsgStreamNew *streamMsg);
   void DiscardStream(CActiveAEStream *stream);
+  void SStreamSample(CActiveAEStream *stream, CSampleBuffer *buffer);
+  bool ReceiveStreamSamples();
+  bool HasStreamSamples();
+  bool CanReceiveStreamSamples();
   void SFlushStream(CActiveAEStream *stream);
   void FlushEngine();
   void ClearDiscardedBuffers();
@@ -319,6 +337,7 @@ protected:
 
   bool RunStages();
   bool HasWork();
+  void UpdateBufferStats();
   CSampleBuffer* SyncStream(CActiveAEStream *stream);
 
   void ResampleSounds();
@@ -330,6 +349,7 @@ protected:
 
   CEvent m_inMsgEvent;
   CEvent m_outMsgEvent;
+  std::atomic<bool> m_waitingForData;
   CActiveAEControlProtocol m_controlPort;
   CActiveAEDataProtocol m_dataPort;
   int m_state;
@@ -338,6 +358,7 @@ protected:
   bool m_extError;
   bool m_extDrain;
   XbmcThreads::EndTime m_extDrainTimer;
+  XbmcThreads::EndTime m_bufferStatsTimer;
   unsigned int m_extKeepConfig;
   bool m_extDeferData;
   std::queue<time_t> m_extLastDeviceChange;
@@ -385,6 +406,7 @@ protected:
   float m_volumeScaled; // multiplier to scale samples in order to achieve the volume specified in m_volume
   bool m_muted;
   bool m_sinkHasVolume;
+  std::vector<float> m_frameGains; // gain of every frame of a stream buffer when fading or limiting
 
   // viz
   std::vector<IAudioCallback*> m_audioCallback;
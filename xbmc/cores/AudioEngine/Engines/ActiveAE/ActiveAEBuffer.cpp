@@ -69,6 +69,52 @@ void CSampleBuffer::Return()
     pool->ReturnBuffer(this);
 }
 
+CSampleBufferRing::CSampleBufferRing() : m_mask(0), m_head(0), m_tail(0)
+{
+}
+
+void CSampleBufferRing::Init(unsigned int size)
+{
+  unsigned int capacity = 1;
+  while (capacity < size)
+    capacity <<= 1;
+  m_ring.assign(capacity, NULL);
+  m_mask = capacity - 1;
+  Reset();
+}
+
+bool CSampleBufferRing::Push(CSampleBuffer *buffer)
+{
+  unsigned int tail = m_tail.load(std::memory_order_relaxed);
+  if (m_ring.empty() || tail - m_head.load() > m_mask)
+    return false;
+  m_ring[tail & m_mask] = buffer;
+  // sequentially consistent, the producer checks whether the consumer sleeps after this
+  m_tail.store(tail + 1);
+  return true;
+}
+
+CSampleBuffer* CSampleBufferRing::Pop()
+{
+  unsigned int head = m_head.load(std::memory_order_relaxed);
+  if (head == m_tail.load())
+    return NULL;
+  CSampleBuffer *buffer = m_ring[head & m_mask];
+  m_head.store(head + 1);
+  return buffer;
+}
+
+bool CSampleBufferRing::IsEmpty() const
+{
+  return m_head.load() == m_tail.load();
+}
+
+void CSampleBufferRing::Reset()
+{
+  m_head = 0;
+  m_tail = 0;
+}
+
 CActiveAEBufferPool::CActiveAEBufferPool(AEAudioFormat format)
 {
   m_format = format;
@@ -448,6 +494,21 @@ bool CActiveAEBufferPoolResample::ResampleBuffers(int64_t timestamp)
           in = NULL;
         }
       }
+      /*
+       * On drain the pipelined DSP still holds the last packets, push them out first
+       */
+      else if (m_useDSP && m_drain && !skipInput && !m_changeResampler && !m_changeDSP)
+      {
+        if (!m_dspSample)
+          m_dspSample = m_dspBuffer->GetFreeBuffer();
+
+        if (m_dspSample && m_processor->Drain(m_dspSample))
+        {
+          in = m_dspSample;
+          in->timestamp = 0;
+          m_dspSample = NULL;
+        }
+      }
 
       int start = m_procSample->pkt->nb_samples *
                   m_procSample->pkt->bytes_per_sample *
@@ -599,6 +660,8 @@ void CActiveAEBufferPoolResample::Flush()
     m_outputSamples.front()->Return();
     m_outputSamples.pop_front();
   }
+  if (m_useDSP && m_processor)
+    m_processor->Flush();
   if (m_resampler)
     ChangeResampler();
 }
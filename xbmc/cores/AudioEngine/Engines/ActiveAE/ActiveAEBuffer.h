@@ -22,7 +22,9 @@
 #include "cores/AudioEngine/Utils/AEAudioFormat.h"
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include "cores/AudioEngine/DSPAddons/ActiveAEDSP.h"
+#include <atomic>
 #include <deque>
+#include <vector>
 
 extern "C" {
 #include "libavutil/avutil.h"
@@ -76,6 +78,27 @@ public:
   int refCount;
 };
 
+/**
+ * Bounded ring of sample buffers between exactly one producer and one consumer thread.
+ * Neither side takes a lock. Init the ring with the size of the buffer pool feeding it,
+ * then every buffer of the pool fits and Push can't fail.
+ */
+class CSampleBufferRing
+{
+public:
+  CSampleBufferRing();
+  void Init(unsigned int size);          // before either side uses the ring, rounded up to a power of two
+  bool Push(CSampleBuffer *buffer);
+  CSampleBuffer *Pop();
+  bool IsEmpty() const;
+  void Reset();                          // only while neither side uses the ring
+protected:
+  std::vector<CSampleBuffer*> m_ring;
+  unsigned int m_mask;
+  std::atomic<unsigned int> m_head;      // next buffer to pop, advanced by the consumer
+  std::atomic<unsigned int> m_tail;      // next free slot, advanced by the producer
+};
+
 class CActiveAEBufferPool
 {
 public:
@@ -18,10 +18,13 @@
  *
  */
 
+#include "cores/AudioEngine/Utils/AEKernels.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "ActiveAEResampleFFMPEG.h"
 #include "utils/log.h"
 
+#include <string.h>
+
 extern "C" {
 #include "libavutil/channel_layout.h"
 #include "libavutil/opt.h"
@@ -34,6 +37,7 @@ CActiveAEResampleFFMPEG::CActiveAEResampleFFMPEG()
 {
   m_pContext = NULL;
   m_loaded = true;
+  m_directConvert = false;
 }
 
 CActiveAEResampleFFMPEG::~CActiveAEResampleFFMPEG()
@@ -65,6 +69,14 @@ bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, i
   if (m_src_chan_layout == 0)
     m_src_chan_layout = av_get_default_channel_layout(m_src_channels);
 
+  // without resampling or mixing the samples are only converted and reordered
+  m_directConvert = m_src_rate == m_dst_rate && m_src_channels == m_dst_channels &&
+                    IsDirectFormat(m_src_fmt) && IsDirectFormat(m_dst_fmt) &&
+                    (av_get_packed_sample_fmt(m_src_fmt) == AV_SAMPLE_FMT_FLT || av_get_packed_sample_fmt(m_dst_fmt) == AV_SAMPLE_FMT_FLT) &&
+                    (remapLayout || m_src_chan_layout == m_dst_chan_layout);
+  for (int i = 0; i < AE_CH_MAX; i++)
+    m_channelMap[i] = i < m_dst_channels ? i : -1;
+
   m_pContext = swr_alloc_set_opts(NULL, m_dst_chan_layout, m_dst_fmt, m_dst_rate,
                                                         m_src_chan_layout, m_src_fmt, m_src_rate,
                                                         0, NULL);
@@ -121,6 +133,20 @@ bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, i
       {
         m_rematrix[out][idx] = 1.0;
       }
+      if (out < AE_CH_MAX)
+        m_channelMap[out] = idx;
+    }
+    if ((int)remapLayout->Count() != m_dst_channels)
+      m_directConvert = false;
+
+    // interleaved sources are only handled in channel order
+    if (!av_sample_fmt_is_planar(m_src_fmt))
+    {
+      for (int out = 0; out < m_dst_channels; out++)
+      {
+        if (m_channelMap[out] != out)
+          m_directConvert = false;
+      }
     }
 
     av_opt_set_int(m_pContext, "out_channel_count", m_dst_channels, 0);
@@ -181,6 +207,10 @@ bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, i
 
 int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio)
 {
+  // once swresample compensates or buffers samples it has to do all the work, or samples would get lost
+  if (ratio != 1.0 || src_samples > dst_samples)
+    m_directConvert = false;
+
   if (ratio != 1.0)
   {
     if (swr_set_compensation(m_pContext,
@@ -192,7 +222,11 @@ int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uin
     }
   }
 
-  int ret = swr_convert(m_pContext, dst_buffer, dst_samples, (const uint8_t**)src_buffer, src_samples);
+  int ret;
+  if (m_directConvert)
+    ret = Convert(dst_buffer, src_buffer, src_samples);
+  else
+    ret = swr_convert(m_pContext, dst_buffer, dst_samples, (const uint8_t**)src_buffer, src_samples);
   if (ret < 0)
   {
     CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Resample - resample failed");
@@ -239,17 +273,104 @@ int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uin
       int planes = av_sample_fmt_is_planar(m_dst_fmt) ? m_dst_channels : 1;
       int samples = ret * m_dst_channels / planes;
       for (int i=0; i<planes; i++)
+        CAEKernels::Get().ShiftRight32((uint32_t*)dst_buffer[i], 32 - m_dst_bits - m_dst_dither_bits, samples);
+    }
+  }
+  return ret;
+}
+
+bool CActiveAEResampleFFMPEG::IsDirectFormat(AVSampleFormat fmt)
+{
+  switch (fmt)
+  {
+  case AV_SAMPLE_FMT_S16:
+  case AV_SAMPLE_FMT_S16P:
+  case AV_SAMPLE_FMT_S32:
+  case AV_SAMPLE_FMT_S32P:
+  case AV_SAMPLE_FMT_FLT:
+  case AV_SAMPLE_FMT_FLTP:
+    return true;
+  default:
+    return false;
+  }
+}
+
+int CActiveAEResampleFFMPEG::Convert(uint8_t **dst_buffer, uint8_t **src_buffer, int samples)
+{
+  if (samples <= 0 || !src_buffer)
+    return 0;
+
+  const CAEKernels::KernelSet &kernels = CAEKernels::Get();
+  AVSampleFormat srcFmt = av_get_packed_sample_fmt(m_src_fmt);
+  AVSampleFormat dstFmt = av_get_packed_sample_fmt(m_dst_fmt);
+  bool srcPlanar = av_sample_fmt_is_planar(m_src_fmt) != 0;
+  bool dstPlanar = av_sample_fmt_is_planar(m_dst_fmt) != 0;
+  int channels = m_dst_channels;
+  int srcPlanes = srcPlanar ? channels : 1;
+  int dstPlanes = dstPlanar ? channels : 1;
+  int total = samples * channels;
+
+  // float samples laid out like the source, then like the destination
+  m_convertBuffer.resize(total * 2);
+  float *srcFloat[AE_CH_MAX];
+  float *dstFloat[AE_CH_MAX];
+  for (int i = 0; i < srcPlanes; i++)
+  {
+    if (srcFmt == AV_SAMPLE_FMT_FLT)
+      srcFloat[i] = (float*)src_buffer[i];
+    else
+    {
+      srcFloat[i] = m_convertBuffer.data() + i * (total / srcPlanes);
+      if (srcFmt == AV_SAMPLE_FMT_S16)
+        kernels.S16ToFloat(srcFloat[i], (const int16_t*)src_buffer[i], total / srcPlanes);
+      else
+        kernels.S32ToFloat(srcFloat[i], (const int32_t*)src_buffer[i], total / srcPlanes);
+    }
+  }
+  for (int i = 0; i < dstPlanes; i++)
+  {
+    if (dstFmt == AV_SAMPLE_FMT_FLT)
+      dstFloat[i] = (float*)dst_buffer[i];
+    else
+      dstFloat[i] = m_convertBuffer.data() + total + i * (total / dstPlanes);
+  }
+
+  if (srcPlanar)
+  {
+    // source planes in destination channel order
+    const float *planes[AE_CH_MAX];
+    for (int c = 0; c < channels; c++)
+    {
+      if (m_channelMap[c] >= 0)
+        planes[c] = srcFloat[m_channelMap[c]];
+      else
       {
-        uint32_t* buf = (uint32_t*)dst_buffer[i];
-        for (int j=0; j<samples; j++)
-        {
-          *buf = *buf >> (32 - m_dst_bits - m_dst_dither_bits);
-          buf++;
-        }
+        if ((int)m_silence.size() < samples)
+          m_silence.resize(samples, 0.0f);
+        planes[c] = m_silence.data();
       }
     }
+    if (dstPlanar)
+    {
+      for (int c = 0; c < channels; c++)
+        memcpy(dstFloat[c], planes[c], samples * sizeof(float));
+    }
+    else
+      kernels.Interleave(dstFloat[0], planes, channels, samples);
   }
-  return ret;
+  else if (dstPlanar)
+    kernels.Deinterleave(dstFloat, srcFloat[0], channels, samples);
+  else
+    memcpy(dstFloat[0], srcFloat[0], total * sizeof(float));
+
+  for (int i = 0; i < dstPlanes && dstFmt != AV_SAMPLE_FMT_FLT; i++)
+  {
+    if (dstFmt == AV_SAMPLE_FMT_S16)
+      kernels.FloatToS16((int16_t*)dst_buffer[i], dstFloat[i], total / dstPlanes);
+    else
+      kernels.FloatToS32((int32_t*)dst_buffer[i], dstFloat[i], total / dstPlanes);
+  }
+  return samples;
 }
 
 int64_t CActiveAEResampleFFMPEG::GetDelay(int64_t base)
@@ -24,6 +24,8 @@
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include "cores/AudioEngine/Interfaces/AEResample.h"
 
+#include <vector>
+
 extern "C" {
 #include "libavutil/samplefmt.h"
 }
@@ -49,6 +51,9 @@ public:
   int GetDstBufferSize(int samples);
 
 protected:
+  static bool IsDirectFormat(AVSampleFormat fmt);
+  int Convert(uint8_t **dst_buffer, uint8_t **src_buffer, int samples);
+
   bool m_loaded;
   uint64_t m_src_chan_layout, m_dst_chan_layout;
   int m_src_rate, m_dst_rate;
@@ -58,6 +63,10 @@ protected:
   int m_src_dither_bits, m_dst_dither_bits;
   SwrContext *m_pContext;
   double m_rematrix[AE_CH_MAX][AE_CH_MAX];
+  bool m_directConvert;            ///< neither rate nor channels change, convert the samples without swresample
+  int m_channelMap[AE_CH_MAX];     ///< source channel of every destination channel, -1 for silence
+  std::vector<float> m_convertBuffer;
+  std::vector<float> m_silence;
 };
 
 }
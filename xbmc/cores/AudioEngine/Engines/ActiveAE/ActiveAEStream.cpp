@@ -39,7 +39,9 @@ CActiveAEStream::CActiveAEStream(AEAudioFormat *format, unsigned int streamid)
 {
   m_format = *format;
   m_id = streamid;
-  m_bufferedTime = 0;
+  m_addedTime = 0.0;
+  m_receivedTime = 0.0;
+  m_waitingForBuffer = false;
   m_currentBuffer = NULL;
   m_drain = false;
   m_paused = false;
@@ -81,22 +83,26 @@ CActiveAEStream::~CActiveAEStream()
 
 void CActiveAEStream::IncFreeBuffers()
 {
-  CSingleLock lock(m_streamLock);
   m_streamFreeBuffers++;
 }
 
 void CActiveAEStream::DecFreeBuffers()
 {
-  CSingleLock lock(m_streamLock);
   m_streamFreeBuffers--;
 }
 
 void CActiveAEStream::ResetFreeBuffers()
 {
-  CSingleLock lock(m_streamLock);
   m_streamFreeBuffers = 0;
 }
 
+void CActiveAEStream::QueueSample(CSampleBuffer *buffer)
+{
+  // the ring holds the whole input pool, so it can't be full
+  m_filledBuffers.Push(buffer);
+  AE.SignalStreamSample();
+}
+
 void CActiveAEStream::InitRemapper()
 {
   // check if input format follows ffmpeg channel mask
@@ -223,7 +229,6 @@ double CActiveAEStream::CalcResampleRatio(double error)
 
 unsigned int CActiveAEStream::GetSpace()
 {
-  CSingleLock lock(m_streamLock);
   if (m_format.m_dataFormat == AE_FMT_RAW)
     return m_streamFreeBuffers;
   else
@@ -284,52 +289,43 @@ unsigned int CActiveAEStream::AddData(uint8_t* const *data, unsigned int offset,
       copied += minFrames;
 
       bool rawPktComplete = false;
+      if (m_format.m_dataFormat != AE_FMT_RAW)
       {
-        CSingleLock lock(m_statsLock);
-        if (m_format.m_dataFormat != AE_FMT_RAW)
-        {
-          m_currentBuffer->pkt->nb_samples += minFrames;
-          m_bufferedTime += (double)minFrames / m_currentBuffer->pkt->config.sample_rate;
-        }
-        else
-        {
-          m_bufferedTime += m_format.m_streamInfo.GetDuration() / 1000;
-          m_currentBuffer->pkt->nb_samples += minFrames;
-          rawPktComplete = true;
-        }
+        m_currentBuffer->pkt->nb_samples += minFrames;
+        m_addedTime = m_addedTime + (double)minFrames / m_currentBuffer->pkt->config.sample_rate;
+      }
+      else
+      {
+        m_addedTime = m_addedTime + m_format.m_streamInfo.GetDuration() / 1000;
+        m_currentBuffer->pkt->nb_samples += minFrames;
+        rawPktComplete = true;
       }
 
       if (m_currentBuffer->pkt->nb_samples == m_currentBuffer->pkt->max_nb_samples || rawPktComplete)
       {
-        MsgStreamSample msgData;
-        msgData.buffer = m_currentBuffer;
-        msgData.stream = this;
         RemapBuffer();
-        m_streamPort->SendOutMessage(CActiveAEDataProtocol::STREAMSAMPLE, &msgData, sizeof(MsgStreamSample));
+        QueueSample(m_currentBuffer);
         m_currentBuffer = NULL;
       }
       continue;
     }
-    else if (m_streamPort->ReceiveInMessage(&msg))
+
+    m_currentBuffer = m_freeBuffers.Pop();
+    if (m_currentBuffer)
     {
-      if (msg->signal == CActiveAEDataProtocol::STREAMBUFFER)
-      {
-        m_currentBuffer = *((CSampleBuffer**)msg->data);
-        m_currentBuffer->timestamp = 0;
-        m_currentBuffer->pkt->nb_samples = 0;
-        m_currentBuffer->pkt->pause_burst_ms = 0;
-        msg->Release();
-        DecFreeBuffers();
-        continue;
-      }
-      else
-      {
-        CLog::Log(LOGERROR, "CActiveAEStream::AddData - unknown signal");
-        msg->Release();
-        break;
-      }
+      m_currentBuffer->timestamp = 0;
+      m_currentBuffer->pkt->nb_samples = 0;
+      m_currentBuffer->pkt->pause_burst_ms = 0;
+      DecFreeBuffers();
+      continue;
     }
-    if (!m_inMsgEvent.WaitMSec(200))
+
+    // the engine only signals new buffers while we wait, check the ring
+    // again after announcing it so a buffer handed out meanwhile isn't missed
+    m_waitingForBuffer = true;
+    bool timeout = m_freeBuffers.IsEmpty() && !m_inMsgEvent.WaitMSec(200);
+    m_waitingForBuffer = false;
+    if (timeout)
       break;
   }
   return copied;
@@ -398,33 +394,30 @@ void CActiveAEStream::Drain(bool wait)
 
   if (m_currentBuffer)
   {
-    MsgStreamSample msgData;
-    msgData.buffer = m_currentBuffer;
-    msgData.stream = this;
     RemapBuffer();
-    m_streamPort->SendOutMessage(CActiveAEDataProtocol::STREAMSAMPLE, &msgData, sizeof(MsgStreamSample));
+    QueueSample(m_currentBuffer);
     m_currentBuffer = NULL;
   }
 
   XbmcThreads::EndTime timer(2000);
   while (!timer.IsTimePast())
   {
+    // hand back unused buffers, the engine stopped providing them when it got the drain
+    CSampleBuffer *buffer;
+    while ((buffer = m_freeBuffers.Pop()) != NULL)
+    {
+      QueueSample(buffer);
+      DecFreeBuffers();
+    }
+
     if (m_streamPort->ReceiveInMessage(&msg))
     {
-      if (msg->signal == CActiveAEDataProtocol::STREAMBUFFER)
-      {
-        MsgStreamSample msgData;
-        msgData.stream = this;
-        msgData.buffer = *((CSampleBuffer**)msg->data);
-        msg->Reply(CActiveAEDataProtocol::STREAMSAMPLE, &msgData, sizeof(MsgStreamSample));
-        DecFreeBuffers();
-        continue;
-      }
-      else if (msg->signal == CActiveAEDataProtocol::STREAMDRAINED)
+      if (msg->signal == CActiveAEDataProtocol::STREAMDRAINED)
       {
         msg->Release();
         return;
       }
+      msg->Release();
     }
     else if (!wait)
       return;
@@ -101,6 +101,7 @@ protected:
   void IncFreeBuffers();
   void DecFreeBuffers();
   void ResetFreeBuffers();
+  void QueueSample(CSampleBuffer *buffer);
   void InitRemapper();
   void RemapBuffer();
   double CalcResampleRatio(double error);
@@ -158,13 +159,12 @@ protected:
   bool m_streamDraining;
   bool m_streamDrained;
   bool m_streamFading;
-  int m_streamFreeBuffers;
+  std::atomic_int m_streamFreeBuffers;
   bool m_streamIsBuffering;
   bool m_streamIsFlushed;
   bool m_bypassDSP;
   IAEStream *m_streamSlave;
   CCriticalSection m_streamLock;
-  CCriticalSection m_statsLock;
   uint8_t *m_leftoverBuffer;
   int m_leftoverBytes;
   CSampleBuffer *m_currentBuffer;
@@ -173,6 +173,13 @@ protected:
   double m_lastPts;
   double m_lastPtsJump;
   std::atomic_int m_errorInterval;
+  std::atomic<double> m_addedTime;        // audio added since the last flush, in seconds
+  std::atomic<bool> m_waitingForBuffer;   // AddData sleeps until the engine hands out a buffer
+
+  // steady state data path, sample buffers are exchanged with the engine through these
+  // rings without locks, the stream port is only used for control messages and if a ring is full
+  CSampleBufferRing m_freeBuffers;        // engine -> stream
+  CSampleBufferRing m_filledBuffers;      // stream -> engine
 
   // only accessed by engine
   CActiveAEBufferPool *m_inputBuffers;
@@ -187,7 +194,7 @@ protected:
   float m_volume;
   float m_rgain;
   float m_amplify;
-  float m_bufferedTime;
+  double m_receivedTime;                  // audio taken from m_filledBuffers since the last flush
   int m_fadingSamples;
   float m_fadingBase;
   float m_fadingTarget;
@@ -0,0 +1,109 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TestActiveAEHarness.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+
+using ::testing::ValuesIn;
+
+namespace
+{
+
+typedef CActiveAETestHarness::Scenario Scenario;
+
+const Scenario scenarios[] = {
+  // name                     streams format          rate    layout            ratio  duration
+  { "float stereo 48k",       1,      AE_FMT_FLOAT,   48000,  AE_CH_LAYOUT_2_0, 1.0,   1500 },
+  { "s16 stereo 44.1k",       1,      AE_FMT_S16NE,   44100,  AE_CH_LAYOUT_2_0, 1.0,   1500 },
+  { "s32 planar 5.1 96k",     1,      AE_FMT_S32NEP,  96000,  AE_CH_LAYOUT_5_1, 1.0,   1500 },
+  { "float planar 7.1 48k",   1,      AE_FMT_FLOATP,  48000,  AE_CH_LAYOUT_7_1, 1.0,   1500 },
+  { "s16 stereo resampled",   1,      AE_FMT_S16NE,   48000,  AE_CH_LAYOUT_2_0, 1.02,  1500 },
+  { "two streams mixed",      2,      AE_FMT_FLOAT,   44100,  AE_CH_LAYOUT_2_0, 1.0,   1500 },
+  { "ac3 passthrough",        1,      AE_FMT_RAW,     48000,  AE_CH_LAYOUT_2_0, 1.0,   1500 },
+};
+
+class TestActiveAE : public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    ASSERT_TRUE(m_harness.Start());
+  }
+
+  virtual void TearDown()
+  {
+    m_harness.Stop();
+  }
+
+  // the functional checks, timings are reported, not asserted on
+  static void CheckResult(const CActiveAETestHarness::Result &result)
+  {
+    EXPECT_TRUE(result.drained);
+    EXPECT_GT(result.packetsAdded, 0u);
+    EXPECT_GT(result.buffersTotal, 0u);
+    EXPECT_LE(result.buffersPeak, result.buffersTotal);
+  }
+
+  CActiveAETestHarness m_harness;
+};
+
+class TestActiveAEScenarios :
+  public TestActiveAE,
+  public ::testing::WithParamInterface<Scenario>
+{
+};
+
+/* A fraction of a second of stereo float, short enough for every run, to catch
+ * an engine that no longer plays and drains through the NULL sink */
+TEST_F(TestActiveAE, Smoke)
+{
+  const Scenario scenario = { "smoke", 1, AE_FMT_FLOAT, 48000, AE_CH_LAYOUT_2_0, 1.0, 200 };
+  CActiveAETestHarness::Result result;
+
+  EXPECT_TRUE(m_harness.Run(scenario, result));
+  CheckResult(result);
+}
+
+/* Plays every scenario in real time through the NULL sink and reports how the
+ * engine did. Takes seconds per scenario and the numbers depend on the machine,
+ * so it only runs on request: --gtest_also_run_disabled_tests */
+TEST_P(TestActiveAEScenarios, DISABLED_Play)
+{
+  const Scenario &scenario(GetParam());
+  CActiveAETestHarness::Result result;
+
+  EXPECT_TRUE(m_harness.Run(scenario, result));
+  std::cout << CActiveAETestHarness::Format(scenario, result) << std::endl;
+
+  RecordProperty("wallTimeMs", static_cast<int>(result.wallTime * 1000));
+  RecordProperty("cpuTimeMs", static_cast<int>(result.cpuTime * 1000));
+  RecordProperty("latencyAverageMs", static_cast<int>(result.latencyAverage * 1000));
+  RecordProperty("latencyMaxMs", static_cast<int>(result.latencyMax * 1000));
+  RecordProperty("buffersPeak", static_cast<int>(result.buffersPeak));
+
+  CheckResult(result);
+}
+
+INSTANTIATE_TEST_CASE_P(Scenarios, TestActiveAEScenarios,
+                        ValuesIn(scenarios));
+}
@@ -0,0 +1,297 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TestActiveAEHarness.h"
+#include "cores/AudioEngine/AEFactory.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
+#include "cores/AudioEngine/Interfaces/AEStream.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "settings/Settings.h"
+#include "threads/SystemClock.h"
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#define NULL_DEVICE "NULL:NULL"
+#define CHUNK_MS 20
+#define AC3_FRAME_SIZE 1792 // 448 kbit/s at 48 kHz
+
+namespace
+{
+
+struct Feed
+{
+  IAEStream *stream;
+  unsigned int chunksLeft;
+  unsigned int offset;
+  double pts;
+};
+
+template<typename T>
+void Store(uint8_t *dst, unsigned int index, float value, float scale)
+{
+  reinterpret_cast<T*>(dst)[index] = static_cast<T>(value * scale);
+}
+
+/*! \brief One chunk of a different sine on each channel, in the planes of the format */
+void FillChunk(const CActiveAETestHarness::Scenario &scenario, unsigned int channels, unsigned int frames,
+               std::vector< std::vector<uint8_t> > &planes)
+{
+  if (scenario.dataFormat == AE_FMT_RAW)
+  {
+    // an AC3 sync word is all the bitstream packer looks at
+    planes.assign(1, std::vector<uint8_t>(AC3_FRAME_SIZE, 0));
+    planes[0][0] = 0x0B;
+    planes[0][1] = 0x77;
+    return;
+  }
+
+  bool planar = AE_IS_PLANAR(scenario.dataFormat);
+  unsigned int bytes = CAEUtil::DataFormatToBits(scenario.dataFormat) >> 3;
+  unsigned int planeCount = planar ? channels : 1;
+  unsigned int samples = planar ? frames : frames * channels;
+  planes.assign(planeCount, std::vector<uint8_t>(samples * bytes, 0));
+
+  for (unsigned int f = 0; f < frames; f++)
+  {
+    for (unsigned int c = 0; c < channels; c++)
+    {
+      float value = 0.5f * sinf(2.0f * static_cast<float>(M_PI) * 220.0f * (c + 1) * f / scenario.sampleRate);
+      uint8_t *dst = planes[planar ? c : 0].data();
+      unsigned int index = planar ? f : f * channels + c;
+      switch (scenario.dataFormat)
+      {
+        case AE_FMT_S16NE:
+        case AE_FMT_S16NEP:
+          Store<int16_t>(dst, index, value, INT16_MAX);
+          break;
+        case AE_FMT_S32NE:
+        case AE_FMT_S32NEP:
+          Store<int32_t>(dst, index, value, INT32_MAX);
+          break;
+        case AE_FMT_FLOAT:
+        case AE_FMT_FLOATP:
+          Store<float>(dst, index, value, 1.0f);
+          break;
+        default:
+          break;
+      }
+    }
+  }
+}
+
+}
+
+CActiveAETestHarness::CActiveAETestHarness() :
+  m_started(false)
+{
+}
+
+CActiveAETestHarness::~CActiveAETestHarness()
+{
+  Stop();
+}
+
+bool CActiveAETestHarness::Start()
+{
+  if (m_started)
+    return true;
+
+  CSettings &settings = CSettings::GetInstance();
+  m_audioDevice = settings.GetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE);
+  m_passthroughDevice = settings.GetString(CSettings::SETTING_AUDIOOUTPUT_PASSTHROUGHDEVICE);
+  settings.SetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE, NULL_DEVICE);
+  settings.SetString(CSettings::SETTING_AUDIOOUTPUT_PASSTHROUGHDEVICE, NULL_DEVICE);
+
+  // StartEngine unloads the engine itself if it fails
+  if (!CAEFactory::LoadEngine() || !CAEFactory::StartEngine())
+  {
+    CAEFactory::UnLoadEngine();
+    settings.SetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE, m_audioDevice);
+    settings.SetString(CSettings::SETTING_AUDIOOUTPUT_PASSTHROUGHDEVICE, m_passthroughDevice);
+    return false;
+  }
+
+  m_started = true;
+  return true;
+}
+
+void CActiveAETestHarness::Stop()
+{
+  if (!m_started)
+    return;
+
+  CAEFactory::UnLoadEngine();
+
+  CSettings &settings = CSettings::GetInstance();
+  settings.SetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE, m_audioDevice);
+  settings.SetString(CSettings::SETTING_AUDIOOUTPUT_PASSTHROUGHDEVICE, m_passthroughDevice);
+  m_started = false;
+}
+
+bool CActiveAETestHarness::Run(const Scenario &scenario, Result &result)
+{
+  result = Result();
+
+  ActiveAE::CActiveAE *engine = dynamic_cast<ActiveAE::CActiveAE*>(CAEFactory::GetEngine());
+  if (!m_started || !engine)
+    return false;
+
+  bool raw = scenario.dataFormat == AE_FMT_RAW;
+
+  AEAudioFormat format;
+  format.m_dataFormat = scenario.dataFormat;
+  format.m_sampleRate = scenario.sampleRate;
+  if (raw)
+  {
+    format.m_sampleRate = 48000;
+    format.m_channelLayout = CAEChannelInfo();
+    format.m_channelLayout += AE_CH_RAW;
+    format.m_channelLayout += AE_CH_RAW;
+    format.m_streamInfo.m_type = CAEStreamInfo::STREAM_TYPE_AC3;
+    format.m_streamInfo.m_sampleRate = 48000;
+    format.m_streamInfo.m_channels = 2;
+    format.m_streamInfo.m_ac3FrameSize = AC3_FRAME_SIZE;
+  }
+  else
+    format.m_channelLayout = scenario.channelLayout;
+
+  // pcm is fed in chunks of CHUNK_MS, raw one AC3 frame at a time
+  unsigned int chunkFrames = raw ? AC3_FRAME_SIZE : scenario.sampleRate * CHUNK_MS / 1000;
+  double chunkDuration = raw ? format.m_streamInfo.GetDuration() : CHUNK_MS;
+  unsigned int chunks = std::max(1u, (unsigned int)(scenario.durationMs / chunkDuration));
+
+  std::vector< std::vector<uint8_t> > planes;
+  FillChunk(scenario, format.m_channelLayout.Count(), chunkFrames, planes);
+  std::vector<uint8_t*> data;
+  for (auto &plane : planes)
+    data.push_back(plane.data());
+
+  unsigned int options = scenario.resampleRatio != 1.0 ? AESTREAM_FORCE_RESAMPLE : 0;
+  std::vector<Feed> feeds;
+  for (unsigned int i = 0; i < scenario.streams; i++)
+  {
+    Feed feed;
+    feed.stream = CAEFactory::MakeStream(format, options);
+    if (!feed.stream)
+      break;
+    if (scenario.resampleRatio != 1.0)
+      feed.stream->SetResampleRatio(scenario.resampleRatio);
+    feed.chunksLeft = chunks;
+    feed.offset = 0;
+    feed.pts = 0.0;
+    feeds.push_back(feed);
+  }
+
+  bool success = feeds.size() == scenario.streams;
+
+  ActiveAE::AEEngineInfo info;
+  engine->ResetEngineInfo();
+  engine->GetEngineInfo(info);
+  int64_t cpuStart = info.cpuTime;
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  unsigned int timeout = scenario.durationMs * 4 + 5000;
+  double latencySum = 0.0;
+  double buffersSum = 0.0;
+  unsigned int bufferSamples = 0;
+
+  bool pending = success;
+  while (pending)
+  {
+    pending = false;
+    bool added = false;
+    for (auto &feed : feeds)
+    {
+      if (!feed.chunksLeft)
+        continue;
+      pending = true;
+
+      unsigned int space = feed.stream->GetSpace();
+      if (raw ? space == 0 : space < (chunkFrames - feed.offset) * feed.stream->GetFrameSize())
+        continue;
+
+      unsigned int copied = feed.stream->AddData(data.data(), feed.offset, chunkFrames - feed.offset, feed.offset ? 0.0 : feed.pts);
+      if (!copied)
+        continue;
+
+      added = true;
+      feed.offset += copied;
+      if (feed.offset == chunkFrames)
+      {
+        feed.offset = 0;
+        feed.pts += chunkDuration;
+        feed.chunksLeft--;
+        result.packetsAdded++;
+
+        double latency = feed.stream->GetDelay();
+        latencySum += latency;
+        result.latencyMax = std::max(result.latencyMax, latency);
+      }
+    }
+
+    engine->GetEngineInfo(info);
+    buffersSum += info.buffersUsed;
+    bufferSamples++;
+
+    if (XbmcThreads::SystemClockMillis() - start > timeout)
+    {
+      success = false;
+      break;
+    }
+    if (pending && !added)
+      Sleep(5);
+  }
+
+  result.drained = success;
+  if (success)
+  {
+    for (auto &feed : feeds)
+    {
+      feed.stream->Drain(true);
+      result.drained &= feed.stream->IsDrained();
+    }
+  }
+
+  engine->GetEngineInfo(info);
+  result.wallTime = (XbmcThreads::SystemClockMillis() - start) / 1000.0;
+  result.cpuTime = (info.cpuTime - cpuStart) / 10000000.0;
+  result.cpuLoad = result.wallTime > 0.0 ? result.cpuTime / result.wallTime : 0.0;
+  result.buffersTotal = info.buffersTotal;
+  result.buffersPeak = info.buffersPeak;
+  result.buffersAverage = bufferSamples ? buffersSum / bufferSamples : 0.0;
+  result.latencyAverage = result.packetsAdded ? latencySum / result.packetsAdded : 0.0;
+
+  for (auto &feed : feeds)
+    CAEFactory::FreeStream(feed.stream);
+
+  return success;
+}
+
+std::string CActiveAETestHarness::Format(const Scenario &scenario, const Result &result)
+{
+  return StringUtils::Format("%-24s wall %6.2fs  engine cpu %7.3fs (%5.2f%%)  buffers peak %3u/%3u avg %5.1f  latency avg %4.0fms max %4.0fms",
+                             scenario.name,
+                             result.wallTime,
+                             result.cpuTime, result.cpuLoad * 100.0,
+                             result.buffersPeak, result.buffersTotal, result.buffersAverage,
+                             result.latencyAverage * 1000.0, result.latencyMax * 1000.0);
+}
@@ -0,0 +1,79 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEChannelData.h"
+
+#include <string>
+
+/*!
+ \brief Runs ActiveAE without audio hardware
+ The engine is loaded with the NULL sink as output and passthrough device. Streams of
+ synthetic audio are fed like a player would, the NULL sink consumes them in real time
+ and the engine counters are sampled while they play.
+ */
+class CActiveAETestHarness
+{
+public:
+  struct Scenario
+  {
+    const char *name;
+    unsigned int streams;         ///< number of streams played at the same time
+    AEDataFormat dataFormat;      ///< AE_FMT_RAW plays an AC3 passthrough stream
+    unsigned int sampleRate;
+    AEStdChLayout channelLayout;
+    double resampleRatio;         ///< forces the resampler if not 1.0
+    unsigned int durationMs;      ///< audio fed to each stream
+  };
+
+  struct Result
+  {
+    double wallTime;              ///< seconds from the first AddData until all streams are drained
+    double cpuTime;               ///< seconds of cpu used by the engine thread meanwhile
+    double cpuLoad;               ///< cpuTime / wallTime
+    unsigned int buffersTotal;    ///< sample buffers allocated by the engine and stream pools
+    unsigned int buffersPeak;     ///< most sample buffers in use at the same time, as sampled by the engine
+    double buffersAverage;        ///< sample buffers in use, averaged over the samples taken
+    double latencyAverage;        ///< stream delay after AddData in seconds, i.e. until the data is heard
+    double latencyMax;
+    unsigned int packetsAdded;    ///< AddData calls that were accepted
+    bool drained;                 ///< all streams reported drained at the end
+  };
+
+  CActiveAETestHarness();
+  ~CActiveAETestHarness();
+
+  /*! \brief Point the audio settings at the NULL sink and start the engine */
+  bool Start();
+
+  /*! \brief Stop the engine and restore the audio settings */
+  void Stop();
+
+  /*! \brief Play a scenario to the end, blocks for about its duration */
+  bool Run(const Scenario &scenario, Result &result);
+
+  /*! \brief One line report of a run */
+  static std::string Format(const Scenario &scenario, const Result &result);
+
+private:
+  bool m_started;
+  std::string m_audioDevice;
+  std::string m_passthroughDevice;
+};
@@ -0,0 +1,119 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace ActiveAE;
+
+TEST(TestSampleBufferRing, FifoAndFull)
+{
+  CSampleBufferRing ring;
+  std::vector<CSampleBuffer> buffers(100);
+
+  // not initialized yet, nothing fits
+  EXPECT_FALSE(ring.Push(&buffers[0]));
+
+  // a pool of 80 buffers (5ms periods) needs a ring of 128
+  ring.Init(80);
+  EXPECT_TRUE(ring.IsEmpty());
+  EXPECT_EQ(NULL, ring.Pop());
+
+  unsigned int pushed = 0;
+  while (pushed < buffers.size() && ring.Push(&buffers[pushed]))
+    pushed++;
+  EXPECT_EQ(buffers.size(), pushed);
+  EXPECT_FALSE(ring.IsEmpty());
+
+  for (unsigned int i = 0; i < pushed; i++)
+    EXPECT_EQ(&buffers[i], ring.Pop());
+  EXPECT_TRUE(ring.IsEmpty());
+
+  // wraps around
+  EXPECT_TRUE(ring.Push(&buffers[0]));
+  EXPECT_EQ(&buffers[0], ring.Pop());
+
+  EXPECT_TRUE(ring.Push(&buffers[1]));
+  ring.Reset();
+  EXPECT_TRUE(ring.IsEmpty());
+  EXPECT_EQ(NULL, ring.Pop());
+}
+
+TEST(TestSampleBufferRing, HoldsWholePool)
+{
+  const unsigned int sizes[] = { 1, 3, 16, 17, 64, 65, 80 };
+  for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+  {
+    CSampleBufferRing ring;
+    std::vector<CSampleBuffer> buffers(sizes[s]);
+    ring.Init(sizes[s]);
+
+    // go round a few times so the indices wrap, every buffer of the pool always fits
+    for (unsigned int round = 0; round < 3; round++)
+    {
+      for (unsigned int i = 0; i < buffers.size(); i++)
+        EXPECT_TRUE(ring.Push(&buffers[i])) << "pool of " << sizes[s];
+      for (unsigned int i = 0; i < buffers.size(); i++)
+        EXPECT_EQ(&buffers[i], ring.Pop());
+      EXPECT_TRUE(ring.IsEmpty());
+      EXPECT_TRUE(ring.Push(&buffers[0]));
+      EXPECT_EQ(&buffers[0], ring.Pop());
+    }
+  }
+}
+
+TEST(TestSampleBufferRing, ProducerConsumer)
+{
+  static const unsigned int count = 100000;
+  CSampleBufferRing ring;
+  std::vector<CSampleBuffer> buffers(16);
+  ring.Init(buffers.size());
+
+  std::thread producer([&ring, &buffers]() {
+    for (unsigned int i = 0; i < count; i++)
+    {
+      while (!ring.Push(&buffers[i % buffers.size()]))
+        std::this_thread::yield();
+    }
+  });
+
+  unsigned int received = 0;
+  bool ordered = true;
+  while (received < count)
+  {
+    CSampleBuffer *buffer = ring.Pop();
+    if (!buffer)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    ordered &= buffer == &buffers[received % buffers.size()];
+    received++;
+  }
+  producer.join();
+
+  EXPECT_TRUE(ordered);
+  EXPECT_TRUE(ring.IsEmpty());
+}
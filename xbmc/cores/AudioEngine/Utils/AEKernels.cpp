@@ -0,0 +1,913 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AEKernels.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP > 1)
+  #define HAS_SSE2_KERNELS
+  #include <emmintrin.h>
+#endif
+
+// the AVX2 kernels are built with a function attribute rather than a compiler flag, so the
+// rest of the engine still runs on CPUs without it
+#if defined(HAS_SSE2_KERNELS) && ((defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))) || defined(_MSC_VER))
+  #define HAS_AVX2_KERNELS
+  #include <immintrin.h>
+  #if defined(__GNUC__)
+    #define AVX2_TARGET __attribute__((target("avx2")))
+  #else
+    #define AVX2_TARGET
+  #endif
+#endif
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+  #define HAS_NEON_KERNELS
+  #include <arm_neon.h>
+#endif
+
+namespace
+{
+const float S16_SCALE = 32768.0f;
+const float S32_SCALE = 2147483648.0f;
+// the largest float below 2^31, 2^31 itself doesn't fit into an int32
+const float S32_MAX = 2147483520.0f;
+
+//-----------------------------------------------------------------------------
+// C++
+//-----------------------------------------------------------------------------
+
+inline float SoftClampSample(float x)
+{
+  /*
+     This is a rational function to approximate a tanh-like soft clipper.
+     It is based on the pade-approximation of the tanh function with tweaked coefficients.
+     See: http://www.musicdsp.org/showone.php?id=238
+  */
+  if (x < -3.0f)
+    return -1.0f;
+  else if (x > 3.0f)
+    return 1.0f;
+  float y = x * x;
+  return x * (27.0f + y) / (27.0f + 9.0f * y);
+}
+
+void MulScalar(float *data, float gain, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    data[i] *= gain;
+}
+
+float MulAddScalar(float *dst, const float *src, float gain, unsigned int count)
+{
+  float peak = 0.0f;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    dst[i] += src[i] * gain;
+    peak = std::max(peak, fabsf(dst[i]));
+  }
+  return peak;
+}
+
+void MulFramesScalar(float *data, const float *gains, unsigned int channels, unsigned int frames)
+{
+  for (unsigned int f = 0; f < frames; f++, data += channels)
+    for (unsigned int c = 0; c < channels; c++)
+      data[c] *= gains[f];
+}
+
+float MulAddFramesScalar(float *dst, const float *src, const float *gains, unsigned int channels, unsigned int frames)
+{
+  float peak = 0.0f;
+  for (unsigned int f = 0; f < frames; f++, dst += channels, src += channels)
+  {
+    for (unsigned int c = 0; c < channels; c++)
+    {
+      dst[c] += src[c] * gains[f];
+      peak = std::max(peak, fabsf(dst[c]));
+    }
+  }
+  return peak;
+}
+
+void SoftClampScalar(float *data, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    data[i] = SoftClampSample(data[i]);
+}
+
+void InterleaveFrom(float *dst, const float *const *src, unsigned int channels, unsigned int start, unsigned int frames)
+{
+  for (unsigned int f = start; f < frames; f++)
+    for (unsigned int c = 0; c < channels; c++)
+      dst[f * channels + c] = src[c][f];
+}
+
+void InterleaveScalar(float *dst, const float *const *src, unsigned int channels, unsigned int frames)
+{
+  InterleaveFrom(dst, src, channels, 0, frames);
+}
+
+void DeinterleaveFrom(float *const *dst, const float *src, unsigned int channels, unsigned int start, unsigned int frames)
+{
+  for (unsigned int f = start; f < frames; f++)
+    for (unsigned int c = 0; c < channels; c++)
+      dst[c][f] = src[f * channels + c];
+}
+
+void DeinterleaveScalar(float *const *dst, const float *src, unsigned int channels, unsigned int frames)
+{
+  DeinterleaveFrom(dst, src, channels, 0, frames);
+}
+
+void FloatToS16Scalar(int16_t *dst, const float *src, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    dst[i] = (int16_t)lrintf(std::min(std::max(src[i] * S16_SCALE, -32768.0f), 32767.0f));
+}
+
+void FloatToS32Scalar(int32_t *dst, const float *src, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    dst[i] = (int32_t)lrintf(std::min(std::max(src[i] * S32_SCALE, -S32_SCALE), S32_MAX));
+}
+
+void S16ToFloatScalar(float *dst, const int16_t *src, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    dst[i] = src[i] * (1.0f / S16_SCALE);
+}
+
+void S32ToFloatScalar(float *dst, const int32_t *src, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    dst[i] = (float)src[i] * (1.0f / S32_SCALE);
+}
+
+void ShiftRight32Scalar(uint32_t *data, unsigned int shift, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    data[i] >>= shift;
+}
+
+const CAEKernels::KernelSet SCALAR_KERNELS =
+{
+  CAEKernels::ISA_SCALAR, "C++",
+  MulScalar, MulAddScalar, MulFramesScalar, MulAddFramesScalar, SoftClampScalar,
+  InterleaveScalar, DeinterleaveScalar,
+  FloatToS16Scalar, FloatToS32Scalar, S16ToFloatScalar, S32ToFloatScalar, ShiftRight32Scalar
+};
+
+//-----------------------------------------------------------------------------
+// SSE2
+//-----------------------------------------------------------------------------
+
+#if defined(HAS_SSE2_KERNELS)
+inline __m128 AbsSSE2(__m128 v)
+{
+  return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+}
+
+inline float HorizontalMaxSSE2(__m128 v)
+{
+  v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtss_f32(v);
+}
+
+inline __m128 SoftClampSSE2(__m128 x)
+{
+  x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-3.0f)), _mm_set1_ps(3.0f));
+  __m128 y = _mm_mul_ps(x, x);
+  return _mm_div_ps(_mm_mul_ps(x, _mm_add_ps(_mm_set1_ps(27.0f), y)),
+                    _mm_add_ps(_mm_set1_ps(27.0f), _mm_mul_ps(_mm_set1_ps(9.0f), y)));
+}
+
+void MulSSE2(float *data, float gain, unsigned int count)
+{
+  const __m128 g = _mm_set1_ps(gain);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), g));
+  MulScalar(data + i, gain, count - i);
+}
+
+float MulAddSSE2(float *dst, const float *src, float gain, unsigned int count)
+{
+  const __m128 g = _mm_set1_ps(gain);
+  __m128 peak = _mm_setzero_ps();
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 d = _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g));
+    _mm_storeu_ps(dst + i, d);
+    peak = _mm_max_ps(peak, AbsSSE2(d));
+  }
+  return std::max(HorizontalMaxSSE2(peak), MulAddScalar(dst + i, src + i, gain, count - i));
+}
+
+void MulFramesSSE2(float *data, const float *gains, unsigned int channels, unsigned int frames)
+{
+  unsigned int f = 0;
+  if (channels == 1)
+  {
+    for (; f + 4 <= frames; f += 4)
+      _mm_storeu_ps(data + f, _mm_mul_ps(_mm_loadu_ps(data + f), _mm_loadu_ps(gains + f)));
+  }
+  else if (channels == 2)
+  {
+    for (; f + 4 <= frames; f += 4)
+    {
+      __m128 g = _mm_loadu_ps(gains + f);
+      float *d = data + f * 2;
+      _mm_storeu_ps(d, _mm_mul_ps(_mm_loadu_ps(d), _mm_unpacklo_ps(g, g)));
+      _mm_storeu_ps(d + 4, _mm_mul_ps(_mm_loadu_ps(d + 4), _mm_unpackhi_ps(g, g)));
+    }
+  }
+  else
+  {
+    for (; f < frames; f++)
+      MulSSE2(data + f * channels, gains[f], channels);
+  }
+  MulFramesScalar(data + f * channels, gains + f, channels, frames - f);
+}
+
+float MulAddFramesSSE2(float *dst, const float *src, const float *gains, unsigned int channels, unsigned int frames)
+{
+  __m128 peak = _mm_setzero_ps();
+  float scalarPeak = 0.0f;
+  unsigned int f = 0;
+  if (channels == 1)
+  {
+    for (; f + 4 <= frames; f += 4)
+    {
+      __m128 d = _mm_add_ps(_mm_loadu_ps(dst + f), _mm_mul_ps(_mm_loadu_ps(src + f), _mm_loadu_ps(gains + f)));
+      _mm_storeu_ps(dst + f, d);
+      peak = _mm_max_ps(peak, AbsSSE2(d));
+    }
+  }
+  else if (channels == 2)
+  {
+    for (; f + 4 <= frames; f += 4)
+    {
+      __m128 g = _mm_loadu_ps(gains + f);
+      float *d = dst + f * 2;
+      const float *s = src + f * 2;
+      __m128 lo = _mm_add_ps(_mm_loadu_ps(d), _mm_mul_ps(_mm_loadu_ps(s), _mm_unpacklo_ps(g, g)));
+      __m128 hi = _mm_add_ps(_mm_loadu_ps(d + 4), _mm_mul_ps(_mm_loadu_ps(s + 4), _mm_unpackhi_ps(g, g)));
+      _mm_storeu_ps(d, lo);
+      _mm_storeu_ps(d + 4, hi);
+      peak = _mm_max_ps(peak, _mm_max_ps(AbsSSE2(lo), AbsSSE2(hi)));
+    }
+  }
+  else
+  {
+    for (; f < frames; f++)
+      scalarPeak = std::max(scalarPeak, MulAddSSE2(dst + f * channels, src + f * channels, gains[f], channels));
+  }
+  scalarPeak = std::max(scalarPeak, MulAddFramesScalar(dst + f * channels, src + f * channels, gains + f, channels, frames - f));
+  return std::max(HorizontalMaxSSE2(peak), scalarPeak);
+}
+
+void SoftClampSSE2(float *data, unsigned int count)
+{
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, SoftClampSSE2(_mm_loadu_ps(data + i)));
+  SoftClampScalar(data + i, count - i);
+}
+
+void InterleaveSSE2(float *dst, const float *const *src, unsigned int channels, unsigned int frames)
+{
+  unsigned int f = 0;
+  if (channels == 2)
+  {
+    for (; f + 4 <= frames; f += 4)
+    {
+      __m128 l = _mm_loadu_ps(src[0] + f);
+      __m128 r = _mm_loadu_ps(src[1] + f);
+      _mm_storeu_ps(dst + f * 2, _mm_unpacklo_ps(l, r));
+      _mm_storeu_ps(dst + f * 2 + 4, _mm_unpackhi_ps(l, r));
+    }
+  }
+  InterleaveFrom(dst, src, channels, f, frames);
+}
+
+void DeinterleaveSSE2(float *const *dst, const float *src, unsigned int channels, unsigned int frames)
+{
+  unsigned int f = 0;
+  if (channels == 2)
+  {
+    for (; f + 4 <= frames; f += 4)
+    {
+      __m128 a = _mm_loadu_ps(src + f * 2);
+      __m128 b = _mm_loadu_ps(src + f * 2 + 4);
+      _mm_storeu_ps(dst[0] + f, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+      _mm_storeu_ps(dst[1] + f, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+  }
+  DeinterleaveFrom(dst, src, channels, f, frames);
+}
+
+void FloatToS16SSE2(int16_t *dst, const float *src, unsigned int count)
+{
+  const __m128 scale = _mm_set1_ps(S16_SCALE);
+  const __m128 min = _mm_set1_ps(-32768.0f);
+  const __m128 max = _mm_set1_ps(32767.0f);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128i a = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), min), max));
+    __m128i b = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale), min), max));
+    _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(a, b));
+  }
+  FloatToS16Scalar(dst + i, src + i, count - i);
+}
+
+void FloatToS32SSE2(int32_t *dst, const float *src, unsigned int count)
+{
+  const __m128 scale = _mm_set1_ps(S32_SCALE);
+  const __m128 min = _mm_set1_ps(-S32_SCALE);
+  const __m128 max = _mm_set1_ps(S32_MAX);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_si128((__m128i*)(dst + i), _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), min), max)));
+  FloatToS32Scalar(dst + i, src + i, count - i);
+}
+
+void S16ToFloatSSE2(float *dst, const int16_t *src, unsigned int count)
+{
+  const __m128 scale = _mm_set1_ps(1.0f / S16_SCALE);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+    // sign extend by moving each sample to the upper half and shifting it back
+    __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+    __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+  }
+  S16ToFloatScalar(dst + i, src + i, count - i);
+}
+
+void S32ToFloatSSE2(float *dst, const int32_t *src, unsigned int count)
+{
+  const __m128 scale = _mm_set1_ps(1.0f / S32_SCALE);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(src + i))), scale));
+  S32ToFloatScalar(dst + i, src + i, count - i);
+}
+
+void ShiftRight32SSE2(uint32_t *data, unsigned int shift, unsigned int count)
+{
+  const __m128i s = _mm_cvtsi32_si128(shift);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_si128((__m128i*)(data + i), _mm_srl_epi32(_mm_loadu_si128((const __m128i*)(data + i)), s));
+  ShiftRight32Scalar(data + i, shift, count - i);
+}
+
+const CAEKernels::KernelSet SSE2_KERNELS =
+{
+  CAEKernels::ISA_SSE2, "SSE2",
+  MulSSE2, MulAddSSE2, MulFramesSSE2, MulAddFramesSSE2, SoftClampSSE2,
+  InterleaveSSE2, DeinterleaveSSE2,
+  FloatToS16SSE2, FloatToS32SSE2, S16ToFloatSSE2, S32ToFloatSSE2, ShiftRight32SSE2
+};
+#endif
+
+//-----------------------------------------------------------------------------
+// AVX2
+//-----------------------------------------------------------------------------
+
+#if defined(HAS_AVX2_KERNELS)
+AVX2_TARGET inline __m256 AbsAVX2(__m256 v)
+{
+  return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);
+}
+
+AVX2_TARGET inline float HorizontalMaxAVX2(__m256 v)
+{
+  return HorizontalMaxSSE2(_mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+}
+
+// gains of 4 stereo frames, each repeated for both channels
+AVX2_TARGET inline __m256 StereoGainsAVX2(const float *gains)
+{
+  __m128 g = _mm_loadu_ps(gains);
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_unpacklo_ps(g, g)), _mm_unpackhi_ps(g, g), 1);
+}
+
+AVX2_TARGET void MulAVX2(float *data, float gain, unsigned int count)
+{
+  const __m256 g = _mm256_set1_ps(gain);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), g));
+  MulSSE2(data + i, gain, count - i);
+}
+
+AVX2_TARGET float MulAddAVX2(float *dst, const float *src, float gain, unsigned int count)
+{
+  const __m256 g = _mm256_set1_ps(gain);
+  __m256 peak = _mm256_setzero_ps();
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 d = _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), g));
+    _mm256_storeu_ps(dst + i, d);
+    peak = _mm256_max_ps(peak, AbsAVX2(d));
+  }
+  return std::max(HorizontalMaxAVX2(peak), MulAddSSE2(dst + i, src + i, gain, count - i));
+}
+
+AVX2_TARGET void MulFramesAVX2(float *data, const float *gains, unsigned int channels, unsigned int frames)
+{
+  unsigned int f = 0;
+  if (channels == 1)
+  {
+    for (; f + 8 <= frames; f += 8)
+      _mm256_storeu_ps(data + f, _mm256_mul_ps(_mm256_loadu_ps(data + f), _mm256_loadu_ps(gains + f)));
+  }
+  else if (channels == 2)
+  {
+    for (; f + 4 <= frames; f += 4)
+      _mm256_storeu_ps(data + f * 2, _mm256_mul_ps(_mm256_loadu_ps(data + f * 2), StereoGainsAVX2(gains + f)));
+  }
+  MulFramesSSE2(data + f * channels, gains + f, channels, frames - f);
+}
+
+AVX2_TARGET float MulAddFramesAVX2(float *dst, const float *src, const float *gains, unsigned int channels, unsigned int frames)
+{
+  __m256 peak = _mm256_setzero_ps();
+  unsigned int f = 0;
+  if (channels == 1)
+  {
+    for (; f + 8 <= frames; f += 8)
+    {
+      __m256 d = _mm256_add_ps(_mm256_loadu_ps(dst + f), _mm256_mul_ps(_mm256_loadu_ps(src + f), _mm256_loadu_ps(gains + f)));
+      _mm256_storeu_ps(dst + f, d);
+      peak = _mm256_max_ps(peak, AbsAVX2(d));
+    }
+  }
+  else if (channels == 2)
+  {
+    for (; f + 4 <= frames; f += 4)
+    {
+      __m256 d = _mm256_add_ps(_mm256_loadu_ps(dst + f * 2), _mm256_mul_ps(_mm256_loadu_ps(src + f * 2), StereoGainsAVX2(gains + f)));
+      _mm256_storeu_ps(dst + f * 2, d);
+      peak = _mm256_max_ps(peak, AbsAVX2(d));
+    }
+  }
+  return std::max(HorizontalMaxAVX2(peak), MulAddFramesSSE2(dst + f * channels, src + f * channels, gains + f, channels, frames - f));
+}
+
+AVX2_TARGET void SoftClampAVX2(float *data, unsigned int count)
+{
+  const __m256 min = _mm256_set1_ps(-3.0f);
+  const __m256 max = _mm256_set1_ps(3.0f);
+  const __m256 c27 = _mm256_set1_ps(27.0f);
+  const __m256 c9 = _mm256_set1_ps(9.0f);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(data + i), min), max);
+    __m256 y = _mm256_mul_ps(x, x);
+    _mm256_storeu_ps(data + i, _mm256_div_ps(_mm256_mul_ps(x, _mm256_add_ps(c27, y)),
+                                             _mm256_add_ps(c27, _mm256_mul_ps(c9, y))));
+  }
+  SoftClampSSE2(data + i, count - i);
+}
+
+AVX2_TARGET void InterleaveAVX2(float *dst, const float *const *src, unsigned int channels, unsigned int frames)
+{
+  unsigned int f = 0;
+  if (channels == 2)
+  {
+    for (; f + 8 <= frames; f += 8)
+    {
+      __m256 l = _mm256_loadu_ps(src[0] + f);
+      __m256 r = _mm256_loadu_ps(src[1] + f);
+      // unpack works within the 128 bit lanes, put the lanes back in order
+      __m256 lo = _mm256_unpacklo_ps(l, r);
+      __m256 hi = _mm256_unpackhi_ps(l, r);
+      _mm256_storeu_ps(dst + f * 2, _mm256_permute2f128_ps(lo, hi, 0x20));
+      _mm256_storeu_ps(dst + f * 2 + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+  }
+  if (f < frames)
+  {
+    const float *rest[2];
+    if (channels == 2)
+    {
+      rest[0] = src[0] + f;
+      rest[1] = src[1] + f;
+      InterleaveSSE2(dst + f * 2, rest, 2, frames - f);
+    }
+    else
+      InterleaveFrom(dst, src, channels, f, frames);
+  }
+}
+
+AVX2_TARGET void FloatToS16AVX2(int16_t *dst, const float *src, unsigned int count)
+{
+  const __m256 scale = _mm256_set1_ps(S16_SCALE);
+  const __m256 min = _mm256_set1_ps(-32768.0f);
+  const __m256 max = _mm256_set1_ps(32767.0f);
+  unsigned int i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    __m256i a = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), min), max));
+    __m256i b = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale), min), max));
+    // packing works within the 128 bit lanes, put the quarters back in order
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+    _mm256_storeu_si256((__m256i*)(dst + i), packed);
+  }
+  FloatToS16SSE2(dst + i, src + i, count - i);
+}
+
+AVX2_TARGET void FloatToS32AVX2(int32_t *dst, const float *src, unsigned int count)
+{
+  const __m256 scale = _mm256_set1_ps(S32_SCALE);
+  const __m256 min = _mm256_set1_ps(-S32_SCALE);
+  const __m256 max = _mm256_set1_ps(S32_MAX);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_si256((__m256i*)(dst + i), _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), min), max)));
+  FloatToS32SSE2(dst + i, src + i, count - i);
+}
+
+AVX2_TARGET void S16ToFloatAVX2(float *dst, const int16_t *src, unsigned int count)
+{
+  const __m256 scale = _mm256_set1_ps(1.0f / S16_SCALE);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i)));
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+  }
+  S16ToFloatSSE2(dst + i, src + i, count - i);
+}
+
+AVX2_TARGET void S32ToFloatAVX2(float *dst, const int32_t *src, unsigned int count)
+{
+  const __m256 scale = _mm256_set1_ps(1.0f / S32_SCALE);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)(src + i))), scale));
+  S32ToFloatSSE2(dst + i, src + i, count - i);
+}
+
+AVX2_TARGET void ShiftRight32AVX2(uint32_t *data, unsigned int shift, unsigned int count)
+{
+  const __m128i s = _mm_cvtsi32_si128(shift);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_si256((__m256i*)(data + i), _mm256_srl_epi32(_mm256_loadu_si256((const __m256i*)(data + i)), s));
+  ShiftRight32SSE2(data + i, shift, count - i);
+}
+
+// deinterleaving is bound by the stores, 256 bit shuffles don't gain anything over SSE2
+const CAEKernels::KernelSet AVX2_KERNELS =
+{
+  CAEKernels::ISA_AVX2, "AVX2",
+  MulAVX2, MulAddAVX2, MulFramesAVX2, MulAddFramesAVX2, SoftClampAVX2,
+  InterleaveAVX2, DeinterleaveSSE2,
+  FloatToS16AVX2, FloatToS32AVX2, S16ToFloatAVX2, S32ToFloatAVX2, ShiftRight32AVX2
+};
+#endif
+
+//-----------------------------------------------------------------------------
+// NEON
+//-----------------------------------------------------------------------------
+
+#if defined(HAS_NEON_KERNELS)
+inline float HorizontalMaxNEON(float32x4_t v)
+{
+  float32x2_t m = vpmax_f32(vget_low_f32(v), vget_high_f32(v));
+  m = vpmax_f32(m, m);
+  return vget_lane_f32(m, 0);
+}
+
+// round to nearest, ARMv7 can only truncate so it rounds half away from zero instead of to even
+inline int32x4_t RoundNEON(float32x4_t v)
+{
+#if defined(__aarch64__)
+  return vcvtnq_s32_f32(v);
+#else
+  float32x4_t half = vbslq_f32(vdupq_n_u32(0x80000000), v, vdupq_n_f32(0.5f));
+  return vcvtq_s32_f32(vaddq_f32(v, half));
+#endif
+}
+
+inline float32x4_t DivNEON(float32x4_t a, float32x4_t b)
+{
+#if defined(__aarch64__)
+  return vdivq_f32(a, b);
+#else
+  // two newton-raphson steps get the reciprocal estimate to full precision
+  float32x4_t r = vrecpeq_f32(b);
+  r = vmulq_f32(vrecpsq_f32(b, r), r);
+  r = vmulq_f32(vrecpsq_f32(b, r), r);
+  return vmulq_f32(a, r);
+#endif
+}
+
+void MulNEON(float *data, float gain, unsigned int count)
+{
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_n_f32(vld1q_f32(data + i), gain));
+  MulScalar(data + i, gain, count - i);
+}
+
+float MulAddNEON(float *dst, const float *src, float gain, unsigned int count)
+{
+  float32x4_t peak = vdupq_n_f32(0.0f);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t d = vmlaq_n_f32(vld1q_f32(dst + i), vld1q_f32(src + i), gain);
+    vst1q_f32(dst + i, d);
+    peak = vmaxq_f32(peak, vabsq_f32(d));
+  }
+  return std::max(HorizontalMaxNEON(peak), MulAddScalar(dst + i, src + i, gain, count - i));
+}
+
+void MulFramesNEON(float *data, const float *gains, unsigned int channels, unsigned int frames)
+{
+  unsigned int f = 0;
+  if (channels == 1)
+  {
+    for (; f + 4 <= frames; f += 4)
+      vst1q_f32(data + f, vmulq_f32(vld1q_f32(data + f), vld1q_f32(gains + f)));
+  }
+  else if (channels == 2)
+  {
+    for (; f + 4 <= frames; f += 4)
+    {
+      float32x4_t g = vld1q_f32(gains + f);
+      float32x4x2_t gg = vzipq_f32(g, g);
+      float *d = data + f * 2;
+      vst1q_f32(d, vmulq_f32(vld1q_f32(d), gg.val[0]));
+      vst1q_f32(d + 4, vmulq_f32(vld1q_f32(d + 4), gg.val[1]));
+    }
+  }
+  else
+  {
+    for (; f < frames; f++)
+      MulNEON(data + f * channels, gains[f], channels);
+  }
+  MulFramesScalar(data + f * channels, gains + f, channels, frames - f);
+}
+
+float MulAddFramesNEON(float *dst, const float *src, const float *gains, unsigned int channels, unsigned int frames)
+{
+  float32x4_t peak = vdupq_n_f32(0.0f);
+  float scalarPeak = 0.0f;
+  unsigned int f = 0;
+  if (channels == 1)
+  {
+    for (; f + 4 <= frames; f += 4)
+    {
+      float32x4_t d = vmlaq_f32(vld1q_f32(dst + f), vld1q_f32(src + f), vld1q_f32(gains + f));
+      vst1q_f32(dst + f, d);
+      peak = vmaxq_f32(peak, vabsq_f32(d));
+    }
+  }
+  else if (channels == 2)
+  {
+    for (; f + 4 <= frames; f += 4)
+    {
+      float32x4_t g = vld1q_f32(gains + f);
+      float32x4x2_t gg = vzipq_f32(g, g);
+      float *d = dst + f * 2;
+      const float *s = src + f * 2;
+      float32x4_t lo = vmlaq_f32(vld1q_f32(d), vld1q_f32(s), gg.val[0]);
+      float32x4_t hi = vmlaq_f32(vld1q_f32(d + 4), vld1q_f32(s + 4), gg.val[1]);
+      vst1q_f32(d, lo);
+      vst1q_f32(d + 4, hi);
+      peak = vmaxq_f32(peak, vmaxq_f32(vabsq_f32(lo), vabsq_f32(hi)));
+    }
+  }
+  else
+  {
+    for (; f < frames; f++)
+      scalarPeak = std::max(scalarPeak, MulAddNEON(dst + f * channels, src + f * channels, gains[f], channels));
+  }
+  scalarPeak = std::max(scalarPeak, MulAddFramesScalar(dst + f * channels, src + f * channels, gains + f, channels, frames - f));
+  return std::max(HorizontalMaxNEON(peak), scalarPeak);
+}
+
+void SoftClampNEON(float *data, unsigned int count)
+{
+  const float32x4_t min = vdupq_n_f32(-3.0f);
+  const float32x4_t max = vdupq_n_f32(3.0f);
+  const float32x4_t c27 = vdupq_n_f32(27.0f);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t x = vminq_f32(vmaxq_f32(vld1q_f32(data + i), min), max);
+    float32x4_t y = vmulq_f32(x, x);
+    vst1q_f32(data + i, DivNEON(vmulq_f32(x, vaddq_f32(c27, y)), vmlaq_n_f32(c27, y, 9.0f)));
+  }
+  SoftClampScalar(data + i, count - i);
+}
+
+void InterleaveNEON(float *dst, const float *const *src, unsigned int channels, unsigned int frames)
+{
+  unsigned int f = 0;
+  if (channels == 2)
+  {
+    for (; f + 4 <= frames; f += 4)
+    {
+      float32x4x2_t v;
+      v.val[0] = vld1q_f32(src[0] + f);
+      v.val[1] = vld1q_f32(src[1] + f);
+      vst2q_f32(dst + f * 2, v);
+    }
+  }
+  InterleaveFrom(dst, src, channels, f, frames);
+}
+
+void DeinterleaveNEON(float *const *dst, const float *src, unsigned int channels, unsigned int frames)
+{
+  unsigned int f = 0;
+  if (channels == 2)
+  {
+    for (; f + 4 <= frames; f += 4)
+    {
+      float32x4x2_t v = vld2q_f32(src + f * 2);
+      vst1q_f32(dst[0] + f, v.val[0]);
+      vst1q_f32(dst[1] + f, v.val[1]);
+    }
+  }
+  DeinterleaveFrom(dst, src, channels, f, frames);
+}
+
+void FloatToS16NEON(int16_t *dst, const float *src, unsigned int count)
+{
+  const float32x4_t min = vdupq_n_f32(-32768.0f);
+  const float32x4_t max = vdupq_n_f32(32767.0f);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    int32x4_t a = RoundNEON(vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i), S16_SCALE), min), max));
+    int32x4_t b = RoundNEON(vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i + 4), S16_SCALE), min), max));
+    vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+  }
+  FloatToS16Scalar(dst + i, src + i, count - i);
+}
+
+void FloatToS32NEON(int32_t *dst, const float *src, unsigned int count)
+{
+  const float32x4_t min = vdupq_n_f32(-S32_SCALE);
+  const float32x4_t max = vdupq_n_f32(S32_MAX);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_s32(dst + i, RoundNEON(vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i), S32_SCALE), min), max)));
+  FloatToS32Scalar(dst + i, src + i, count - i);
+}
+
+void S16ToFloatNEON(float *dst, const int16_t *src, unsigned int count)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    int16x8_t v = vld1q_s16(src + i);
+    vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), 1.0f / S16_SCALE));
+    vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), 1.0f / S16_SCALE));
+  }
+  S16ToFloatScalar(dst + i, src + i, count - i);
+}
+
+void S32ToFloatNEON(float *dst, const int32_t *src, unsigned int count)
+{
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(src + i)), 1.0f / S32_SCALE));
+  S32ToFloatScalar(dst + i, src + i, count - i);
+}
+
+void ShiftRight32NEON(uint32_t *data, unsigned int shift, unsigned int count)
+{
+  // a negative left shift is a right shift
+  const int32x4_t s = vdupq_n_s32(-(int)shift);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_u32(data + i, vshlq_u32(vld1q_u32(data + i), s));
+  ShiftRight32Scalar(data + i, shift, count - i);
+}
+
+const CAEKernels::KernelSet NEON_KERNELS =
+{
+  CAEKernels::ISA_NEON, "NEON",
+  MulNEON, MulAddNEON, MulFramesNEON, MulAddFramesNEON, SoftClampNEON,
+  InterleaveNEON, DeinterleaveNEON,
+  FloatToS16NEON, FloatToS32NEON, S16ToFloatNEON, S32ToFloatNEON, ShiftRight32NEON
+};
+#endif
+
+const CAEKernels::KernelSet& SelectKernels()
+{
+  // NEON is left out until the kernels have been run against the scalar ones on ARM, they are
+  // only used when asked for with Get(ISA_NEON)
+  static const CAEKernels::InstructionSet preference[] = { CAEKernels::ISA_AVX2, CAEKernels::ISA_SSE2 };
+
+  const CAEKernels::KernelSet *kernels = &SCALAR_KERNELS;
+  for (unsigned int i = 0; i < sizeof(preference) / sizeof(preference[0]); i++)
+  {
+    const CAEKernels::KernelSet *set = CAEKernels::Get(preference[i]);
+    if (set)
+    {
+      kernels = set;
+      break;
+    }
+  }
+  CLog::Log(LOGNOTICE, "CAEKernels - using %s kernels", kernels->name);
+  return *kernels;
+}
+}
+
+const CAEKernels::KernelSet& CAEKernels::Get()
+{
+  static const KernelSet &kernels = SelectKernels();
+  return kernels;
+}
+
+const CAEKernels::KernelSet* CAEKernels::Get(InstructionSet isa)
+{
+  if (!IsSupported(isa))
+    return NULL;
+
+  switch (isa)
+  {
+#if defined(HAS_SSE2_KERNELS)
+  case ISA_SSE2:
+    return &SSE2_KERNELS;
+#endif
+#if defined(HAS_AVX2_KERNELS)
+  case ISA_AVX2:
+    return &AVX2_KERNELS;
+#endif
+#if defined(HAS_NEON_KERNELS)
+  case ISA_NEON:
+    return &NEON_KERNELS;
+#endif
+  case ISA_SCALAR:
+    return &SCALAR_KERNELS;
+  default:
+    return NULL;
+  }
+}
+
+bool CAEKernels::IsSupported(InstructionSet isa)
+{
+  switch (isa)
+  {
+  case ISA_SCALAR:
+    return true;
+#if defined(HAS_SSE2_KERNELS)
+  // the build already requires it
+  case ISA_SSE2:
+    return true;
+#endif
+#if defined(HAS_AVX2_KERNELS)
+  case ISA_AVX2:
+    return (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_AVX2) != 0;
+#endif
+#if defined(HAS_NEON_KERNELS)
+  case ISA_NEON:
+  #if defined(__aarch64__)
+    return true;
+  #else
+    return CCPUInfo::HasNeon();
+  #endif
+#endif
+  default:
+    return false;
+  }
+}
@@ -0,0 +1,87 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+
+/*!
+ \brief The sample processing kernels used by the audio engine
+ Every kernel has a plain C++ version and SSE2, AVX2 and NEON versions where they pay off.
+ The set for the best instruction set the CPU supports is picked on first use, kernels that
+ have no version for it fall back to the next best one. The NEON set hasn't been verified on
+ ARM yet and is never picked, ARM uses the plain C++ kernels unless it's asked for explicitly.
+
+ Float samples are in the range -1..1, integer samples are native endian. Buffers need no
+ particular alignment.
+ */
+class CAEKernels
+{
+public:
+  enum InstructionSet
+  {
+    ISA_SCALAR = 0,
+    ISA_SSE2,
+    ISA_AVX2,
+    ISA_NEON
+  };
+
+  struct KernelSet
+  {
+    InstructionSet isa;
+    const char *name;
+
+    /*! \brief data[i] *= gain */
+    void  (*Mul)(float *data, float gain, unsigned int count);
+    /*! \brief dst[i] += src[i] * gain
+     \return the largest absolute value in dst afterwards, to decide whether it needs clamping */
+    float (*MulAdd)(float *dst, const float *src, float gain, unsigned int count);
+    /*! \brief data[frame * channels + c] *= gains[frame], for per frame fades and limiting */
+    void  (*MulFrames)(float *data, const float *gains, unsigned int channels, unsigned int frames);
+    /*! \brief dst[frame * channels + c] += src[frame * channels + c] * gains[frame]
+     \return the largest absolute value in dst afterwards */
+    float (*MulAddFrames)(float *dst, const float *src, const float *gains, unsigned int channels, unsigned int frames);
+    /*! \brief tanh like soft clipping of everything outside -1..1 */
+    void  (*SoftClamp)(float *data, unsigned int count);
+
+    /*! \brief interleave channel planes, src[c] is the plane of channel c */
+    void  (*Interleave)(float *dst, const float *const *src, unsigned int channels, unsigned int frames);
+    /*! \brief split interleaved samples into channel planes, dst[c] is the plane of channel c */
+    void  (*Deinterleave)(float *const *dst, const float *src, unsigned int channels, unsigned int frames);
+
+    /*! \brief convert with rounding to nearest and saturation */
+    void  (*FloatToS16)(int16_t *dst, const float *src, unsigned int count);
+    void  (*FloatToS32)(int32_t *dst, const float *src, unsigned int count);
+    void  (*S16ToFloat)(float *dst, const int16_t *src, unsigned int count);
+    void  (*S32ToFloat)(float *dst, const int32_t *src, unsigned int count);
+    /*! \brief data[i] >>= shift, moves S32 aligned samples to the low bits for S24NE4 */
+    void  (*ShiftRight32)(uint32_t *data, unsigned int shift, unsigned int count);
+  };
+
+  /*! \brief The kernels for the best instruction set the CPU supports */
+  static const KernelSet& Get();
+
+  /*! \brief The kernels for a specific instruction set
+   \return the kernel set, NULL if it wasn't built in or the CPU doesn't support it
+   */
+  static const KernelSet* Get(InstructionSet isa);
+
+private:
+  static bool IsSupported(InstructionSet isa);
+};
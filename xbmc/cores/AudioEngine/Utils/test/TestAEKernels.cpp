@@ -0,0 +1,254 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEKernels.h"
+#include "test/TestUtils.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+// odd sizes so every kernel also runs its tail loop
+const unsigned int FRAMES = 1021;
+const unsigned int CHANNELS[] = { 1, 2, 6 };
+
+// one second of 7.1 at 48kHz, which is what the engine pushes per second at most
+const unsigned int BENCHMARK_SAMPLES = 48000 * 8;
+const unsigned int BENCHMARK_LOOPS = 100;
+
+std::vector<const CAEKernels::KernelSet*> GetKernelSets()
+{
+  std::vector<const CAEKernels::KernelSet*> sets;
+  const CAEKernels::InstructionSet isas[] = { CAEKernels::ISA_SSE2, CAEKernels::ISA_AVX2, CAEKernels::ISA_NEON };
+  for (unsigned int i = 0; i < sizeof(isas) / sizeof(isas[0]); i++)
+  {
+    const CAEKernels::KernelSet *set = CAEKernels::Get(isas[i]);
+    if (set)
+      sets.push_back(set);
+  }
+  return sets;
+}
+
+double SamplesPerSecond(const std::function<void()> &kernel)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < BENCHMARK_LOOPS; i++)
+    kernel();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return (double)BENCHMARK_SAMPLES * BENCHMARK_LOOPS / seconds;
+}
+}
+
+TEST(TestAEKernels, ScalarReference)
+{
+  const CAEKernels::KernelSet *kernels = CAEKernels::Get(CAEKernels::ISA_SCALAR);
+  ASSERT_NE(nullptr, kernels);
+
+  float data[] = { 0.5f, -0.25f, 1.0f, -1.0f };
+  kernels->Mul(data, 0.5f, 4);
+  EXPECT_EQ(0.25f, data[0]);
+  EXPECT_EQ(-0.5f, data[3]);
+
+  float add[] = { 2.0f, 0.0f, 0.0f, 0.0f };
+  EXPECT_EQ(1.25f, kernels->MulAdd(data, add, 0.5f, 4));
+
+  float clamp[] = { 5.0f, -5.0f, 0.0f, 3.0f };
+  kernels->SoftClamp(clamp, 4);
+  EXPECT_EQ(1.0f, clamp[0]);
+  EXPECT_EQ(-1.0f, clamp[1]);
+  EXPECT_EQ(0.0f, clamp[2]);
+  EXPECT_FLOAT_EQ(1.0f, clamp[3]);
+
+  float samples[] = { 1.0f, -1.0f, 0.5f, 2.0f };
+  int16_t s16[4];
+  kernels->FloatToS16(s16, samples, 4);
+  EXPECT_EQ(32767, s16[0]);
+  EXPECT_EQ(-32768, s16[1]);
+  EXPECT_EQ(16384, s16[2]);
+  EXPECT_EQ(32767, s16[3]);
+  int32_t s32[4];
+  kernels->FloatToS32(s32, samples, 4);
+  EXPECT_LT(2147483000, s32[0]);
+  EXPECT_EQ(INT32_MIN, s32[1]);
+  EXPECT_EQ(1073741824, s32[2]);
+}
+
+// every instruction set has to give the same results as the plain C++ kernels
+TEST(TestAEKernels, MatchScalar)
+{
+  const CAEKernels::KernelSet &ref = *CAEKernels::Get(CAEKernels::ISA_SCALAR);
+
+  std::vector<const CAEKernels::KernelSet*> sets = GetKernelSets();
+  for (std::vector<const CAEKernels::KernelSet*>::const_iterator set = sets.begin(); set != sets.end(); ++set)
+  {
+    const CAEKernels::KernelSet &k = **set;
+    for (unsigned int c = 0; c < sizeof(CHANNELS) / sizeof(CHANNELS[0]); c++)
+    {
+      unsigned int channels = CHANNELS[c];
+      unsigned int count = FRAMES * channels;
+      SCOPED_TRACE(std::string(k.name) + " " + std::to_string(channels) + " channels");
+
+      std::vector<float> loud = CXBMCTestUtils::Instance().CreateTestSamples(count, 2.0f);
+      std::vector<float> quiet = CXBMCTestUtils::Instance().CreateTestSamples(count, 1.0f);
+      std::vector<float> gains = CXBMCTestUtils::Instance().CreateTestSamples(FRAMES, 0.5f);
+      std::vector<float> expected, actual;
+
+      expected = loud; ref.Mul(expected.data(), 0.7f, count);
+      actual = loud; k.Mul(actual.data(), 0.7f, count);
+      EXPECT_EQ(expected, actual);
+
+      expected = loud; float expectedPeak = ref.MulAdd(expected.data(), quiet.data(), 0.3f, count);
+      actual = loud; float actualPeak = k.MulAdd(actual.data(), quiet.data(), 0.3f, count);
+      for (unsigned int i = 0; i < count; i++)
+        ASSERT_NEAR(expected[i], actual[i], 1e-6f);
+      EXPECT_NEAR(expectedPeak, actualPeak, 1e-6f);
+
+      expected = loud; ref.MulFrames(expected.data(), gains.data(), channels, FRAMES);
+      actual = loud; k.MulFrames(actual.data(), gains.data(), channels, FRAMES);
+      EXPECT_EQ(expected, actual);
+
+      expected = loud; expectedPeak = ref.MulAddFrames(expected.data(), quiet.data(), gains.data(), channels, FRAMES);
+      actual = loud; actualPeak = k.MulAddFrames(actual.data(), quiet.data(), gains.data(), channels, FRAMES);
+      for (unsigned int i = 0; i < count; i++)
+        ASSERT_NEAR(expected[i], actual[i], 1e-6f);
+      EXPECT_NEAR(expectedPeak, actualPeak, 1e-6f);
+
+      expected = loud; ref.SoftClamp(expected.data(), count);
+      actual = loud; k.SoftClamp(actual.data(), count);
+      for (unsigned int i = 0; i < count; i++)
+      {
+        ASSERT_NEAR(expected[i], actual[i], 1e-6f);
+        ASSERT_LE(std::fabs(actual[i]), 1.0f);
+      }
+
+      std::vector<std::vector<float> > planes(channels, std::vector<float>(FRAMES));
+      std::vector<const float*> src;
+      std::vector<float*> dst;
+      for (unsigned int ch = 0; ch < channels; ch++)
+      {
+        for (unsigned int f = 0; f < FRAMES; f++)
+          planes[ch][f] = loud[f * channels + ch];
+        src.push_back(planes[ch].data());
+      }
+      actual.assign(count, 0.0f);
+      k.Interleave(actual.data(), src.data(), channels, FRAMES);
+      EXPECT_EQ(loud, actual);
+      std::vector<std::vector<float> > split(channels, std::vector<float>(FRAMES));
+      for (unsigned int ch = 0; ch < channels; ch++)
+        dst.push_back(split[ch].data());
+      k.Deinterleave(dst.data(), loud.data(), channels, FRAMES);
+      EXPECT_EQ(planes, split);
+
+      // rounding differs on ARMv7, which rounds halfway cases away from zero
+      std::vector<int16_t> expected16(count), actual16(count);
+      ref.FloatToS16(expected16.data(), loud.data(), count);
+      k.FloatToS16(actual16.data(), loud.data(), count);
+      for (unsigned int i = 0; i < count; i++)
+        ASSERT_NEAR(expected16[i], actual16[i], 1);
+
+      std::vector<int32_t> expected32(count), actual32(count);
+      ref.FloatToS32(expected32.data(), loud.data(), count);
+      k.FloatToS32(actual32.data(), loud.data(), count);
+      for (unsigned int i = 0; i < count; i++)
+        ASSERT_NEAR((double)expected32[i], (double)actual32[i], 1.0);
+
+      expected.assign(count, 0.0f);
+      actual.assign(count, 0.0f);
+      ref.S16ToFloat(expected.data(), expected16.data(), count);
+      k.S16ToFloat(actual.data(), expected16.data(), count);
+      EXPECT_EQ(expected, actual);
+      ref.S32ToFloat(expected.data(), expected32.data(), count);
+      k.S32ToFloat(actual.data(), expected32.data(), count);
+      EXPECT_EQ(expected, actual);
+
+      std::vector<uint32_t> expectedShifted(expected32.begin(), expected32.end());
+      std::vector<uint32_t> actualShifted(expectedShifted);
+      ref.ShiftRight32(expectedShifted.data(), 8, count);
+      k.ShiftRight32(actualShifted.data(), 8, count);
+      EXPECT_EQ(expectedShifted, actualShifted);
+    }
+  }
+}
+
+/* Reports how many samples per second each kernel gets through with every
+ * instruction set, run with --gtest_also_run_disabled_tests */
+TEST(TestAEKernels, DISABLED_Benchmark)
+{
+  std::vector<const CAEKernels::KernelSet*> sets = GetKernelSets();
+  sets.insert(sets.begin(), CAEKernels::Get(CAEKernels::ISA_SCALAR));
+
+  std::vector<float> samples = CXBMCTestUtils::Instance().CreateTestSamples(BENCHMARK_SAMPLES, 1.0f);
+  std::vector<float> mix = CXBMCTestUtils::Instance().CreateTestSamples(BENCHMARK_SAMPLES, 0.1f);
+  std::vector<float> gains(BENCHMARK_SAMPLES / 2, 0.999f);
+  std::vector<float> scratch(BENCHMARK_SAMPLES);
+  std::vector<int16_t> s16(BENCHMARK_SAMPLES);
+  std::vector<int32_t> s32(BENCHMARK_SAMPLES);
+  float *planes[2] = { scratch.data(), scratch.data() + BENCHMARK_SAMPLES / 2 };
+  const float *constPlanes[2] = { planes[0], planes[1] };
+
+  std::cout << "Msamples/s" << std::setw(16) << "";
+  for (std::vector<const CAEKernels::KernelSet*>::const_iterator set = sets.begin(); set != sets.end(); ++set)
+    std::cout << std::setw(10) << (*set)->name;
+  std::cout << std::endl;
+
+  struct Kernel
+  {
+    const char *name;
+    std::function<void(const CAEKernels::KernelSet&)> run;
+  } kernels[] = {
+    { "Mul",                [&](const CAEKernels::KernelSet &k) { k.Mul(samples.data(), 0.999f, BENCHMARK_SAMPLES); } },
+    { "MulAdd",             [&](const CAEKernels::KernelSet &k) { k.MulAdd(samples.data(), mix.data(), 0.001f, BENCHMARK_SAMPLES); } },
+    { "MulFrames (2ch)",    [&](const CAEKernels::KernelSet &k) { k.MulFrames(samples.data(), gains.data(), 2, BENCHMARK_SAMPLES / 2); } },
+    { "MulAddFrames (2ch)", [&](const CAEKernels::KernelSet &k) { k.MulAddFrames(samples.data(), mix.data(), gains.data(), 2, BENCHMARK_SAMPLES / 2); } },
+    { "SoftClamp",          [&](const CAEKernels::KernelSet &k) { k.SoftClamp(samples.data(), BENCHMARK_SAMPLES); } },
+    { "Interleave (2ch)",   [&](const CAEKernels::KernelSet &k) { k.Interleave(samples.data(), constPlanes, 2, BENCHMARK_SAMPLES / 2); } },
+    { "Deinterleave (2ch)", [&](const CAEKernels::KernelSet &k) { k.Deinterleave(planes, samples.data(), 2, BENCHMARK_SAMPLES / 2); } },
+    { "FloatToS16",         [&](const CAEKernels::KernelSet &k) { k.FloatToS16(s16.data(), samples.data(), BENCHMARK_SAMPLES); } },
+    { "FloatToS32",         [&](const CAEKernels::KernelSet &k) { k.FloatToS32(s32.data(), samples.data(), BENCHMARK_SAMPLES); } },
+    { "S16ToFloat",         [&](const CAEKernels::KernelSet &k) { k.S16ToFloat(scratch.data(), s16.data(), BENCHMARK_SAMPLES); } },
+    { "S32ToFloat",         [&](const CAEKernels::KernelSet &k) { k.S32ToFloat(scratch.data(), s32.data(), BENCHMARK_SAMPLES); } },
+    { "ShiftRight32",       [&](const CAEKernels::KernelSet &k) { k.ShiftRight32((uint32_t*)s32.data(), 0, BENCHMARK_SAMPLES); } },
+  };
+
+  for (unsigned int i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++)
+  {
+    std::cout << std::left << std::setw(26) << kernels[i].name << std::right;
+    for (std::vector<const CAEKernels::KernelSet*>::const_iterator set = sets.begin(); set != sets.end(); ++set)
+    {
+      const CAEKernels::KernelSet &k = **set;
+      double rate = SamplesPerSecond([&]() { kernels[i].run(k); });
+      std::cout << std::setw(10) << std::fixed << std::setprecision(0) << rate / 1000000.0;
+    }
+    std::cout << std::endl;
+  }
+
+  // keep the results alive
+  EXPECT_FALSE(std::isnan(samples[0]));
+}
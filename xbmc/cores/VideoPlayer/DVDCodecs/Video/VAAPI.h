@@ -34,6 +34,7 @@
 #include "threads/Thread.h"
 #include "utils/ActorProtocol.h"
 #include "guilib/Geometry.h"
+#include <deque>
 #include <list>
 #include <map>
 #include <memory>
@@ -59,6 +59,7 @@
 #include "guilib/Geometry.h"
 #include <list>
 #include <map>
+#include <queue>
 
 extern "C" {
 #include "libavutil/avutil.h"
@@ -25,17 +25,173 @@
 #include "DVDClock.h"
 #include "utils/log.h"
 
+#include <atomic>
+
 extern "C" {
 #include "libavcodec/avcodec.h"
 }
 
+namespace
+{
+struct PooledPacket
+{
+  DemuxPacket packet; // must be first, this is what callers get to see
+  int sizeClass;      // -1 if the packet is too big to be pooled
+};
+
+/*!
+ * Recycles packets together with their payload buffer. Payloads are rounded
+ * up to power of two size classes and every class keeps a fixed number of
+ * free packets in atomic slots, so allocating and freeing from the demux,
+ * audio and video threads never takes a lock. Pooled payload is bounded by
+ * MAX_POOLED_BYTES, anything above that is freed as before.
+ */
+class CDemuxPacketPool
+{
+public:
+  CDemuxPacketPool()
+  {
+    for (int sizeClass = 0; sizeClass < NUM_CLASSES; ++sizeClass)
+      for (int slot = 0; slot < NUM_SLOTS; ++slot)
+        m_slots[sizeClass][slot] = nullptr;
+    m_allocations = 0;
+    m_hits = 0;
+    m_pooled = 0;
+    m_pooledBytes = 0;
+  }
+
+  ~CDemuxPacketPool()
+  {
+    for (int sizeClass = 0; sizeClass < NUM_CLASSES; ++sizeClass)
+      for (int slot = 0; slot < NUM_SLOTS; ++slot)
+        Destroy(m_slots[sizeClass][slot].exchange(nullptr));
+  }
+
+  PooledPacket* Get(int iDataSize)
+  {
+    m_allocations++;
+
+    int sizeClass = GetSizeClass(iDataSize);
+    if (sizeClass >= 0)
+    {
+      for (int slot = 0; slot < NUM_SLOTS; ++slot)
+      {
+        if (!m_slots[sizeClass][slot].load(std::memory_order_relaxed))
+          continue;
+        PooledPacket* packet = m_slots[sizeClass][slot].exchange(nullptr, std::memory_order_acquire);
+        if (packet)
+        {
+          m_hits++;
+          m_pooled--;
+          m_pooledBytes -= GetCapacity(sizeClass);
+          return packet;
+        }
+      }
+    }
+
+    PooledPacket* packet = new PooledPacket;
+    packet->sizeClass = sizeClass;
+    packet->packet.pData = NULL;
+    size_t capacity = sizeClass >= 0 ? GetCapacity(sizeClass) : iDataSize;
+    if (capacity > 0)
+    {
+      packet->packet.pData = (uint8_t*)_aligned_malloc(capacity + FF_INPUT_BUFFER_PADDING_SIZE, 16);
+      if (!packet->packet.pData)
+      {
+        delete packet;
+        return NULL;
+      }
+    }
+    return packet;
+  }
+
+  void Put(PooledPacket* packet)
+  {
+    int sizeClass = packet->sizeClass;
+    if (sizeClass >= 0)
+    {
+      size_t capacity = GetCapacity(sizeClass);
+      if (m_pooledBytes.fetch_add(capacity) + capacity <= MAX_POOLED_BYTES)
+      {
+        for (int slot = 0; slot < NUM_SLOTS; ++slot)
+        {
+          PooledPacket* empty = nullptr;
+          if (m_slots[sizeClass][slot].compare_exchange_strong(empty, packet, std::memory_order_release))
+          {
+            m_pooled++;
+            return;
+          }
+        }
+      }
+      m_pooledBytes -= capacity;
+    }
+    Destroy(packet);
+  }
+
+  DemuxPacketPoolStats GetStats() const
+  {
+    DemuxPacketPoolStats stats;
+    stats.allocations = m_allocations;
+    stats.hits = m_hits;
+    stats.pooled = m_pooled;
+    stats.pooledBytes = m_pooledBytes;
+    return stats;
+  }
+
+private:
+  static const int MIN_CLASS_SHIFT = 10;  // smallest payload class is 1 KiB
+  static const int NUM_CLASSES = 15;      // no payload, then 1 KiB to 8 MiB
+  static const int NUM_SLOTS = 32;
+  static const size_t MAX_POOLED_BYTES = 64 * 1024 * 1024;
+
+  static int GetSizeClass(int iDataSize)
+  {
+    if (iDataSize <= 0)
+      return 0;
+    for (int sizeClass = 1; sizeClass < NUM_CLASSES; ++sizeClass)
+    {
+      if ((size_t)iDataSize <= GetCapacity(sizeClass))
+        return sizeClass;
+    }
+    return -1;
+  }
+
+  static size_t GetCapacity(int sizeClass)
+  {
+    if (sizeClass == 0)
+      return 0;
+    return (size_t)1 << (MIN_CLASS_SHIFT + sizeClass - 1);
+  }
+
+  static void Destroy(PooledPacket* packet)
+  {
+    if (!packet)
+      return;
+    if (packet->packet.pData)
+      _aligned_free(packet->packet.pData);
+    delete packet;
+  }
+
+  std::atomic<PooledPacket*> m_slots[NUM_CLASSES][NUM_SLOTS];
+  std::atomic<uint64_t> m_allocations;
+  std::atomic<uint64_t> m_hits;
+  std::atomic<unsigned int> m_pooled;
+  std::atomic<size_t> m_pooledBytes;
+};
+
+CDemuxPacketPool& GetPacketPool()
+{
+  static CDemuxPacketPool pool;
+  return pool;
+}
+}
+
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
     try {
-      if (pPacket->pData) _aligned_free(pPacket->pData);
-      delete pPacket;
+      GetPacketPool().Put(reinterpret_cast<PooledPacket*>(pPacket));
     }
     catch(...) {
       CLog::Log(LOGERROR, "%s - Exception thrown while freeing packet", __FUNCTION__);
@@ -45,11 +201,17 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket;
-  if (!pPacket) return NULL;
+  DemuxPacket* pPacket = NULL;
 
   try
   {
+    PooledPacket* pooled = GetPacketPool().Get(iDataSize);
+    if (!pooled)
+      return NULL;
+
+    // a recycled packet keeps its payload buffer, everything else is reset
+    pPacket = &pooled->packet;
+    uint8_t* pData = pPacket->pData;
     memset(pPacket, 0, sizeof(DemuxPacket));
 
     if (iDataSize > 0)
@@ -63,12 +225,7 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
         * Note, if the first 23 bits of the additional bytes are not 0 then damaged
         * MPEG bitstreams could cause overread and segfault
         */
-      pPacket->pData =(uint8_t*)_aligned_malloc(iDataSize + FF_INPUT_BUFFER_PADDING_SIZE, 16);
-      if (!pPacket->pData)
-      {
-        FreeDemuxPacket(pPacket);
-        return NULL;
-      }
+      pPacket->pData = pData;
 
       // reset the last 8 bytes to 0;
       memset(pPacket->pData + iDataSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
@@ -87,3 +244,8 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
   }
   return pPacket;
 }
+
+DemuxPacketPoolStats CDVDDemuxUtils::GetPacketPoolStats()
+{
+  return GetPacketPool().GetStats();
+}
@@ -20,12 +20,23 @@
  *
  */
 
+#include <stddef.h>
+#include <stdint.h>
 #include "DVDDemuxPacket.h"
 
+struct DemuxPacketPoolStats
+{
+  uint64_t allocations;   // packets handed out by AllocateDemuxPacket
+  uint64_t hits;          // allocations served from the pool
+  unsigned int pooled;    // packets currently waiting in the pool
+  size_t pooledBytes;     // payload bytes currently held by the pool
+};
+
 class CDVDDemuxUtils
 {
 public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
+  static DemuxPacketPoolStats GetPacketPoolStats();
 };
 
@@ -29,11 +29,18 @@ CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m
   m_iDataSize     = 0;
   m_bAbortRequest = false;
   m_bInitialized = false;
+  m_bWaiting = false;
 
   m_TimeBack = DVD_NOPTS_VALUE;
   m_TimeFront = DVD_NOPTS_VALUE;
   m_TimeSize = 1.0 / 4.0; /* 4 seconds */
   m_iMaxDataSize = 0;
+
+  m_listSize = 0;
+  m_ringHead = 0;
+  m_ringTail = 0;
+  m_producer = 0;
+  m_ticket = 0;
 }
 
 CDVDMessageQueue::~CDVDMessageQueue()
@@ -49,11 +56,24 @@ void CDVDMessageQueue::Init()
   m_bInitialized = true;
   m_TimeBack = DVD_NOPTS_VALUE;
   m_TimeFront = DVD_NOPTS_VALUE;
+  m_producer = 0;
 }
 
 void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
   CSingleLock lock(m_section);
+  CSingleLock ringLock(m_ringSection);
+
+  // the ring can only be consumed, so anything we keep moves to the list
+  while (const RingItem* item = PeekRing())
+  {
+    CDVDMsg* pMsg = item->message;
+    uint64_t ticket = item->ticket;
+    PopRing();
+    if (!pMsg->IsType(type) && type != CDVDMsg::NONE)
+      InsertList(pMsg, 0, ticket);
+    pMsg->Release();
+  }
 
   for (SList::iterator it = m_list.begin(); it != m_list.end();)
   {
@@ -62,6 +82,7 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
     else
       ++it;
   }
+  m_listSize = m_list.size();
 
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
   {
@@ -91,11 +112,102 @@ void CDVDMessageQueue::End()
   m_bAbortRequest = false;
 }
 
+bool CDVDMessageQueue::IsProducer()
+{
+  ThreadIdentifier self = CThread::GetCurrentThreadId();
+  ThreadIdentifier producer = m_producer;
+  if (producer == self)
+    return true;
+  if (producer == 0)
+    return m_producer.compare_exchange_strong(producer, self);
+  return false;
+}
+
+bool CDVDMessageQueue::PushRing(CDVDMsg* pMsg, uint64_t ticket)
+{
+  unsigned int tail = m_ringTail.load(std::memory_order_relaxed);
+  if (tail - m_ringHead.load(std::memory_order_acquire) == RING_SIZE)
+    return false;
+
+  m_ring[tail % RING_SIZE].message = pMsg;
+  m_ring[tail % RING_SIZE].ticket = ticket;
+  m_ringTail = tail + 1;
+  return true;
+}
 
-MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
+const CDVDMessageQueue::RingItem* CDVDMessageQueue::PeekRing() const
 {
-  CSingleLock lock(m_section);
+  unsigned int head = m_ringHead.load(std::memory_order_relaxed);
+  if (head == m_ringTail.load(std::memory_order_acquire))
+    return NULL;
+  return &m_ring[head % RING_SIZE];
+}
+
+CDVDMsg* CDVDMessageQueue::PopRing()
+{
+  const RingItem* item = PeekRing();
+  if (!item)
+    return NULL;
+  CDVDMsg* pMsg = item->message;
+  m_ringHead.store(m_ringHead.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  return pMsg;
+}
+
+void CDVDMessageQueue::InsertList(CDVDMsg* pMsg, int priority, uint64_t ticket)
+{
+  // sorted by priority, oldest message of the highest priority at the back
+  SList::iterator it = m_list.begin();
+  while(it != m_list.end())
+  {
+    if(priority < it->priority || (priority == it->priority && ticket > it->ticket))
+      break;
+    ++it;
+  }
+  m_list.insert(it, DVDMessageListItem(pMsg, priority, ticket));
+  m_listSize = m_list.size();
+}
+
+void CDVDMessageQueue::OnPacketPut(CDVDMsg* pMsg)
+{
+  if (!pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+    return;
+
+  DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)pMsg)->GetPacket();
+  if (packet)
+  {
+    m_iDataSize += packet->iSize;
+    if (packet->dts != DVD_NOPTS_VALUE)
+      m_TimeFront = packet->dts;
+    else if (packet->pts != DVD_NOPTS_VALUE)
+      m_TimeFront = packet->pts;
+
+    if (m_TimeBack == DVD_NOPTS_VALUE)
+      m_TimeBack = m_TimeFront.load();
+  }
+}
+
+void CDVDMessageQueue::OnPacketGet(CDVDMsg* pMsg)
+{
+  if (!pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+    return;
 
+  DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)pMsg)->GetPacket();
+  if (packet)
+  {
+    // a flush can reset the size while the packet was still in the ring,
+    // don't let the accounting go negative
+    int dataSize = m_iDataSize.load();
+    while (!m_iDataSize.compare_exchange_weak(dataSize, std::max(0, dataSize - packet->iSize)))
+      ;
+    if (packet->dts != DVD_NOPTS_VALUE)
+      m_TimeBack = packet->dts;
+    else if (packet->pts != DVD_NOPTS_VALUE)
+      m_TimeBack = packet->pts;
+  }
+}
+
+MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
+{
   if (!m_bInitialized)
   {
     CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Put MSGQ_NOT_INITIALIZED", m_owner.c_str());
@@ -108,29 +220,30 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
     return MSGQ_INVALID_MSG;
   }
 
-  SList::iterator it = m_list.begin();
-  while(it != m_list.end())
-  {
-    if(priority <= it->priority)
-      break;
-    ++it;
-  }
-  m_list.insert(it, DVDMessageListItem(pMsg, priority));
+  uint64_t ticket = m_ticket++;
 
-  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
+  if (priority == 0 && IsProducer())
   {
-    DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)pMsg)->GetPacket();
-    if (packet)
+    // account before publishing, the consumer may take it right away
+    OnPacketPut(pMsg);
+    if (PushRing(pMsg, ticket))
     {
-      m_iDataSize += packet->iSize;
-      if (packet->dts != DVD_NOPTS_VALUE)
-        m_TimeFront = packet->dts;
-      else if (packet->pts != DVD_NOPTS_VALUE)
-        m_TimeFront = packet->pts;
-
-      if (m_TimeBack == DVD_NOPTS_VALUE)
-        m_TimeBack = m_TimeFront;
+      // only wake the consumer if it's about to sleep
+      if (m_bWaiting)
+        m_hEvent.Set();
+      return MSGQ_OK;
     }
+
+    // ring is full, the list keeps the order by ticket
+    CSingleLock lock(m_section);
+    InsertList(pMsg, priority, ticket);
+  }
+  else
+  {
+    CSingleLock lock(m_section);
+    InsertList(pMsg, priority, ticket);
+    if (priority == 0)
+      OnPacketPut(pMsg);
   }
 
   pMsg->Release();
@@ -140,13 +253,54 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
   return MSGQ_OK;
 }
 
-MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
+bool CDVDMessageQueue::Pop(CDVDMsg** pMsg, int &priority)
 {
-  CSingleLock lock(m_section);
+  if (m_listSize > 0)
+  {
+    CSingleLock lock(m_section);
+    CSingleLock ringLock(m_ringSection);
 
-  *pMsg = NULL;
+    if (!m_list.empty() && m_list.back().priority >= priority)
+    {
+      DVDMessageListItem& item(m_list.back());
+      const RingItem* ringItem = PeekRing();
+      if (item.priority > 0 || !ringItem || item.ticket < ringItem->ticket)
+      {
+        priority = item.priority;
+        if (item.priority == 0)
+          OnPacketGet(item.message);
+
+        *pMsg = item.message->Acquire();
+        m_list.pop_back();
+        m_listSize = m_list.size();
+        return true;
+      }
+    }
+
+    if (priority <= 0 && (*pMsg = PopRing()))
+    {
+      priority = 0;
+      OnPacketGet(*pMsg);
+      return true;
+    }
+    return false;
+  }
 
-  int ret = 0;
+  if (priority > 0)
+    return false;
+
+  CSingleLock ringLock(m_ringSection);
+  if ((*pMsg = PopRing()))
+  {
+    OnPacketGet(*pMsg);
+    return true;
+  }
+  return false;
+}
+
+MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
+{
+  *pMsg = NULL;
 
   if (!m_bInitialized)
   {
@@ -156,52 +310,32 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
 
   while (!m_bAbortRequest)
   {
-    if (!m_list.empty() && m_list.back().priority >= priority)
-    {
-      DVDMessageListItem& item(m_list.back());
-      priority = item.priority;
-
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
-      {
-        DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)item.message)->GetPacket();
-        if (packet)
-        {
-          m_iDataSize -= packet->iSize;
-          if (packet->dts != DVD_NOPTS_VALUE)
-            m_TimeBack = packet->dts;
-          else if (packet->pts != DVD_NOPTS_VALUE)
-            m_TimeBack = packet->pts;
-        }
-      }
-
-      *pMsg = item.message->Acquire();
-      m_list.pop_back();
-
-      ret = MSGQ_OK;
-      break;
-    }
+    if (Pop(pMsg, priority))
+      return MSGQ_OK;
     else if (!iTimeoutInMilliSeconds)
+      return MSGQ_TIMEOUT;
+
+    // tell the producer we're about to sleep and look once more, so a
+    // message pushed to the ring in between still wakes us up. The fence
+    // keeps the acquire load of m_ringTail in Pop from moving ahead of the
+    // store, the producer stores m_ringTail and loads m_bWaiting seq_cst.
+    m_hEvent.Reset();
+    m_bWaiting = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (Pop(pMsg, priority))
     {
-      ret = MSGQ_TIMEOUT;
-      break;
+      m_bWaiting = false;
+      return MSGQ_OK;
     }
-    else
-    {
-      m_hEvent.Reset();
-      lock.Leave();
-
-      // wait for a new message
-      if (!m_hEvent.WaitMSec(iTimeoutInMilliSeconds))
-        return MSGQ_TIMEOUT;
 
-      lock.Enter();
-    }
+    // wait for a new message
+    bool signaled = m_hEvent.WaitMSec(iTimeoutInMilliSeconds);
+    m_bWaiting = false;
+    if (!signaled)
+      return MSGQ_TIMEOUT;
   }
 
-  if (m_bAbortRequest)
-    return MSGQ_ABORT;
-
-  return (MsgQueueReturnCode)ret;
+  return MSGQ_ABORT;
 }
 
 unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
@@ -218,6 +352,14 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
       count++;
   }
 
+  CSingleLock ringLock(m_ringSection);
+  unsigned int tail = m_ringTail.load(std::memory_order_acquire);
+  for (unsigned int i = m_ringHead.load(std::memory_order_relaxed); i != tail; ++i)
+  {
+    if (m_ring[i % RING_SIZE].message->IsType(type))
+      count++;
+  }
+
   return count;
 }
 
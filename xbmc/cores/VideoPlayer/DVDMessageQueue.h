@@ -21,23 +21,28 @@
  */
 
 #include "DVDMessage.h"
+#include <stdint.h>
+#include <atomic>
 #include <string>
 #include <list>
 #include <algorithm>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
+#include "threads/Thread.h"
 
 struct DVDMessageListItem
 {
-  DVDMessageListItem(CDVDMsg* msg, int prio)
+  DVDMessageListItem(CDVDMsg* msg, int prio, uint64_t tick = 0)
   {
     message = msg->Acquire();
     priority = prio;
+    ticket = tick;
   }
   DVDMessageListItem()
   {
     message = NULL;
     priority = 0;
+    ticket = 0;
   }
   DVDMessageListItem(const DVDMessageListItem& item)
   {
@@ -47,6 +52,7 @@ struct DVDMessageListItem
       message = NULL;
 
     priority = item.priority;
+    ticket = item.ticket;
   }
  ~DVDMessageListItem()
   {
@@ -64,11 +70,13 @@ struct DVDMessageListItem
       message = NULL;
 
     priority = item.priority;
+    ticket = item.ticket;
     return *this;
   }
 
   CDVDMsg* message;
   int priority;
+  uint64_t ticket; // order of arrival in the queue
 };
 
 enum MsgQueueReturnCode
@@ -83,6 +91,16 @@ enum MsgQueueReturnCode
 
 #define MSGQ_IS_ERROR(c)    (c < 0)
 
+/**
+ * Priority message queue between the player threads.
+ *
+ * Priority 0 messages put by the first thread that puts one after Init()
+ * (normally the demuxing thread) go through a bounded single producer,
+ * single consumer ring and don't take the queue lock on that side. All
+ * other messages, or priority 0 messages once the ring is full, go to the
+ * locked list. Every message gets a ticket on Put so Get still returns
+ * messages of the same priority in order of arrival.
+ */
 class CDVDMessageQueue
 {
 public:
@@ -127,15 +145,32 @@ public:
 
 private:
 
+  struct RingItem
+  {
+    CDVDMsg* message;
+    uint64_t ticket;
+  };
+
+  bool IsProducer();
+  bool PushRing(CDVDMsg* pMsg, uint64_t ticket);
+  const RingItem* PeekRing() const;
+  CDVDMsg* PopRing();
+  bool Pop(CDVDMsg** pMsg, int &priority);
+  void InsertList(CDVDMsg* pMsg, int priority, uint64_t ticket);
+  void OnPacketPut(CDVDMsg* pMsg);
+  void OnPacketGet(CDVDMsg* pMsg);
+
   CEvent m_hEvent;
   mutable CCriticalSection m_section;
+  mutable CCriticalSection m_ringSection; // consumer side of the ring
 
   bool m_bAbortRequest;
   bool m_bInitialized;
+  std::atomic<bool> m_bWaiting;
 
-  int m_iDataSize;
-  double m_TimeFront;
-  double m_TimeBack;
+  std::atomic<int> m_iDataSize;
+  std::atomic<double> m_TimeFront;
+  std::atomic<double> m_TimeBack;
   double m_TimeSize;
 
   int m_iMaxDataSize;
@@ -143,5 +178,13 @@ private:
 
   typedef std::list<DVDMessageListItem> SList;
   SList m_list;
+  std::atomic<unsigned int> m_listSize;
+
+  static const unsigned int RING_SIZE = 1024;
+  RingItem m_ring[RING_SIZE];
+  std::atomic<unsigned int> m_ringHead; // next item to get, advanced by the consumer
+  std::atomic<unsigned int> m_ringTail; // next free slot, advanced by the producer
+  std::atomic<ThreadIdentifier> m_producer;
+  std::atomic<uint64_t> m_ticket;
 };
 
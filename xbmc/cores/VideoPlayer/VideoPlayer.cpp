@@ -3152,6 +3152,12 @@ void CVideoPlayer::GetGeneralInfo(std::string& strGeneralInfo)
           strBuf += StringUtils::Format(" %d sec", DVD_TIME_TO_SEC(m_State.cache_delay));
       }
 
+      DemuxPacketPoolStats pool = CDVDDemuxUtils::GetPacketPoolStats();
+      if (pool.allocations > 0)
+        strBuf += StringUtils::Format(" pkt:%2.0f%% %s"
+                                      , 100.0 * pool.hits / pool.allocations
+                                      , StringUtils::SizeToString(pool.pooledBytes).c_str());
+
       strGeneralInfo = StringUtils::Format("C( ad:% 6.3f, a/v:% 6.3f%s, dcpu:%2i%% acpu:%2i%% vcpu:%2i%%%s )"
                                            , dDelay
                                            , dDiff
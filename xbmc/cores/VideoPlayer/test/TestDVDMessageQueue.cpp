@@ -0,0 +1,221 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDMessageQueue.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+int GetValue(CDVDMessageQueue &queue, int &priority)
+{
+  CDVDMsg *msg = NULL;
+  EXPECT_EQ(MSGQ_OK, queue.Get(&msg, 0, priority));
+  if (!msg)
+    return -1;
+  int value = *static_cast<CDVDMsgInt*>(msg);
+  msg->Release();
+  return value;
+}
+
+int GetValue(CDVDMessageQueue &queue)
+{
+  int priority = 0;
+  return GetValue(queue, priority);
+}
+}
+
+TEST(TestDVDMessageQueue, Priority)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  queue.Put(new CDVDMsgInt(CDVDMsg::GENERAL_RESYNC, 0));
+  queue.Put(new CDVDMsgInt(CDVDMsg::GENERAL_RESYNC, 1));
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 2), 1);
+
+  int priority = 1;
+  EXPECT_EQ(2, GetValue(queue, priority));
+  EXPECT_EQ(1, priority);
+
+  CDVDMsg *msg = NULL;
+  priority = 1;
+  EXPECT_EQ(MSGQ_TIMEOUT, queue.Get(&msg, 0, priority));
+
+  EXPECT_EQ(0, GetValue(queue));
+  EXPECT_EQ(1, GetValue(queue));
+  queue.End();
+}
+
+TEST(TestDVDMessageQueue, OrderAcrossProducers)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  // the first thread putting becomes the ring producer, the other one uses the list
+  for (int i = 0; i < 5; ++i)
+    queue.Put(new CDVDMsgInt(CDVDMsg::GENERAL_RESYNC, i));
+  std::thread other([&queue]() { queue.Put(new CDVDMsgInt(CDVDMsg::GENERAL_RESYNC, 100)); });
+  other.join();
+  for (int i = 5; i < 10; ++i)
+    queue.Put(new CDVDMsgInt(CDVDMsg::GENERAL_RESYNC, i));
+
+  for (int i = 0; i < 5; ++i)
+    EXPECT_EQ(i, GetValue(queue));
+  EXPECT_EQ(100, GetValue(queue));
+  for (int i = 5; i < 10; ++i)
+    EXPECT_EQ(i, GetValue(queue));
+  queue.End();
+}
+
+TEST(TestDVDMessageQueue, RingOverflow)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  for (int i = 0; i < 3000; ++i)
+    queue.Put(new CDVDMsgInt(CDVDMsg::GENERAL_RESYNC, i));
+  EXPECT_EQ(3000U, queue.GetPacketCount(CDVDMsg::GENERAL_RESYNC));
+  for (int i = 0; i < 3000; ++i)
+    EXPECT_EQ(i, GetValue(queue));
+  queue.End();
+}
+
+TEST(TestDVDMessageQueue, Flush)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  DemuxPacket *packet = CDVDDemuxUtils::AllocateDemuxPacket(100);
+  packet->iSize = 100;
+  queue.Put(new CDVDMsgDemuxerPacket(packet));
+  queue.Put(new CDVDMsgInt(CDVDMsg::GENERAL_RESYNC, 1));
+  packet = CDVDDemuxUtils::AllocateDemuxPacket(100);
+  packet->iSize = 100;
+  queue.Put(new CDVDMsgDemuxerPacket(packet));
+  EXPECT_EQ(200, queue.GetDataSize());
+  EXPECT_EQ(2U, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+
+  queue.Flush();
+  EXPECT_EQ(0, queue.GetDataSize());
+  EXPECT_EQ(0U, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(1, GetValue(queue));
+  queue.End();
+}
+
+namespace
+{
+struct QueueBenchmark
+{
+  double messagesPerSec;
+  double latencyP50;
+  double latencyP99;
+};
+
+QueueBenchmark RunQueueBenchmark(bool ring)
+{
+  static const int messages = 200000;
+  static const int wakeups = 200;
+  CDVDMessageQueue queue("benchmark");
+  queue.Init();
+  QueueBenchmark result;
+
+  if (!ring)
+  {
+    // claim the ring for this thread, so the producer below takes the locked path
+    queue.Put(new CDVDMsgInt(CDVDMsg::GENERAL_RESYNC, 0));
+    GetValue(queue);
+  }
+
+  // throughput, the consumer is rarely asleep
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::atomic<int> consumed(0);
+  std::thread producer([&queue, &consumed]() {
+    for (int i = 0; i < messages; ++i)
+    {
+      while (i - consumed > 1000)
+        std::this_thread::yield();
+      queue.Put(new CDVDMsgInt(CDVDMsg::GENERAL_RESYNC, i));
+    }
+  });
+  for (int i = 0; i < messages; ++i)
+  {
+    CDVDMsg *msg = NULL;
+    int priority = 0;
+    queue.Get(&msg, 1000, priority);
+    if (msg)
+      msg->Release();
+    consumed++;
+  }
+  producer.join();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  result.messagesPerSec = messages / elapsed.count();
+
+  // wake-up latency, the consumer is always asleep when a message arrives
+  std::vector<double> latencies;
+  std::thread sender([&queue]() {
+    for (int i = 0; i < wakeups; ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      queue.Put(new CDVDMsgDouble(CDVDMsg::GENERAL_RESYNC,
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count()));
+    }
+  });
+  for (int i = 0; i < wakeups; ++i)
+  {
+    CDVDMsg *msg = NULL;
+    int priority = 0;
+    queue.Get(&msg, 1000, priority);
+    double now = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (msg)
+    {
+      latencies.push_back(now - *static_cast<CDVDMsgDouble*>(msg));
+      msg->Release();
+    }
+  }
+  sender.join();
+  queue.End();
+
+  std::sort(latencies.begin(), latencies.end());
+  result.latencyP50 = latencies.empty() ? 0 : latencies[latencies.size() / 2];
+  result.latencyP99 = latencies.empty() ? 0 : latencies[latencies.size() * 99 / 100];
+  return result;
+}
+}
+
+/* Benchmark, run with --gtest_also_run_disabled_tests */
+TEST(TestDVDMessageQueue, DISABLED_Benchmark)
+{
+  QueueBenchmark locked = RunQueueBenchmark(false);
+  QueueBenchmark ring = RunQueueBenchmark(true);
+  std::cout << "locked list: " << static_cast<int>(locked.messagesPerSec) << " msgs/sec, wake-up p50 "
+            << locked.latencyP50 << "us p99 " << locked.latencyP99 << "us" << std::endl;
+  std::cout << "spsc ring:   " << static_cast<int>(ring.messagesPerSec) << " msgs/sec, wake-up p50 "
+            << ring.latencyP50 << "us p99 " << ring.latencyP99 << "us" << std::endl;
+  EXPECT_GT(ring.messagesPerSec, 0);
+}
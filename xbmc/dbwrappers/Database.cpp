@@ -253,6 +253,53 @@ bool CDatabase::ResultQuery(const std::string &strQuery)
   return bReturn;
 }
 
+bool CDatabase::ExecuteQuery(const std::string &strQuery, const BindParams &params)
+{
+  if (NULL == m_pDB.get()) return false;
+  if (NULL == m_pDS.get()) return false;
+
+  if (m_multipleExecute)
+  {
+    m_multipleQueries.push_back(m_pDS->bind(strQuery, params));
+    return true;
+  }
+
+  bool bReturn = false;
+
+  try
+  {
+    m_pDS->exec(strQuery, params);
+    bReturn = true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to execute query '%s'",
+        __FUNCTION__, strQuery.c_str());
+  }
+
+  return bReturn;
+}
+
+bool CDatabase::ResultQuery(const std::string &strQuery, const BindParams &params)
+{
+  bool bReturn = false;
+
+  try
+  {
+    if (NULL == m_pDB.get()) return bReturn;
+    if (NULL == m_pDS.get()) return bReturn;
+
+    bReturn = m_pDS->query(strQuery, params);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to execute query '%s'",
+        __FUNCTION__, strQuery.c_str());
+  }
+
+  return bReturn;
+}
+
 bool CDatabase::QueueInsertQuery(const std::string &strQuery)
 {
   if (strQuery.empty())
@@ -20,15 +20,17 @@
  *
  */
 
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace dbiplus {
   class Database;
   class Dataset;
+  class field_value;
+  typedef std::vector<field_value> BindParams;
 }
 
-#include <memory>
-#include <string>
-#include <vector>
-
 class DatabaseSettings; // forward
 class CDbUrl;
 struct SortDescription;
@@ -110,6 +112,18 @@ public:
    */
   bool ExecuteQuery(const std::string &strQuery);
 
+  /*!
+   * @brief Execute a query that does not return any result, binding
+   *        params in order to the '?' placeholders of the statement.
+   *        The statement text is used verbatim so that the compiled form
+   *        can be reused by the connection.
+   * @param strQuery The single statement to execute.
+   * @param params The values to bind.
+   * @return True if the query was executed successfully, false otherwise.
+   * @sa ExecuteQuery
+   */
+  bool ExecuteQuery(const std::string &strQuery, const dbiplus::BindParams &params);
+
   /*!
    * @brief Execute a query that returns a result.
    * @remarks Call m_pDS->close(); to clean up the dataset when done.
@@ -118,6 +132,16 @@ public:
    */
   bool ResultQuery(const std::string &strQuery);
 
+  /*!
+   * @brief Execute a query that returns a result, binding params in order
+   *        to the '?' placeholders of the statement.
+   * @remarks Call m_pDS->close(); to clean up the dataset when done.
+   * @param strQuery The single statement to execute, used verbatim.
+   * @param params The values to bind.
+   * @return True if the query was executed successfully, false otherwise.
+   */
+  bool ResultQuery(const std::string &strQuery, const dbiplus::BindParams &params);
+
   /*!
    * @brief Start a multiple execution queue. Any ExecuteQuery() function
    *        following this call will be queued rather than executed until
@@ -202,6 +202,62 @@ void Dataset::parse_sql(std::string &sql) {
 }
 
 
+int Dataset::exec(const std::string &sql, const BindParams &params) {
+  return exec(bind(sql, params));
+}
+
+
+bool Dataset::query(const std::string &sql, const BindParams &params) {
+  return query(bind(sql, params));
+}
+
+
+std::string Dataset::bind(const std::string &sql, const BindParams &params) {
+  std::string result;
+  result.reserve(sql.size() + params.size() * 8);
+
+  size_t param = 0;
+  char quote = 0;
+  for (std::string::const_iterator c = sql.begin(); c != sql.end(); ++c)
+  {
+    if (quote)
+    {
+      if (*c == quote)
+        quote = 0;
+    }
+    else if (*c == '\'' || *c == '"' || *c == '`')
+      quote = *c;
+    else if (*c == '?' && param < params.size())
+    {
+      const field_value &v = params[param++];
+      if (v.get_isNull())
+        result += "NULL";
+      else switch (v.get_fType())
+      {
+        case ft_Boolean:
+          result += v.get_asBool() ? "1" : "0";
+          break;
+        case ft_Short:
+        case ft_UShort:
+        case ft_Int:
+        case ft_UInt:
+        case ft_Int64:
+        case ft_Float:
+        case ft_Double:
+          result += v.get_asString();
+          break;
+        default:
+          result += db->prepare("'%s'", v.get_asString().c_str());
+          break;
+      }
+      continue;
+    }
+    result += *c;
+  }
+  return result;
+}
+
+
 void Dataset::close(void) {
   haveError  = false;
   frecno = 0;
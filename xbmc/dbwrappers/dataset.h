@@ -182,6 +182,7 @@ enum sqlType {sqlSelect,sqlUpdate,sqlInsert,sqlDelete,sqlExec};
 
 typedef std::list<std::string> StringList;
 typedef std::map<std::string,field_value> ParamList;
+typedef std::vector<field_value> BindParams;
 
 
 class Dataset  {
@@ -307,6 +308,13 @@ public:
   virtual const void* getExecRes()=0;
 /* as open, but with our query exept Sql */
   virtual bool query(const std::string &sql) = 0;
+/* as exec and query, but with params bound in order to the '?' placeholders
+   of a single sql statement. Drivers that can keep compiled statements
+   override these, the default substitutes params as escaped literals */
+  virtual int  exec (const std::string &sql, const BindParams &params);
+  virtual bool query(const std::string &sql, const BindParams &params);
+/* substitutes params for the '?' placeholders in sql as escaped literals */
+  std::string bind(const std::string &sql, const BindParams &params);
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
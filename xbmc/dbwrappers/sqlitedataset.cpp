@@ -39,6 +39,10 @@
 #endif
 
 namespace dbiplus {
+
+// number of compiled statements kept per connection
+static const size_t STATEMENT_CACHE_SIZE = 64;
+
 //************* Callback function ***************************
 
 int callback(void* res_ptr,int ncol, char** reslt,char** cols)
@@ -96,6 +100,8 @@ SqliteDatabase::SqliteDatabase() {
   db = "sqlite.db";
   login = "root";
   passwd = "";
+  stmt_hits = 0;
+  stmt_misses = 0;
 }
 
 SqliteDatabase::~SqliteDatabase() {
@@ -257,10 +263,63 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
+  clearStatements();
   sqlite3_close(conn);
   active = false;
 }
 
+sqlite3_stmt *SqliteDatabase::acquireStatement(const std::string &sql) {
+  std::unordered_map<std::string, StatementList::iterator>::iterator it = stmt_index.find(sql);
+  if (it != stmt_index.end())
+  {
+    // hand the statement out of the cache so nested users of the same
+    // sql on this connection each get their own
+    sqlite3_stmt *stmt = it->second->second;
+    stmt_cache.erase(it->second);
+    stmt_index.erase(it);
+    stmt_hits++;
+    return stmt;
+  }
+
+  stmt_misses++;
+  sqlite3_stmt *stmt = NULL;
+  if (setErr(sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, NULL), sql.c_str()) != SQLITE_OK)
+  {
+    sqlite3_finalize(stmt);
+    return NULL;
+  }
+  return stmt;
+}
+
+void SqliteDatabase::releaseStatement(const std::string &sql, sqlite3_stmt *stmt) {
+  if (!stmt) return;
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+
+  if (!active || stmt_index.find(sql) != stmt_index.end())
+  {
+    sqlite3_finalize(stmt);
+    return;
+  }
+
+  stmt_cache.push_front(std::make_pair(sql, stmt));
+  stmt_index[sql] = stmt_cache.begin();
+
+  while (stmt_cache.size() > STATEMENT_CACHE_SIZE)
+  {
+    sqlite3_finalize(stmt_cache.back().second);
+    stmt_index.erase(stmt_cache.back().first);
+    stmt_cache.pop_back();
+  }
+}
+
+void SqliteDatabase::clearStatements() {
+  for (StatementList::iterator it = stmt_cache.begin(); it != stmt_cache.end(); ++it)
+    sqlite3_finalize(it->second);
+  stmt_cache.clear();
+  stmt_index.clear();
+}
+
 int SqliteDatabase::create() {
   return connect(true);
 }
@@ -627,6 +686,35 @@ int SqliteDataset::exec(const std::string &sql) {
     }
 }
 
+int SqliteDataset::exec(const std::string &sql, const BindParams &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  exec_res.clear();
+
+  SqliteDatabase *sdb = static_cast<SqliteDatabase*>(db);
+  sqlite3_stmt *stmt = sdb->acquireStatement(sql);
+  if (!stmt)
+    throw DbErrors(db->getErrorMsg());
+
+  try
+  {
+    bind_params(stmt, params, sql);
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+      ;
+  }
+  catch (...)
+  {
+    sdb->releaseStatement(sql, stmt);
+    throw;
+  }
+
+  int res = sqlite3_reset(stmt);
+  sdb->releaseStatement(sql, stmt);
+  if ((res = db->setErr(res, sql.c_str())) == SQLITE_OK)
+    return res;
+  else
+    throw DbErrors(db->getErrorMsg());
+}
+
 int SqliteDataset::exec() {
   return exec(sql);
 }
@@ -636,20 +724,41 @@ const void* SqliteDataset::getExecRes() {
 }
 
 
-bool SqliteDataset::query(const std::string &query) {
-    if(!handle()) throw DbErrors("No Database Connection");
-    std::string qry = query;
-    int fs = qry.find("select");
-    int fS = qry.find("SELECT");
-    if (!( fs >= 0 || fS >=0))                                 
-         throw DbErrors("MUST be select SQL!"); 
-
-  close();
-
-  sqlite3_stmt *stmt = NULL;
-  if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
-    throw DbErrors(db->getErrorMsg());
+void SqliteDataset::bind_params(sqlite3_stmt *stmt, const BindParams &params, const std::string &sql) {
+  for (unsigned int i = 0; i < params.size(); i++)
+  {
+    const field_value &v = params[i];
+    const int col = i + 1;
+    int res;
+    if (v.get_isNull())
+      res = sqlite3_bind_null(stmt, col);
+    else switch (v.get_fType())
+    {
+    case ft_Boolean:
+    case ft_Short:
+    case ft_UShort:
+    case ft_Int:
+    case ft_UInt:
+    case ft_Int64:
+      res = sqlite3_bind_int64(stmt, col, v.get_asInt64());
+      break;
+    case ft_Float:
+    case ft_Double:
+      res = sqlite3_bind_double(stmt, col, v.get_asDouble());
+      break;
+    default:
+      {
+        const std::string str = v.get_asString();
+        res = sqlite3_bind_text(stmt, col, str.c_str(), str.size(), SQLITE_TRANSIENT);
+      }
+      break;
+    }
+    if (db->setErr(res, sql.c_str()) != SQLITE_OK)
+      throw DbErrors(db->getErrorMsg());
+  }
+}
 
+void SqliteDataset::fetch_rows(sqlite3_stmt *stmt) {
   // column headers
   const unsigned int numColumns = sqlite3_column_count(stmt);
   result.record_header.resize(numColumns);
@@ -687,6 +796,24 @@ bool SqliteDataset::query(const std::string &query) {
     }
     result.records.push_back(res);
   }
+}
+
+bool SqliteDataset::query(const std::string &query) {
+    if(!handle()) throw DbErrors("No Database Connection");
+    std::string qry = query;
+    int fs = qry.find("select");
+    int fS = qry.find("SELECT");
+    if (!( fs >= 0 || fS >=0))                                 
+         throw DbErrors("MUST be select SQL!"); 
+
+  close();
+
+  sqlite3_stmt *stmt = NULL;
+  if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+
+  fetch_rows(stmt);
+
   if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
   {
     active = true;
@@ -700,6 +827,41 @@ bool SqliteDataset::query(const std::string &query) {
   }  
 }
 
+bool SqliteDataset::query(const std::string &query, const BindParams &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  if (query.find("select") == std::string::npos && query.find("SELECT") == std::string::npos)
+    throw DbErrors("MUST be select SQL!");
+
+  close();
+
+  SqliteDatabase *sdb = static_cast<SqliteDatabase*>(db);
+  sqlite3_stmt *stmt = sdb->acquireStatement(query);
+  if (!stmt)
+    throw DbErrors(db->getErrorMsg());
+
+  try
+  {
+    bind_params(stmt, params, query);
+    fetch_rows(stmt);
+  }
+  catch (...)
+  {
+    sdb->releaseStatement(query, stmt);
+    throw;
+  }
+
+  // reset reports the error of the last step, if any
+  int res = sqlite3_reset(stmt);
+  sdb->releaseStatement(query, stmt);
+  if (db->setErr(res, query.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
 void SqliteDataset::open(const std::string &sql) {
   set_select_sql(sql);
   open();
@@ -29,6 +29,9 @@
  **********************************************************************/
 
 #include <stdio.h>
+#include <list>
+#include <unordered_map>
+#include <utility>
 #include "dataset.h"
 #include <sqlite3.h>
 
@@ -45,6 +48,16 @@ protected:
   bool _in_transaction;
   int last_err;
 
+/* compiled statements kept for reuse, most recently used first */
+  typedef std::list<std::pair<std::string, sqlite3_stmt*> > StatementList;
+  StatementList stmt_cache;
+  std::unordered_map<std::string, StatementList::iterator> stmt_index;
+  unsigned int stmt_hits;
+  unsigned int stmt_misses;
+
+/* finalizes all cached statements */
+  void clearStatements();
+
 public:
 /* default constructor */
   SqliteDatabase();
@@ -96,6 +109,15 @@ public:
 
   bool in_transaction() {return _in_transaction;}; 	
 
+/* func. returns a compiled statement for sql, reusing a cached one when
+   possible. The statement belongs to the caller until releaseStatement() */
+  sqlite3_stmt *acquireStatement(const std::string &sql);
+/* func. resets stmt and returns it to the cache */
+  void releaseStatement(const std::string &sql, sqlite3_stmt *stmt);
+/* statement cache counters */
+  unsigned int getStatementHits() const { return stmt_hits; }
+  unsigned int getStatementMisses() const { return stmt_misses; }
+
 };
 
 
@@ -121,6 +143,11 @@ protected:
 
   //static int sqlite_callback(void* res_ptr,int ncol, char** reslt, char** cols);
 
+/* binds params to the placeholders of stmt */
+  void bind_params(sqlite3_stmt *stmt, const BindParams &params, const std::string &sql);
+/* steps stmt and stores the returned rows in result */
+  void fetch_rows(sqlite3_stmt *stmt);
+
 /* This function works only with MySQL database
   Filling the fields information from select statement */
   virtual void fill_fields();
@@ -145,9 +172,11 @@ or insert() operations default = false) */
 /* func. executes a query without results to return */
   virtual int  exec ();
   virtual int  exec (const std::string &sql);
+  virtual int  exec (const std::string &sql, const BindParams &params);
   virtual const void* getExecRes();
 /* as open, but with our query exept Sql */
   virtual bool query(const std::string &query);
+  virtual bool query(const std::string &query, const BindParams &params);
 /* func. closes a query */
   virtual void close(void);
 /* Cancel changes, made in insert or edit states of dataset */
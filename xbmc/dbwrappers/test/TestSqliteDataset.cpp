@@ -0,0 +1,212 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/StringUtils.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+using namespace dbiplus;
+
+namespace
+{
+const int NUM_PATHS = 100;
+const int FILES_PER_PATH = 20;
+const char *ART_TYPES[] = { "poster", "fanart", "thumb" };
+
+field_value NullValue()
+{
+  field_value value;
+  value.set_isNull();
+  return value;
+}
+}
+
+class TestSqliteDataset : public testing::Test
+{
+protected:
+  TestSqliteDataset()
+  {
+    m_db.setHostName(CSpecialProtocol::TranslatePath("special://temp/").c_str());
+    m_db.setDatabase("TestSqliteDataset.db");
+    XFILE::CFile::Delete(DatabasePath());
+    EXPECT_EQ(DB_CONNECTION_OK, m_db.connect(true));
+    m_ds.reset(m_db.CreateDataset());
+
+    // a cut down version of the video library tables used for navigation
+    m_ds->exec("CREATE TABLE path (idPath integer primary key, strPath text)");
+    m_ds->exec("CREATE TABLE files (idFile integer primary key, idPath integer, strFilename text)");
+    m_ds->exec("CREATE TABLE art (art_id integer primary key, media_id integer, media_type text, type text, url text)");
+    m_ds->exec("CREATE UNIQUE INDEX ix_path ON path (strPath)");
+    m_ds->exec("CREATE INDEX ix_files ON files (idPath, strFilename)");
+    m_ds->exec("CREATE INDEX ix_art ON art (media_id, media_type, type)");
+
+    m_db.start_transaction();
+    for (int p = 1; p <= NUM_PATHS; p++)
+    {
+      m_ds->exec("INSERT INTO path (idPath, strPath) VALUES (?, ?)", { p, PathName(p).c_str() });
+      for (int f = 1; f <= FILES_PER_PATH; f++)
+      {
+        int idFile = (p - 1) * FILES_PER_PATH + f;
+        m_ds->exec("INSERT INTO files (idFile, idPath, strFilename) VALUES (?, ?, ?)", { idFile, p, FileName(f).c_str() });
+        for (const char *type : ART_TYPES)
+          m_ds->exec("INSERT INTO art (media_id, media_type, type, url) VALUES (?, 'movie', ?, ?)",
+                     { idFile, type, StringUtils::Format("image://%s/%d.jpg", type, idFile).c_str() });
+      }
+    }
+    m_db.commit_transaction();
+  }
+
+  ~TestSqliteDataset()
+  {
+    m_ds.reset();
+    m_db.disconnect();
+    XFILE::CFile::Delete(DatabasePath());
+  }
+
+  std::string DatabasePath() const
+  {
+    return CSpecialProtocol::TranslatePath("special://temp/TestSqliteDataset.db");
+  }
+
+  static std::string PathName(int p)
+  {
+    return StringUtils::Format("/media/movies/Movie's %03d/", p);
+  }
+
+  static std::string FileName(int f)
+  {
+    return StringUtils::Format("part %02d.mkv", f);
+  }
+
+  SqliteDatabase m_db;
+  std::unique_ptr<Dataset> m_ds;
+};
+
+TEST_F(TestSqliteDataset, BoundQueryMatchesFormatted)
+{
+  std::string path = PathName(42);
+  ASSERT_TRUE(m_ds->query(m_db.prepare("SELECT idPath FROM path WHERE strPath='%s'", path.c_str())));
+  ASSERT_EQ(1, m_ds->num_rows());
+  int formatted = m_ds->fv(0).get_asInt();
+  m_ds->close();
+
+  ASSERT_TRUE(m_ds->query("SELECT idPath FROM path WHERE strPath=?", { path.c_str() }));
+  ASSERT_EQ(1, m_ds->num_rows());
+  EXPECT_EQ(42, formatted);
+  EXPECT_EQ(formatted, m_ds->fv("idPath").get_asInt());
+  m_ds->close();
+
+  ASSERT_TRUE(m_ds->query("SELECT type, url FROM art WHERE media_id=? AND media_type=?", { 7, "movie" }));
+  EXPECT_EQ(3, m_ds->num_rows());
+  m_ds->close();
+
+  // a null parameter never compares equal
+  ASSERT_TRUE(m_ds->query("SELECT idFile FROM files WHERE strFilename=?", { NullValue() }));
+  EXPECT_EQ(0, m_ds->num_rows());
+  m_ds->close();
+}
+
+TEST_F(TestSqliteDataset, ReusesStatements)
+{
+  unsigned int hits = m_db.getStatementHits();
+  unsigned int misses = m_db.getStatementMisses();
+  for (int i = 1; i <= 10; i++)
+  {
+    ASSERT_TRUE(m_ds->query("SELECT idFile FROM files WHERE strFilename=? AND idPath=?", { FileName(1).c_str(), i }));
+    EXPECT_EQ(1, m_ds->num_rows());
+    EXPECT_EQ((i - 1) * FILES_PER_PATH + 1, m_ds->fv(0).get_asInt());
+    m_ds->close();
+  }
+  EXPECT_EQ(misses + 1, m_db.getStatementMisses());
+  EXPECT_EQ(hits + 9, m_db.getStatementHits());
+
+  // errors leave the cached statement usable
+  EXPECT_THROW(m_ds->exec("INSERT INTO path (idPath, strPath) VALUES (?, ?)", { 1, "duplicate" }), DbErrors);
+  m_ds->exec("INSERT INTO path (idPath, strPath) VALUES (?, ?)", { NUM_PATHS + 1, "new" });
+  EXPECT_EQ(std::string("new"), m_ds->query("SELECT strPath FROM path WHERE idPath=?", { NUM_PATHS + 1 }) ? m_ds->fv(0).get_asString() : "");
+  m_ds->close();
+}
+
+TEST_F(TestSqliteDataset, BindSubstitutesLiterals)
+{
+  std::string sql = m_ds->bind("SELECT * FROM path WHERE strPath=? AND note='?' AND idPath=? AND x=?",
+                               { "it's", 3, NullValue() });
+  EXPECT_EQ("SELECT * FROM path WHERE strPath='it''s' AND note='?' AND idPath=3 AND x=NULL", sql);
+}
+
+/* Benchmark, run with --gtest_also_run_disabled_tests */
+TEST_F(TestSqliteDataset, DISABLED_Benchmark)
+{
+  // the lookups done for every item while listing a library folder:
+  // GetPathId, GetFileId and GetArtForItem
+  const int rounds = 5;
+  int rows[2] = { 0, 0 };
+  double ms[2] = { 0, 0 };
+
+  for (int bound = 0; bound < 2; bound++)
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+    {
+      for (int p = 1; p <= NUM_PATHS; p++)
+      {
+        std::string path = PathName(p);
+        for (int f = 1; f <= FILES_PER_PATH; f++)
+        {
+          std::string file = FileName(f);
+          if (bound)
+          {
+            m_ds->query("select idPath from path where strPath=?", { path.c_str() });
+            int idPath = m_ds->fv(0).get_asInt();
+            m_ds->query("select idFile from files where strFileName=? and idPath=?", { file.c_str(), idPath });
+            int idFile = m_ds->fv(0).get_asInt();
+            m_ds->query("SELECT type,url FROM art WHERE media_id=? AND media_type=?", { idFile, "movie" });
+          }
+          else
+          {
+            m_ds->query(m_db.prepare("select idPath from path where strPath='%s'", path.c_str()));
+            int idPath = m_ds->fv(0).get_asInt();
+            m_ds->query(m_db.prepare("select idFile from files where strFileName='%s' and idPath=%i", file.c_str(), idPath));
+            int idFile = m_ds->fv(0).get_asInt();
+            m_ds->query(m_db.prepare("SELECT type,url FROM art WHERE media_id=%i AND media_type='%s'", idFile, "movie"));
+          }
+          rows[bound] += m_ds->num_rows();
+          m_ds->close();
+        }
+      }
+    }
+    ms[bound] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  EXPECT_EQ(rows[0], rows[1]);
+  EXPECT_EQ(rounds * NUM_PATHS * FILES_PER_PATH * 3, rows[1]);
+
+  const int lookups = rounds * NUM_PATHS * FILES_PER_PATH;
+  std::cout << "formatted queries: " << ms[0] << " ms for " << lookups << " items" << std::endl;
+  std::cout << "cached statements: " << ms[1] << " ms for " << lookups << " items ("
+            << (ms[1] > 0 ? ms[0] / ms[1] : 0) << "x)" << std::endl;
+}
@@ -19,6 +19,7 @@
  */
 
 #include "threads/SystemClock.h"
+#include "threads/SingleLock.h"
 #include "CacheStrategy.h"
 #include "IFile.h"
 #include "Util.h"
@@ -279,6 +280,359 @@ CCacheStrategy *CSimpleFileCache::CreateNew()
 }
 
 
+CBlockFileCache::CBlockFileCache(size_t maxSize)
+  : m_cacheFileRead(new CacheLocalFile())
+  , m_cacheFileWrite(new CacheLocalFile())
+  , m_maxBlocks(std::max(maxSize / BLOCK_SIZE, (size_t)4))
+  , m_usedSlots(0)
+  , m_readPos(0)
+  , m_writePos(0)
+{
+}
+
+CBlockFileCache::~CBlockFileCache()
+{
+  Close();
+  delete m_cacheFileRead;
+  delete m_cacheFileWrite;
+}
+
+int CBlockFileCache::Open()
+{
+  Close();
+
+  m_filename = CSpecialProtocol::TranslatePath(CUtil::GetNextFilename("special://temp/filecache%03d.cache", 999));
+  if (m_filename.empty())
+  {
+    CLog::Log(LOGERROR, "%s - Unable to generate a new filename", __FUNCTION__);
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  CURL fileURL(m_filename);
+
+  if (!m_cacheFileWrite->OpenForWrite(fileURL, false))
+  {
+    CLog::LogF(LOGERROR, "failed to create file \"%s\" for writing", m_filename.c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  if (!m_cacheFileRead->Open(fileURL))
+  {
+    CLog::LogF(LOGERROR, "failed to open file \"%s\" for reading", m_filename.c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  return CACHE_RC_OK;
+}
+
+void CBlockFileCache::Close()
+{
+  m_cacheFileWrite->Close();
+  m_cacheFileRead->Close();
+
+  if (!m_filename.empty() && !m_cacheFileRead->Delete(CURL(m_filename)))
+    CLog::LogF(LOGWARNING, "failed to delete temporary file \"%s\"", m_filename.c_str());
+
+  m_filename.clear();
+
+  CSingleLock lock(m_sync);
+  m_blocks.clear();
+  m_lru.clear();
+  m_usedSlots = 0;
+  m_readPos = 0;
+  m_writePos = 0;
+}
+
+CBlockFileCache::Block* CBlockFileCache::GetBlock(int64_t index)
+{
+  std::map<int64_t, Block>::iterator it = m_blocks.find(index);
+  if (it == m_blocks.end())
+    return NULL;
+
+  m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+  return &it->second;
+}
+
+bool CBlockFileCache::IsProtected(int64_t index) const
+{
+  // data between the read and write position hasn't been read yet
+  return index >= m_readPos / (int64_t)BLOCK_SIZE && index <= m_writePos / (int64_t)BLOCK_SIZE;
+}
+
+CBlockFileCache::Block* CBlockFileCache::AllocateBlock(int64_t index)
+{
+  size_t slot;
+  if (m_usedSlots < m_maxBlocks)
+    slot = m_usedSlots++;
+  else
+  {
+    // recycle the least recently used block that has already been read
+    std::list<int64_t>::reverse_iterator victim = m_lru.rbegin();
+    while (victim != m_lru.rend() && IsProtected(*victim))
+      ++victim;
+    if (victim == m_lru.rend())
+      return NULL;
+
+    std::map<int64_t, Block>::iterator it = m_blocks.find(*victim);
+    slot = it->second.slot;
+    m_lru.erase(it->second.lru);
+    m_blocks.erase(it);
+  }
+
+  m_lru.push_front(index);
+  Block &block = m_blocks[index];
+  block.slot = slot;
+  block.begin = 0;
+  block.end = 0;
+  block.lru = m_lru.begin();
+  return &block;
+}
+
+int64_t CBlockFileCache::GetCachedEnd(int64_t iFilePosition)
+{
+  int64_t end = iFilePosition;
+  while (true)
+  {
+    std::map<int64_t, Block>::const_iterator it = m_blocks.find(end / BLOCK_SIZE);
+    if (it == m_blocks.end())
+      break;
+
+    size_t offset = (size_t)(end % BLOCK_SIZE);
+    if (offset < it->second.begin || offset >= it->second.end)
+      break;
+
+    end += it->second.end - offset;
+    if (it->second.end < BLOCK_SIZE)
+      break;
+  }
+  return end;
+}
+
+size_t CBlockFileCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  CSingleLock lock(m_sync);
+
+  // keep a quarter of the budget for data behind the read position
+  if (m_writePos - m_readPos >= (int64_t)(m_maxBlocks - m_maxBlocks / 4) * (int64_t)BLOCK_SIZE)
+    return 0;
+
+  int64_t index = m_writePos / BLOCK_SIZE;
+  if (m_blocks.find(index) == m_blocks.end() && m_usedSlots == m_maxBlocks)
+  {
+    bool evictable = false;
+    for (std::list<int64_t>::reverse_iterator it = m_lru.rbegin(); it != m_lru.rend() && !evictable; ++it)
+      evictable = !IsProtected(*it);
+    if (!evictable)
+      return 0;
+  }
+
+  return std::min(iRequestSize, BLOCK_SIZE - (size_t)(m_writePos % BLOCK_SIZE));
+}
+
+int CBlockFileCache::WriteToCache(const char *pBuffer, size_t iSize)
+{
+  CSingleLock lock(m_sync);
+
+  size_t written = 0;
+  while (written < iSize)
+  {
+    int64_t index = m_writePos / BLOCK_SIZE;
+    size_t offset = (size_t)(m_writePos % BLOCK_SIZE);
+    Block *block = GetBlock(index);
+    if (!block)
+      block = AllocateBlock(index);
+    if (!block)
+      break;
+
+    size_t len = std::min(iSize - written, BLOCK_SIZE - offset);
+    size_t slot = block->slot;
+
+    // the block being written is never recycled, so write without the lock
+    lock.Leave();
+    bool ok = m_cacheFileWrite->Seek((int64_t)slot * BLOCK_SIZE + offset, SEEK_SET) >= 0;
+    size_t done = 0;
+    while (ok && done < len)
+    {
+      const ssize_t lastWritten = m_cacheFileWrite->Write(pBuffer + written + done, len - done);
+      if (lastWritten <= 0)
+        ok = false;
+      else
+        done += lastWritten;
+    }
+    lock.Enter();
+
+    if (!ok)
+    {
+      CLog::LogF(LOGERROR, "failed to write to file");
+      return CACHE_RC_ERROR;
+    }
+
+    block = GetBlock(index);
+    if (offset >= block->begin && offset <= block->end)
+      block->end = std::max(block->end, offset + len);
+    else
+    {
+      // not contiguous with what we had, only keep the new data
+      block->begin = offset;
+      block->end = offset + len;
+    }
+
+    m_writePos += len;
+    written += len;
+  }
+
+  if (written > 0)
+    m_written.Set();
+
+  return written;
+}
+
+int CBlockFileCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
+{
+  CSingleLock lock(m_sync);
+
+  int64_t avail = m_writePos - m_readPos;
+  if (avail <= 0)
+    return m_bEndOfInput ? 0 : CACHE_RC_WOULD_BLOCK;
+
+  int64_t index = m_readPos / BLOCK_SIZE;
+  size_t offset = (size_t)(m_readPos % BLOCK_SIZE);
+  Block *block = GetBlock(index);
+  if (!block)
+  {
+    CLog::LogF(LOGERROR, "block %" PRId64" missing from cache", index);
+    return CACHE_RC_ERROR;
+  }
+
+  size_t len = std::min(iMaxSize, BLOCK_SIZE - offset);
+  if ((int64_t)len > avail)
+    len = (size_t)avail;
+  size_t slot = block->slot;
+
+  // blocks between the read and write position are never recycled
+  lock.Leave();
+  if (m_cacheFileRead->Seek((int64_t)slot * BLOCK_SIZE + offset, SEEK_SET) < 0)
+  {
+    CLog::LogF(LOGERROR, "can't seek file");
+    return CACHE_RC_ERROR;
+  }
+  size_t readBytes = 0;
+  while (readBytes < len)
+  {
+    const ssize_t lastRead = m_cacheFileRead->Read(pBuffer + readBytes, len - readBytes);
+    if (lastRead <= 0)
+    {
+      CLog::LogF(LOGERROR, "failed to read from file");
+      return CACHE_RC_ERROR;
+    }
+    readBytes += lastRead;
+  }
+  lock.Enter();
+
+  m_readPos += readBytes;
+  m_space.Set();
+
+  return readBytes;
+}
+
+int64_t CBlockFileCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  CSingleLock lock(m_sync);
+  int64_t avail = m_writePos - m_readPos;
+
+  if (iMillis == 0 || IsEndOfInput())
+    return avail;
+
+  XbmcThreads::EndTime endtime(iMillis);
+  while (!IsEndOfInput() && avail < iMinAvail && !endtime.IsTimePast())
+  {
+    lock.Leave();
+    m_written.WaitMSec(50);
+    lock.Enter();
+    avail = m_writePos - m_readPos;
+  }
+
+  if (avail < iMinAvail && !IsEndOfInput())
+    return CACHE_RC_TIMEOUT;
+  return avail;
+}
+
+int64_t CBlockFileCache::Seek(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+
+  // if seek is a bit over what we have, try to wait for the data instead of seeking the source
+  if (iFilePosition > m_writePos && iFilePosition < m_writePos + 100000)
+  {
+    m_readPos = m_writePos;
+    lock.Leave();
+    WaitForData((unsigned int)(iFilePosition - m_readPos), 5000);
+    lock.Enter();
+  }
+
+  // only positions the writer is still extending can be read without a reset
+  if (iFilePosition <= m_writePos && GetCachedEnd(iFilePosition) >= m_writePos)
+  {
+    m_readPos = iFilePosition;
+    m_space.Set();
+    return iFilePosition;
+  }
+
+  return CACHE_RC_ERROR;
+}
+
+bool CBlockFileCache::Reset(int64_t iSourcePosition, bool clearAnyway)
+{
+  CSingleLock lock(m_sync);
+
+  if (clearAnyway)
+  {
+    m_blocks.clear();
+    m_lru.clear();
+    m_usedSlots = 0;
+  }
+
+  // continue writing after whatever we already have from this position on
+  m_readPos = iSourcePosition;
+  m_writePos = GetCachedEnd(iSourcePosition);
+  m_space.Set();
+
+  return clearAnyway || m_writePos == iSourcePosition;
+}
+
+void CBlockFileCache::EndOfInput()
+{
+  CCacheStrategy::EndOfInput();
+  m_written.Set();
+}
+
+int64_t CBlockFileCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  return GetCachedEnd(iFilePosition);
+}
+
+int64_t CBlockFileCache::CachedDataEndPos()
+{
+  CSingleLock lock(m_sync);
+  return m_writePos;
+}
+
+bool CBlockFileCache::IsCachedPosition(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  return iFilePosition == m_writePos || GetCachedEnd(iFilePosition) > iFilePosition;
+}
+
+CCacheStrategy *CBlockFileCache::CreateNew()
+{
+  return new CBlockFileCache(m_maxBlocks * BLOCK_SIZE);
+}
+
+
 CDoubleCache::CDoubleCache(CCacheStrategy *impl)
 {
   assert(NULL != impl);
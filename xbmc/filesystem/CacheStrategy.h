@@ -23,7 +23,10 @@
 #define XFILECACHESTRATEGY_H
 
 #include <stdint.h>
+#include <list>
+#include <map>
 #include <string>
+#include "threads/CriticalSection.h"
 #include "threads/Event.h"
 
 namespace XFILE {
@@ -111,6 +114,68 @@ protected:
   volatile int64_t m_nReadPosition;
 };
 
+/**
+ * Sparse on-disk cache of the whole file.
+ *
+ * The file is split into blocks that are stored in slots of a temporary
+ * file, indexed by their position in the source. Blocks stay cached after a
+ * seek, so seeking back into data that was already downloaded only moves the
+ * read position and restarts the source after the cached run. When the byte
+ * budget is used up the least recently used block outside the unread data
+ * is recycled.
+ */
+class CBlockFileCache : public CCacheStrategy {
+public:
+  CBlockFileCache(size_t maxSize);
+  virtual ~CBlockFileCache();
+
+  virtual int Open() ;
+  virtual void Close() ;
+
+  virtual size_t GetMaxWriteSize(const size_t& iRequestSize) ;
+  virtual int WriteToCache(const char *pBuffer, size_t iSize) ;
+  virtual int ReadFromCache(char *pBuffer, size_t iMaxSize) ;
+  virtual int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) ;
+
+  virtual int64_t Seek(int64_t iFilePosition);
+  virtual bool Reset(int64_t iSourcePosition, bool clearAnyway=true);
+  virtual void EndOfInput();
+
+  virtual int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition);
+  virtual int64_t CachedDataEndPos();
+  virtual bool IsCachedPosition(int64_t iFilePosition);
+
+  virtual CCacheStrategy *CreateNew();
+
+protected:
+  struct Block
+  {
+    size_t slot;  // position of the block in the cache file, in blocks
+    size_t begin; // valid data within the block
+    size_t end;
+    std::list<int64_t>::iterator lru;
+  };
+
+  Block* GetBlock(int64_t index);
+  Block* AllocateBlock(int64_t index);
+  int64_t GetCachedEnd(int64_t iFilePosition);
+  bool IsProtected(int64_t index) const;
+
+  static const size_t BLOCK_SIZE = 1024 * 1024;
+
+  std::string m_filename;
+  IFile*   m_cacheFileRead;
+  IFile*   m_cacheFileWrite;
+  size_t   m_maxBlocks;
+  size_t   m_usedSlots;
+  std::map<int64_t, Block> m_blocks;
+  std::list<int64_t> m_lru; // block indices, most recently used first
+  int64_t  m_readPos;
+  int64_t  m_writePos;
+  CCriticalSection m_sync;
+  CEvent   m_written;
+};
+
 class CDoubleCache : public CCacheStrategy{
 public:
   CDoubleCache(CCacheStrategy *impl);
@@ -150,6 +150,13 @@ bool CDirectory::GetDirectory(const CURL& url, CFileItemList &items, const CHint
     // check our cache for this path
     if (g_directoryCache.GetDirectory(realURL.Get(), items, (hints.flags & DIR_FLAG_READ_CACHE) == DIR_FLAG_READ_CACHE))
       items.SetURL(url);
+    else if (!(hints.flags & DIR_FLAG_BYPASS_CACHE) && pDirectory->GetCacheType(url) != DIR_CACHE_NEVER &&
+             g_directoryCache.GetPersistentDirectory(realURL.Get(), items))
+    {
+      // listed in an earlier session and unchanged since
+      items.SetURL(url);
+      g_directoryCache.SetDirectory(realURL.Get(), items, pDirectory->GetCacheType(url));
+    }
     else
     {
       // need to clear the cache (in case the directory fetch fails)
@@ -216,8 +223,11 @@ bool CDirectory::GetDirectory(const CURL& url, CFileItemList &items, const CHint
       }
 
       // cache the directory, if necessary
-      if (!(hints.flags & DIR_FLAG_BYPASS_CACHE))
+      if (!(hints.flags & DIR_FLAG_BYPASS_CACHE) && pDirectory->GetCacheType(url) != DIR_CACHE_NEVER)
+      {
         g_directoryCache.SetDirectory(realURL.Get(), items, pDirectory->GetCacheType(url));
+        g_directoryCache.SetPersistentDirectory(realURL.Get(), items);
+      }
     }
 
     // now filter for allowed files
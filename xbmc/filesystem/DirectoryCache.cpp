@@ -19,8 +19,12 @@
  */
 
 #include "DirectoryCache.h"
+#include "File.h"
 #include "FileItem.h"
+#include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "utils/StringUtils.h"
@@ -28,10 +32,15 @@
 #include "climits"
 
 #include <algorithm>
+#include <time.h>
 
 // Maximum number of directories to keep in our cache
 #define MAX_CACHED_DIRS 50
 
+// Location and format version of the persisted listings
+#define PERSISTENT_CACHE_PATH    "special://temp/dircache/"
+#define PERSISTENT_CACHE_VERSION 1
+
 using namespace XFILE;
 
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
@@ -113,7 +122,9 @@ void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemLi
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ClearDirectory(storedPath);
+  iCache i = m_cache.find(storedPath);
+  if (i != m_cache.end())
+    Delete(i);
 
   CheckIfFull();
 
@@ -142,6 +153,10 @@ void CDirectoryCache::ClearDirectory(const std::string& strPath)
   iCache i = m_cache.find(storedPath);
   if (i != m_cache.end())
     Delete(i);
+
+  // the store does file i/o that can call back into us, so don't hold our lock
+  lock.Leave();
+  DeletePersistent(storedPath);
 }
 
 void CDirectoryCache::ClearSubPaths(const std::string& strPath)
@@ -178,6 +193,9 @@ void CDirectoryCache::AddFile(const std::string& strFile)
     dir->m_Items->Add(item);
     dir->SetLastAccess(m_accessCounter);
   }
+
+  lock.Leave();
+  DeletePersistent(strPath);
 }
 
 bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
@@ -208,6 +226,127 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
   return false;
 }
 
+bool CDirectoryCache::GetPersistentDirectory(const std::string& strPath, CFileItemList &items)
+{
+  // Get rid of any URL options, else the compare may be wrong
+  std::string storedPath = CURL(strPath).GetWithoutOptions();
+  URIUtils::RemoveSlashAtEnd(storedPath);
+
+  int ttl = GetPersistentTTL(storedPath);
+  if (ttl <= 0)
+    return false;
+
+  CFileItemList cached;
+  int64_t mtime = 0, size = 0, stored = 0;
+  {
+    CSingleLock lock(m_storeSection);
+    CFile file;
+    if (!file.Open(GetPersistentFile(storedPath)))
+      return false;
+
+    CArchive ar(&file, CArchive::load);
+    int version = 0;
+    std::string path;
+    long long value;
+    ar >> version;
+    if (version != PERSISTENT_CACHE_VERSION)
+      return false;
+    ar >> path;
+    if (path != storedPath)
+      return false; // hash collision
+    ar >> value; mtime = value;
+    ar >> value; size = value;
+    ar >> value; stored = value;
+    ar >> cached;
+  }
+
+  int64_t now = time(NULL);
+  if (now < stored || now - stored >= ttl)
+  {
+    // expired, so check whether the directory has changed since we listed it
+    struct __stat64 buffer;
+    if (CFile::Stat(storedPath, &buffer) != 0 || buffer.st_mtime != mtime || buffer.st_size != size)
+    {
+      CLog::Log(LOGDEBUG, "%s - %s changed, listing it again", __FUNCTION__, CURL::GetRedacted(storedPath).c_str());
+      DeletePersistent(storedPath);
+      return false;
+    }
+    WritePersistent(storedPath, cached, mtime, size);
+  }
+
+  items.Copy(cached);
+  return true;
+}
+
+void CDirectoryCache::SetPersistentDirectory(const std::string& strPath, const CFileItemList &items)
+{
+  // Get rid of any URL options, else the compare may be wrong
+  std::string storedPath = CURL(strPath).GetWithoutOptions();
+  URIUtils::RemoveSlashAtEnd(storedPath);
+
+  if (GetPersistentTTL(storedPath) <= 0)
+    return;
+
+  // without a modification time we'd have no way to tell when the listing is stale
+  struct __stat64 buffer;
+  if (CFile::Stat(storedPath, &buffer) != 0 || buffer.st_mtime == 0)
+    return;
+
+  WritePersistent(storedPath, items, buffer.st_mtime, buffer.st_size);
+}
+
+int CDirectoryCache::GetPersistentTTL(const std::string& storedPath)
+{
+  if (g_advancedSettings.m_directoryCacheTTL.empty())
+    return 0;
+
+  std::string protocol = CURL(storedPath).GetProtocol();
+  StringUtils::ToLower(protocol);
+  std::map<std::string, int>::const_iterator it = g_advancedSettings.m_directoryCacheTTL.find(protocol);
+  if (it == g_advancedSettings.m_directoryCacheTTL.end())
+    return 0;
+  return it->second;
+}
+
+std::string CDirectoryCache::GetPersistentFile(const std::string& storedPath)
+{
+  Crc32 crc;
+  crc.Compute(storedPath);
+  return StringUtils::Format(PERSISTENT_CACHE_PATH "%08x.fi", (unsigned __int32)crc);
+}
+
+void CDirectoryCache::WritePersistent(const std::string& storedPath, const CFileItemList &items, int64_t mtime, int64_t size)
+{
+  CSingleLock lock(m_storeSection);
+
+  CFile file;
+  if (!file.OpenForWrite(GetPersistentFile(storedPath), true))
+  {
+    // the folder is only created on first use
+    if (!CDirectory::Create(PERSISTENT_CACHE_PATH) || !file.OpenForWrite(GetPersistentFile(storedPath), true))
+      return;
+  }
+
+  CArchive ar(&file, CArchive::store);
+  ar << PERSISTENT_CACHE_VERSION;
+  ar << storedPath;
+  ar << (long long)mtime;
+  ar << (long long)size;
+  ar << (long long)time(NULL);
+  ar << const_cast<CFileItemList&>(items);
+}
+
+void CDirectoryCache::DeletePersistent(const std::string& storedPath)
+{
+  if (GetPersistentTTL(storedPath) <= 0)
+    return;
+
+  CSingleLock lock(m_storeSection);
+  std::string cacheFile = GetPersistentFile(storedPath);
+  if (CFile::Exists(cacheFile))
+    CFile::Delete(cacheFile);
+}
+
 void CDirectoryCache::Clear()
 {
   // this routine clears everything
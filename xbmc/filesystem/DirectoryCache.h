@@ -57,6 +57,17 @@ namespace XFILE
     void Clear();
     void AddFile(const std::string& strFile);
     bool FileExists(const std::string& strPath, bool& bInCache);
+
+    /*! \brief Get a listing from the persistent store.
+     Listings of protocols that have a TTL set in advancedsettings are kept on disk
+     across restarts. Within the TTL they are used as is, after it the directory is
+     only listed again if its modification time or size changed.
+     \param strPath the directory to look up.
+     \param items [out] the cached listing.
+     \return true if a valid listing was found, false otherwise.
+     */
+    bool GetPersistentDirectory(const std::string& strPath, CFileItemList &items);
+    void SetPersistentDirectory(const std::string& strPath, const CFileItemList &items);
 #ifdef _DEBUG
     void PrintStats() const;
 #endif
@@ -65,12 +76,18 @@ namespace XFILE
     void ClearCache(std::set<std::string>& dirs);
     void CheckIfFull();
 
+    static int GetPersistentTTL(const std::string& storedPath);
+    static std::string GetPersistentFile(const std::string& storedPath);
+    void WritePersistent(const std::string& storedPath, const CFileItemList &items, int64_t mtime, int64_t size);
+    void DeletePersistent(const std::string& storedPath);
+
     std::map<std::string, CDir*> m_cache;
     typedef std::map<std::string, CDir*>::iterator iCache;
     typedef std::map<std::string, CDir*>::const_iterator ciCache;
     void Delete(iCache i);
 
     CCriticalSection m_cs;
+    CCriticalSection m_storeSection; ///< serializes access to the persisted listings
 
     unsigned int m_accessCounter;
 
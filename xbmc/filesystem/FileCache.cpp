@@ -185,7 +185,15 @@ bool CFileCache::Open(const CURL& url)
 
   if (!m_pCache)
   {
-    if (g_advancedSettings.m_cacheMemBufferSize == 0)
+    if (g_advancedSettings.m_cacheDiskBufferSize > 0)
+    {
+      // Use a block indexed cache on disk that keeps data across seeks
+      size_t cacheSize = g_advancedSettings.m_cacheDiskBufferSize;
+      if (m_flags & READ_MULTI_STREAM)
+        cacheSize /= 2;
+      m_pCache = new CBlockFileCache(cacheSize);
+    }
+    else if (g_advancedSettings.m_cacheMemBufferSize == 0)
     {
       // Use cache on disk
       m_pCache = new CSimpleFileCache();
@@ -0,0 +1,135 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/CacheStrategy.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+const size_t BLOCK = 1024 * 1024;
+
+char Pattern(int64_t pos)
+{
+  return (char)((pos * 7 + pos / 251) & 0xff);
+}
+
+void Fill(CCacheStrategy &cache, int64_t from, int64_t to)
+{
+  std::vector<char> buf(64 * 1024);
+  int64_t pos = from;
+  while (pos < to)
+  {
+    size_t len = cache.GetMaxWriteSize(std::min((int64_t)buf.size(), to - pos));
+    ASSERT_GT(len, 0U);
+    for (size_t i = 0; i < len; i++)
+      buf[i] = Pattern(pos + i);
+    ASSERT_EQ((int)len, cache.WriteToCache(buf.data(), len));
+    pos += len;
+  }
+}
+
+void Drain(CCacheStrategy &cache, int64_t from, int64_t to)
+{
+  std::vector<char> buf(48 * 1024);
+  int64_t pos = from;
+  while (pos < to)
+  {
+    int len = cache.ReadFromCache(buf.data(), std::min((int64_t)buf.size(), to - pos));
+    ASSERT_GT(len, 0);
+    for (int i = 0; i < len; i++)
+      ASSERT_EQ(Pattern(pos + i), buf[i]) << "at " << pos + i;
+    pos += len;
+  }
+}
+}
+
+TEST(TestBlockFileCache, ReadWrite)
+{
+  CBlockFileCache cache(8 * BLOCK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Fill(cache, 0, 3 * BLOCK + 100);
+  EXPECT_EQ(3 * BLOCK + 100, cache.CachedDataEndPos());
+  Drain(cache, 0, 3 * BLOCK + 100);
+
+  char c;
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.ReadFromCache(&c, 1));
+  cache.EndOfInput();
+  EXPECT_EQ(0, cache.ReadFromCache(&c, 1));
+  cache.Close();
+}
+
+TEST(TestBlockFileCache, SeekBackKeepsData)
+{
+  CBlockFileCache cache(8 * BLOCK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Fill(cache, 0, 4 * BLOCK);
+  Drain(cache, 0, 4 * BLOCK);
+
+  // everything up to the write position is still on disk
+  EXPECT_TRUE(cache.IsCachedPosition(BLOCK / 2));
+  EXPECT_EQ(BLOCK / 2, cache.Seek(BLOCK / 2));
+  Drain(cache, BLOCK / 2, 4 * BLOCK);
+
+  // a seek past the cached data needs the source to restart there
+  EXPECT_FALSE(cache.IsCachedPosition(10 * BLOCK));
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(10 * BLOCK));
+  EXPECT_TRUE(cache.Reset(10 * BLOCK, false));
+  Fill(cache, 10 * BLOCK, 11 * BLOCK);
+  Drain(cache, 10 * BLOCK, 11 * BLOCK);
+
+  // data from before the jump survives and continues where it ended
+  EXPECT_EQ(4 * BLOCK, cache.CachedDataEndPosIfSeekTo(BLOCK));
+  EXPECT_FALSE(cache.Reset(BLOCK, false));
+  EXPECT_EQ(4 * BLOCK, cache.CachedDataEndPos());
+  Drain(cache, BLOCK, 4 * BLOCK);
+  Fill(cache, 4 * BLOCK, 5 * BLOCK);
+  Drain(cache, 4 * BLOCK, 5 * BLOCK);
+
+  cache.Close();
+}
+
+TEST(TestBlockFileCache, EvictsLeastRecentlyUsed)
+{
+  CBlockFileCache cache(4 * BLOCK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  // the budget holds four blocks, only three of them may be unread
+  Fill(cache, 0, 3 * BLOCK);
+  EXPECT_EQ(0U, cache.GetMaxWriteSize(BLOCK));
+  Drain(cache, 0, 2 * BLOCK);
+
+  Fill(cache, 3 * BLOCK, 5 * BLOCK);
+  Drain(cache, 2 * BLOCK, 5 * BLOCK);
+
+  // the first block was recycled, the more recent ones are still there
+  EXPECT_FALSE(cache.IsCachedPosition(0));
+  EXPECT_TRUE(cache.IsCachedPosition(2 * BLOCK));
+  EXPECT_TRUE(cache.Reset(0, true));
+  EXPECT_FALSE(cache.IsCachedPosition(2 * BLOCK));
+
+  cache.Close();
+}
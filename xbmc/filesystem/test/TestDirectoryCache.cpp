@@ -0,0 +1,78 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/File.h"
+#include "settings/AdvancedSettings.h"
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+// writes an advancedsettings.xml with the given <network> content and parses it
+void ParseNetwork(CAdvancedSettings &settings, const std::string &network)
+{
+  XFILE::CFile *file = XBMC_CREATETEMPFILE(".xml");
+  ASSERT_NE(nullptr, file);
+  std::string xml = "<advancedsettings><network>" + network + "</network>"
+                    "<jsonrpc><compactoutput>false</compactoutput></jsonrpc></advancedsettings>";
+  ASSERT_EQ((ssize_t)xml.size(), file->Write(xml.c_str(), xml.size()));
+  file->Close();
+
+  settings.ParseSettingsFile(XBMC_TEMPFILEPATH(file));
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+}
+
+TEST(TestDirectoryCache, TTLDefaults)
+{
+  CAdvancedSettings settings;
+  settings.Initialize();
+  EXPECT_TRUE(settings.m_directoryCacheTTL.empty());
+
+  // other network settings don't enable the store
+  ParseNetwork(settings, "<curlclienttimeout>20</curlclienttimeout>");
+  EXPECT_TRUE(settings.m_directoryCacheTTL.empty());
+}
+
+TEST(TestDirectoryCache, TTLParsing)
+{
+  CAdvancedSettings settings;
+  settings.Initialize();
+  ParseNetwork(settings,
+               "<directorycache>"
+                 "<ttl protocol=\"SMB\">3600</ttl>"
+                 "<ttl protocol=\"nfs\">60</ttl>"
+                 "<ttl protocol=\"upnp\">-5</ttl>"
+                 "<ttl>10</ttl>"
+                 "<ttl protocol=\"ftp\"></ttl>"
+               "</directorycache>"
+               "<cachemembuffersize>1234</cachemembuffersize>");
+
+  // protocols are lower cased, negative values clamped and incomplete entries ignored
+  ASSERT_EQ(3u, settings.m_directoryCacheTTL.size());
+  EXPECT_EQ(3600, settings.m_directoryCacheTTL["smb"]);
+  EXPECT_EQ(60, settings.m_directoryCacheTTL["nfs"]);
+  EXPECT_EQ(0, settings.m_directoryCacheTTL["upnp"]);
+
+  // the rest of the network block and the blocks after it are still parsed
+  EXPECT_EQ(1234u, settings.m_cacheMemBufferSize);
+  EXPECT_FALSE(settings.m_jsonOutputCompact);
+}
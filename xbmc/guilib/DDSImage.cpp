@@ -19,6 +19,9 @@
  */
 
 #include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <vector>
 #include "DDSImage.h"
 #include "XBTF.h"
 #include "utils/log.h"
@@ -86,6 +89,13 @@ unsigned char *CDDSImage::GetData() const
   return m_data;
 }
 
+unsigned int CDDSImage::GetMipmapCount() const
+{
+  if ((m_desc.flags & ddsd_mipmapcount) && m_desc.mipmapcount > 1)
+    return m_desc.mipmapcount;
+  return 1;
+}
+
 bool CDDSImage::ReadFile(const std::string &inputFile)
 {
   // open the file
@@ -102,19 +112,261 @@ bool CDDSImage::ReadFile(const std::string &inputFile)
   if (!GetFormat())
     return false;  // not supported
 
-  // allocate our data
-  m_data = new unsigned char[m_desc.linearSize];
+  // allocate our data, the top level followed by any mip levels
+  unsigned int size = GetDataSize();
+  delete[] m_data;
+  m_data = new unsigned char[size];
   if (!m_data)
     return false;
 
   // and read it in
-  if (file.Read(m_data, m_desc.linearSize) != m_desc.linearSize)
+  if (file.Read(m_data, size) != size)
     return false;
 
   file.Close();
   return true;
 }
 
+bool CDDSImage::WriteFile(const std::string &outputFile) const
+{
+  if (!m_data)
+    return false;
+
+  CFile file;
+  if (!file.OpenForWrite(outputFile, true))
+    return false;
+
+  unsigned int size = GetDataSize();
+  if (file.Write("DDS ", 4) != 4 ||
+      file.Write(&m_desc, sizeof(m_desc)) != sizeof(m_desc) ||
+      file.Write(m_data, size) != size)
+    return false;
+
+  file.Close();
+  return true;
+}
+
+namespace
+{
+// DXT endpoints are 5:6:5 with red in the high bits
+uint16_t PackColor(const unsigned char *bgr)
+{
+  return ((bgr[2] >> 3) << 11) | ((bgr[1] >> 2) << 5) | (bgr[0] >> 3);
+}
+
+void UnpackColor(uint16_t color, int *bgr)
+{
+  bgr[0] = ((color & 0x1f) << 3) | ((color & 0x1f) >> 2);
+  bgr[1] = (((color >> 5) & 0x3f) << 2) | (((color >> 5) & 0x3f) >> 4);
+  bgr[2] = ((color >> 11) << 3) | ((color >> 11) >> 2);
+}
+
+/*! \brief Compress a 4x4 BGRA block into an 8 byte DXT colour block
+ The endpoints are the corners of the block's bounding box, inset a little to
+ reduce the error of the in between entries, and each pixel takes the nearest of
+ the four palette entries. Always uses 4 colour mode so it's valid for DXT5 too.
+ */
+void CompressColorBlock(const unsigned char *block, unsigned char *out)
+{
+  unsigned char lo[3] = { 255, 255, 255 };
+  unsigned char hi[3] = { 0, 0, 0 };
+  for (int i = 0; i < 16; i++)
+  {
+    for (int c = 0; c < 3; c++)
+    {
+      lo[c] = std::min(lo[c], block[i * 4 + c]);
+      hi[c] = std::max(hi[c], block[i * 4 + c]);
+    }
+  }
+  for (int c = 0; c < 3; c++)
+  {
+    int inset = (hi[c] - lo[c]) >> 4;
+    lo[c] += inset;
+    hi[c] -= inset;
+  }
+
+  uint16_t color0 = PackColor(hi);
+  uint16_t color1 = PackColor(lo);
+  uint32_t indices = 0;
+  if (color0 != color1)
+  {
+    if (color0 < color1)
+      std::swap(color0, color1);
+
+    int palette[4][3];
+    UnpackColor(color0, palette[0]);
+    UnpackColor(color1, palette[1]);
+    for (int c = 0; c < 3; c++)
+    {
+      palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+      palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    for (int i = 0; i < 16; i++)
+    {
+      int best = 0;
+      int bestError = INT_MAX;
+      for (int p = 0; p < 4; p++)
+      {
+        int error = 0;
+        for (int c = 0; c < 3; c++)
+        {
+          int d = block[i * 4 + c] - palette[p][c];
+          error += d * d;
+        }
+        if (error < bestError)
+        {
+          bestError = error;
+          best = p;
+        }
+      }
+      indices |= best << (i * 2);
+    }
+  }
+
+  out[0] = color0 & 0xff;
+  out[1] = color0 >> 8;
+  out[2] = color1 & 0xff;
+  out[3] = color1 >> 8;
+  for (int i = 0; i < 4; i++)
+    out[4 + i] = (indices >> (i * 8)) & 0xff;
+}
+
+//! \brief Compress the alpha of a 4x4 BGRA block into an 8 byte DXT5 alpha block using the 8 alpha mode
+void CompressAlphaBlock(const unsigned char *block, unsigned char *out)
+{
+  int alpha0 = 0;
+  int alpha1 = 255;
+  for (int i = 0; i < 16; i++)
+  {
+    alpha0 = std::max(alpha0, (int)block[i * 4 + 3]);
+    alpha1 = std::min(alpha1, (int)block[i * 4 + 3]);
+  }
+
+  uint64_t indices = 0;
+  if (alpha0 != alpha1)
+  {
+    int palette[8];
+    palette[0] = alpha0;
+    palette[1] = alpha1;
+    for (int p = 1; p < 7; p++)
+      palette[p + 1] = ((7 - p) * alpha0 + p * alpha1) / 7;
+
+    for (int i = 0; i < 16; i++)
+    {
+      int best = 0;
+      int bestError = INT_MAX;
+      for (int p = 0; p < 8; p++)
+      {
+        int error = abs(block[i * 4 + 3] - palette[p]);
+        if (error < bestError)
+        {
+          bestError = error;
+          best = p;
+        }
+      }
+      indices |= (uint64_t)best << (i * 3);
+    }
+  }
+
+  out[0] = alpha0;
+  out[1] = alpha1;
+  for (int i = 0; i < 6; i++)
+    out[2 + i] = (indices >> (i * 8)) & 0xff;
+}
+
+//! \brief Halve a BGRA surface with a box filter, odd edges reuse their last row or column
+void Downsample(const unsigned char *src, unsigned int width, unsigned int height, unsigned int pitch,
+                unsigned char *dst, unsigned int dstWidth, unsigned int dstHeight)
+{
+  for (unsigned int y = 0; y < dstHeight; y++)
+  {
+    const unsigned char *row0 = src + std::min(y * 2, height - 1) * pitch;
+    const unsigned char *row1 = src + std::min(y * 2 + 1, height - 1) * pitch;
+    for (unsigned int x = 0; x < dstWidth; x++)
+    {
+      unsigned int x0 = std::min(x * 2, width - 1) * 4;
+      unsigned int x1 = std::min(x * 2 + 1, width - 1) * 4;
+      for (int c = 0; c < 4; c++)
+        *dst++ = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4;
+    }
+  }
+}
+}
+
+bool CDDSImage::Compress(unsigned int width, unsigned int height, unsigned int pitch, const unsigned char *bgra, bool mipmaps)
+{
+  if (!bgra || !width || !height)
+    return false;
+
+  bool hasAlpha = false;
+  for (unsigned int y = 0; y < height && !hasAlpha; y++)
+  {
+    const unsigned char *row = bgra + y * pitch;
+    for (unsigned int x = 0; x < width; x++)
+    {
+      if (row[x * 4 + 3] != 0xff)
+      {
+        hasAlpha = true;
+        break;
+      }
+    }
+  }
+
+  unsigned int levels = 1;
+  if (mipmaps)
+  {
+    while ((width >> levels) || (height >> levels))
+      levels++;
+  }
+  unsigned int format = hasAlpha ? XB_FMT_DXT5 : XB_FMT_DXT1;
+  Allocate(width, height, format, levels);
+  if (!m_data)
+    return false;
+
+  std::vector<unsigned char> mip;
+  std::vector<unsigned char> next;
+  unsigned char *out = m_data;
+  for (unsigned int level = 0; level < levels; level++)
+  {
+    if (level)
+    { // build this level from the one before
+      unsigned int mipWidth = std::max(width >> 1, 1U);
+      unsigned int mipHeight = std::max(height >> 1, 1U);
+      next.resize(mipWidth * mipHeight * 4);
+      Downsample(bgra, width, height, pitch, &next[0], mipWidth, mipHeight);
+      mip.swap(next);
+      width = mipWidth;
+      height = mipHeight;
+      pitch = width * 4;
+      bgra = &mip[0];
+    }
+
+    for (unsigned int by = 0; by < height; by += 4)
+    {
+      for (unsigned int bx = 0; bx < width; bx += 4)
+      {
+        // gather the block, replicating the edge pixels of partial blocks
+        unsigned char block[64];
+        for (unsigned int y = 0; y < 4; y++)
+        {
+          const unsigned char *row = bgra + std::min(by + y, height - 1) * pitch;
+          for (unsigned int x = 0; x < 4; x++)
+            memcpy(block + (y * 4 + x) * 4, row + std::min(bx + x, width - 1) * 4, 4);
+        }
+        if (hasAlpha)
+        {
+          CompressAlphaBlock(block, out);
+          out += 8;
+        }
+        CompressColorBlock(block, out);
+        out += 8;
+      }
+    }
+  }
+  return true;
+}
+
 unsigned int CDDSImage::GetStorageRequirements(unsigned int width, unsigned int height, unsigned int format)
 {
   switch (format)
@@ -130,7 +382,16 @@ unsigned int CDDSImage::GetStorageRequirements(unsigned int width, unsigned int
   }
 }
 
-void CDDSImage::Allocate(unsigned int width, unsigned int height, unsigned int format)
+unsigned int CDDSImage::GetDataSize() const
+{
+  unsigned int format = GetFormat();
+  unsigned int size = m_desc.linearSize;
+  for (unsigned int level = 1; level < GetMipmapCount(); level++)
+    size += GetStorageRequirements(std::max(m_desc.width >> level, 1U), std::max(m_desc.height >> level, 1U), format);
+  return size;
+}
+
+void CDDSImage::Allocate(unsigned int width, unsigned int height, unsigned int format, unsigned int mipmaps)
 {
   memset(&m_desc, 0, sizeof(m_desc));
   m_desc.size = sizeof(m_desc);
@@ -142,8 +403,14 @@ void CDDSImage::Allocate(unsigned int width, unsigned int height, unsigned int f
   m_desc.pixelFormat.flags = ddpf_fourcc;
   memcpy(&m_desc.pixelFormat.fourcc, GetFourCC(format), 4);
   m_desc.caps.flags1 = ddscaps_texture;
+  if (mipmaps > 1)
+  {
+    m_desc.flags |= ddsd_mipmapcount;
+    m_desc.mipmapcount = mipmaps;
+    m_desc.caps.flags1 |= ddscaps_complex | ddscaps_mipmap;
+  }
   delete[] m_data;
-  m_data = new unsigned char[m_desc.linearSize];
+  m_data = new unsigned char[GetDataSize()];
 }
 
 const char *CDDSImage::GetFourCC(unsigned int format)
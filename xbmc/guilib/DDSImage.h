@@ -35,11 +35,26 @@ public:
   unsigned int GetFormat() const;
   unsigned int GetSize() const;
   unsigned char *GetData() const;
+  /*! \brief number of mip levels in GetData(), the top level followed by each smaller level in turn */
+  unsigned int GetMipmapCount() const;
 
   bool ReadFile(const std::string &file);
+  bool WriteFile(const std::string &file) const;
+
+  /*! \brief Compress a 32bit BGRA surface to DXT blocks
+   Opaque surfaces are stored as DXT1, those with any alpha as DXT5.
+   \param width width of the surface.
+   \param height height of the surface.
+   \param pitch bytes per row of the surface.
+   \param bgra the surface to compress.
+   \param mipmaps whether to generate the mip chain down to 1x1.
+   \return true if the surface was compressed.
+   */
+  bool Compress(unsigned int width, unsigned int height, unsigned int pitch, const unsigned char *bgra, bool mipmaps);
 
 private:
-  void Allocate(unsigned int width, unsigned int height, unsigned int format);
+  void Allocate(unsigned int width, unsigned int height, unsigned int format, unsigned int mipmaps = 1);
+  unsigned int GetDataSize() const;
   static const char *GetFourCC(unsigned int format);
 
   static unsigned int GetStorageRequirements(unsigned int width, unsigned int height, unsigned int format);
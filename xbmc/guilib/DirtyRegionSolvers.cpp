@@ -20,6 +20,9 @@
 
 #include "DirtyRegionSolvers.h"
 #include "GraphicContext.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <stdio.h>
 
 void CUnionDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
@@ -81,3 +84,70 @@ void CGreedyDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegion
       output.push_back(currentRegion);
   }
 }
+
+CClusterDirtyRegionSolver::CClusterDirtyRegionSolver(unsigned int maxRegions, float costNewRegion)
+{
+  m_maxRegions    = std::max(maxRegions, 1U);
+  m_costNewRegion = costNewRegion;
+}
+
+void CClusterDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
+{
+  // scissors are whole pixels, so snap outwards first to not have regions overlap once rounded
+  CDirtyRegionList regions;
+  for (unsigned int i = 0; i < input.size(); i++)
+  {
+    if (input[i].IsEmpty())
+      continue;
+    CDirtyRegion region(floorf(input[i].x1), floorf(input[i].y1), ceilf(input[i].x2), ceilf(input[i].y2));
+
+    // buffering marks the same regions over several frames, drop anything already covered
+    bool covered = false;
+    for (unsigned int j = 0; j < regions.size() && !covered; j++)
+    {
+      CDirtyRegion temporaryUnion = regions[j];
+      temporaryUnion.Union(region);
+      covered = !(temporaryUnion != regions[j]);
+    }
+    if (!covered)
+      regions.push_back(region);
+  }
+
+  while (regions.size() > 1)
+  {
+    int   bestFirst  = -1;
+    int   bestSecond = -1;
+    float bestGain   = -FLT_MAX;
+
+    for (unsigned int i = 0; i < regions.size(); i++)
+    {
+      for (unsigned int j = i + 1; j < regions.size(); j++)
+      {
+        CDirtyRegion intersection = regions[i];
+        intersection.Intersect(regions[j]);
+        CDirtyRegion temporaryUnion = regions[i];
+        temporaryUnion.Union(regions[j]);
+
+        // an overlap would be drawn twice, so these have to go together whatever the cost
+        float gain = FLT_MAX;
+        if (intersection.IsEmpty())
+          gain = m_costNewRegion - (temporaryUnion.Area() - regions[i].Area() - regions[j].Area());
+
+        if (gain > bestGain)
+        {
+          bestFirst  = i;
+          bestSecond = j;
+          bestGain   = gain;
+        }
+      }
+    }
+
+    if (bestGain <= 0.0f && regions.size() <= m_maxRegions)
+      break;
+
+    regions[bestFirst].Union(regions[bestSecond]);
+    regions.erase(regions.begin() + bestSecond);
+  }
+
+  output.insert(output.end(), regions.begin(), regions.end());
+}
@@ -48,3 +48,20 @@ private:
   float m_costNewRegion;
   float m_costPerArea;
 };
+
+/*! \brief Clusters dirty regions into a few non-overlapping rendering passes
+ Regions are merged pairwise, cheapest first, for as long as the pixels a merge adds
+ cost less than the extra rendering pass it saves, and until no more than maxRegions
+ passes remain. Overlapping regions are always merged so that no pixel is drawn twice.
+ \param maxRegions the maximum number of rendering passes to output
+ \param costNewRegion the cost of a rendering pass, in redrawn pixels
+ */
+class CClusterDirtyRegionSolver : public IDirtyRegionSolver
+{
+public:
+  CClusterDirtyRegionSolver(unsigned int maxRegions = 4, float costNewRegion = 40000.0f);
+  virtual void Solve(const CDirtyRegionList &input, CDirtyRegionList &output);
+private:
+  unsigned int m_maxRegions;
+  float m_costNewRegion;
+};
@@ -49,6 +49,10 @@ void CDirtyRegionTracker::SelectAlgorithm()
       CLog::Log(LOGDEBUG, "guilib: Cost reduction as algorithm for solving rendering passes");
       m_solver = new CGreedyDirtyRegionSolver();
       break;
+    case DIRTYREGION_SOLVER_CLUSTER:
+      CLog::Log(LOGDEBUG, "guilib: Clustering as algorithm for solving rendering passes");
+      m_solver = new CClusterDirtyRegionSolver();
+      break;
     case DIRTYREGION_SOLVER_UNION:
       m_solver = new CUnionDirtyRegionSolver();
       CLog::Log(LOGDEBUG, "guilib: Union as algorithm for solving rendering passes");
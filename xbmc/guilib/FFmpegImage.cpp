@@ -134,6 +134,56 @@ static int64_t mem_file_seek(void *h, int64_t pos, int whence)
   return mbuf->pos;
 }
 
+// walk the marker segments up to the first start of frame to get the coded size
+// without decoding anything
+static bool GetJpegDimensions(const unsigned char* buffer, unsigned int bufSize, unsigned int &width, unsigned int &height)
+{
+  unsigned int pos = 2;
+  while (pos + 4 <= bufSize)
+  {
+    if (buffer[pos] != 0xFF)
+      return false;
+    unsigned char marker = buffer[pos + 1];
+    if (marker == 0xFF) // fill byte
+    {
+      pos++;
+      continue;
+    }
+    if (marker == 0xD9 || marker == 0xDA) // end of image or start of scan before any frame header
+      return false;
+
+    unsigned int length = (buffer[pos + 2] << 8) | buffer[pos + 3];
+    // SOF0-SOF15 except DHT, JPG and DAC which share the range
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+    {
+      if (pos + 9 > bufSize || length < 7)
+        return false;
+      height = (buffer[pos + 5] << 8) | buffer[pos + 6];
+      width = (buffer[pos + 7] << 8) | buffer[pos + 8];
+      return width > 0 && height > 0;
+    }
+    pos += 2 + length;
+  }
+  return false;
+}
+
+int CFFmpegImage::GetLowResolution(unsigned int srcWidth, unsigned int srcHeight,
+                                   unsigned int width, unsigned int height, int maxLowres)
+{
+  if (!srcWidth || !srcHeight || !width || !height)
+    return 0;
+
+  // the decoded image gets fitted into width x height, keep at least that many pixels
+  float scale = std::min(width / (float)srcWidth, height / (float)srcHeight);
+
+  int lowres = 0;
+  while (lowres < maxLowres &&
+         (srcWidth >> (lowres + 1)) >= srcWidth * scale &&
+         (srcHeight >> (lowres + 1)) >= srcHeight * scale)
+    lowres++;
+  return lowres;
+}
+
 CFFmpegImage::CFFmpegImage(const std::string& strMimeType) : m_strMimeType(strMimeType)
 {
   m_hasAlpha = false;
@@ -166,7 +216,7 @@ bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSi
                                       unsigned int width, unsigned int height)
 {
     
-  if (!Initialize(buffer, bufSize))
+  if (!Initialize(buffer, bufSize, width, height))
   {
     //log
     return false;
@@ -174,11 +224,31 @@ bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSi
 
   av_frame_free(&m_pFrame);
   m_pFrame = ExtractFrame();
+  if (!m_pFrame)
+    return false;
 
-  return !(m_pFrame == nullptr);
+  // report the size we are going to scale to in Decode so the caller doesn't
+  // allocate (and we don't convert) more than was asked for
+  if (width && height && (m_width > width || m_height > height))
+  {
+    float ratio = m_width / (float)m_height;
+    if (m_height > height)
+    {
+      m_height = height;
+      m_width = std::max(1u, (unsigned int)(m_height * ratio + 0.5f));
+    }
+    if (m_width > width)
+    {
+      m_width = width;
+      m_height = std::max(1u, (unsigned int)(m_width / ratio + 0.5f));
+    }
+  }
+
+  return true;
 }
 
-bool CFFmpegImage::Initialize(unsigned char* buffer, unsigned int bufSize)
+bool CFFmpegImage::Initialize(unsigned char* buffer, unsigned int bufSize,
+                              unsigned int width /* = 0 */, unsigned int height /* = 0 */)
 {
   uint8_t* fbuffer = (uint8_t*)av_malloc(FFMPEG_FILE_BUFFER_SIZE);
   if (!fbuffer)
@@ -251,6 +321,22 @@ bool CFFmpegImage::Initialize(unsigned char* buffer, unsigned int bufSize)
 
   AVCodecContext* codec_ctx = m_fctx->streams[0]->codec;
   AVCodec* codec = avcodec_find_decoder(codec_ctx->codec_id);
+
+  // jpeg can be decoded at 1/2, 1/4 or 1/8 of its size in the DCT domain, which is
+  // a lot cheaper than decoding everything and throwing most of it away in sws_scale
+  unsigned int srcWidth = 0, srcHeight = 0;
+  if (is_jpeg && codec && av_codec_get_max_lowres(codec) > 0 &&
+      GetJpegDimensions(buffer, bufSize, srcWidth, srcHeight))
+  {
+    int lowres = GetLowResolution(srcWidth, srcHeight, width, height, av_codec_get_max_lowres(codec));
+    if (lowres > 0)
+    {
+      av_codec_set_lowres(codec_ctx, lowres);
+      m_originalWidth = srcWidth;
+      m_originalHeight = srcHeight;
+    }
+  }
+
   if (avcodec_open2(codec_ctx, codec, NULL) < 0)
   {
     avformat_close_input(&m_fctx);
@@ -287,8 +373,12 @@ AVFrame* CFFmpegImage::ExtractFrame()
       av_frame_set_pkt_duration(frame, av_rescale_q(frame->pkt_duration, m_fctx->streams[0]->time_base, AVRational{ 1, 1000 }));
       m_height = frame->height;
       m_width = frame->width;
-      m_originalWidth = m_width;
-      m_originalHeight = m_height;
+      // a reduced resolution decode keeps the coded size from the header
+      if (!av_codec_get_lowres(m_fctx->streams[0]->codec))
+      {
+        m_originalWidth = m_width;
+        m_originalHeight = m_height;
+      }
 
       const AVPixFmtDescriptor* pixDescriptor = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
       if (pixDescriptor && ((pixDescriptor->flags & (AV_PIX_FMT_FLAG_ALPHA | AV_PIX_FMT_FLAG_PAL)) != 0))
@@ -370,7 +460,9 @@ bool CFFmpegImage::Decode(unsigned char * const pixels, unsigned int width, unsi
     return false;
   }
 
-  return DecodeFrame(m_pFrame, width, height, pitch, pixels);
+  // the texture is usually allocated larger (power of two, padded rows) than
+  // the size reported by Width()/Height(), never scale beyond that
+  return DecodeFrame(m_pFrame, std::min(width, m_width), std::min(height, m_height), pitch, pixels);
 }
 
 bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int height, unsigned int pitch, unsigned char * const pixels)
@@ -415,9 +507,9 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
   AVPixelFormat pixFormat = ConvertFormats(frame);
 
   // assumption quadratic maximums e.g. 2048x2048
-  float ratio = m_width / (float)m_height;
-  unsigned int nHeight = m_originalHeight;
-  unsigned int nWidth = m_originalWidth;
+  float ratio = frame->width / (float)frame->height;
+  unsigned int nHeight = frame->height;
+  unsigned int nWidth = frame->width;
   if (nHeight > height)
   {
     nHeight = height;
@@ -429,7 +521,7 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
     nHeight = (unsigned int)(nWidth / ratio + 0.5f);
   }
 
-  struct SwsContext* context = sws_getContext(m_originalWidth, m_originalHeight, pixFormat,
+  struct SwsContext* context = sws_getContext(frame->width, frame->height, pixFormat,
     nWidth, nHeight, AV_PIX_FMT_RGB32, SWS_BICUBIC, NULL, NULL, NULL);
 
   if (range == AVCOL_RANGE_JPEG)
@@ -442,7 +534,7 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
     sws_setColorspaceDetails(context, inv_table, srcRange, table, dstRange, brightness, contrast, saturation);
   }
 
-  sws_scale(context, frame->data, frame->linesize, 0, m_originalHeight,
+  sws_scale(context, frame->data, frame->linesize, 0, frame->height,
     pictureRGB->data, pictureRGB->linesize);
   sws_freeContext(context);
 
@@ -79,7 +79,13 @@ public:
                                           unsigned int &bufferoutSize);
   virtual void ReleaseThumbnailBuffer();
 
-  bool Initialize(unsigned char* buffer, unsigned int bufSize);
+  /*!
+   \brief Open the image data for decoding
+   \param width,height The size the image is going to be scaled to, 0 for full size.
+          Decoders that support it (jpeg) decode at the smallest reduced resolution
+          that still covers it, originalWidth()/originalHeight() stay at the coded size.
+   */
+  bool Initialize(unsigned char* buffer, unsigned int bufSize, unsigned int width = 0, unsigned int height = 0);
 
   std::shared_ptr<Frame> ReadFrame();
 
@@ -88,6 +94,8 @@ private:
   AVFrame* ExtractFrame();
   bool DecodeFrame(AVFrame* m_pFrame, unsigned int width, unsigned int height, unsigned int pitch, unsigned char * const pixels);
   static AVPixelFormat ConvertFormats(AVFrame* frame);
+  static int GetLowResolution(unsigned int srcWidth, unsigned int srcHeight,
+                              unsigned int width, unsigned int height, int maxLowres);
   std::string m_strMimeType;
   void CleanupLocalOutputBuffer();
 
@@ -56,6 +56,7 @@ CGUIBaseContainer::CGUIBaseContainer(int parentID, int controlID, float posX, fl
   m_scrollItemsPerFrame = 0.0f;
   m_type = VIEW_TYPE_NONE;
   m_listProvider = NULL;
+  m_pageSize = 0;
   m_autoScrollMoveTime = 0;
   m_autoScrollDelayTime = 0;
   m_autoScrollIsReversed = false;
@@ -104,6 +105,9 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
   // Free memory not used on screen
   if ((int)m_items.size() > m_itemsPerPage + cacheBefore + cacheAfter)
     FreeMemory(CorrectOffset(offset - cacheBefore, 0), CorrectOffset(offset + m_itemsPerPage + 1 + cacheAfter, 0));
+  // and fetch the pages of a paged list that are needed
+  if (m_pageSize)
+    UpdatePages(CorrectOffset(offset - cacheBefore, 0), CorrectOffset(offset + m_itemsPerPage + 1 + cacheAfter, 0));
 
   CPoint origin = CPoint(m_posX, m_posY) + m_renderOffset;
   float pos = (m_orientation == VERTICAL) ? origin.y : origin.x;
@@ -458,7 +462,10 @@ bool CGUIBaseContainer::OnMessage(CGUIMessage& message)
     else if (message.GetMessage() == GUI_MSG_REFRESH_LIST)
     { // update our list contents
       for (unsigned int i = 0; i < m_items.size(); ++i)
-        m_items[i]->SetInvalid();
+      {
+        if (m_items[i])
+          m_items[i]->SetInvalid();
+      }
     }
     else if (message.GetMessage() == GUI_MSG_MOVE_OFFSET)
     {
@@ -760,7 +767,7 @@ bool CGUIBaseContainer::OnClick(int actionID)
     if (m_listProvider)
     { // "select" action
       int selected = GetSelectedItem();
-      if (selected >= 0 && selected < (int)m_items.size())
+      if (selected >= 0 && selected < (int)m_items.size() && m_items[selected])
       {
         if (m_clickActions.HasAnyActions())
           m_clickActions.ExecuteActions(0, GetParentID(), m_items[selected]);
@@ -783,7 +790,7 @@ std::string CGUIBaseContainer::GetDescription() const
 {
   std::string strLabel;
   int item = GetSelectedItem();
-  if (item >= 0 && item < (int)m_items.size())
+  if (item >= 0 && item < (int)m_items.size() && m_items[item])
   {
     CGUIListItemPtr pItem = m_items[item];
     if (pItem->m_bIsFolder)
@@ -855,7 +862,10 @@ void CGUIBaseContainer::UpdateLayout(bool updateAllItems)
   if (updateAllItems)
   { // free memory of items
     for (iItems it = m_items.begin(); it != m_items.end(); ++it)
-      (*it)->FreeMemory();
+    {
+      if (*it)
+        (*it)->FreeMemory();
+    }
   }
   // and recalculate the layout
   CalculateLayout();
@@ -911,11 +921,17 @@ void CGUIBaseContainer::UpdateListProvider(bool forceRefresh /* = false */)
       int currentItem = GetSelectedItem();
       CGUIListItem *current = (currentItem >= 0 && currentItem < (int)m_items.size()) ? m_items[currentItem].get() : NULL;
       Reset();
-      m_listProvider->Fetch(m_items);
+      if (m_listProvider->IsPaged())
+      { // only the pages in view are fetched, see UpdatePages
+        m_pageSize = m_listProvider->GetPageSize();
+        m_items.resize(m_listProvider->GetItemCount());
+      }
+      else
+        m_listProvider->Fetch(m_items);
       SetPageControlRange();
       // update the newly selected item
       bool found = false;
-      for (int i = 0; i < (int)m_items.size(); i++)
+      for (int i = 0; current && i < (int)m_items.size(); i++)
       {
         if (m_items[i].get() == current)
         {
@@ -960,6 +976,10 @@ void CGUIBaseContainer::UpdateScrollByLetter()
 {
   m_letterOffsets.clear();
 
+  // a paged list doesn't have all the labels at hand
+  if (m_pageSize)
+    return;
+
   // for scrolling by letter we have an offset table into our vector.
   std::string currentMatch;
   for (unsigned int i = 0; i < m_items.size(); i++)
@@ -1087,6 +1107,9 @@ void CGUIBaseContainer::Reset()
   m_wasReset = true;
   m_items.clear();
   m_lastItem.reset();
+  m_pageSize = 0;
+  m_loadedPages.clear();
+  m_pendingPages.clear();
   ResetAutoScrolling();
 }
 
@@ -1135,17 +1158,111 @@ void CGUIBaseContainer::FreeMemory(int keepStart, int keepEnd)
   if (keepStart < keepEnd)
   { // remove before keepStart and after keepEnd
     for (int i = 0; i < keepStart && i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+    {
+      if (m_items[i])
+        m_items[i]->FreeMemory();
+    }
     for (int i = std::max(keepEnd + 1, 0); i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+    {
+      if (m_items[i])
+        m_items[i]->FreeMemory();
+    }
   }
   else
   { // wrapping
     for (int i = std::max(keepEnd + 1, 0); i < keepStart && i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+    {
+      if (m_items[i])
+        m_items[i]->FreeMemory();
+    }
+  }
+}
+
+void CGUIBaseContainer::UpdatePages(int keepStart, int keepEnd)
+{
+  // wrapping lists append copies of their items when they have too few, those aren't
+  // paged themselves, an offset into them is the same as one into the items copied
+  int numItems = GetNumItems();
+  if (!m_pageSize || !m_listProvider || numItems <= 0)
+    return;
+  if (numItems < (int)m_items.size())
+  {
+    keepStart %= numItems;
+    keepEnd %= numItems;
+  }
+
+  // the pages in view, and half a page either side of it so that they are ready when scrolling
+  int margin = m_pageSize / 2;
+  int lastPage = (numItems - 1) / m_pageSize;
+  std::set<unsigned int> wanted;
+  if (keepStart <= keepEnd)
+  {
+    for (int page = std::max(keepStart - margin, 0) / m_pageSize; page <= std::min((keepEnd + margin) / (int)m_pageSize, lastPage); page++)
+      wanted.insert(page);
+  }
+  else
+  { // wrapping
+    for (int page = 0; page <= std::min((keepEnd + margin) / (int)m_pageSize, lastPage); page++)
+      wanted.insert(page);
+    for (int page = std::max(keepStart - margin, 0) / m_pageSize; page <= lastPage; page++)
+      wanted.insert(page);
+  }
+
+  // drop the pages that are out of view
+  for (std::set<unsigned int>::iterator page = m_loadedPages.begin(); page != m_loadedPages.end();)
+  {
+    if (wanted.find(*page) == wanted.end())
+    {
+      ClearPage(*page);
+      page = m_loadedPages.erase(page);
+    }
+    else
+      ++page;
+  }
+  for (std::set<unsigned int>::iterator page = m_pendingPages.begin(); page != m_pendingPages.end();)
+  {
+    if (wanted.find(*page) == wanted.end())
+    {
+      ClearPage(*page);
+      page = m_pendingPages.erase(page);
+    }
+    else
+      ++page;
+  }
+
+  // and fetch those that came into view. Pages on their way are shown as empty items
+  for (std::set<unsigned int>::const_iterator page = wanted.begin(); page != wanted.end(); ++page)
+  {
+    if (m_loadedPages.find(*page) != m_loadedPages.end())
+      continue;
+
+    unsigned int start = *page * m_pageSize;
+    unsigned int end = std::min(start + m_pageSize, (unsigned int)m_items.size());
+    std::vector<CGUIListItemPtr> items;
+    if (m_listProvider->FetchPage(*page, items))
+    {
+      for (unsigned int i = start; i < end; i++)
+        m_items[i] = i - start < items.size() ? items[i - start] : CGUIListItemPtr(new CFileItem);
+      m_loadedPages.insert(*page);
+      m_pendingPages.erase(*page);
+      MarkDirtyRegion();
+    }
+    else if (m_pendingPages.insert(*page).second)
+    {
+      for (unsigned int i = start; i < end; i++)
+        m_items[i].reset(new CFileItem);
+    }
   }
 }
 
+void CGUIBaseContainer::ClearPage(unsigned int page)
+{
+  unsigned int start = page * m_pageSize;
+  unsigned int end = std::min(start + m_pageSize, (unsigned int)m_items.size());
+  for (unsigned int i = start; i < end; i++)
+    m_items[i].reset();
+}
+
 bool CGUIBaseContainer::InsideLayout(const CGUIListItemLayout *layout, const CPoint &point) const
 {
   if (!layout) return false;
@@ -1162,6 +1279,7 @@ void CGUIBaseContainer::DumpTextureUse()
   for (unsigned int i = 0; i < m_items.size(); ++i)
   {
     CGUIListItemPtr item = m_items[i];
+    if (!item) continue;
     if (item->GetFocusedLayout()) item->GetFocusedLayout()->DumpTextureUse();
     if (item->GetLayout()) item->GetLayout()->DumpTextureUse();
   }
@@ -1183,7 +1301,7 @@ bool CGUIBaseContainer::GetCondition(int condition, int data) const
   case CONTAINER_HAS_PREVIOUS:
     return (HasPreviousPage());
   case CONTAINER_HAS_PARENT_ITEM:
-    return (m_items.size() && m_items[0]->IsFileItem() && (std::static_pointer_cast<CFileItem>(m_items[0]))->IsParentFolder());
+    return (m_items.size() && m_items[0] && m_items[0]->IsFileItem() && (std::static_pointer_cast<CFileItem>(m_items[0]))->IsParentFolder());
   case CONTAINER_SUBITEM:
     {
       CGUIListItemLayout *layout = GetFocusedLayout();
@@ -1251,7 +1369,7 @@ std::string CGUIBaseContainer::GetLabel(int info) const
     break;
   case CONTAINER_CURRENT_ITEM:
     {
-      if (m_items.size() && m_items[0]->IsFileItem() && (std::static_pointer_cast<CFileItem>(m_items[0]))->IsParentFolder())
+      if (m_items.size() && m_items[0] && m_items[0]->IsFileItem() && (std::static_pointer_cast<CFileItem>(m_items[0]))->IsParentFolder())
         label = StringUtils::Format("%i", GetSelectedItem());
       else
         label = StringUtils::Format("%i", GetSelectedItem() + 1);
@@ -1260,7 +1378,7 @@ std::string CGUIBaseContainer::GetLabel(int info) const
   case CONTAINER_NUM_ITEMS:
     {
       unsigned int numItems = GetNumItems();
-      if (numItems && m_items[0]->IsFileItem() && (std::static_pointer_cast<CFileItem>(m_items[0]))->IsParentFolder())
+      if (numItems && m_items[0] && m_items[0]->IsFileItem() && (std::static_pointer_cast<CFileItem>(m_items[0]))->IsParentFolder())
         label = StringUtils::Format("%u", numItems-1);
       else
         label = StringUtils::Format("%u", numItems);
@@ -25,6 +25,7 @@
  *
  */
 
+#include <set>
 #include <utility>
 
 #include "GUIListItemLayout.h"
@@ -135,6 +136,15 @@ protected:
   inline float Size() const;
   void MoveToRow(int row);
   void FreeMemory(int keepStart, int keepEnd);
+  /*! \brief Fetch the pages of a paged list provider around the given range and drop the others
+   Items of pages that are not in view are NULL, and items of pages that are still on their way
+   are empty placeholders.
+   \param keepStart the first item in view
+   \param keepEnd the last item in view
+   \sa IListProvider::IsPaged
+   */
+  void UpdatePages(int keepStart, int keepEnd);
+  void ClearPage(unsigned int page);
   void GetCurrentLayouts();
   CGUIListItemLayout *GetFocusedLayout() const;
 
@@ -165,6 +175,9 @@ protected:
   CScroller m_scroller;
 
   IListProvider *m_listProvider;
+  unsigned int m_pageSize;               ///< items per page if the list provider is paged, 0 otherwise
+  std::set<unsigned int> m_loadedPages;
+  std::set<unsigned int> m_pendingPages; ///< pages requested from the list provider
 
   bool m_wasReset;  // true if we've received a Reset message until we've rendered once.  Allows
                     // us to make sure we don't tell the infomanager that we've been moving when
@@ -195,8 +195,17 @@ void CGUIControl::DoRender()
       CGUITexture::DrawQuad(g_graphicsContext.generateAABB(m_hitRect), color);
     }
 
+    // controls drawing through their own renderers can't be batched with textures
+    bool foreignRender = ControlType == GUICONTROL_VIDEO || ControlType == GUICONTROL_VISUALISATION ||
+                         ControlType == GUICONTROL_RENDERADDON || ControlType == GUICONTROL_UNKNOWN;
+    if (foreignRender)
+      CGUITexture::FlushBatch();
+
     Render();
 
+    if (foreignRender)
+      CGUITexture::FlushBatch();
+
     GUIPROFILER_RENDER_END(this);
 
     if (hasStereo)
@@ -24,6 +24,7 @@
 #include <utility>
 
 #include "guiinfo/GUIInfoLabels.h"
+#include "GUITexture.h"
 
 CGUIControlGroup::CGUIControlGroup()
 {
@@ -120,6 +121,8 @@ void CGUIControlGroup::Render()
 {
   CPoint pos(GetPosition());
   g_graphicsContext.SetOrigin(pos.x, pos.y);
+  // children sharing textures (list items, panel icons) are drawn together
+  CGUITexture::BeginBatch();
   CGUIControl *focusedControl = NULL;
   for (iControls it = m_children.begin(); it != m_children.end(); ++it)
   {
@@ -132,6 +135,7 @@ void CGUIControlGroup::Render()
   if (focusedControl)
     focusedControl->DoRender();
   CGUIControl::Render();
+  CGUITexture::EndBatch();
   g_graphicsContext.RestoreOrigin();
 }
 
@@ -23,10 +23,13 @@
 #include "utils/TimeUtils.h"
 #include "utils/StringUtils.h"
 
+#include <algorithm>
+#include <vector>
+
 bool CGUIControlProfiler::m_bIsRunning = false;
 
 CGUIControlProfilerItem::CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl)
-: m_pProfiler(pProfiler), m_pParent(pParent), m_pControl(pControl), m_visTime(0), m_renderTime(0), m_i64VisStart(0), m_i64RenderStart(0)
+: m_pProfiler(pProfiler), m_pParent(pParent), m_pControl(pControl), m_visTime(0), m_renderTime(0), m_drawCalls(0), m_i64VisStart(0), m_i64RenderStart(0), m_drawCallStart(0)
 {
   if (m_pControl)
   {
@@ -54,6 +57,7 @@ void CGUIControlProfilerItem::Reset(CGUIControlProfiler *pProfiler)
 
   m_visTime = 0;
   m_renderTime = 0;
+  m_drawCalls = 0;
   const unsigned int dwSize = m_vecChildren.size();
   for (unsigned int i=0; i<dwSize; ++i)
     delete m_vecChildren[i];
@@ -75,11 +79,13 @@ void CGUIControlProfilerItem::EndVisibility(void)
 void CGUIControlProfilerItem::BeginRender(void)
 {
   m_i64RenderStart = CurrentHostCounter();
+  m_drawCallStart = m_pProfiler->GetDrawCalls();
 }
 
 void CGUIControlProfilerItem::EndRender(void)
 {
   m_renderTime += (unsigned int)(m_pProfiler->m_fPerfScale * (CurrentHostCounter() - m_i64RenderStart));
+  m_drawCalls += m_pProfiler->GetDrawCalls() - m_drawCallStart;
 }
 
 void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
@@ -202,6 +208,16 @@ void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
     elem->LinkEndChild(text);
   }
 
+  // draw calls are reported per frame
+  if (m_drawCalls && m_pProfiler->GetFrameCount())
+  {
+    TiXmlElement *elem = new TiXmlElement("drawcalls");
+    xmlControl->LinkEndChild(elem);
+    std::string val = StringUtils::Format("%.1f", (float)m_drawCalls / m_pProfiler->GetFrameCount());
+    TiXmlText *text = new TiXmlText(val.c_str());
+    elem->LinkEndChild(text);
+  }
+
   if (m_vecChildren.size())
   {
     TiXmlElement *xmlChilds = new TiXmlElement("children");
@@ -237,7 +253,7 @@ CGUIControlProfilerItem *CGUIControlProfilerItem::FindOrAddControl(CGUIControl *
 }
 
 CGUIControlProfiler::CGUIControlProfiler(void)
-: m_ItemHead(NULL, NULL, NULL), m_pLastItem(NULL), m_iMaxFrameCount(200), m_iFrameCount(0)
+: m_ItemHead(NULL, NULL, NULL), m_pLastItem(NULL), m_iMaxFrameCount(200), m_iFrameCount(0), m_drawCalls(0)
 // m_bIsRunning(false), no isRunning because it is static
 {
   m_fPerfScale = 100000.0f / CurrentHostFrequency();
@@ -257,6 +273,8 @@ bool CGUIControlProfiler::IsRunning(void)
 void CGUIControlProfiler::Start(void)
 {
   m_iFrameCount = 0;
+  m_drawCalls = 0;
+  m_conditions.clear();
   m_bIsRunning = true;
   m_pLastItem = NULL;
   m_ItemHead.Reset(this);
@@ -286,6 +304,13 @@ void CGUIControlProfiler::EndRender(CGUIControl *pControl)
   item->EndRender();
 }
 
+void CGUIControlProfiler::AddConditionEvaluation(const std::string &expression, int64_t elapsed)
+{
+  ConditionCost &cost = m_conditions[expression];
+  cost.m_evaluations++;
+  cost.m_time += elapsed;
+}
+
 CGUIControlProfilerItem *CGUIControlProfiler::FindOrAddControl(CGUIControl *pControl)
 {
   if (m_pLastItem)
@@ -325,6 +350,7 @@ void CGUIControlProfiler::EndFrame(void)
       CGUIControlProfilerItem *p = m_ItemHead.m_vecChildren[i];
       m_ItemHead.m_visTime += p->m_visTime;
       m_ItemHead.m_renderTime += p->m_renderTime;
+      m_ItemHead.m_drawCalls += p->m_drawCalls;
     }
 
     m_bIsRunning = false;
@@ -346,8 +372,49 @@ bool CGUIControlProfiler::SaveResults(void)
   std::string str = StringUtils::Format("%d", m_iFrameCount);
   root->SetAttribute("framecount", str.c_str());
   root->SetAttribute("timeunit", "ms");
+  if (m_iFrameCount)
+  {
+    str = StringUtils::Format("%.1f", (float)m_drawCalls / m_iFrameCount);
+    root->SetAttribute("drawcallsperframe", str.c_str());
+  }
   doc.LinkEndChild(root);
 
   m_ItemHead.SaveToXML(root);
+  SaveConditionsToXML(root);
   return doc.SaveFile(m_strOutputFile);
 }
+
+void CGUIControlProfiler::SaveConditionsToXML(TiXmlElement *parent) const
+{
+  if (m_conditions.empty() || !m_iFrameCount)
+    return;
+
+  // most expensive first
+  std::vector<std::pair<int64_t, std::string> > conditions;
+  unsigned int evaluations = 0;
+  for (std::map<std::string, ConditionCost>::const_iterator i = m_conditions.begin(); i != m_conditions.end(); ++i)
+  {
+    conditions.push_back(std::make_pair(i->second.m_time, i->first));
+    evaluations += i->second.m_evaluations;
+  }
+  std::sort(conditions.rbegin(), conditions.rend());
+
+  TiXmlElement *xmlConditions = new TiXmlElement("conditions");
+  parent->LinkEndChild(xmlConditions);
+  std::string str = StringUtils::Format("%.1f", (float)evaluations / m_iFrameCount);
+  xmlConditions->SetAttribute("evaluationsperframe", str.c_str());
+
+  for (std::vector<std::pair<int64_t, std::string> >::const_iterator i = conditions.begin(); i != conditions.end(); ++i)
+  {
+    const ConditionCost &cost = m_conditions.find(i->second)->second;
+    TiXmlElement *xmlCondition = new TiXmlElement("condition");
+    xmlConditions->LinkEndChild(xmlCondition);
+    // conditions are cheap, so time is kept in counter ticks and reported in ms with more precision
+    str = StringUtils::Format("%.3f", m_fPerfScale * cost.m_time / 100.0f);
+    xmlCondition->SetAttribute("time", str.c_str());
+    str = StringUtils::Format("%.2f", (float)cost.m_evaluations / m_iFrameCount);
+    xmlCondition->SetAttribute("evaluationsperframe", str.c_str());
+    TiXmlText *text = new TiXmlText(i->second.c_str());
+    xmlCondition->LinkEndChild(text);
+  }
+}
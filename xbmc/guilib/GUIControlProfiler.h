@@ -24,6 +24,8 @@
 
 #include "GUIControl.h"
 
+#include <map>
+
 class CGUIControlProfiler;
 class TiXmlElement;
 
@@ -39,8 +41,10 @@ public:
   CGUIControl::GUICONTROLTYPES m_ControlType;
   unsigned int m_visTime;
   unsigned int m_renderTime;
+  unsigned int m_drawCalls;  ///< draw calls issued while rendering, including children
   int64_t m_i64VisStart;
   int64_t m_i64RenderStart;
+  unsigned int m_drawCallStart;
 
   CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl);
   ~CGUIControlProfilerItem(void);
@@ -69,6 +73,10 @@ public:
   void EndVisibility(CGUIControl *pControl);
   void BeginRender(CGUIControl *pControl);
   void EndRender(CGUIControl *pControl);
+  void AddDrawCall(void) { m_drawCalls++; };
+  void AddConditionEvaluation(const std::string &expression, int64_t elapsed);
+  unsigned int GetDrawCalls(void) const { return m_drawCalls; };
+  int GetFrameCount(void) const { return m_iFrameCount; };
   int GetMaxFrameCount(void) const { return m_iMaxFrameCount; };
   void SetMaxFrameCount(int iMaxFrameCount) { m_iMaxFrameCount = iMaxFrameCount; };
   void SetOutputFile(const std::string &strOutputFile) { m_strOutputFile = strOutputFile; };
@@ -86,16 +94,27 @@ private:
   CGUIControlProfilerItem m_ItemHead;
   CGUIControlProfilerItem *m_pLastItem;
   CGUIControlProfilerItem *FindOrAddControl(CGUIControl *pControl);
+  void SaveConditionsToXML(TiXmlElement *parent) const;
+
+  struct ConditionCost
+  {
+    ConditionCost() : m_evaluations(0), m_time(0) {};
+    unsigned int m_evaluations;
+    int64_t m_time;  ///< in host counter ticks, including the conditions it depends on
+  };
+  std::map<std::string, ConditionCost> m_conditions;
 
   static bool m_bIsRunning;
   std::string m_strOutputFile;
   int m_iMaxFrameCount;
   int m_iFrameCount;
+  unsigned int m_drawCalls;
 };
 
 #define GUIPROFILER_VISIBILITY_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginVisibility(x); }
 #define GUIPROFILER_VISIBILITY_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndVisibility(x); }
 #define GUIPROFILER_RENDER_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginRender(x); }
 #define GUIPROFILER_RENDER_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndRender(x); }
+#define GUIPROFILER_DRAWCALL() { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().AddDrawCall(); }
 
 #endif
@@ -46,11 +46,10 @@ class CGUIFontCacheImpl
         delete(it->second);
       hashMap.clear();
     }
-    typename HashMap::iterator FindKey(CGUIFontCacheKey<Position> key)
+    typename HashMap::iterator FindKey(size_t hash, const CGUIFontCacheKey<Position> &key)
     {
-      CGUIFontCacheHash<Position> hashGen;
       CGUIFontCacheKeysMatch<Position> keyMatch;
-      auto range = hashMap.equal_range(hashGen(key));
+      auto range = hashMap.equal_range(hash);
       for (auto ret = range.first; ret != range.second; ++ret)
       {
         if (keyMatch(ret->second->m_key, key))
@@ -83,8 +82,11 @@ class CGUIFontCacheImpl
   CGUIFontCache<Position, Value> *m_parent;
   
 public:
+  unsigned int m_hits;
+  unsigned int m_misses;
+  unsigned int m_generation;
 
-  CGUIFontCacheImpl(CGUIFontCache<Position, Value>* parent) : m_parent(parent) {}
+  CGUIFontCacheImpl(CGUIFontCache<Position, Value>* parent) : m_parent(parent), m_hits(0), m_misses(0), m_generation(0) {}
   Value &Lookup(Position &pos,
                 const vecColors &colors, const vecText &text,
                 uint32_t alignment, float maxPixelWidth,
@@ -156,10 +158,13 @@ Value &CGUIFontCacheImpl<Position, Value>::Lookup(Position &pos,
                                        scrolling, g_graphicsContext.GetGUIMatrix(),
                                        g_graphicsContext.GetGUIScaleX(), g_graphicsContext.GetGUIScaleY());
 
-  auto i = m_list.FindKey(key);
+  CGUIFontCacheHash<Position> hashgen;
+  size_t hash = hashgen(key);
+  auto i = m_list.FindKey(hash, key);
   if (i == m_list.hashMap.end())
   {
     // Cache miss
+    m_misses++;
     dirtyCache = true;
     CGUIFontCacheEntry<Position, Value> *entry = nullptr;
     if (!m_list.ageMap.empty() && (nowMillis - m_list.ageMap.begin()->first) > FONT_CACHE_TIME_LIMIT)
@@ -170,16 +175,16 @@ Value &CGUIFontCacheImpl<Position, Value>::Lookup(Position &pos,
     }
 
     // add new entry
-    CGUIFontCacheHash<Position> hashgen;
     if (!entry)
       entry = new CGUIFontCacheEntry<Position, Value>(*m_parent, key, nowMillis);
     else
       entry->Assign(key, nowMillis);
-    return m_list.Insert(hashgen(key), entry)->second->m_value;
+    return m_list.Insert(hash, entry)->second->m_value;
   }
   else
   {
     // Cache hit
+    m_hits++;
     // Update the translation arguments so that they hold the offset to apply
     // to the cached values (but only in the dynamic case)
     pos.UpdateWithOffsets(i->second->m_key.m_pos, scrolling);
@@ -202,6 +207,25 @@ template<class Position, class Value>
 void CGUIFontCacheImpl<Position, Value>::Flush()
 {
   m_list.Flush();
+  m_generation++;
+}
+
+template<class Position, class Value>
+unsigned int CGUIFontCache<Position, Value>::GetHits() const
+{
+  return m_impl ? m_impl->m_hits : 0;
+}
+
+template<class Position, class Value>
+unsigned int CGUIFontCache<Position, Value>::GetMisses() const
+{
+  return m_impl ? m_impl->m_misses : 0;
+}
+
+template<class Position, class Value>
+unsigned int CGUIFontCache<Position, Value>::GetGeneration() const
+{
+  return m_impl ? m_impl->m_generation : 0;
 }
 
 template CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::CGUIFontCache(CGUIFontTTFBase &font);
@@ -209,12 +233,18 @@ template CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::~
 template CGUIFontCacheEntry<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::~CGUIFontCacheEntry();
 template CGUIFontCacheStaticValue &CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::Lookup(CGUIFontCacheStaticPosition &, const vecColors &, const vecText &, uint32_t, float, bool, unsigned int, bool &);
 template void CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::Flush();
+template unsigned int CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::GetHits() const;
+template unsigned int CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::GetMisses() const;
+template unsigned int CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::GetGeneration() const;
 
 template CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::CGUIFontCache(CGUIFontTTFBase &font);
 template CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::~CGUIFontCache();
 template CGUIFontCacheEntry<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::~CGUIFontCacheEntry();
 template CGUIFontCacheDynamicValue &CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::Lookup(CGUIFontCacheDynamicPosition &, const vecColors &, const vecText &, uint32_t, float, bool, unsigned int, bool &);
 template void CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::Flush();
+template unsigned int CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::GetHits() const;
+template unsigned int CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::GetMisses() const;
+template unsigned int CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::GetGeneration() const;
 
 void CVertexBuffer::clear()
 {
@@ -102,18 +102,38 @@ struct CGUIFontCacheEntry
   void Assign(const CGUIFontCacheKey<Position> &key, unsigned int nowMillis);
 };
 
+inline void HashCombine(size_t &hash, uint32_t value)
+{
+  hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+}
+
+inline void HashCombine(size_t &hash, float value)
+{
+  // adding 0 folds -0 into 0, which compare equal
+  value += 0.0f;
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  HashCombine(hash, bits);
+}
+
 template<class Position>
 struct CGUIFontCacheHash
 {
   size_t operator()(const CGUIFontCacheKey<Position> &key) const
   {
-    /* Not much effort has gone into choosing this hash function */
-    size_t hash = 0, i;
-    for (i = 0; i < 3 && i < key.m_text.size(); ++i)
-      hash += key.m_text[i];
-    if (key.m_colors.size())
-      hash += key.m_colors[0];
-    hash += MatrixHashContribution(key);
+    /* Mix in everything CGUIFontCacheKeysMatch compares exactly so that list
+     * items sharing a prefix or colour don't end up in the same bucket */
+    size_t hash = key.m_text.size();
+    for (vecText::const_iterator i = key.m_text.begin(); i != key.m_text.end(); ++i)
+      HashCombine(hash, *i);
+    for (vecColors::const_iterator i = key.m_colors.begin(); i != key.m_colors.end(); ++i)
+      HashCombine(hash, *i);
+    HashCombine(hash, key.m_alignment);
+    HashCombine(hash, key.m_maxPixelWidth);
+    HashCombine(hash, (uint32_t)key.m_scrolling);
+    HashCombine(hash, key.m_scaleX);
+    HashCombine(hash, key.m_scaleY);
+    PositionHashContribution(hash, key);
     return hash;
   }
 };
@@ -153,6 +173,11 @@ public:
                 bool scrolling,
                 unsigned int nowMillis, bool &dirtyCache);
   void Flush();
+
+  unsigned int GetHits() const;
+  unsigned int GetMisses() const;
+  /*! \brief Number of flushes so far, entries returned by Lookup are invalid once it changed */
+  unsigned int GetGeneration() const;
 };
 
 struct CGUIFontCacheStaticPosition
@@ -179,10 +204,13 @@ inline bool Match(const CGUIFontCacheStaticPosition &a, const TransformMatrix &a
   return a.m_x == b.m_x && a.m_y == b.m_y && a_m == b_m;
 }
 
-inline float MatrixHashContribution(const CGUIFontCacheKey<CGUIFontCacheStaticPosition> &a)
+inline void PositionHashContribution(size_t &hash, const CGUIFontCacheKey<CGUIFontCacheStaticPosition> &a)
 {
-  /* Ensure horizontally translated versions end up in different buckets */
-  return a.m_matrix.m[0][3];
+  /* Position and translation must match exactly, so translated versions end up in different buckets */
+  HashCombine(hash, a.m_pos.m_x);
+  HashCombine(hash, a.m_pos.m_y);
+  HashCombine(hash, a.m_matrix.m[0][3]);
+  HashCombine(hash, a.m_matrix.m[1][3]);
 }
 
 struct CGUIFontCacheDynamicPosition
@@ -256,9 +284,12 @@ inline bool Match(const CGUIFontCacheDynamicPosition &a, const TransformMatrix &
           // We already know the first 3 columns of both matrices are diagonal, so no need to check the other elements
 }
 
-inline float MatrixHashContribution(const CGUIFontCacheKey<CGUIFontCacheDynamicPosition> &a)
+inline void PositionHashContribution(size_t &hash, const CGUIFontCacheKey<CGUIFontCacheDynamicPosition> &a)
 {
-  return 0;
+  /* Positions only need to match to within whole pixels, so only the scale is hashed */
+  HashCombine(hash, a.m_matrix.m[0][0]);
+  HashCombine(hash, a.m_matrix.m[1][1]);
+  HashCombine(hash, a.m_matrix.m[2][2]);
 }
 
 #endif
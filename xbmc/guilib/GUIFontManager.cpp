@@ -264,6 +264,18 @@ void GUIFontManager::FreeFontFile(CGUIFontTTFBase *pFont)
   }
 }
 
+void GUIFontManager::GetCacheStatistics(unsigned int &hits, unsigned int &misses, unsigned int &atlasRebuilds, unsigned int &atlasMemory) const
+{
+  hits = misses = atlasRebuilds = atlasMemory = 0;
+  for (std::vector<CGUIFontTTFBase*>::const_iterator it = m_vecFontFiles.begin(); it != m_vecFontFiles.end(); ++it)
+  {
+    hits += (*it)->GetCacheHits();
+    misses += (*it)->GetCacheMisses();
+    atlasRebuilds += (*it)->GetAtlasRebuilds();
+    atlasMemory += (*it)->GetAtlasMemoryUsage();
+  }
+}
+
 CGUIFontTTFBase* GUIFontManager::GetFontFile(const std::string& strFileName)
 {
   for (int i = 0; i < (int)m_vecFontFiles.size(); ++i)
@@ -78,6 +78,14 @@ public:
   void Clear();
   void FreeFontFile(CGUIFontTTFBase *pFont);
 
+  /*! \brief font cache statistics summed over the loaded font files
+   \param hits [out] text lookups served from the vertex caches
+   \param misses [out] text lookups that had to build their vertices
+   \param atlasRebuilds [out] glyph atlas reallocations
+   \param atlasMemory [out] bytes held by the glyph atlases
+   */
+  void GetCacheStatistics(unsigned int &hits, unsigned int &misses, unsigned int &atlasRebuilds, unsigned int &atlasMemory) const;
+
   static void SettingOptionsFontsFiller(const CSetting *setting, std::vector< std::pair<std::string, std::string> > &list, std::string &current, void *data);
 
 protected:
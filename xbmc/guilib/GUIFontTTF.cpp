@@ -173,6 +173,7 @@ CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache
   m_ellipsesWidth = m_height = 0.0f;
   m_color = 0;
   m_nTexture = 0;
+  m_atlasRebuilds = 0;
 }
 
 CGUIFontTTFBase::~CGUIFontTTFBase(void)
@@ -212,6 +213,22 @@ void CGUIFontTTFBase::ClearCharacterCache()
   m_textureHeight = 0;
 }
 
+unsigned int CGUIFontTTFBase::GetCacheHits() const
+{
+  return m_staticCache.GetHits() + m_dynamicCache.GetHits();
+}
+
+unsigned int CGUIFontTTFBase::GetCacheMisses() const
+{
+  return m_staticCache.GetMisses() + m_dynamicCache.GetMisses();
+}
+
+unsigned int CGUIFontTTFBase::GetAtlasMemoryUsage() const
+{
+  // the glyph atlas is 8bit alpha
+  return m_textureWidth * m_textureHeight;
+}
+
 void CGUIFontTTFBase::Clear()
 {
   delete(m_texture);
@@ -384,6 +401,11 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
                            dirtyCache));
   if (dirtyCache)
   {
+    // caching new glyphs may reallocate the atlas, which flushes both caches
+    // (even if the reallocation fails half way) and invalidates the entries above
+    unsigned int staticGeneration = m_staticCache.GetGeneration();
+    unsigned int dynamicGeneration = m_dynamicCache.GetGeneration();
+
     // save the origin, which is scaled separately
     m_originX = x;
     m_originY = y;
@@ -517,24 +539,29 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
     }
     if (hardwareClipping)
     {
-      CVertexBuffer &vertexBuffer = m_dynamicCache.Lookup(dynamicPos,
-                                                          colors, text,
-                                                          rawAlignment, maxPixelWidth,
-                                                          scrolling,
-                                                          XbmcThreads::SystemClockMillis(),
-                                                          dirtyCache);
+      // the entry from the first lookup is still ours unless the caches were flushed
+      CVertexBuffer &cachedBuffer = m_dynamicCache.GetGeneration() == dynamicGeneration ? vertexBuffer :
+          m_dynamicCache.Lookup(dynamicPos,
+                                colors, text,
+                                rawAlignment, maxPixelWidth,
+                                scrolling,
+                                XbmcThreads::SystemClockMillis(),
+                                dirtyCache);
       CVertexBuffer newVertexBuffer = CreateVertexBuffer(*tempVertices);
-      vertexBuffer = newVertexBuffer;
-      m_vertexTrans.push_back(CTranslatedVertices(0, 0, 0, &vertexBuffer, g_graphicsContext.GetClipRegion()));
+      cachedBuffer = newVertexBuffer;
+      m_vertexTrans.push_back(CTranslatedVertices(0, 0, 0, &cachedBuffer, g_graphicsContext.GetClipRegion()));
     }
     else
     {
-      m_staticCache.Lookup(staticPos,
-                           colors, text,
-                           rawAlignment, maxPixelWidth,
-                           scrolling,
-                           XbmcThreads::SystemClockMillis(),
-                           dirtyCache) = *static_cast<CGUIFontCacheStaticValue *>(&tempVertices);
+      CGUIFontCacheStaticValue &cachedVertices = m_staticCache.GetGeneration() == staticGeneration ?
+          static_cast<CGUIFontCacheStaticValue &>(vertices) :
+          m_staticCache.Lookup(staticPos,
+                               colors, text,
+                               rawAlignment, maxPixelWidth,
+                               scrolling,
+                               XbmcThreads::SystemClockMillis(),
+                               dirtyCache);
+      cachedVertices = *static_cast<CGUIFontCacheStaticValue *>(&tempVertices);
       /* Append the new vertices to the set collected since the first Begin() call */
       m_vertex.insert(m_vertex.end(), tempVertices->begin(), tempVertices->end());
     }
@@ -756,6 +783,7 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
           return false;
         }
         m_texture = newTexture;
+        m_atlasRebuilds++;
       }
     }
 
@@ -103,6 +103,15 @@ public:
 
   const std::string& GetFileName() const { return m_strFileName; };
 
+  /*! \brief statistics for tuning font memory
+   Hits and misses count text lookups in the vertex caches, rebuilds count
+   reallocations of the glyph atlas, each of which flushes the caches.
+   */
+  unsigned int GetCacheHits() const;
+  unsigned int GetCacheMisses() const;
+  unsigned int GetAtlasRebuilds() const { return m_atlasRebuilds; }
+  unsigned int GetAtlasMemoryUsage() const;
+
 protected:
   struct Character
   {
@@ -198,6 +207,7 @@ protected:
 
   CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue> m_staticCache;
   CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue> m_dynamicCache;
+  unsigned int m_atlasRebuilds;
 
 private:
   virtual bool FirstBegin() = 0;
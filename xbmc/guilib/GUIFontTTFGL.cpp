@@ -25,6 +25,7 @@
 #include "Texture.h"
 #include "TextureManager.h"
 #include "GraphicContext.h"
+#include "GUITexture.h"
 #include "gui3d.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
@@ -57,6 +58,9 @@ CGUIFontTTFGL::~CGUIFontTTFGL(void)
 
 bool CGUIFontTTFGL::FirstBegin()
 {
+  // our texture and vertex state replaces that of any batched GUI textures
+  CGUITexture::FlushBatch();
+
   if (m_textureStatus == TEXTURE_REALLOCATED)
   {
     if (glIsTexture(m_nTexture))
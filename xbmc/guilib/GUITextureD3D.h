@@ -39,6 +39,9 @@ public:
   CGUITextureD3D(float posX, float posY, float width, float height, const CTextureInfo& texture);
   ~CGUITextureD3D();
   static void DrawQuad(const CRect &coords, color_t color, CBaseTexture *texture = NULL, const CRect *texCoords = NULL);
+  static void BeginBatch() {}
+  static void EndBatch() {}
+  static void FlushBatch() {}
 
 protected:
   void Begin(color_t color);
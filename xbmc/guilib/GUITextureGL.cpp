@@ -26,10 +26,43 @@
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "guilib/Geometry.h"
+#include "guilib/GUIControlProfiler.h"
 #include "windowing/WindowingFactory.h"
 
 #if defined(HAS_GL)
 
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+struct BatchVertex
+{
+  float x, y, z;
+  GLubyte r, g, b, a;
+  float u1, v1;
+  float u2, v2;
+};
+
+/*! \brief quads from consecutive textures sharing texture and diffuse state
+ Texture state is set up once when the batch opens and the quads are drawn
+ from a single vertex array when it's flushed.
+ */
+struct CTextureBatch
+{
+  CTextureBatch() : open(false), texture(NULL), diffuse(NULL), limitedColor(false), depth(0) {}
+
+  bool open;
+  const CBaseTexture *texture;
+  const CBaseTexture *diffuse;
+  bool limitedColor;
+  unsigned int depth;
+  std::vector<BatchVertex> vertices;
+};
+
+CTextureBatch batch;
+}
+
 CGUITextureGL::CGUITextureGL(float posX, float posY, float width, float height, const CTextureInfo &texture)
 : CGUITextureBase(posX, posY, width, height, texture)
 {
@@ -39,7 +72,8 @@ CGUITextureGL::CGUITextureGL(float posX, float posY, float width, float height,
 void CGUITextureGL::Begin(color_t color)
 {
   int range, unit = 0;
-  if(g_Windowing.UseLimitedColor())
+  bool limitedColor = g_Windowing.UseLimitedColor();
+  if(limitedColor)
     range = 235 - 16;
   else
     range = 255 -  0;
@@ -50,9 +84,23 @@ void CGUITextureGL::Begin(color_t color)
   m_col[3] = GET_A(color);
 
   CBaseTexture* texture = m_texture.m_textures[m_currentFrame];
+  CBaseTexture* diffuse = m_diffuse.size() ? m_diffuse.m_textures[0] : NULL;
+
+  // uploading binds the texture, which would disturb an open batch
+  if (texture->GetPixels() || (diffuse && diffuse->GetPixels()))
+    FlushBatch();
   texture->LoadToGPU();
-  if (m_diffuse.size())
-    m_diffuse.m_textures[0]->LoadToGPU();
+  if (diffuse)
+    diffuse->LoadToGPU();
+
+  if (batch.open && batch.texture == texture && batch.diffuse == diffuse && batch.limitedColor == limitedColor)
+    return; // state is already set up, keep adding to the batch
+
+  FlushBatch();
+  batch.open = true;
+  batch.texture = texture;
+  batch.diffuse = diffuse;
+  batch.limitedColor = limitedColor;
 
   texture->BindToUnit(unit++);
 
@@ -109,15 +157,57 @@ void CGUITextureGL::Begin(color_t color)
     glTexEnvi (GL_TEXTURE_ENV, GL_SOURCE0_ALPHA    , GL_PREVIOUS);
     VerifyGLState();
   }
-
-  //glDisable(GL_TEXTURE_2D); // uncomment these 2 lines to switch to wireframe rendering
-  //glBegin(GL_LINE_LOOP);
-  glBegin(GL_QUADS);
 }
 
 void CGUITextureGL::End()
 {
-  glEnd();
+  if (!batch.depth)
+    FlushBatch();
+}
+
+void CGUITextureGL::BeginBatch()
+{
+  batch.depth++;
+}
+
+void CGUITextureGL::EndBatch()
+{
+  if (batch.depth && !--batch.depth)
+    FlushBatch();
+}
+
+void CGUITextureGL::FlushBatch()
+{
+  if (!batch.open)
+    return;
+
+  if (!batch.vertices.empty())
+  {
+    BatchVertex *vertices = &batch.vertices[0];
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+    glColorPointer (4, GL_UNSIGNED_BYTE, sizeof(BatchVertex), (char*)vertices + offsetof(BatchVertex, r));
+    glVertexPointer(3, GL_FLOAT        , sizeof(BatchVertex), (char*)vertices + offsetof(BatchVertex, x));
+    glEnableClientState(GL_COLOR_ARRAY);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    if (batch.diffuse)
+    {
+      glClientActiveTexture(GL_TEXTURE1_ARB);
+      glTexCoordPointer(2, GL_FLOAT, sizeof(BatchVertex), (char*)vertices + offsetof(BatchVertex, u2));
+      glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    }
+    glClientActiveTexture(GL_TEXTURE0_ARB);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(BatchVertex), (char*)vertices + offsetof(BatchVertex, u1));
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+
+    //glDisable(GL_TEXTURE_2D); // uncomment these 2 lines to switch to wireframe rendering
+    //glDrawArrays(GL_LINE_LOOP, 0, batch.vertices.size());
+    glDrawArrays(GL_QUADS, 0, batch.vertices.size());
+
+    glPopClientAttrib();
+    batch.vertices.clear();
+  }
+
   glActiveTexture(GL_TEXTURE2_ARB);
   glBindTexture(GL_TEXTURE_2D, 0);
   glDisable(GL_TEXTURE_2D);
@@ -127,57 +217,64 @@ void CGUITextureGL::End()
   glActiveTexture(GL_TEXTURE0_ARB);
   glBindTexture(GL_TEXTURE_2D, 0);
   glDisable(GL_TEXTURE_2D);
+
+  batch.open = false;
+  batch.texture = NULL;
+  batch.diffuse = NULL;
 }
 
 void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
 {
+  BatchVertex vertices[4];
+  for (int i = 0; i < 4; i++)
+  {
+    vertices[i].x = x[i];
+    vertices[i].y = y[i];
+    vertices[i].z = z[i];
+    vertices[i].r = m_col[0];
+    vertices[i].g = m_col[1];
+    vertices[i].b = m_col[2];
+    vertices[i].a = m_col[3];
+  }
+
   // Top-left vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
-  glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y1);
-  if (m_diffuse.size())
-    glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y1);
-  glVertex3f(x[0], y[0], z[0]);
+  vertices[0].u1 = texture.x1;
+  vertices[0].v1 = texture.y1;
 
   // Top-right vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
-  if (orientation & 4)
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y2);
-  else
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y1);
-  if (m_diffuse.size())
-  {
-    if (m_info.orientation & 4)
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y2);
-    else
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y1);
-  }
-  glVertex3f(x[1], y[1], z[1]);
+  vertices[1].u1 = (orientation & 4) ? texture.x1 : texture.x2;
+  vertices[1].v1 = (orientation & 4) ? texture.y2 : texture.y1;
 
   // Bottom-right vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
-  glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y2);
-  if (m_diffuse.size())
-    glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y2);
-  glVertex3f(x[2], y[2], z[2]);
+  vertices[2].u1 = texture.x2;
+  vertices[2].v1 = texture.y2;
 
   // Bottom-left vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
-  if (orientation & 4)
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y1);
-  else
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y2);
+  vertices[3].u1 = (orientation & 4) ? texture.x2 : texture.x1;
+  vertices[3].v1 = (orientation & 4) ? texture.y1 : texture.y2;
+
   if (m_diffuse.size())
   {
-    if (m_info.orientation & 4)
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y1);
-    else
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y2);
+    vertices[0].u2 = diffuse.x1;
+    vertices[0].v2 = diffuse.y1;
+    vertices[1].u2 = (m_info.orientation & 4) ? diffuse.x1 : diffuse.x2;
+    vertices[1].v2 = (m_info.orientation & 4) ? diffuse.y2 : diffuse.y1;
+    vertices[2].u2 = diffuse.x2;
+    vertices[2].v2 = diffuse.y2;
+    vertices[3].u2 = (m_info.orientation & 4) ? diffuse.x2 : diffuse.x1;
+    vertices[3].v2 = (m_info.orientation & 4) ? diffuse.y1 : diffuse.y2;
   }
-  glVertex3f(x[3], y[3], z[3]);
+
+  // the draw call is charged to the control whose quads open the batch, controls merged into it add none
+  if (batch.vertices.empty())
+    GUIPROFILER_DRAWCALL();
+  batch.vertices.insert(batch.vertices.end(), vertices, vertices + 4);
 }
 
 void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  FlushBatch();
+
   if (texture)
   {
     texture->LoadToGPU();
@@ -220,6 +317,7 @@ void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CBaseTexture *tex
   glVertex3f(rect.x1, rect.y2, 0);
 
   glEnd();
+  GUIPROFILER_DRAWCALL();
   if (texture)
     glDisable(GL_TEXTURE_2D);
 }
@@ -37,6 +37,15 @@ class CGUITextureGL : public CGUITextureBase
 public:
   CGUITextureGL(float posX, float posY, float width, float height, const CTextureInfo& texture);
   static void DrawQuad(const CRect &coords, color_t color, CBaseTexture *texture = NULL, const CRect *texCoords = NULL);
+
+  /*! \brief Batch the quads of consecutive textures sharing the same state until EndBatch
+   Calls nest, the batch is drawn when the outermost EndBatch is reached, when the
+   state changes or when FlushBatch is called. Anything drawing through GL other
+   than CGUITexture must FlushBatch first.
+   */
+  static void BeginBatch();
+  static void EndBatch();
+  static void FlushBatch();
 protected:
   void Begin(color_t color);
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation);
@@ -28,6 +28,7 @@
 #include "utils/MathUtils.h"
 #include "windowing/WindowingFactory.h"
 #include "guilib/GraphicContext.h"
+#include "guilib/GUIControlProfiler.h"
 
 #include <cstddef>
 
@@ -119,6 +120,7 @@ void CGUITextureGLES::End()
   glEnableVertexAttribArray(tex0Loc);
 
   glDrawElements(GL_TRIANGLES, m_packedVertices.size()*6 / 4, GL_UNSIGNED_SHORT, m_idx.data());
+  GUIPROFILER_DRAWCALL();
 
   if (m_diffuse.size())
   {
@@ -278,6 +280,7 @@ void CGUITextureGLES::DrawQuad(const CRect &rect, color_t color, CBaseTexture *t
     tex[2][1] = tex[3][1] = coords.y2;
   }
   glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_BYTE, idx);
+  GUIPROFILER_DRAWCALL();
 
   glDisableVertexAttribArray(posLoc);
   if (texture)
@@ -46,6 +46,9 @@ class CGUITextureGLES : public CGUITextureBase
 public:
   CGUITextureGLES(float posX, float posY, float width, float height, const CTextureInfo& texture);
   static void DrawQuad(const CRect &coords, color_t color, CBaseTexture *texture = NULL, const CRect *texCoords = NULL);
+  static void BeginBatch() {}
+  static void EndBatch() {}
+  static void FlushBatch() {}
 protected:
   void Begin(color_t color);
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation);
@@ -21,6 +21,7 @@
 #include "system.h"
 #include "GUIWindow.h"
 #include "GUIWindowManager.h"
+#include "GUIWindowXMLCache.h"
 #include "input/Key.h"
 #include "GUIControlFactory.h"
 #include "GUIControlGroup.h"
@@ -134,13 +135,26 @@ bool CGUIWindow::Load(const std::string& strFileName, bool bContainsPath)
 
 bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLowerPath)
 {
+  // windows that haven't kept their xml may have it resolved already
+  if (!m_windowXMLRootElement)
+  {
+    TiXmlElement *resolved = CGUIWindowXMLCache::GetInstance().Get(strPath, m_xmlIncludeConditions);
+    if (resolved)
+    {
+      CLog::Log(LOGDEBUG, "Using cached xml for %s", strPath.c_str());
+      return LoadResolved(resolved);
+    }
+  }
+
   // load window xml if we don't have it stored yet
+  bool cacheable = false;
   if (!m_windowXMLRootElement)
   {
     CXBMCTinyXML xmlDoc;
     std::string strPathLower = strPath;
     StringUtils::ToLower(strPathLower);
-    if (!xmlDoc.LoadFile(strPath) && !xmlDoc.LoadFile(strPathLower) && !xmlDoc.LoadFile(strLowerPath))
+    cacheable = xmlDoc.LoadFile(strPath);
+    if (!cacheable && !xmlDoc.LoadFile(strPathLower) && !xmlDoc.LoadFile(strLowerPath))
     {
       CLog::Log(LOGERROR, "unable to load:%s, Line %d\n%s", strPath.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
       SetID(WINDOW_INVALID);
@@ -151,30 +165,49 @@ bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLower
   else
     CLog::Log(LOGDEBUG, "Using already stored xml root node for %s", strPath.c_str());
 
-  return Load(m_windowXMLRootElement);
+  TiXmlElement *resolved = ResolveXML(m_windowXMLRootElement);
+  if (!resolved)
+    return false;
+  // only files loaded from the path asked for are cached, as that's the one that gets checked for changes
+  if (cacheable)
+    CGUIWindowXMLCache::GetInstance().Add(strPath, *resolved, m_xmlIncludeConditions);
+  return LoadResolved(resolved);
 }
 
 bool CGUIWindow::Load(TiXmlElement* pRootElement)
 {
-  if (!pRootElement)
+  TiXmlElement *resolved = ResolveXML(pRootElement);
+  if (!resolved)
     return false;
+  return LoadResolved(resolved);
+}
+
+TiXmlElement* CGUIWindow::ResolveXML(const TiXmlElement* pRootElement)
+{
+  if (!pRootElement)
+    return NULL;
   
   if (strcmpi(pRootElement->Value(), "window"))
   {
     CLog::Log(LOGERROR, "file : XML file doesnt contain <window>");
-    return false;
+    return NULL;
   }
 
   // we must create copy of root element as we will manipulate it when resolving includes
   // and we don't want original root element to change
-  pRootElement = (TiXmlElement*)pRootElement->Clone();
+  TiXmlElement *resolved = (TiXmlElement*)pRootElement->Clone();
 
+  // Resolve any includes that may be present and save conditions used to do it
+  g_SkinInfo->ResolveIncludes(resolved, &m_xmlIncludeConditions);
+  return resolved;
+}
+
+bool CGUIWindow::LoadResolved(TiXmlElement* pRootElement)
+{
   // set the scaling resolution so that any control creation or initialisation can
   // be done with respect to the correct aspect ratio
   g_graphicsContext.SetScalingResolution(m_coordsRes, m_needsScaling);
 
-  // Resolve any includes that may be present and save conditions used to do it
-  g_SkinInfo->ResolveIncludes(pRootElement, &m_xmlIncludeConditions);
   // now load in the skin file
   SetDefaults();
 
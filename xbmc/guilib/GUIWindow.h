@@ -203,6 +203,8 @@ protected:
   virtual EVENT_RESULT OnMouseEvent(const CPoint &point, const CMouseEvent &event);
   virtual bool LoadXML(const std::string& strPath, const std::string &strLowerPath);  ///< Loads from the given file
   bool Load(TiXmlElement *pRootElement);                 ///< Loads from the given XML root element
+  TiXmlElement* ResolveXML(const TiXmlElement *pRootElement); ///< Returns a copy of the given XML root element with the includes resolved
+  bool LoadResolved(TiXmlElement *pRootElement);         ///< Loads from an XML root element with resolved includes, which it takes ownership of
   /*! \brief Check if XML file needs (re)loading
    XML file has to be (re)loaded when window is not loaded or include conditions values were changed
    */
@@ -0,0 +1,487 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIWindowXMLCache.h"
+
+#include <algorithm>
+
+#include "GUIInfoManager.h"
+#include "addons/Skin.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
+#include "utils/JobManager.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/log.h"
+
+namespace
+{
+const unsigned int CACHE_MAGIC = 0x4c4d5853;
+const unsigned int CACHE_VERSION = 1;
+const unsigned int CACHE_END = 0x444e4521;
+
+// windows kept in memory and preloaded on the next skin load
+const size_t MAX_ENTRIES = 16;
+const unsigned int MAX_DEPTH = 256;
+
+enum NodeType
+{
+  NODE_ELEMENT = 0,
+  NODE_TEXT,
+  NODE_CDATA
+};
+}
+
+CGUIWindowXMLCache& CGUIWindowXMLCache::GetInstance()
+{
+  static CGUIWindowXMLCache sWindowXMLCache;
+  return sWindowXMLCache;
+}
+
+CGUIWindowXMLCache::CGUIWindowXMLCache()
+  : m_generation(0),
+    m_useCounter(0)
+{
+}
+
+void CGUIWindowXMLCache::Initialize()
+{
+  std::string folder;
+  unsigned int generation;
+  {
+    CSingleLock lock(m_critSection);
+    m_entries.clear();
+    m_modificationTimes.clear();
+    m_folder.clear();
+    m_skinVersion.clear();
+    generation = ++m_generation;
+    if (!g_advancedSettings.m_guiSkinXMLCache || !g_SkinInfo)
+      return;
+
+    folder = URIUtils::AddFileToFolder("special://temp/skincache/", g_SkinInfo->ID());
+    URIUtils::AddSlashAtEnd(folder);
+  }
+
+  if (!XFILE::CDirectory::Exists(folder) &&
+      (!XFILE::CDirectory::Create("special://temp/skincache/") || !XFILE::CDirectory::Create(folder)))
+  {
+    CLog::Log(LOGERROR, "%s: unable to create %s", __FUNCTION__, folder.c_str());
+    return;
+  }
+
+  CSingleLock lock(m_critSection);
+  if (m_generation != generation)
+    return;
+  m_folder = folder;
+  m_skinVersion = g_SkinInfo->Version().asString();
+  CJobManager::GetInstance().Submit([this, folder, generation]() {
+    Preload(folder, generation);
+  });
+}
+
+void CGUIWindowXMLCache::Deinitialize()
+{
+  CSingleLock lock(m_critSection);
+  if (!m_folder.empty())
+  {
+    // remember the windows used this session, most recently used first
+    std::vector<std::pair<unsigned int, std::string>> used;
+    for (std::map<std::string, CacheEntryPtr>::const_iterator i = m_entries.begin(); i != m_entries.end(); ++i)
+    {
+      if (i->second->lastUsed)
+        used.push_back(std::make_pair(i->second->lastUsed, i->first));
+    }
+    std::sort(used.rbegin(), used.rend());
+
+    std::string preload;
+    for (std::vector<std::pair<unsigned int, std::string>>::const_iterator i = used.begin(); i != used.end(); ++i)
+      preload += i->second + "\n";
+
+    XFILE::CFile file;
+    if (!file.OpenForWrite(m_folder + "preload.txt", true) ||
+        file.Write(preload.c_str(), preload.size()) != (ssize_t)preload.size())
+      CLog::Log(LOGWARNING, "%s: unable to write %spreload.txt", __FUNCTION__, m_folder.c_str());
+  }
+
+  m_entries.clear();
+  m_modificationTimes.clear();
+  m_folder.clear();
+  m_skinVersion.clear();
+  m_generation++;
+}
+
+TiXmlElement* CGUIWindowXMLCache::Get(const std::string &path, std::map<INFO::InfoPtr, bool> &conditions)
+{
+  CacheEntryPtr entry;
+  std::string cacheFile;
+  {
+    CSingleLock lock(m_critSection);
+    if (m_folder.empty())
+      return NULL;
+    std::map<std::string, CacheEntryPtr>::const_iterator i = m_entries.find(path);
+    if (i != m_entries.end())
+      entry = i->second;
+    else
+      cacheFile = GetCacheFile(m_folder, path);
+  }
+
+  if (!entry)
+  {
+    entry = Load(cacheFile, path);
+    if (!entry)
+      return NULL;
+  }
+
+  if (!IsValid(*entry))
+  {
+    CLog::Log(LOGDEBUG, "%s: cached xml for %s is out of date", __FUNCTION__, path.c_str());
+    CSingleLock lock(m_critSection);
+    m_entries.erase(path);
+    return NULL;
+  }
+
+  conditions.clear();
+  for (std::vector<std::pair<std::string, bool>>::const_iterator i = entry->conditions.begin(); i != entry->conditions.end(); ++i)
+    conditions[g_infoManager.Register(i->first)] = i->second;
+
+  {
+    CSingleLock lock(m_critSection);
+    entry->lastUsed = ++m_useCounter;
+    Insert(path, entry);
+  }
+  return static_cast<TiXmlElement*>(entry->root->Clone());
+}
+
+void CGUIWindowXMLCache::Add(const std::string &path, const TiXmlElement &resolved, const std::map<INFO::InfoPtr, bool> &conditions)
+{
+  CacheEntryPtr entry = std::make_shared<CacheEntry>();
+  {
+    CSingleLock lock(m_critSection);
+    if (m_folder.empty())
+      return;
+    entry->skinVersion = m_skinVersion;
+  }
+
+  entry->files.push_back(std::make_pair(path, GetModificationTime(path)));
+  const std::vector<std::string> &includes = g_SkinInfo->GetIncludeFiles();
+  for (std::vector<std::string>::const_iterator i = includes.begin(); i != includes.end(); ++i)
+    entry->files.push_back(std::make_pair(*i, GetModificationTime(*i)));
+  for (std::map<INFO::InfoPtr, bool>::const_iterator i = conditions.begin(); i != conditions.end(); ++i)
+    entry->conditions.push_back(std::make_pair(i->first->GetExpression(), i->second));
+  entry->root.reset(static_cast<TiXmlElement*>(resolved.Clone()));
+
+  std::string cacheFile;
+  {
+    CSingleLock lock(m_critSection);
+    if (m_folder.empty())
+      return;
+    entry->lastUsed = ++m_useCounter;
+    Insert(path, entry);
+    cacheFile = GetCacheFile(m_folder, path);
+  }
+
+  // the entry isn't changed once it is in the cache, so it can be written out while in use
+  CJobManager::GetInstance().Submit([cacheFile, path, entry]() {
+    if (!Save(cacheFile, path, *entry))
+      CLog::Log(LOGWARNING, "CGUIWindowXMLCache: unable to write %s", cacheFile.c_str());
+  });
+}
+
+bool CGUIWindowXMLCache::IsValid(const CacheEntry &entry)
+{
+  {
+    CSingleLock lock(m_critSection);
+    if (entry.skinVersion != m_skinVersion || entry.files.empty())
+      return false;
+  }
+
+  // the includes need to have been resolved from the same files, loaded in the same order
+  const std::vector<std::string> &includes = g_SkinInfo->GetIncludeFiles();
+  if (entry.files.size() != includes.size() + 1)
+    return false;
+  for (size_t i = 0; i < includes.size(); i++)
+  {
+    if (entry.files[i + 1].first != includes[i])
+      return false;
+  }
+
+  for (std::vector<std::pair<std::string, int64_t>>::const_iterator i = entry.files.begin(); i != entry.files.end(); ++i)
+  {
+    if (GetModificationTime(i->first) != i->second)
+      return false;
+  }
+
+  for (std::vector<std::pair<std::string, bool>>::const_iterator i = entry.conditions.begin(); i != entry.conditions.end(); ++i)
+  {
+    INFO::InfoPtr condition = g_infoManager.Register(i->first);
+    if (!condition || condition->Get() != i->second)
+      return false;
+  }
+  return true;
+}
+
+int64_t CGUIWindowXMLCache::GetModificationTime(const std::string &path)
+{
+  std::map<std::string, int64_t>::const_iterator i = m_modificationTimes.find(path);
+  if (i != m_modificationTimes.end())
+    return i->second;
+
+  struct __stat64 buffer;
+  int64_t time = XFILE::CFile::Stat(path, &buffer) == 0 ? (int64_t)buffer.st_mtime : -1;
+  m_modificationTimes[path] = time;
+  return time;
+}
+
+void CGUIWindowXMLCache::Insert(const std::string &path, const CacheEntryPtr &entry)
+{
+  m_entries[path] = entry;
+  while (m_entries.size() > MAX_ENTRIES)
+  {
+    std::map<std::string, CacheEntryPtr>::iterator oldest = m_entries.begin();
+    for (std::map<std::string, CacheEntryPtr>::iterator i = m_entries.begin(); i != m_entries.end(); ++i)
+    {
+      if (i->second->lastUsed < oldest->second->lastUsed)
+        oldest = i;
+    }
+    m_entries.erase(oldest);
+  }
+}
+
+void CGUIWindowXMLCache::Preload(const std::string &folder, unsigned int generation)
+{
+  XFILE::CFile file;
+  XFILE::auto_buffer buffer;
+  if (file.LoadFile(folder + "preload.txt", buffer) <= 0)
+    return;
+
+  std::vector<std::string> paths = StringUtils::Split(std::string(buffer.get(), buffer.size()), "\n");
+  unsigned int loaded = 0;
+  for (std::vector<std::string>::const_iterator path = paths.begin(); path != paths.end() && loaded < MAX_ENTRIES; ++path)
+  {
+    if (path->empty())
+      continue;
+    {
+      CSingleLock lock(m_critSection);
+      if (m_generation != generation)
+        return;
+      if (m_entries.find(*path) != m_entries.end())
+        continue;
+    }
+
+    CacheEntryPtr entry = Load(GetCacheFile(folder, *path), *path);
+    if (!entry)
+      continue;
+
+    // validation needs the GUI thread, it's done when the window asks for it
+    CSingleLock lock(m_critSection);
+    if (m_generation != generation)
+      return;
+    if (m_entries.find(*path) == m_entries.end())
+    {
+      Insert(*path, entry);
+      loaded++;
+    }
+  }
+  CLog::Log(LOGDEBUG, "CGUIWindowXMLCache: preloaded %u windows from %s", loaded, folder.c_str());
+}
+
+std::string CGUIWindowXMLCache::GetCacheFile(const std::string &folder, const std::string &path)
+{
+  Crc32 crc;
+  crc.ComputeFromLowerCase(path);
+  return StringUtils::Format("%s%08x.bin", folder.c_str(), (uint32_t)crc);
+}
+
+bool CGUIWindowXMLCache::Save(const std::string &cacheFile, const std::string &path, const CacheEntry &entry)
+{
+  // write to a temporary file first so that a cache file is always complete
+  std::string tempFile = cacheFile + ".tmp";
+  XFILE::CFile file;
+  if (!file.OpenForWrite(tempFile, true))
+    return false;
+
+  {
+    CArchive ar(&file, CArchive::store);
+    ar << CACHE_MAGIC << CACHE_VERSION;
+    ar << path << entry.skinVersion;
+    ar << (unsigned int)entry.files.size();
+    for (std::vector<std::pair<std::string, int64_t>>::const_iterator i = entry.files.begin(); i != entry.files.end(); ++i)
+      ar << i->first << i->second;
+    ar << (unsigned int)entry.conditions.size();
+    for (std::vector<std::pair<std::string, bool>>::const_iterator i = entry.conditions.begin(); i != entry.conditions.end(); ++i)
+      ar << i->first << i->second;
+    Save(ar, *entry.root);
+    ar << CACHE_END;
+    ar.Close();
+  }
+  file.Close();
+
+  XFILE::CFile::Delete(cacheFile);
+  if (!XFILE::CFile::Rename(tempFile, cacheFile))
+  {
+    XFILE::CFile::Delete(tempFile);
+    return false;
+  }
+  return true;
+}
+
+CGUIWindowXMLCache::CacheEntryPtr CGUIWindowXMLCache::Load(const std::string &cacheFile, const std::string &path)
+{
+  XFILE::CFile file;
+  if (!file.Open(cacheFile))
+    return CacheEntryPtr();
+
+  CArchive ar(&file, CArchive::load);
+  unsigned int magic = 0;
+  unsigned int version = 0;
+  ar >> magic >> version;
+  if (magic != CACHE_MAGIC || version != CACHE_VERSION)
+    return CacheEntryPtr();
+
+  // the file name is a hash of the path, so check that it's really ours
+  std::string cachedPath;
+  ar >> cachedPath;
+  if (cachedPath != path)
+    return CacheEntryPtr();
+
+  CacheEntryPtr entry = std::make_shared<CacheEntry>();
+  ar >> entry->skinVersion;
+
+  unsigned int count = 0;
+  ar >> count;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    std::pair<std::string, int64_t> modified(std::string(), 0);
+    ar >> modified.first >> modified.second;
+    entry->files.push_back(modified);
+  }
+
+  count = 0;
+  ar >> count;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    std::pair<std::string, bool> condition(std::string(), false);
+    ar >> condition.first >> condition.second;
+    entry->conditions.push_back(condition);
+  }
+
+  TiXmlElement *root = Load(ar, 0);
+  if (!root)
+    return CacheEntryPtr();
+  entry->root.reset(root);
+
+  unsigned int end = 0;
+  ar >> end;
+  if (end != CACHE_END)
+  {
+    CLog::Log(LOGWARNING, "%s: %s is corrupt", __FUNCTION__, cacheFile.c_str());
+    return CacheEntryPtr();
+  }
+  return entry;
+}
+
+void CGUIWindowXMLCache::Save(CArchive &ar, const TiXmlElement &element)
+{
+  ar << element.ValueStr();
+
+  unsigned int attributes = 0;
+  for (const TiXmlAttribute *attribute = element.FirstAttribute(); attribute; attribute = attribute->Next())
+    attributes++;
+  ar << attributes;
+  for (const TiXmlAttribute *attribute = element.FirstAttribute(); attribute; attribute = attribute->Next())
+    ar << std::string(attribute->Name()) << std::string(attribute->Value());
+
+  // comments and the like don't matter once the window is loaded
+  unsigned int children = 0;
+  for (const TiXmlNode *child = element.FirstChild(); child; child = child->NextSibling())
+  {
+    if (child->ToElement() || child->ToText())
+      children++;
+  }
+  ar << children;
+  for (const TiXmlNode *child = element.FirstChild(); child; child = child->NextSibling())
+  {
+    if (const TiXmlElement *childElement = child->ToElement())
+    {
+      ar << (char)NODE_ELEMENT;
+      Save(ar, *childElement);
+    }
+    else if (const TiXmlText *text = child->ToText())
+    {
+      ar << (char)(text->CDATA() ? NODE_CDATA : NODE_TEXT);
+      ar << text->ValueStr();
+    }
+  }
+}
+
+TiXmlElement* CGUIWindowXMLCache::Load(CArchive &ar, unsigned int depth)
+{
+  if (depth > MAX_DEPTH)
+    return NULL;
+
+  std::string name;
+  ar >> name;
+  if (name.empty())
+    return NULL;
+  std::unique_ptr<TiXmlElement> element(new TiXmlElement(name.c_str()));
+
+  unsigned int attributes = 0;
+  ar >> attributes;
+  for (unsigned int i = 0; i < attributes; i++)
+  {
+    std::string attribute;
+    std::string value;
+    ar >> attribute >> value;
+    if (attribute.empty())
+      return NULL;
+    element->SetAttribute(attribute.c_str(), value.c_str());
+  }
+
+  unsigned int children = 0;
+  ar >> children;
+  for (unsigned int i = 0; i < children; i++)
+  {
+    char type = -1;
+    ar >> type;
+    if (type == NODE_ELEMENT)
+    {
+      TiXmlElement *child = Load(ar, depth + 1);
+      if (!child)
+        return NULL;
+      element->LinkEndChild(child);
+    }
+    else if (type == NODE_TEXT || type == NODE_CDATA)
+    {
+      std::string value;
+      ar >> value;
+      TiXmlText *text = new TiXmlText(value.c_str());
+      text->SetCDATA(type == NODE_CDATA);
+      element->LinkEndChild(text);
+    }
+    else
+      return NULL;
+  }
+  return element.release();
+}
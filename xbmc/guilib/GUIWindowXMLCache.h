@@ -0,0 +1,111 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "interfaces/info/InfoBool.h"
+#include "threads/CriticalSection.h"
+
+class CArchive;
+class TiXmlElement;
+
+/*! \brief Cache of window XML with the skin includes already resolved
+ Parsing a window and resolving its includes is most of the time spent loading it. The
+ resolved tree is kept in memory and in a binary file per window under
+ special://temp/skincache/<skin id>/, together with what it was resolved from: the skin
+ version, the modification times of the window and include files and the values of the
+ include conditions. An entry is only used while all of those are unchanged.
+
+ The windows used in a session are remembered when the skin is unloaded and read back
+ into memory by a background job on the next skin load, before they are needed.
+ */
+class CGUIWindowXMLCache
+{
+  friend class TestGUIWindowXMLCacheHelper;
+
+public:
+  static CGUIWindowXMLCache& GetInstance();
+
+  /*! \brief Start caching for the current skin, call after its includes are loaded
+   */
+  void Initialize();
+
+  /*! \brief Remember the windows used for the next session and drop the memory cache
+   */
+  void Deinitialize();
+
+  /*! \brief Fetch the resolved XML for a window file
+   \param path the window file
+   \param conditions [out] the include conditions the XML was resolved with
+   \return a copy of the resolved root element the caller takes ownership of, NULL if there is no valid entry
+   */
+  TiXmlElement* Get(const std::string &path, std::map<INFO::InfoPtr, bool> &conditions);
+
+  /*! \brief Store the resolved XML for a window file
+   The include files loaded so far are recorded with it, so call right after resolving.
+   \param path the window file the XML was loaded from
+   \param resolved the root element after resolving includes
+   \param conditions the include conditions used while resolving
+   */
+  void Add(const std::string &path, const TiXmlElement &resolved, const std::map<INFO::InfoPtr, bool> &conditions);
+
+private:
+  CGUIWindowXMLCache();
+  CGUIWindowXMLCache(const CGUIWindowXMLCache&) = delete;
+  CGUIWindowXMLCache& operator=(const CGUIWindowXMLCache&) = delete;
+
+  struct CacheEntry
+  {
+    CacheEntry() : lastUsed(0) {}
+
+    std::string skinVersion;
+    std::vector<std::pair<std::string, int64_t>> files; ///< window file first, then the include files in load order
+    std::vector<std::pair<std::string, bool>> conditions;
+    std::shared_ptr<const TiXmlElement> root;
+    unsigned int lastUsed;
+  };
+  typedef std::shared_ptr<CacheEntry> CacheEntryPtr;
+
+  bool IsValid(const CacheEntry &entry);
+  int64_t GetModificationTime(const std::string &path);
+  void Insert(const std::string &path, const CacheEntryPtr &entry);
+  void Preload(const std::string &folder, unsigned int generation);
+
+  static std::string GetCacheFile(const std::string &folder, const std::string &path);
+  static bool Save(const std::string &cacheFile, const std::string &path, const CacheEntry &entry);
+  static CacheEntryPtr Load(const std::string &cacheFile, const std::string &path);
+  static void Save(CArchive &ar, const TiXmlElement &element);
+  static TiXmlElement* Load(CArchive &ar, unsigned int depth);
+
+  CCriticalSection m_critSection;
+  std::map<std::string, CacheEntryPtr> m_entries;
+  std::map<std::string, int64_t> m_modificationTimes; ///< memoized for the session, only used from the GUI thread
+  std::string m_folder;
+  std::string m_skinVersion;
+  unsigned int m_generation;
+  unsigned int m_useCounter;
+};
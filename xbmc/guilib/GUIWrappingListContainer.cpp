@@ -141,7 +141,7 @@ void CGUIWrappingListContainer::ValidateOffset()
       // add additional copies of items, as we require extras at render time
       for (unsigned int i = 0; i < numItems; i++)
       {
-        m_items.push_back(CGUIListItemPtr(m_items[i]->Clone()));
+        m_items.push_back(m_items[i] ? CGUIListItemPtr(m_items[i]->Clone()) : CGUIListItemPtr());
         m_extraItems++;
       }
     }
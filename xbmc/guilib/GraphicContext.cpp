@@ -28,6 +28,7 @@
 #include "settings/Settings.h"
 #include "windowing/WindowingFactory.h"
 #include "TextureManager.h"
+#include "GUITexture.h"
 #include "input/InputManager.h"
 #include "GUIWindowManager.h"
 #include "video/VideoReferenceClock.h"
@@ -240,6 +241,7 @@ bool CGraphicContext::SetViewPort(float fx, float fy, float fwidth, float fheigh
   m_viewStack.push(newviewport);
 
   newviewport = StereoCorrection(newviewport);
+  CGUITexture::FlushBatch();
   g_Windowing.SetViewPort(newviewport);
 
 
@@ -251,6 +253,7 @@ void CGraphicContext::RestoreViewPort()
 {
   if (m_viewStack.size() <= 1) return;
 
+  CGUITexture::FlushBatch();
   m_viewStack.pop();
   CRect viewport = StereoCorrection(m_viewStack.top());
   g_Windowing.SetViewPort(viewport);
@@ -290,12 +293,14 @@ void CGraphicContext::SetScissors(const CRect &rect)
 {
   m_scissors = rect;
   m_scissors.Intersect(CRect(0,0,(float)m_iScreenWidth, (float)m_iScreenHeight));
+  CGUITexture::FlushBatch();
   g_Windowing.SetScissors(StereoCorrection(m_scissors));
 }
 
 void CGraphicContext::ResetScissors()
 {
   m_scissors.SetRect(0, 0, (float)m_iScreenWidth, (float)m_iScreenHeight);
+  CGUITexture::FlushBatch();
   g_Windowing.SetScissors(StereoCorrection(m_scissors));
 }
 
@@ -649,6 +654,7 @@ void CGraphicContext::ResetScreenParameters(RESOLUTION res)
 
 void CGraphicContext::Clear(color_t color)
 {
+  CGUITexture::FlushBatch();
   g_Windowing.ClearBuffers(color);
 }
 
@@ -659,6 +665,7 @@ void CGraphicContext::CaptureStateBlock()
 
 void CGraphicContext::ApplyStateBlock()
 {
+  CGUITexture::FlushBatch();
   g_Windowing.ApplyStateBlock();
 }
 
@@ -818,6 +825,7 @@ void CGraphicContext::SetStereoView(RENDER_STEREO_VIEW view)
   m_viewStack.push(viewport);
 
   viewport = StereoCorrection(viewport);
+  CGUITexture::FlushBatch();
   g_Windowing.SetStereoMode(m_stereoMode, m_stereoView);
   g_Windowing.SetViewPort(viewport);
   g_Windowing.SetScissors(viewport);
@@ -923,6 +931,7 @@ void CGraphicContext::UpdateCameraPosition(const CPoint &camera, const float &fa
     float scaleX = static_cast<float>(CSettings::GetInstance().GetInt(CSettings::SETTING_LOOKANDFEEL_STEREOSTRENGTH)) * scaleRes;
     stereoFactor = factor * (m_stereoView == RENDER_STEREO_VIEW_LEFT ? scaleX : -scaleX);
   }
+  CGUITexture::FlushBatch();
   g_Windowing.SetCameraPosition(camera, m_iScreenWidth, m_iScreenHeight, stereoFactor);
 }
 
@@ -993,11 +1002,13 @@ void CGraphicContext::Flip(bool rendered)
 
 void CGraphicContext::ApplyHardwareTransform()
 {
+  CGUITexture::FlushBatch();
   g_Windowing.ApplyHardwareTransform(m_finalTransform.matrix);
 }
 
 void CGraphicContext::RestoreHardwareTransform()
 {
+  CGUITexture::FlushBatch();
   g_Windowing.RestoreHardwareTransform();
 }
 
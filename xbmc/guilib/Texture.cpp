@@ -43,6 +43,7 @@ CBaseTexture::CBaseTexture(unsigned int width, unsigned int height, unsigned int
  : m_hasAlpha( true )
 {
   m_pixels = NULL;
+  m_mipmapCount = 1;
   m_loadedToGPU = false;
   Allocate(width, height, format);
 }
@@ -100,6 +101,8 @@ void CBaseTexture::Allocate(unsigned int width, unsigned int height, unsigned in
 
   delete[] m_pixels;
   m_pixels = NULL;
+  m_mipmaps.clear();
+  m_mipmapCount = 1;
   if (GetPitch() * GetRows() > 0)
   {
     m_pixels = new unsigned char[GetPitch() * GetRows()];
@@ -217,7 +220,37 @@ bool CBaseTexture::LoadFromFileInternal(const std::string& texturePath, unsigned
     CDDSImage image;
     if (image.ReadFile(texturePath))
     {
-      Update(image.GetWidth(), image.GetHeight(), 0, image.GetFormat(), image.GetData(), false);
+      // Update() only deals with uncompressed pixels (ClampToEdge would mangle
+      // the blocks), copy the compressed block rows as they are and leave any
+      // padding blank
+      Allocate(image.GetWidth(), image.GetHeight(), image.GetFormat());
+      if (m_pixels == NULL)
+        return false;
+
+      unsigned int srcPitch = GetPitch(image.GetWidth());
+      unsigned int srcRows = GetRows(image.GetHeight());
+      unsigned int dstPitch = GetPitch();
+      unsigned int dstRows = GetRows();
+      memset(m_pixels, 0, dstPitch * dstRows);
+      const unsigned char *src = image.GetData();
+      unsigned char *dst = m_pixels;
+      for (unsigned int y = 0; y < srcRows && y < dstRows; y++)
+      {
+        memcpy(dst, src, std::min(srcPitch, dstPitch));
+        src += srcPitch;
+        dst += dstPitch;
+      }
+
+      // the mip chain only matches if the texture didn't need padding
+      if (image.GetMipmapCount() > 1 && m_textureWidth == image.GetWidth() && m_textureHeight == image.GetHeight())
+      {
+        const unsigned char *mipmaps = image.GetData() + image.GetSize();
+        unsigned int size = 0;
+        for (unsigned int level = 1; level < image.GetMipmapCount(); level++)
+          size += GetPitch(std::max(m_textureWidth >> level, 1U)) * GetRows(std::max(m_textureHeight >> level, 1U));
+        m_mipmaps.assign(mipmaps, mipmaps + size);
+        m_mipmapCount = image.GetMipmapCount();
+      }
       return true;
     }
     return false;
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "system.h"
 #include "XBTF.h"
 #include "guilib/imagefactory.h"
@@ -92,6 +94,9 @@ public:
   /*! \brief return the original height of the image, before scaling/cropping */
   unsigned int GetOriginalHeight() const { return m_originalHeight; }
 
+  /*! \brief number of compressed mip levels to upload, including the top level held in the pixels */
+  unsigned int GetMipmapCount() const { return m_mipmapCount; }
+
   int GetOrientation() const { return m_orientation; }
   void SetOrientation(int orientation) { m_orientation = orientation; }
 
@@ -124,6 +129,8 @@ protected:
   unsigned int m_originalHeight;  ///< original image height before scaling or cropping
 
   unsigned char* m_pixels;
+  std::vector<unsigned char> m_mipmaps; ///< compressed mip levels below the top level, smallest last
+  unsigned int m_mipmapCount;
   bool m_loadedToGPU;
   unsigned int m_format;
   int m_orientation;
@@ -18,6 +18,8 @@
  *
  */
 
+#include <algorithm>
+
 #include "system.h"
 #include "Texture.h"
 #include "windowing/WindowingFactory.h"
@@ -123,6 +125,22 @@ void CGLTexture::LoadToGPU()
     // changed from glCompressedTexImage2D to support GL < 1.3
     glCompressedTexImage2DARB(GL_TEXTURE_2D, 0, format,
       m_textureWidth, m_textureHeight, 0, GetPitch() * GetRows(), m_pixels);
+
+    // pre-built mip levels from the texture cache, so minified posters don't shimmer
+    if (m_mipmapCount > 1)
+    {
+      const unsigned char *mipmap = &m_mipmaps[0];
+      for (unsigned int level = 1; level < m_mipmapCount; level++)
+      {
+        unsigned int width = std::max(m_textureWidth >> level, 1U);
+        unsigned int height = std::max(m_textureHeight >> level, 1U);
+        glCompressedTexImage2DARB(GL_TEXTURE_2D, level, format,
+          width, height, 0, GetPitch(width) * GetRows(height), mipmap);
+        mipmap += GetPitch(width) * GetRows(height);
+      }
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_mipmapCount - 1);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    }
   }
 
   glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
@@ -178,6 +196,7 @@ void CGLTexture::LoadToGPU()
 
   delete [] m_pixels;
   m_pixels = NULL;
+  std::vector<unsigned char>().swap(m_mipmaps);
 
   m_loadedToGPU = true;
 }
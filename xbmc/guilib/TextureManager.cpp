@@ -31,6 +31,7 @@
 #include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
 #include "URL.h"
+#include "settings/AdvancedSettings.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -224,6 +225,9 @@ void CTextureMap::Add(CBaseTexture* texture, int delay)
 /*                                                                      */
 /************************************************************************/
 CGUITextureManager::CGUITextureManager(void)
+  : m_unusedMemory(0)
+  , m_cacheHits(0)
+  , m_cacheMisses(0)
 {
   // we set the theme bundle to be the first bundle (thus prioritizing it)
   m_TexBundle[0].SetThemeBundle(true);
@@ -261,14 +265,10 @@ bool CGUITextureManager::HasTexture(const std::string &textureName, std::string
 
   // Check our loaded and bundled textures - we store in bundles using \\.
   std::string bundledName = CTextureBundle::Normalize(textureName);
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  if (m_textures.find(textureName) != m_textures.end())
   {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == textureName)
-    {
-      if (size) *size = 1;
-      return true;
-    }
+    if (size) *size = 1;
+    return true;
   }
 
   for (int i = 0; i < 2; i++)
@@ -298,33 +298,31 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
   if (size) // we found the texture
   {
-    for (int i = 0; i < (int)m_vecTextures.size(); ++i)
-    {
-      CTextureMap *pMap = m_vecTextures[i];
-      if (pMap->GetName() == strTextureName)
-      {
-        //CLog::Log(LOGDEBUG, "Total memusage %u", GetMemoryUsage());
-        return pMap->GetTexture();
-      }
-    }
-    // Whoops, not there.
-    return emptyTexture;
+    iTextures i = m_textures.find(strTextureName);
+    if (i == m_textures.end()) // Whoops, not there.
+      return emptyTexture;
+    //CLog::Log(LOGDEBUG, "Total memusage %u", GetMemoryUsage());
+    m_cacheHits++;
+    return i->second->GetTexture();
   }
 
-  for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end(); ++i)
+  auto unused = m_unusedIndex.find(strTextureName);
+  if (unused != m_unusedIndex.end())
   {
-    CTextureMap* pMap = i->first;
-    if (pMap->GetName() == strTextureName && i->second > 0)
-    {
-      m_vecTextures.push_back(pMap);
-      m_unusedTextures.erase(i);
-      return pMap->GetTexture();
-    }
+    CTextureMap* pMap = unused->second->first;
+    m_unusedMemory -= pMap->GetMemoryUsage();
+    m_unusedTextures.erase(unused->second);
+    m_unusedIndex.erase(unused);
+    m_textures[strTextureName] = pMap;
+    m_cacheHits++;
+    return pMap->GetTexture();
   }
 
   if (checkBundleOnly && bundle == -1)
     return emptyTexture;
 
+  m_cacheMisses++;
+
   //Lock here, we will do stuff that could break rendering
   CSingleLock lock(g_graphicsContext);
 
@@ -364,7 +362,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
     delete[] pTextures;
     delete[] Delay;
 
-    m_vecTextures.push_back(pMap);
+    m_textures[strTextureName] = pMap;
     return pMap->GetTexture();
   }
   else if (StringUtils::EndsWithNoCase(strPath, ".gif") ||
@@ -423,7 +421,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
     file.Close();
 
-    m_vecTextures.push_back(pMap);
+    m_textures[strTextureName] = pMap;
     return pMap->GetTexture();
   }
 
@@ -450,7 +448,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
   CTextureMap* pMap = new CTextureMap(strTextureName, width, height, 0);
   pMap->Add(pTexture, 100);
-  m_vecTextures.push_back(pMap);
+  m_textures[strTextureName] = pMap;
 
 #ifdef _DEBUG_TEXTURES
   int64_t end, freq;
@@ -469,25 +467,35 @@ void CGUITextureManager::ReleaseTexture(const std::string& strTextureName, bool
 {
   CSingleLock lock(g_graphicsContext);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  iTextures i = m_textures.find(strTextureName);
+  if (i == m_textures.end())
   {
-    CTextureMap* pMap = *i;
-    if (pMap->GetName() == strTextureName)
-    {
-      if (pMap->Release())
-      {
-        //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
-        // add to our textures to free
-        m_unusedTextures.push_back(std::make_pair(pMap, immediately ? 0 : XbmcThreads::SystemClockMillis()));
-        i = m_vecTextures.erase(i);
-      }
-      return;
-    }
-    ++i;
+    CLog::Log(LOGWARNING, "%s: Unable to release texture %s", __FUNCTION__, strTextureName.c_str());
+    return;
+  }
+
+  CTextureMap* pMap = i->second;
+  if (pMap->Release())
+  {
+    //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
+    // add to our textures to free - textures released immediately can't be reused
+    m_textures.erase(i);
+    ilistUnused unused = m_unusedTextures.insert(m_unusedTextures.end(), std::make_pair(pMap, immediately ? 0 : XbmcThreads::SystemClockMillis()));
+    m_unusedMemory += pMap->GetMemoryUsage();
+    if (!immediately)
+      m_unusedIndex[strTextureName] = unused;
   }
-  CLog::Log(LOGWARNING, "%s: Unable to release texture %s", __FUNCTION__, strTextureName.c_str());
+}
+
+CGUITextureManager::ilistUnused CGUITextureManager::FreeUnusedTexture(ilistUnused i)
+{
+  CTextureMap* pMap = i->first;
+  auto index = m_unusedIndex.find(pMap->GetName());
+  if (index != m_unusedIndex.end() && index->second == i)
+    m_unusedIndex.erase(index);
+  m_unusedMemory -= pMap->GetMemoryUsage();
+  delete pMap;
+  return m_unusedTextures.erase(i);
 }
 
 void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay)
@@ -497,14 +505,30 @@ void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay)
   for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end();)
   {
     if (currFrameTime - i->second >= timeDelay)
-    {
-      delete i->first;
-      i = m_unusedTextures.erase(i);
-    }
+      i = FreeUnusedTexture(i);
+    else
+      ++i;
+  }
+  FreeHwTextures();
+}
+
+void CGUITextureManager::TrimUnusedTextures()
+{
+  CSingleLock lock(g_graphicsContext);
+  // m_unusedTextures is ordered by release time, so evicting from the front drops the least recently used
+  uint64_t budget = (uint64_t)g_advancedSettings.m_guiTextureCacheSize * 1024 * 1024;
+  for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end();)
+  {
+    if (!i->second || m_unusedMemory > budget)
+      i = FreeUnusedTexture(i);
     else
       ++i;
   }
+  FreeHwTextures();
+}
 
+void CGUITextureManager::FreeHwTextures()
+{
 #if defined(HAS_GL) || defined(HAS_GLES)
   for (unsigned int i = 0; i < m_unusedHwTextures.size(); ++i)
   {
@@ -530,15 +554,13 @@ void CGUITextureManager::Cleanup()
 {
   CSingleLock lock(g_graphicsContext);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  for (iTextures i = m_textures.begin(); i != m_textures.end(); ++i)
   {
-    CTextureMap* pMap = *i;
+    CTextureMap* pMap = i->second;
     CLog::Log(LOGWARNING, "%s: Having to cleanup texture %s", __FUNCTION__, pMap->GetName().c_str());
     delete pMap;
-    i = m_vecTextures.erase(i);
   }
+  m_textures.clear();
   for (int i = 0; i < 2; i++)
     m_TexBundle[i].Cleanup();
   FreeUnusedTextures();
@@ -546,11 +568,12 @@ void CGUITextureManager::Cleanup()
 
 void CGUITextureManager::Dump() const
 {
-  CLog::Log(LOGDEBUG, "%s: total texturemaps size:%" PRIuS, __FUNCTION__, m_vecTextures.size());
+  CLog::Log(LOGDEBUG, "%s: total texturemaps size:%" PRIuS", unused:%" PRIuS" (%u bytes), hits:%u misses:%u", __FUNCTION__,
+            m_textures.size(), m_unusedTextures.size(), m_unusedMemory, m_cacheHits, m_cacheMisses);
 
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  for (TextureIndex::const_iterator i = m_textures.begin(); i != m_textures.end(); ++i)
   {
-    const CTextureMap* pMap = m_vecTextures[i];
+    const CTextureMap* pMap = i->second;
     if (!pMap->IsEmpty())
       pMap->Dump();
   }
@@ -560,16 +583,15 @@ void CGUITextureManager::Flush()
 {
   CSingleLock lock(g_graphicsContext);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  iTextures i = m_textures.begin();
+  while (i != m_textures.end())
   {
-    CTextureMap* pMap = *i;
+    CTextureMap* pMap = i->second;
     pMap->Flush();
     if (pMap->IsEmpty() )
     {
       delete pMap;
-      i = m_vecTextures.erase(i);
+      i = m_textures.erase(i);
     }
     else
     {
@@ -581,13 +603,16 @@ void CGUITextureManager::Flush()
 unsigned int CGUITextureManager::GetMemoryUsage() const
 {
   unsigned int memUsage = 0;
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
-  {
-    memUsage += m_vecTextures[i]->GetMemoryUsage();
-  }
+  for (TextureIndex::const_iterator i = m_textures.begin(); i != m_textures.end(); ++i)
+    memUsage += i->second->GetMemoryUsage();
   return memUsage;
 }
 
+uint32_t CGUITextureManager::GetUnusedMemoryUsage() const
+{
+  return m_unusedMemory;
+}
+
 void CGUITextureManager::SetTexturePath(const std::string &texturePath)
 {
   CSingleLock lock(m_section);
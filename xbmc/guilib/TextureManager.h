@@ -25,6 +25,8 @@
 #pragma once
 
 #include <list>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 
@@ -114,6 +116,9 @@ public:
   void Cleanup();
   void Dump() const;
   uint32_t GetMemoryUsage() const;
+  uint32_t GetUnusedMemoryUsage() const;  ///< Memory held by released textures kept around for reuse
+  unsigned int GetCacheHits() const { return m_cacheHits; }
+  unsigned int GetCacheMisses() const { return m_cacheMisses; }
   void Flush();
   std::string GetTexturePath(const std::string& textureName, bool directory = false);
   void GetBundledTexturesFromPath(const std::string& texturePath, std::vector<std::string> &items);
@@ -122,14 +127,25 @@ public:
   void SetTexturePath(const std::string &texturePath);    ///< Set a single path as the path to check when loading media (clear then add)
   void RemoveTexturePath(const std::string &texturePath); ///< Remove a path from the paths to check when loading media
 
-  void FreeUnusedTextures(unsigned int timeDelay = 0); ///< Free textures (called from app thread only)
+  void FreeUnusedTextures(unsigned int timeDelay = 0); ///< Free textures released more than timeDelay ms ago (called from app thread only)
+  void TrimUnusedTextures(); ///< Free released textures, least recently used first, until they fit the cache budget (called from app thread only)
   void ReleaseHwTexture(unsigned int texture);
 protected:
-  std::vector<CTextureMap*> m_vecTextures;
-  std::list<std::pair<CTextureMap*, unsigned int> > m_unusedTextures;
+  typedef std::unordered_map<std::string, CTextureMap*> TextureIndex;
+  typedef std::list<std::pair<CTextureMap*, unsigned int> > UnusedList;
+  typedef TextureIndex::iterator iTextures;
+  typedef UnusedList::iterator ilistUnused;
+
+  ilistUnused FreeUnusedTexture(ilistUnused i);
+  void FreeHwTextures();
+
+  TextureIndex m_textures;      ///< textures in use, by name
+  UnusedList m_unusedTextures;  ///< released textures with their release time, least recently released first
+  std::unordered_map<std::string, ilistUnused> m_unusedIndex; ///< reusable entries of m_unusedTextures, by name
+  uint32_t m_unusedMemory;
+  unsigned int m_cacheHits;
+  unsigned int m_cacheMisses;
   std::vector<unsigned int> m_unusedHwTextures;
-  typedef std::vector<CTextureMap*>::iterator ivecTextures;
-  typedef std::list<std::pair<CTextureMap*, unsigned int> >::iterator ilistUnused;
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
 
@@ -33,6 +33,8 @@ public:
    \param bufSize The size of the buffer
    \param width The ideal width of the texture
    \param height The ideal height of the texture
+   \remarks Loaders may decode at a reduced resolution that still covers width x height,
+   Width() and Height() then report the decoded size and originalWidth()/originalHeight() the full size.
    \return true if the image could be loaded
    */
   virtual bool LoadImageFromMemory(unsigned char* buffer, unsigned int bufSize, unsigned int width, unsigned int height)=0;
@@ -0,0 +1,170 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/File.h"
+#include "guilib/DDSImage.h"
+#include "guilib/FFmpegImage.h"
+#include "guilib/XBTF.h"
+#include "test/TestUtils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+// posters as cached at the default imageres
+const unsigned int POSTER_WIDTH = 480;
+const unsigned int POSTER_HEIGHT = 720;
+const unsigned int POSTER_WALL = 500;
+
+// the bytes CBaseTexture hands to the GPU for a texture, mip levels included
+unsigned int UploadSize(const CDDSImage &image)
+{
+  unsigned int size = 0;
+  unsigned int blockSize = image.GetFormat() == XB_FMT_DXT1 ? 8 : 16;
+  for (unsigned int level = 0; level < image.GetMipmapCount(); level++)
+  {
+    unsigned int width = std::max(image.GetWidth() >> level, 1U);
+    unsigned int height = std::max(image.GetHeight() >> level, 1U);
+    size += ((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+  }
+  return size;
+}
+}
+
+TEST(TestDDSImage, CompressOpaque)
+{
+  std::vector<unsigned char> pixels = CXBMCTestUtils::Instance().CreateTestSurface(POSTER_WIDTH + 2, POSTER_HEIGHT + 1, 0xff);
+
+  CDDSImage image;
+  ASSERT_TRUE(image.Compress(POSTER_WIDTH + 2, POSTER_HEIGHT + 1, (POSTER_WIDTH + 2) * 4, &pixels[0], true));
+  EXPECT_EQ((unsigned int)XB_FMT_DXT1, image.GetFormat());
+  EXPECT_EQ(POSTER_WIDTH + 2, image.GetWidth());
+  EXPECT_EQ(POSTER_HEIGHT + 1, image.GetHeight());
+  EXPECT_EQ(10U, image.GetMipmapCount());
+  EXPECT_EQ(121U * 181U * 8U, image.GetSize());
+}
+
+TEST(TestDDSImage, CompressAlpha)
+{
+  std::vector<unsigned char> pixels = CXBMCTestUtils::Instance().CreateTestSurface(64, 64, 0x80);
+
+  CDDSImage image;
+  ASSERT_TRUE(image.Compress(64, 64, 64 * 4, &pixels[0], false));
+  EXPECT_EQ((unsigned int)XB_FMT_DXT5, image.GetFormat());
+  EXPECT_EQ(1U, image.GetMipmapCount());
+  EXPECT_EQ(16U * 16U * 16U, image.GetSize());
+  // a constant alpha is stored as two equal endpoints
+  EXPECT_EQ(0x80, image.GetData()[0]);
+  EXPECT_EQ(0x80, image.GetData()[1]);
+}
+
+TEST(TestDDSImage, WriteAndRead)
+{
+  std::vector<unsigned char> pixels = CXBMCTestUtils::Instance().CreateTestSurface(POSTER_WIDTH, POSTER_HEIGHT, 0xff);
+  CDDSImage image;
+  ASSERT_TRUE(image.Compress(POSTER_WIDTH, POSTER_HEIGHT, POSTER_WIDTH * 4, &pixels[0], true));
+
+  XFILE::CFile *file = XBMC_CREATETEMPFILE(".dds");
+  ASSERT_NE(nullptr, file);
+  std::string path = XBMC_TEMPFILEPATH(file);
+  file->Close();
+  ASSERT_TRUE(image.WriteFile(path));
+
+  CDDSImage loaded;
+  ASSERT_TRUE(loaded.ReadFile(path));
+  EXPECT_EQ(image.GetFormat(), loaded.GetFormat());
+  EXPECT_EQ(image.GetWidth(), loaded.GetWidth());
+  EXPECT_EQ(image.GetHeight(), loaded.GetHeight());
+  ASSERT_EQ(image.GetMipmapCount(), loaded.GetMipmapCount());
+  unsigned int size = UploadSize(image);
+  EXPECT_EQ(0, memcmp(image.GetData(), loaded.GetData(), size));
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+// what it costs to get a wall of posters ready for the GPU from the texture
+// cache: decoding the cached JPG into an uncompressed texture versus reading
+// the DXT mip chain as is. The upload itself needs a GL context, so the bytes
+// handed to the driver (which is also what ends up in VRAM) stand in for it.
+/* Benchmark, run with --gtest_also_run_disabled_tests */
+TEST(TestDDSImage, DISABLED_PosterWallBenchmark)
+{
+  std::vector<unsigned char> pixels = CXBMCTestUtils::Instance().CreateTestSurface(POSTER_WIDTH, POSTER_HEIGHT, 0xff);
+
+  CFFmpegImage encoder("image/jpeg");
+  unsigned char *jpeg = nullptr;
+  unsigned int jpegSize = 0;
+  ASSERT_TRUE(encoder.CreateThumbnailFromSurface(&pixels[0], POSTER_WIDTH, POSTER_HEIGHT, XB_FMT_A8R8G8B8,
+                                                 POSTER_WIDTH * 4, "poster.jpg", jpeg, jpegSize));
+  XFILE::CFile *jpegFile = XBMC_CREATETEMPFILE(".jpg");
+  ASSERT_NE(nullptr, jpegFile);
+  std::string jpegPath = XBMC_TEMPFILEPATH(jpegFile);
+  ASSERT_TRUE(jpegFile->OpenForWrite(jpegPath, true));
+  ASSERT_EQ((ssize_t)jpegSize, jpegFile->Write(jpeg, jpegSize));
+  jpegFile->Close();
+  encoder.ReleaseThumbnailBuffer();
+
+  CDDSImage compressed;
+  ASSERT_TRUE(compressed.Compress(POSTER_WIDTH, POSTER_HEIGHT, POSTER_WIDTH * 4, &pixels[0], true));
+  XFILE::CFile *ddsFile = XBMC_CREATETEMPFILE(".dds");
+  ASSERT_NE(nullptr, ddsFile);
+  std::string ddsPath = XBMC_TEMPFILEPATH(ddsFile);
+  ddsFile->Close();
+  ASSERT_TRUE(compressed.WriteFile(ddsPath));
+
+  uint64_t rgbaBytes = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < POSTER_WALL; i++)
+  {
+    XFILE::CFile file;
+    XFILE::auto_buffer buffer;
+    ASSERT_LT(0, file.LoadFile(jpegPath, buffer));
+    CFFmpegImage image("image/jpeg");
+    ASSERT_TRUE(image.LoadImageFromMemory((unsigned char *)buffer.get(), buffer.size(), 0, 0));
+    std::vector<unsigned char> texture(image.Width() * image.Height() * 4);
+    ASSERT_TRUE(image.Decode(&texture[0], image.Width(), image.Height(), image.Width() * 4, XB_FMT_A8R8G8B8));
+    rgbaBytes += texture.size();
+  }
+  double rgbaMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  uint64_t dxtBytes = 0;
+  start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < POSTER_WALL; i++)
+  {
+    CDDSImage image;
+    ASSERT_TRUE(image.ReadFile(ddsPath));
+    dxtBytes += UploadSize(image);
+  }
+  double dxtMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << POSTER_WALL << " posters " << POSTER_WIDTH << "x" << POSTER_HEIGHT << std::endl;
+  std::cout << "  jpg -> rgba:      " << rgbaMs << " ms, " << rgbaBytes / (1024 * 1024) << " MB to upload" << std::endl;
+  std::cout << "  dds (dxt1+mips):  " << dxtMs << " ms, " << dxtBytes / (1024 * 1024) << " MB to upload" << std::endl;
+  EXPECT_LT(dxtBytes, rgbaBytes);
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(jpegFile));
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(ddsFile));
+}
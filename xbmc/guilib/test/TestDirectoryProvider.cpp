@@ -0,0 +1,75 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "listproviders/DirectoryProvider.h"
+#include "music/MusicDbUrl.h"
+#include "video/VideoDbUrl.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+const char *rules = "\"rules\":{\"and\":[{\"field\":\"genre\",\"operator\":\"is\",\"value\":[\"Drama\"]}]}";
+
+std::string Playlist(const std::string &type, const std::string &extra = "")
+{
+  return "{\"type\":\"" + type + "\"," + rules + extra + "}";
+}
+}
+
+TEST(TestDirectoryProvider, CanPagePlaylistWithoutOrderOrLimit)
+{
+  CVideoDbUrl videoUrl;
+  ASSERT_TRUE(videoUrl.FromString("videodb://movies/titles/"));
+  EXPECT_TRUE(CDirectoryProvider::CanPage(videoUrl));
+
+  videoUrl.AddOption("xsp", Playlist("movies"));
+  EXPECT_TRUE(CDirectoryProvider::CanPage(videoUrl));
+
+  CMusicDbUrl musicUrl;
+  ASSERT_TRUE(musicUrl.FromString("musicdb://songs/"));
+  musicUrl.AddOption("filter", Playlist("songs"));
+  EXPECT_TRUE(CDirectoryProvider::CanPage(musicUrl));
+}
+
+TEST(TestDirectoryProvider, CannotPagePlaylistWithOrderOrLimit)
+{
+  const std::string order = ",\"order\":{\"method\":\"year\",\"direction\":\"descending\"}";
+  const std::string limit = ",\"limit\":10";
+
+  for (const char *option : { "xsp", "filter" })
+  {
+    CVideoDbUrl orderedUrl;
+    ASSERT_TRUE(orderedUrl.FromString("videodb://movies/titles/"));
+    orderedUrl.AddOption(option, Playlist("movies", order));
+    EXPECT_FALSE(CDirectoryProvider::CanPage(orderedUrl)) << option;
+
+    CMusicDbUrl limitedUrl;
+    ASSERT_TRUE(limitedUrl.FromString("musicdb://songs/"));
+    limitedUrl.AddOption(option, Playlist("songs", limit));
+    EXPECT_FALSE(CDirectoryProvider::CanPage(limitedUrl)) << option;
+  }
+
+  // an option the database can't load would fail the query anyway
+  CVideoDbUrl brokenUrl;
+  ASSERT_TRUE(brokenUrl.FromString("videodb://movies/titles/"));
+  brokenUrl.AddOption("xsp", "{not json");
+  EXPECT_FALSE(CDirectoryProvider::CanPage(brokenUrl));
+}
@@ -0,0 +1,246 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/File.h"
+#include "guilib/DirtyRegionSolvers.h"
+#include "guilib/DirtyRegionTracker.h"
+#include "settings/AdvancedSettings.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+const float SCREEN_AREA = 1920.0f * 1080.0f;
+
+const char *TRACES[] = {
+  "cornerlabels.txt",
+  "listfocus.txt",
+  "osdbusy.txt",
+};
+
+// a trace has one line per frame listing the regions marked dirty in that frame
+// as x1,y1,x2,y2 separated by ';'. lines starting with # are comments.
+std::vector<CDirtyRegionList> LoadTrace(const std::string &name)
+{
+  std::vector<CDirtyRegionList> frames;
+  XFILE::CFile file;
+  XFILE::auto_buffer buffer;
+  if (file.LoadFile(XBMC_REF_FILE_PATH("xbmc/guilib/test/data/dirtyregions/" + name), buffer) <= 0)
+    return frames;
+
+  std::istringstream trace(std::string(buffer.get(), buffer.size()));
+  std::string line;
+  while (std::getline(trace, line))
+  {
+    if (StringUtils::StartsWith(line, "#"))
+      continue;
+    CDirtyRegionList frame;
+    std::vector<std::string> regions = StringUtils::Split(line, ";");
+    for (std::vector<std::string>::const_iterator i = regions.begin(); i != regions.end(); ++i)
+    {
+      std::vector<std::string> coords = StringUtils::Split(*i, ",");
+      if (coords.size() == 4)
+        frame.push_back(CDirtyRegion((float)atof(coords[0].c_str()), (float)atof(coords[1].c_str()),
+                                     (float)atof(coords[2].c_str()), (float)atof(coords[3].c_str())));
+    }
+    frames.push_back(frame);
+  }
+  return frames;
+}
+
+struct ReplayResult
+{
+  ReplayResult() : frames(0), renderedFrames(0), passes(0), pixels(0.0f) {}
+
+  unsigned int frames;
+  unsigned int renderedFrames;
+  unsigned int passes;
+  float pixels;
+};
+
+// feeds a trace through the tracker the way CGUIWindowManager does every frame
+ReplayResult Replay(const std::vector<CDirtyRegionList> &frames, int algorithm, bool checkCover)
+{
+  int oldAlgorithm = g_advancedSettings.m_guiAlgorithmDirtyRegions;
+  bool oldVisualize = g_advancedSettings.m_guiVisualizeDirtyRegions;
+  g_advancedSettings.m_guiAlgorithmDirtyRegions = algorithm;
+  g_advancedSettings.m_guiVisualizeDirtyRegions = false;
+
+  ReplayResult result;
+  CDirtyRegionTracker tracker;
+  tracker.SelectAlgorithm();
+  for (std::vector<CDirtyRegionList>::const_iterator frame = frames.begin(); frame != frames.end(); ++frame)
+  {
+    for (CDirtyRegionList::const_iterator region = frame->begin(); region != frame->end(); ++region)
+      tracker.MarkDirtyRegion(*region);
+
+    CDirtyRegionList passes = tracker.GetDirtyRegions();
+    result.frames++;
+    if (!passes.empty())
+      result.renderedFrames++;
+    result.passes += passes.size();
+    for (CDirtyRegionList::const_iterator pass = passes.begin(); pass != passes.end(); ++pass)
+      result.pixels += pass->Area();
+
+    if (checkCover)
+    {
+      // every marked region is redrawn and no pixel is drawn twice
+      const CDirtyRegionList &marked = tracker.GetMarkedRegions();
+      for (CDirtyRegionList::const_iterator region = marked.begin(); region != marked.end(); ++region)
+      {
+        bool covered = false;
+        for (CDirtyRegionList::const_iterator pass = passes.begin(); pass != passes.end() && !covered; ++pass)
+        {
+          CDirtyRegion temporaryUnion = *pass;
+          temporaryUnion.Union(*region);
+          covered = !(temporaryUnion != *pass);
+        }
+        EXPECT_TRUE(covered);
+      }
+      for (unsigned int i = 0; i < passes.size(); i++)
+      {
+        for (unsigned int j = i + 1; j < passes.size(); j++)
+        {
+          CDirtyRegion intersection = passes[i];
+          intersection.Intersect(passes[j]);
+          EXPECT_TRUE(intersection.IsEmpty());
+        }
+      }
+    }
+
+    tracker.CleanMarkedRegions();
+  }
+
+  g_advancedSettings.m_guiAlgorithmDirtyRegions = oldAlgorithm;
+  g_advancedSettings.m_guiVisualizeDirtyRegions = oldVisualize;
+  return result;
+}
+}
+
+TEST(TestDirtyRegionSolvers, ClusterSeparatesDistantRegions)
+{
+  CDirtyRegionList input;
+  input.push_back(CDirtyRegion(40, 30, 420, 80));
+  input.push_back(CDirtyRegion(1500, 1000, 1880, 1050));
+
+  CDirtyRegionList output;
+  CClusterDirtyRegionSolver solver;
+  solver.Solve(input, output);
+  ASSERT_EQ(2U, output.size());
+  EXPECT_EQ(380.0f * 50.0f * 2, output[0].Area() + output[1].Area());
+}
+
+TEST(TestDirtyRegionSolvers, ClusterMergesNeighbours)
+{
+  CDirtyRegionList input;
+  input.push_back(CDirtyRegion(100, 200, 800, 270));
+  input.push_back(CDirtyRegion(100, 270, 800, 340));
+  input.push_back(CDirtyRegion(100, 200, 800, 270));
+
+  CDirtyRegionList output;
+  CClusterDirtyRegionSolver solver;
+  solver.Solve(input, output);
+  ASSERT_EQ(1U, output.size());
+  EXPECT_FALSE(output[0] != CDirtyRegion(100, 200, 800, 340));
+}
+
+TEST(TestDirtyRegionSolvers, ClusterMergesOverlaps)
+{
+  CDirtyRegionList input;
+  input.push_back(CDirtyRegion(0, 0, 100, 100));
+  input.push_back(CDirtyRegion(1000, 0, 1100, 100));
+  input.push_back(CDirtyRegion(50, 50, 1050, 60));
+
+  // even though the union is expensive the regions overlap
+  CDirtyRegionList output;
+  CClusterDirtyRegionSolver solver(4, 0.0f);
+  solver.Solve(input, output);
+  ASSERT_EQ(1U, output.size());
+  EXPECT_FALSE(output[0] != CDirtyRegion(0, 0, 1100, 100));
+}
+
+TEST(TestDirtyRegionSolvers, ClusterLimitsRegions)
+{
+  CDirtyRegionList input;
+  for (int i = 0; i < 10; i++)
+    input.push_back(CDirtyRegion(i * 190.0f, i * 100.0f, i * 190.0f + 20, i * 100.0f + 20));
+
+  CDirtyRegionList output;
+  CClusterDirtyRegionSolver solver(3, 0.0f);
+  solver.Solve(input, output);
+  EXPECT_EQ(3U, output.size());
+}
+
+// replays the recorded traces, the clusters are disjoint parts of the union,
+// so they can never redraw more
+TEST(TestDirtyRegionSolvers, ReplayTracesClusterBounded)
+{
+  for (unsigned int t = 0; t < sizeof(TRACES) / sizeof(TRACES[0]); t++)
+  {
+    std::vector<CDirtyRegionList> frames = LoadTrace(TRACES[t]);
+    ASSERT_FALSE(frames.empty()) << TRACES[t];
+
+    ReplayResult unionResult = Replay(frames, DIRTYREGION_SOLVER_UNION, false);
+    ReplayResult clusterResult = Replay(frames, DIRTYREGION_SOLVER_CLUSTER, true);
+    EXPECT_LE(clusterResult.pixels, unionResult.pixels) << TRACES[t];
+    EXPECT_LE(clusterResult.passes, clusterResult.frames * 4) << TRACES[t];
+  }
+}
+
+/* Reports how many pixels every solver redraws on the recorded traces,
+ * run with --gtest_also_run_disabled_tests */
+TEST(TestDirtyRegionSolvers, DISABLED_ReplayTraces)
+{
+  struct Solver
+  {
+    int algorithm;
+    const char *name;
+  } solvers[] = {
+    { DIRTYREGION_SOLVER_UNION,          "union" },
+    { DIRTYREGION_SOLVER_COST_REDUCTION, "greedy" },
+    { DIRTYREGION_SOLVER_CLUSTER,        "cluster" },
+  };
+
+  for (unsigned int t = 0; t < sizeof(TRACES) / sizeof(TRACES[0]); t++)
+  {
+    std::vector<CDirtyRegionList> frames = LoadTrace(TRACES[t]);
+    ASSERT_FALSE(frames.empty()) << TRACES[t];
+
+    std::cout << TRACES[t] << " (" << frames.size() << " frames)" << std::endl;
+    ReplayResult results[sizeof(solvers) / sizeof(solvers[0])];
+    for (unsigned int s = 0; s < sizeof(solvers) / sizeof(solvers[0]); s++)
+    {
+      results[s] = Replay(frames, solvers[s].algorithm, solvers[s].algorithm == DIRTYREGION_SOLVER_CLUSTER);
+      std::cout << "  " << solvers[s].name << ": " << results[s].pixels / results[s].frames << " pixels/frame, "
+                << (float)results[s].passes / results[s].frames << " passes/frame" << std::endl;
+    }
+    // what fill viewport on change would redraw
+    std::cout << "  viewport: " << SCREEN_AREA * results[0].renderedFrames / frames.size() << " pixels/frame, "
+              << (float)results[0].renderedFrames / frames.size() << " passes/frame" << std::endl;
+  }
+}
@@ -0,0 +1,169 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/FFmpegImage.h"
+#include "guilib/XBTF.h"
+#include "test/TestUtils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+#if defined(TARGET_POSIX)
+#include <unistd.h>
+#endif
+
+#include "gtest/gtest.h"
+
+namespace
+{
+const unsigned int THUMB_WIDTH = 1920;
+const unsigned int THUMB_HEIGHT = 1080;
+
+// encodes a synthetic width x height image
+std::vector<unsigned char> CreateImage(const std::string &mimeType, unsigned int width, unsigned int height)
+{
+  std::vector<unsigned char> pixels = CXBMCTestUtils::Instance().CreateTestSurface(width, height);
+
+  std::vector<unsigned char> result;
+  CFFmpegImage encoder(mimeType);
+  unsigned char *buffer = nullptr;
+  unsigned int size = 0;
+  if (encoder.CreateThumbnailFromSurface(&pixels[0], width, height, XB_FMT_A8R8G8B8, width * 4,
+                                         mimeType == "image/png" ? "corpus.png" : "corpus.jpg", buffer, size))
+    result.assign(buffer, buffer + size);
+  encoder.ReleaseThumbnailBuffer();
+  return result;
+}
+
+// resident set size in KB, 0 where /proc isn't available
+long ResidentKB()
+{
+  long resident = 0;
+#if defined(TARGET_POSIX)
+  long pages = 0;
+  FILE *statm = fopen("/proc/self/statm", "r");
+  if (!statm)
+    return 0;
+  if (fscanf(statm, "%ld %ld", &pages, &resident) != 2)
+    resident = 0;
+  fclose(statm);
+  resident *= sysconf(_SC_PAGESIZE) / 1024;
+#endif
+  return resident;
+}
+
+// loads and decodes an image the way CTextureCacheJob does, either asking for
+// the thumbnail size up front or decoding at full size and scaling afterwards.
+// memory is how much the resident set grew while the decoded frame was alive.
+bool DecodeThumb(const std::string &mimeType, std::vector<unsigned char> &data, bool reduced,
+                 unsigned int &width, unsigned int &height, long &memory)
+{
+  long before = ResidentKB();
+  CFFmpegImage image(mimeType);
+  if (!image.LoadImageFromMemory(&data[0], data.size(), reduced ? THUMB_WIDTH : 0, reduced ? THUMB_HEIGHT : 0))
+    return false;
+
+  std::vector<unsigned char> pixels(THUMB_WIDTH * THUMB_HEIGHT * 4);
+  if (!image.Decode(&pixels[0], THUMB_WIDTH, THUMB_HEIGHT, THUMB_WIDTH * 4, XB_FMT_A8R8G8B8))
+    return false;
+
+  memory = ResidentKB() - before;
+  width = image.Width();
+  height = image.Height();
+  return true;
+}
+}
+
+TEST(TestFFmpegImage, ReducedJpegDecode)
+{
+  std::vector<unsigned char> jpeg = CreateImage("image/jpeg", 4000, 3000);
+  ASSERT_FALSE(jpeg.empty());
+
+  CFFmpegImage image("image/jpeg");
+  ASSERT_TRUE(image.LoadImageFromMemory(&jpeg[0], jpeg.size(), THUMB_WIDTH, THUMB_HEIGHT));
+  EXPECT_EQ(4000U, image.originalWidth());
+  EXPECT_EQ(3000U, image.originalHeight());
+  EXPECT_EQ(1440U, image.Width());
+  EXPECT_EQ(THUMB_HEIGHT, image.Height());
+
+  std::vector<unsigned char> pixels(image.Width() * image.Height() * 4);
+  EXPECT_TRUE(image.Decode(&pixels[0], image.Width(), image.Height(), image.Width() * 4, XB_FMT_A8R8G8B8));
+  EXPECT_EQ(1440U, image.Width());
+  EXPECT_EQ(THUMB_HEIGHT, image.Height());
+}
+
+TEST(TestFFmpegImage, FullSizeDecode)
+{
+  std::vector<unsigned char> png = CreateImage("image/png", 800, 600);
+  ASSERT_FALSE(png.empty());
+
+  // no size requested and images smaller than the requested size are left alone
+  for (unsigned int size = 0; size <= THUMB_WIDTH; size += THUMB_WIDTH)
+  {
+    CFFmpegImage image("image/png");
+    ASSERT_TRUE(image.LoadImageFromMemory(&png[0], png.size(), size, size));
+    EXPECT_EQ(800U, image.Width());
+    EXPECT_EQ(600U, image.Height());
+    EXPECT_EQ(800U, image.originalWidth());
+    EXPECT_EQ(600U, image.originalHeight());
+  }
+}
+
+/* Benchmark, run with --gtest_also_run_disabled_tests */
+TEST(TestFFmpegImage, DISABLED_Benchmark)
+{
+  // large fanart sized images as they come from scrapers and cameras
+  struct Corpus
+  {
+    std::string mimeType;
+    std::vector<unsigned char> data;
+  } corpus[] = {
+    { "image/jpeg", CreateImage("image/jpeg", 6000, 4000) },
+    { "image/jpeg", CreateImage("image/jpeg", 4000, 6000) },
+    { "image/png",  CreateImage("image/png", 6000, 4000) },
+  };
+  const int rounds = 3;
+
+  for (int reduced = 0; reduced < 2; reduced++)
+  {
+    int thumbs = 0;
+    long peak = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+    {
+      for (auto &image : corpus)
+      {
+        ASSERT_FALSE(image.data.empty());
+        unsigned int width = 0, height = 0;
+        long memory = 0;
+        ASSERT_TRUE(DecodeThumb(image.mimeType, image.data, reduced != 0, width, height, memory));
+        peak = std::max(peak, memory);
+        EXPECT_LE(width, THUMB_WIDTH);
+        EXPECT_LE(height, THUMB_HEIGHT);
+        thumbs++;
+      }
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << (reduced ? "reduced decode: " : "full decode:    ") << ms / thumbs << " ms/thumbnail, peak RSS +"
+              << peak << " KB" << std::endl;
+  }
+}
@@ -0,0 +1,101 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/File.h"
+#include "guilib/GUIWindowXMLCache.h"
+#include "test/TestUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include "gtest/gtest.h"
+
+class TestGUIWindowXMLCacheHelper
+{
+public:
+  typedef CGUIWindowXMLCache::CacheEntry CacheEntry;
+  typedef CGUIWindowXMLCache::CacheEntryPtr CacheEntryPtr;
+
+  static bool Save(const std::string &cacheFile, const std::string &path, const CacheEntry &entry)
+  {
+    return CGUIWindowXMLCache::Save(cacheFile, path, entry);
+  }
+
+  static CacheEntryPtr Load(const std::string &cacheFile, const std::string &path)
+  {
+    return CGUIWindowXMLCache::Load(cacheFile, path);
+  }
+};
+
+namespace
+{
+const char *WINDOW_XML =
+  "<window type=\"dialog\" id=\"1100\">"
+    "<defaultcontrol always=\"true\">2</defaultcontrol>"
+    "<controls>"
+      "<control type=\"label\" id=\"2\">"
+        "<label>$LOCALIZE[31000]</label>"
+        "<visible>Player.HasVideo + !Skin.HasSetting(hide)</visible>"
+      "</control>"
+      "<onload><![CDATA[SetProperty(a,<b>)]]></onload>"
+    "</controls>"
+  "</window>";
+
+std::string ToString(const TiXmlElement &element)
+{
+  TiXmlPrinter printer;
+  element.Accept(&printer);
+  return printer.Str();
+}
+}
+
+TEST(TestGUIWindowXMLCache, RoundTrip)
+{
+  CXBMCTinyXML doc;
+  ASSERT_TRUE(doc.Parse(WINDOW_XML));
+  ASSERT_NE(nullptr, doc.RootElement());
+
+  TestGUIWindowXMLCacheHelper::CacheEntry entry;
+  entry.skinVersion = "1.2.3";
+  entry.files.push_back(std::make_pair(std::string("special://skin/xml/DialogTest.xml"), (int64_t)1234));
+  entry.files.push_back(std::make_pair(std::string("special://skin/xml/Includes.xml"), (int64_t)5678));
+  entry.conditions.push_back(std::make_pair(std::string("player.hasvideo"), true));
+  entry.conditions.push_back(std::make_pair(std::string("skin.hassetting(hide)"), false));
+  entry.root.reset(static_cast<TiXmlElement*>(doc.RootElement()->Clone()));
+
+  XFILE::CFile *file = XBMC_CREATETEMPFILE(".bin");
+  ASSERT_NE(nullptr, file);
+  std::string cacheFile = XBMC_TEMPFILEPATH(file);
+  file->Close();
+
+  ASSERT_TRUE(TestGUIWindowXMLCacheHelper::Save(cacheFile, entry.files[0].first, entry));
+  EXPECT_FALSE(XFILE::CFile::Exists(cacheFile + ".tmp"));
+
+  // the file name is a hash of the path, a different path must not match
+  EXPECT_TRUE(TestGUIWindowXMLCacheHelper::Load(cacheFile, "special://skin/xml/Other.xml").get() == NULL);
+
+  TestGUIWindowXMLCacheHelper::CacheEntryPtr loaded = TestGUIWindowXMLCacheHelper::Load(cacheFile, entry.files[0].first);
+  ASSERT_TRUE(loaded.get() != NULL);
+  EXPECT_EQ(entry.skinVersion, loaded->skinVersion);
+  EXPECT_EQ(entry.files, loaded->files);
+  EXPECT_EQ(entry.conditions, loaded->conditions);
+  ASSERT_TRUE(loaded->root.get() != NULL);
+  EXPECT_EQ(ToString(*entry.root), ToString(*loaded->root));
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
@@ -19,7 +19,9 @@
  */
 
 #include "InfoBool.h"
+#include "guilib/GUIControlProfiler.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 
 namespace INFO
 {
@@ -27,9 +29,23 @@ namespace INFO
     : m_value(false),
       m_context(context),
       m_listItemDependent(false),
+      m_sources(INFO_SOURCE_FRAME),
       m_expression(expression),
       m_dirty(true)
   {
     StringUtils::ToLower(m_expression);
   }
+
+  void InfoBool::Evaluate(const CGUIListItem *item)
+  {
+    if (!CGUIControlProfiler::IsRunning())
+    {
+      Update(item);
+      return;
+    }
+
+    int64_t start = CurrentHostCounter();
+    Update(item);
+    CGUIControlProfiler::Instance().AddConditionEvaluation(m_expression, CurrentHostCounter() - start);
+  }
 }
@@ -27,6 +27,20 @@ class CGUIListItem;
 
 namespace INFO
 {
+/*!
+ \ingroup info
+ \brief Sources of information boolean conditions depend upon
+ A condition is only re-evaluated once a source it depends upon has changed.
+ */
+enum InfoSource
+{
+  INFO_SOURCE_NONE          = 0,      ///< constant for the lifetime of the application
+  INFO_SOURCE_FRAME         = 1 << 0, ///< may change any frame
+  INFO_SOURCE_SKIN_SETTINGS = 1 << 1, ///< changes with the skin settings
+  INFO_SOURCE_LIBRARY       = 1 << 2, ///< changes with the library content
+  INFO_SOURCE_ALL           = ~0
+};
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -44,6 +58,14 @@ public:
   {
     m_dirty = true;
   }
+  /*! \brief Set the info bool dirty if it depends on any of the given sources.
+   \param sources the INFO_SOURCE_* flags of the sources that changed
+   */
+  void SetDirty(int sources)
+  {
+    if (m_sources & sources)
+      m_dirty = true;
+  }
   /*! \brief Get the value of this info bool
    This is called to update (if dirty) and fetch the value of the info bool
    \param item the item used to evaluate the bool
@@ -51,10 +73,10 @@ public:
   inline bool Get(const CGUIListItem *item = NULL)
   {
     if (item && m_listItemDependent)
-      Update(item);
+      Evaluate(item);
     else if (m_dirty)
     {
-      Update(NULL);
+      Evaluate(NULL);
       m_dirty = false;
     }
     return m_value;
@@ -73,13 +95,19 @@ public:
 
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+  int GetSources() const { return m_sources; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
+  int m_sources;               ///< INFO_SOURCE_* flags of the sources the value depends on
 
 private:
+  /*! \brief Update the value, accounting the time taken to the GUI control profiler if it is running
+   */
+  void Evaluate(const CGUIListItem *item);
+
   std::string  m_expression;   ///< original expression
   bool         m_dirty;        ///< whether we need an update
 };
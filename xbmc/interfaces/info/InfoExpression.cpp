@@ -22,6 +22,7 @@
 #include <stack>
 #include "utils/log.h"
 #include "GUIInfoManager.h"
+#include <algorithm>
 #include <list>
 #include <memory>
 
@@ -31,6 +32,7 @@ InfoSingle::InfoSingle(const std::string &expression, int context)
 : InfoBool(expression, context)
 {
   m_condition = g_infoManager.TranslateSingleString(expression, m_listItemDependent);
+  m_sources = g_infoManager.GetInfoSources(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -41,16 +43,22 @@ void InfoSingle::Update(const CGUIListItem *item)
 InfoExpression::InfoExpression(const std::string &expression, int context)
 : InfoBool(expression, context)
 {
-  if (!Parse(expression))
+  InfoSubexpressionPtr tree;
+  if (!Parse(expression, tree))
   {
     CLog::Log(LOGERROR, "Error parsing boolean expression %s", expression.c_str());
-    m_expression_tree = std::make_shared<InfoLeaf>(g_infoManager.Register("false", 0), false);
+    InfoPtr info = g_infoManager.Register("false", 0);
+    m_listItemDependent = false;
+    m_sources = info->GetSources();
+    tree = std::make_shared<InfoLeaf>(info, false);
   }
+  // the root is always the first node
+  Compile(tree);
 }
 
 void InfoExpression::Update(const CGUIListItem *item)
 {
-  m_value = m_expression_tree->Evaluate(item);
+  m_value = Evaluate(0, item);
 }
 
 /* Expressions are rewritten at parse time into a form which favours the
@@ -71,9 +79,68 @@ void InfoExpression::Update(const CGUIListItem *item)
  *    operations. So [A|B]|[C|D+[[E|F]|G] becomes A|B|C|[D+[E|F|G]].
  */
 
-bool InfoExpression::InfoLeaf::Evaluate(const CGUIListItem *item)
+/* Once parsed, the tree is compiled into a flat array of nodes so evaluation
+ * doesn't need to chase pointers through lists of reference counted nodes.
+ * Leaves refer to registered conditions, so a condition shared by any number
+ * of expressions is still only evaluated once while it isn't dirty. An
+ * expression as a whole is only dirtied when one of the sources of its leaves
+ * changes (see InfoBool::SetDirty).
+ */
+
+unsigned int InfoExpression::Compile(const InfoSubexpressionPtr &tree)
 {
-  return m_invert ^ m_info->Get(item);
+  unsigned int index = m_nodes.size();
+  m_nodes.push_back(InfoNode());
+  m_nodes[index].m_type = tree->Type();
+  m_nodes[index].m_invert = false;
+  m_nodes[index].m_first = 0;
+  m_nodes[index].m_count = 0;
+
+  if (tree->Type() == NODE_LEAF)
+  {
+    const InfoLeaf *leaf = static_cast<const InfoLeaf*>(tree.get());
+    m_nodes[index].m_info = leaf->m_info;
+    m_nodes[index].m_invert = leaf->m_invert;
+    return index;
+  }
+
+  // reserve the range of children first, their own children follow
+  const std::list<InfoSubexpressionPtr> &children = static_cast<const InfoAssociativeGroup*>(tree.get())->m_children;
+  unsigned int first = m_children.size();
+  m_nodes[index].m_first = first;
+  m_nodes[index].m_count = children.size();
+  m_children.resize(first + children.size());
+  for (std::list<InfoSubexpressionPtr>::const_iterator i = children.begin(); i != children.end(); ++i)
+  {
+    unsigned int child = Compile(*i);
+    m_children[first++] = child;
+  }
+  return index;
+}
+
+bool InfoExpression::Evaluate(unsigned int node, const CGUIListItem *item)
+{
+  const InfoNode &info = m_nodes[node];
+  if (info.m_type == NODE_LEAF)
+    return info.m_invert ^ info.m_info->Get(item);
+
+  /* Handle either AND or OR by using the relation
+   * A AND B == !(!A OR !B)
+   * to convert ANDs into ORs
+   */
+  bool use_and = (info.m_type == NODE_AND);
+  unsigned int *children = &m_children[info.m_first];
+  for (unsigned int i = 0; i < info.m_count; i++)
+  {
+    if (use_and ^ Evaluate(children[i], item))
+    {
+      /* Move this child to the head of the range so we evaluate faster next time */
+      if (i)
+        std::rotate(children, children + i, children + i + 1);
+      return !use_and;
+    }
+  }
+  return use_and;
 }
 
 InfoExpression::InfoAssociativeGroup::InfoAssociativeGroup(
@@ -96,29 +163,6 @@ void InfoExpression::InfoAssociativeGroup::Merge(std::shared_ptr<InfoAssociative
   m_children.splice(m_children.end(), other->m_children);
 }
 
-bool InfoExpression::InfoAssociativeGroup::Evaluate(const CGUIListItem *item)
-{
-  /* Handle either AND or OR by using the relation
-   * A AND B == !(!A OR !B)
-   * to convert ANDs into ORs
-   */
-  std::list<InfoSubexpressionPtr>::iterator last = m_children.end();
-  std::list<InfoSubexpressionPtr>::iterator it = m_children.begin();
-  bool use_and = (m_type == NODE_AND);
-  bool result = use_and ^ (*it)->Evaluate(item);
-  while (!result && ++it != last)
-  {
-    result = use_and ^ (*it)->Evaluate(item);
-    if (result)
-    {
-      /* Move this child to the head of the list so we evaluate faster next time */
-      m_children.push_front(*it);
-      m_children.erase(it);
-    }
-  }
-  return use_and ^ result;
-}
-
 /* Expressions are parsed using the shunting-yard algorithm. Binary operators
  * (AND/OR) are treated as right-associative so that we don't need to make a
  * special case for the unary NOT operator. This has no effect upon the answers
@@ -207,8 +251,9 @@ void InfoExpression::OperatorPop(std::stack<operator_t> &operator_stack, bool &i
   }
 }
 
-bool InfoExpression::Parse(const std::string &expression)
+bool InfoExpression::Parse(const std::string &expression, InfoSubexpressionPtr &tree)
 {
+  m_sources = INFO_SOURCE_NONE;
   const char *s = expression.c_str();
   std::string operand;
   std::stack<operator_t> operator_stack;
@@ -248,8 +293,9 @@ bool InfoExpression::Parse(const std::string &expression)
           CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
           return false;
         }
-        /* Propagate any listItem dependency from the operand to the expression */
+        /* Propagate any listItem dependency and the sources from the operand to the expression */
         m_listItemDependent |= info->ListItemDependent();
+        m_sources |= info->GetSources();
         nodes.push(std::make_shared<InfoLeaf>(info, invert));
         /* Reuse operand string for next operand */
         operand.clear();
@@ -299,13 +345,14 @@ bool InfoExpression::Parse(const std::string &expression)
       CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
       return false;
     }
-    /* Propagate any listItem dependency from the operand to the expression */
+    /* Propagate any listItem dependency and the sources from the operand to the expression */
     m_listItemDependent |= info->ListItemDependent();
+    m_sources |= info->GetSources();
     nodes.push(std::make_shared<InfoLeaf>(info, invert));
   }
   while (!operator_stack.empty())
     OperatorPop(operator_stack, invert, nodes);
 
-  m_expression_tree = nodes.top();
+  tree = nodes.top();
   return true;
 }
@@ -74,7 +74,6 @@ private:
   {
   public:
     virtual ~InfoSubexpression(void) {}; // so we can destruct derived classes using a pointer to their base class
-    virtual bool Evaluate(const CGUIListItem *item) = 0;
     virtual node_type_t Type() const=0;
   };
 
@@ -85,9 +84,9 @@ private:
   {
   public:
     InfoLeaf(InfoPtr info, bool invert) : m_info(info), m_invert(invert) {};
-    virtual bool Evaluate(const CGUIListItem *item);
     virtual node_type_t Type() const { return NODE_LEAF; };
   private:
+    friend class InfoExpression;
     InfoPtr m_info;
     bool m_invert;
   };
@@ -99,17 +98,32 @@ private:
     InfoAssociativeGroup(node_type_t type, const InfoSubexpressionPtr &left, const InfoSubexpressionPtr &right);
     void AddChild(const InfoSubexpressionPtr &child);
     void Merge(std::shared_ptr<InfoAssociativeGroup> other);
-    virtual bool Evaluate(const CGUIListItem *item);
     virtual node_type_t Type() const { return m_type; };
   private:
+    friend class InfoExpression;
     node_type_t m_type;
     std::list<InfoSubexpressionPtr> m_children;
   };
 
+  // A node of the compiled expression. The nodes of an expression are kept
+  // together in m_nodes, and the children of a group are a range of m_children.
+  struct InfoNode
+  {
+    node_type_t m_type;
+    bool m_invert;          ///< leaves only, whether the value is inverted
+    InfoPtr m_info;         ///< leaves only, the condition
+    unsigned int m_first;   ///< groups only, the first child in m_children
+    unsigned int m_count;   ///< groups only, the number of children
+  };
+
   static operator_t GetOperator(char ch);
   static void OperatorPop(std::stack<operator_t> &operator_stack, bool &invert, std::stack<InfoSubexpressionPtr> &nodes);
-  bool Parse(const std::string &expression);
-  InfoSubexpressionPtr m_expression_tree;
+  bool Parse(const std::string &expression, InfoSubexpressionPtr &tree);
+  unsigned int Compile(const InfoSubexpressionPtr &tree);
+  bool Evaluate(unsigned int node, const CGUIListItem *item);
+
+  std::vector<InfoNode> m_nodes;
+  std::vector<unsigned int> m_children;
 };
 
 };
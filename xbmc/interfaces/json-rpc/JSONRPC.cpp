@@ -235,13 +235,21 @@ JSONRPC_STATUS CJSONRPC::NotifyAll(const std::string &method, ITransportLayer *t
 
 std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client)
 {
-  CVariant inputroot, outputroot, result;
+  CVariant outputroot;
+  std::string str = MethodCall(inputString, transport, client, outputroot) ? CJSONVariantWriter::Write(outputroot, g_advancedSettings.m_jsonOutputCompact) : "";
+  return str;
+}
+
+bool CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client, CVariant &outputroot)
+{
+  CVariant inputroot;
   bool hasResponse = false;
 
   if(g_advancedSettings.CanLogComponent(LOGJSONRPC))
     CLog::Log(LOGDEBUG, "JSONRPC: Incoming request: %s", inputString.c_str());
 
-  inputroot = CJSONVariantParser::Parse((unsigned char *)inputString.c_str(), inputString.length());
+  // parsed straight into inputroot, the request tree is never copied
+  CJSONVariantParser::Parse(inputString.c_str(), inputString.length(), inputroot);
   if (!inputroot.isNull())
   {
     if (inputroot.isArray())
@@ -259,7 +267,7 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
           CVariant response;
           if (HandleMethodCall(*itr, response, transport, client))
           {
-            outputroot.append(response);
+            outputroot.append(std::move(response));
             hasResponse = true;
           }
         }
@@ -275,8 +283,7 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
     hasResponse = true;
   }
 
-  std::string str = hasResponse ? CJSONVariantWriter::Write(outputroot, g_advancedSettings.m_jsonOutputCompact) : "";
-  return str;
+  return hasResponse;
 }
 
 bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
@@ -298,7 +305,7 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
     if ((errorCode = CJSONServiceDescription::CheckCall(methodName.c_str(), request["params"], transport, client, isNotification, method, params)) == OK)
       errorCode = method(methodName, transport, client, params, result);
     else
-      result = params;
+      result = std::move(params);
   }
   else
   {
@@ -306,7 +313,7 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
     errorCode = InvalidRequest;
   }
 
-  BuildResponse(request, errorCode, result, response);
+  BuildResponse(request, errorCode, std::move(result), response);
 
   return !isNotification;
 }
@@ -316,7 +323,7 @@ inline bool CJSONRPC::IsProperJSONRPC(const CVariant& inputroot)
   return inputroot.isObject() && inputroot.isMember("jsonrpc") && inputroot["jsonrpc"].isString() && inputroot["jsonrpc"] == CVariant("2.0") && inputroot.isMember("method") && inputroot["method"].isString() && (!inputroot.isMember("params") || inputroot["params"].isArray() || inputroot["params"].isObject());
 }
 
-inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response)
+inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant&& result, CVariant& response)
 {
   response["jsonrpc"] = "2.0";
   response["id"] = request.isObject() && request.isMember("id") ? request["id"] : CVariant();
@@ -324,7 +331,8 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
   switch (code)
   {
     case OK:
-      response["result"] = result;
+      // moved, results like VideoLibrary.GetMovies can be large
+      response["result"] = std::move(result);
       break;
     case ACK:
       response["result"] = "OK";
@@ -337,7 +345,7 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
       response["error"]["code"] = InvalidParams;
       response["error"]["message"] = "Invalid params.";
       if (!result.isNull())
-        response["error"]["data"] = result;
+        response["error"]["data"] = std::move(result);
       break;
     case MethodNotFound:
       response["error"]["code"] = MethodNotFound;
@@ -64,6 +64,20 @@ namespace JSONRPC
      */
     static std::string MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client);
 
+    /*!
+     \brief Handles an incoming JSON-RPC request without serializing the response
+     \param inputString received JSON-RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \param response JSON-RPC response to be sent back to the client
+     \return True if there is a response to send back, false for notifications
+
+     Same as MethodCall() above but leaves the response as a CVariant so the
+     transport can serialize it straight into its own buffers with
+     CJSONVariantStreamWriter.
+     */
+    static bool MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client, CVariant &response);
+
     static JSONRPC_STATUS Introspect(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Version(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Permission(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
@@ -77,7 +91,7 @@ namespace JSONRPC
     static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
-    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
+    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant&& result, CVariant& response);
 
     static bool m_initialized;
   };
@@ -20,6 +20,7 @@
 
 #include "DirectoryProvider.h"
 
+#include <cstdlib>
 #include <memory>
 #include <utility>
 
@@ -28,30 +29,45 @@
 #include "filesystem/FavouritesDirectory.h"
 #include "guilib/GUIWindowManager.h"
 #include "interfaces/AnnouncementManager.h"
+#include "media/MediaType.h"
 #include "messaging/ApplicationMessenger.h"
+#include "music/MusicDatabase.h"
+#include "music/MusicDbUrl.h"
 #include "music/MusicThumbLoader.h"
 #include "pictures/PictureThumbLoader.h"
+#include "playlists/SmartPlayList.h"
 #include "settings/Settings.h"
 #include "threads/SingleLock.h"
+#include "utils/DatabaseUtils.h"
 #include "utils/JobManager.h"
 #include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "utils/XMLUtils.h"
+#include "video/VideoDatabase.h"
+#include "video/VideoDbUrl.h"
 #include "video/VideoThumbLoader.h"
 
 using namespace XFILE;
 using namespace ANNOUNCEMENT;
 using namespace KODI::MESSAGING;
 
+// items per page of a paged list, and the pages fetched ahead that are kept around
+static const unsigned int PAGE_SIZE = 100;
+static const size_t MAX_PAGES = 8;
+
 class CDirectoryJob : public CJob
 {
 public:
-  CDirectoryJob(const std::string &url, SortDescription sort, int limit, int parentID)
+  CDirectoryJob(const std::string &url, SortDescription sort, int limit, int parentID, int page = -1)
     : m_url(url),
       m_sort(sort),
       m_limit(limit),
-      m_parentID(parentID)
+      m_parentID(parentID),
+      m_page(page),
+      m_paged(false),
+      m_total(0)
   { }
   virtual ~CDirectoryJob() { }
 
@@ -61,7 +77,7 @@ public:
     if (strcmp(job->GetType(),GetType()) == 0)
     {
       const CDirectoryJob* dirJob = dynamic_cast<const CDirectoryJob*>(job);
-      if (dirJob && dirJob->m_url == m_url)
+      if (dirJob && dirJob->m_url == m_url && dirJob->m_page == m_page)
         return true;
     }
     return false;
@@ -70,6 +86,20 @@ public:
   virtual bool DoWork()
   {
     CFileItemList items;
+    if (m_page >= 0 && GetPage(items))
+    {
+      m_paged = true;
+      m_total = std::max((int)items.GetProperty("total").asInteger(), items.Size());
+      if (m_limit && m_total > m_limit)
+        m_total = m_limit;
+      int start = m_page * PAGE_SIZE;
+      AddItems(items, std::max(std::min((int)m_total - start, items.Size()), 0));
+      return true;
+    }
+    // later pages only come from lists that could be paged
+    if (m_page > 0)
+      return false;
+
     if (CDirectory::GetDirectory(m_url, items, ""))
     {
       // sort the items if necessary
@@ -78,46 +108,141 @@ public:
 
       // limit must not exceed the number of items
       int limit = (m_limit == 0) ? items.Size() : std::min((int) m_limit, items.Size());
-      // convert to CGUIStaticItem's and set visibility and targets
-      m_items.reserve(limit);
-      for (int i = 0; i < limit; i++)
-      {
-        CGUIStaticItemPtr item(new CGUIStaticItem(*items[i]));
-        if (item->HasProperty("node.visible"))
-          item->SetVisibleCondition(item->GetProperty("node.visible").asString(), m_parentID);
-
-        getThumbLoader(item)->LoadItem(item.get());
-
-        m_items.push_back(item);
-      }
+      AddItems(items, limit);
       m_target = items.GetProperty("node.target").asString();
     }
     return true;    
   }
 
+  // convert to CGUIStaticItem's and set visibility and targets
+  void AddItems(const CFileItemList &items, int count)
+  {
+    m_items.reserve(count);
+    for (int i = 0; i < count; i++)
+    {
+      CGUIStaticItemPtr item(new CGUIStaticItem(*items[i]));
+      if (item->HasProperty("node.visible"))
+        item->SetVisibleCondition(item->GetProperty("node.visible").asString(), m_parentID);
+
+      getThumbLoader(item)->LoadItem(item.get());
+
+      m_items.push_back(item);
+    }
+  }
+
+  /*! \brief Fetch a page of a library listing straight from the database
+   The database only applies the limits itself when it doesn't need to sort, so the sorting is
+   handed to it as an ORDER BY clause, with the id to keep the pages stable.
+   \param items [out] the items on the page, with the size of the whole listing in the "total" property.
+   \return true if the listing can be paged, false otherwise. Only the sort methods that map onto a
+   database field can be paged, see GetOrder, and not urls carrying their own order or limit, see
+   CDirectoryProvider::CanPage.
+   */
+  bool GetPage(CFileItemList &items) const
+  {
+    SortDescription sorting;
+    sorting.limitStart = m_page * PAGE_SIZE;
+    sorting.limitEnd = sorting.limitStart + PAGE_SIZE;
+
+    CDatabase::Filter filter;
+    if (URIUtils::IsProtocol(m_url, "musicdb"))
+    {
+      CMusicDbUrl musicUrl;
+      if (!musicUrl.FromString(m_url) || !IsPageable(musicUrl.GetType()) ||
+          !CDirectoryProvider::CanPage(musicUrl) ||
+          !GetOrder(CMediaTypes::FromString(musicUrl.GetType()), filter.order))
+        return false;
+
+      CMusicDatabase database;
+      return database.Open() && database.GetItems(m_url, items, filter, sorting);
+    }
+    if (URIUtils::IsProtocol(m_url, "videodb"))
+    {
+      CVideoDbUrl videoUrl;
+      if (!videoUrl.FromString(m_url) || !IsPageable(videoUrl.GetItemType()) ||
+          !CDirectoryProvider::CanPage(videoUrl) ||
+          !GetOrder(CMediaTypes::FromString(videoUrl.GetItemType()), filter.order))
+        return false;
+
+      CVideoDatabase database;
+      return database.Open() && database.GetItems(m_url, items, filter, sorting);
+    }
+    return false;
+  }
+
+  static bool IsPageable(const std::string &itemType)
+  {
+    return itemType == "songs" || itemType == "albums" || itemType == "artists" ||
+           itemType == "movies" || itemType == "tvshows" || itemType == "episodes" || itemType == "musicvideos";
+  }
+
+  /*! \brief Translate the sort method into an ORDER BY clause
+   \param order [out] the clause, the id is always added to keep the pages stable
+   \return false if the sort method has no database field, the listing is then sorted in
+   memory and can't be paged
+   */
+  bool GetOrder(const MediaType &mediaType, std::string &order) const
+  {
+    Field field = FieldNone;
+    switch (m_sort.sortBy)
+    {
+    case SortByNone:        break;
+    case SortByLabel:
+    case SortByTitle:
+      field = mediaType == MediaTypeAlbum ? FieldAlbum : (mediaType == MediaTypeArtist ? FieldArtist : FieldTitle);
+      break;
+    case SortByArtist:      field = FieldArtist; break;
+    case SortByAlbum:       field = FieldAlbum; break;
+    case SortByYear:        field = FieldYear; break;
+    case SortByTrackNumber: field = FieldTrackNumber; break;
+    case SortByRating:      field = FieldRating; break;
+    case SortByUserRating:  field = FieldUserRating; break;
+    case SortByDateAdded:   field = FieldDateAdded; break;
+    case SortByLastPlayed:  field = FieldLastPlayed; break;
+    case SortByPlaycount:   field = FieldPlaycount; break;
+    default:
+      return false;
+    }
+
+    order = DatabaseUtils::GetField(field, mediaType, DatabaseQueryPartOrderBy);
+    if (field != FieldNone && order.empty())
+      return false;
+    if (!order.empty())
+    {
+      if (field == FieldTitle || field == FieldArtist || field == FieldAlbum)
+        order = "LOWER(" + order + ")";
+      if (m_sort.sortOrder == SortOrderDescending)
+        order += " DESC";
+    }
+    std::string id = DatabaseUtils::GetField(FieldId, mediaType, DatabaseQueryPartOrderBy);
+    if (!id.empty())
+      order += order.empty() ? id : ", " + id;
+    return true;
+  }
+
   std::shared_ptr<CThumbLoader> getThumbLoader(CGUIStaticItemPtr &item)
   {
     if (item->IsVideo())
     {
-      initThumbLoader<CVideoThumbLoader>(VIDEO);
-      return m_thumbloaders[VIDEO];
+      initThumbLoader<CVideoThumbLoader>(CDirectoryProvider::VIDEO);
+      return m_thumbloaders[CDirectoryProvider::VIDEO];
     }
     if (item->IsAudio())
     {
-      initThumbLoader<CMusicThumbLoader>(AUDIO);
-      return m_thumbloaders[AUDIO];
+      initThumbLoader<CMusicThumbLoader>(CDirectoryProvider::AUDIO);
+      return m_thumbloaders[CDirectoryProvider::AUDIO];
     }
     if (item->IsPicture())
     {
-      initThumbLoader<CPictureThumbLoader>(PICTURE);
-      return m_thumbloaders[PICTURE];
+      initThumbLoader<CPictureThumbLoader>(CDirectoryProvider::PICTURE);
+      return m_thumbloaders[CDirectoryProvider::PICTURE];
     }
-    initThumbLoader<CProgramThumbLoader>(PROGRAM);
-    return m_thumbloaders[PROGRAM];
+    initThumbLoader<CProgramThumbLoader>(CDirectoryProvider::PROGRAM);
+    return m_thumbloaders[CDirectoryProvider::PROGRAM];
   }
 
   template<class CThumbLoaderClass>
-  void initThumbLoader(InfoTagType type)
+  void initThumbLoader(CDirectoryProvider::InfoTagType type)
   {
     if (!m_thumbloaders.count(type))
     {
@@ -129,10 +254,13 @@ public:
 
   const std::vector<CGUIStaticItemPtr> &GetItems() const { return m_items; }
   const std::string &GetTarget() const { return m_target; }
-  std::vector<InfoTagType> GetItemTypes(std::vector<InfoTagType> &itemTypes) const
+  int GetPageIndex() const { return m_page; }
+  bool IsPaged() const { return m_paged; }
+  unsigned int GetTotal() const { return m_total; }
+  std::vector<CDirectoryProvider::InfoTagType> GetItemTypes(std::vector<CDirectoryProvider::InfoTagType> &itemTypes) const
   {
     itemTypes.clear();
-    for (std::map<InfoTagType, std::shared_ptr<CThumbLoader> >::const_iterator
+    for (std::map<CDirectoryProvider::InfoTagType, std::shared_ptr<CThumbLoader> >::const_iterator
          i = m_thumbloaders.begin(); i != m_thumbloaders.end(); ++i)
       itemTypes.push_back(i->first);
     return itemTypes;
@@ -143,8 +271,11 @@ private:
   SortDescription m_sort;
   unsigned int m_limit;
   int m_parentID;
+  int m_page;
+  bool m_paged;
+  unsigned int m_total;
   std::vector<CGUIStaticItemPtr> m_items;
-  std::map<InfoTagType, std::shared_ptr<CThumbLoader> > m_thumbloaders;
+  std::map<CDirectoryProvider::InfoTagType, std::shared_ptr<CThumbLoader> > m_thumbloaders;
 };
 
 CDirectoryProvider::CDirectoryProvider(const TiXmlElement *element, int parentID)
@@ -152,11 +283,18 @@ CDirectoryProvider::CDirectoryProvider(const TiXmlElement *element, int parentID
    m_updateState(OK),
    m_isAnnounced(false),
    m_jobID(0),
-   m_currentLimit(0)
+   m_paged(false),
+   m_currentLimit(0),
+   m_currentPaged(false),
+   m_currentTotal(0)
 {
   assert(element);
   if (!element->NoChildren())
   {
+    const char *paged = element->Attribute("paged");
+    if (paged && StringUtils::EqualsNoCase(paged, "true"))
+      m_paged = true;
+
     const char *target = element->Attribute("target");
     if (target)
       m_target.SetLabel(target, "", parentID);
@@ -249,6 +387,71 @@ void CDirectoryProvider::Fetch(std::vector<CGUIListItemPtr> &items) const
   }
 }
 
+bool CDirectoryProvider::IsPaged() const
+{
+  CSingleLock lock(m_section);
+  return m_currentPaged;
+}
+
+unsigned int CDirectoryProvider::GetItemCount() const
+{
+  CSingleLock lock(m_section);
+  return m_currentTotal;
+}
+
+bool CDirectoryProvider::CanPage(const CUrlOptions &options)
+{
+  for (const char *option : { "xsp", "filter" })
+  {
+    CVariant value;
+    if (!options.GetOption(option, value))
+      continue;
+
+    CSmartPlaylist playlist;
+    if (!playlist.LoadFromJson(value.asString()) || playlist.GetLimit() > 0 || playlist.GetOrder() != SortByNone)
+      return false;
+  }
+  return true;
+}
+
+unsigned int CDirectoryProvider::GetPageSize() const
+{
+  return PAGE_SIZE;
+}
+
+bool CDirectoryProvider::FetchPage(unsigned int page, std::vector<CGUIListItemPtr> &items)
+{
+  CSingleLock lock(m_section);
+  if (!m_currentPaged)
+    return false;
+
+  // pages are handed out once, the container holds on to them while they're in view
+  std::map<unsigned int, std::vector<CGUIStaticItemPtr> >::iterator i = m_pages.find(page);
+  if (i != m_pages.end())
+  {
+    items.assign(i->second.begin(), i->second.end());
+    m_pages.erase(i);
+    return true;
+  }
+
+  bool requested = false;
+  for (std::map<unsigned int, unsigned int>::const_iterator job = m_pageJobs.begin(); job != m_pageJobs.end() && !requested; ++job)
+    requested = job->second == page;
+  if (!requested)
+  {
+    unsigned int jobID = CJobManager::GetInstance().AddJob(new CDirectoryJob(m_currentUrl, m_currentSort, m_currentLimit, m_parentID, page), this);
+    m_pageJobs.insert(std::make_pair(jobID, page));
+  }
+  return false;
+}
+
+void CDirectoryProvider::CancelPageJobs()
+{
+  for (std::map<unsigned int, unsigned int>::const_iterator job = m_pageJobs.begin(); job != m_pageJobs.end(); ++job)
+    CJobManager::GetInstance().CancelJob(job->first);
+  m_pageJobs.clear();
+}
+
 void CDirectoryProvider::Reset(bool immediately /* = false */)
 {
   // cancel any pending jobs
@@ -256,10 +459,14 @@ void CDirectoryProvider::Reset(bool immediately /* = false */)
   if (m_jobID)
     CJobManager::GetInstance().CancelJob(m_jobID);
   m_jobID = 0;
+  CancelPageJobs();
   // reset only if this is going to be destructed
   if (immediately)
   {
     m_items.clear();
+    m_pages.clear();
+    m_currentPaged = false;
+    m_currentTotal = 0;
     m_currentTarget.clear();
     m_currentUrl.clear();
     m_itemTypes.clear();
@@ -274,11 +481,38 @@ void CDirectoryProvider::Reset(bool immediately /* = false */)
 void CDirectoryProvider::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
   CSingleLock lock(m_section);
+  CDirectoryJob *dirJob = (CDirectoryJob*)job;
+
+  std::map<unsigned int, unsigned int>::iterator pageJob = m_pageJobs.find(jobID);
+  if (pageJob != m_pageJobs.end())
+  {
+    m_pageJobs.erase(pageJob);
+    if (success && m_currentPaged)
+    {
+      m_pages[dirJob->GetPageIndex()] = dirJob->GetItems();
+      // don't hold on to pages the container has lost interest in
+      while (m_pages.size() > MAX_PAGES)
+        m_pages.erase(std::abs((int)m_pages.begin()->first - dirJob->GetPageIndex()) > std::abs((int)m_pages.rbegin()->first - dirJob->GetPageIndex()) ?
+                      m_pages.begin()->first : m_pages.rbegin()->first);
+    }
+    return;
+  }
+
   if (success)
   {
-    m_items = ((CDirectoryJob*)job)->GetItems();
-    m_currentTarget = ((CDirectoryJob*)job)->GetTarget();
-    ((CDirectoryJob*)job)->GetItemTypes(m_itemTypes);
+    m_pages.clear();
+    // lists that fit on a page are handed out in one go
+    m_currentPaged = dirJob->IsPaged() && dirJob->GetTotal() > PAGE_SIZE;
+    m_currentTotal = dirJob->GetTotal();
+    if (m_currentPaged)
+    {
+      m_items.clear();
+      m_pages[0] = dirJob->GetItems();
+    }
+    else
+      m_items = dirJob->GetItems();
+    m_currentTarget = dirJob->GetTarget();
+    dirJob->GetItemTypes(m_itemTypes);
     m_updateState = DONE;
   }
   m_jobID = 0;
@@ -287,6 +521,9 @@ void CDirectoryProvider::OnJobComplete(unsigned int jobID, bool success, CJob *j
 bool CDirectoryProvider::OnClick(const CGUIListItemPtr &item)
 {
   CFileItem fileItem(*std::static_pointer_cast<CFileItem>(item));
+  // placeholder of a page that's still being fetched
+  if (fileItem.GetPath().empty() && fileItem.GetLabel().empty())
+    return false;
   std::string target = fileItem.GetProperty("node.target").asString();
   if (target.empty())
     target = m_currentTarget;
@@ -317,7 +554,8 @@ void CDirectoryProvider::FireJob()
   CSingleLock lock(m_section);
   if (m_jobID)
     CJobManager::GetInstance().CancelJob(m_jobID);
-  m_jobID = CJobManager::GetInstance().AddJob(new CDirectoryJob(m_currentUrl, m_currentSort, m_currentLimit, m_parentID), this);
+  CancelPageJobs();
+  m_jobID = CJobManager::GetInstance().AddJob(new CDirectoryJob(m_currentUrl, m_currentSort, m_currentLimit, m_parentID, m_paged ? 0 : -1), this);
 }
 
 void CDirectoryProvider::RegisterListProvider(bool hasLibraryContent)
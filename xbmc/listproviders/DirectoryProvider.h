@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <map>
 #include <string>
 #include "IListProvider.h"
 #include "guilib/GUIStaticItem.h"
@@ -28,22 +29,23 @@
 #include "interfaces/IAnnouncer.h"
 
 class TiXmlElement;
+class CUrlOptions;
 class CVariant;
 
-typedef enum
-{
-  VIDEO,
-  AUDIO,
-  PICTURE,
-  PROGRAM
-} InfoTagType;
-
 class CDirectoryProvider :
   public IListProvider,
   public IJobCallback,
   public ANNOUNCEMENT::IAnnouncer
 {
 public:
+  typedef enum
+  {
+    VIDEO,
+    AUDIO,
+    PICTURE,
+    PROGRAM
+  } InfoTagType;
+
   typedef enum
   {
     OK,
@@ -60,13 +62,26 @@ public:
   virtual void Reset(bool immediately = false);
   virtual bool OnClick(const CGUIListItemPtr &item);
   virtual bool IsUpdating() const;
+  virtual bool IsPaged() const;
+  virtual unsigned int GetItemCount() const;
+  virtual unsigned int GetPageSize() const;
+  virtual bool FetchPage(unsigned int page, std::vector<CGUIListItemPtr> &items);
 
   // callback from directory job
   virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+  /*! \brief Whether the smart playlist options of a library url leave the order and size to the pages
+   GetFilter lets the order and limit of an "xsp" or "filter" option replace the sorting of the query,
+   which would break the paging.
+   \param options the options of the musicdb:// or videodb:// url
+   \return false if a smart playlist option has an order or a limit, or can't be loaded
+   */
+  static bool CanPage(const CUrlOptions &options);
 private:
   UpdateState      m_updateState;
   bool             m_isAnnounced;
   unsigned int     m_jobID;
+  bool             m_paged;           ///< \brief whether library listings should be fetched a page at a time
   CGUIInfoLabel    m_url;
   CGUIInfoLabel    m_target;
   CGUIInfoLabel    m_sortMethod;
@@ -76,11 +91,16 @@ private:
   std::string      m_currentTarget;   ///< \brief node.target property on the list as a whole
   SortDescription  m_currentSort;
   unsigned int     m_currentLimit;
+  bool             m_currentPaged;
+  unsigned int     m_currentTotal;
   std::vector<CGUIStaticItemPtr> m_items;
+  std::map<unsigned int, std::vector<CGUIStaticItemPtr> > m_pages; ///< \brief fetched pages of a paged list
+  std::map<unsigned int, unsigned int> m_pageJobs;                 ///< \brief page of each running page job
   std::vector<InfoTagType> m_itemTypes;
   CCriticalSection m_section;
 
   void FireJob();
+  void CancelPageJobs();
   void RegisterListProvider(bool hasLibraryContent);
   bool UpdateURL();
   bool UpdateLimit();
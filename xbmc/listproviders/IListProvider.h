@@ -89,6 +89,35 @@ public:
    \sa GetDefaultItem, SetDefaultItem
    */
   virtual bool AlwaysFocusDefaultItem() const { return false; }
+
+  /*! \brief Whether the list is handed out a page at a time rather than with Fetch.
+   Containers only fetch the pages of a paged list that are in or near view.
+   \return true if the list is paged, false otherwise.
+   \sa GetItemCount, GetPageSize, FetchPage
+   */
+  virtual bool IsPaged() const { return false; }
+
+  /*! \brief The number of items in a paged list.
+   \return the number of items.
+   \sa IsPaged
+   */
+  virtual unsigned int GetItemCount() const { return 0; }
+
+  /*! \brief The number of items on each page of a paged list.
+   \return the page size.
+   \sa IsPaged
+   */
+  virtual unsigned int GetPageSize() const { return 0; }
+
+  /*! \brief Fetch a page of a paged list.
+   Pages that aren't available yet are requested in the background, the caller is expected
+   to ask again later.
+   \param page the page to fetch, the first item on it is page * GetPageSize().
+   \param items [out] the items on the page.
+   \return true if the page was available, false if it has been requested.
+   \sa IsPaged
+   */
+  virtual bool FetchPage(unsigned int page, std::vector<CGUIListItemPtr> &items) { return false; }
 protected:
   int m_parentID;
 };
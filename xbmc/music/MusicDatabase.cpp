@@ -105,6 +105,8 @@ static void AnnounceUpdate(const std::string& content, int id)
 
 CMusicDatabase::CMusicDatabase(void)
 {
+  m_albumBatchSize = 0;
+  m_albumsInBatch = 0;
 }
 
 CMusicDatabase::~CMusicDatabase(void)
@@ -478,7 +480,8 @@ std::string CMusicDatabase::LoadCuesheet(const std::string& fullSongPath)
 
 bool CMusicDatabase::AddAlbum(CAlbum& album)
 {
-  BeginTransaction();
+  if (m_albumBatchSize == 0 || m_albumsInBatch == 0)
+    BeginTransaction();
 
   album.idAlbum = AddAlbum(album.strAlbum,
                            album.strMusicBrainzAlbumID,
@@ -539,10 +542,36 @@ bool CMusicDatabase::AddAlbum(CAlbum& album)
                                                         ++albumArt)
     SetArtForItem(album.idAlbum, MediaTypeAlbum, albumArt->first, albumArt->second);
 
-  CommitTransaction();
+  if (m_albumBatchSize == 0)
+    CommitTransaction();
+  else if (++m_albumsInBatch >= m_albumBatchSize)
+    CommitAlbumBatch();
   return true;
 }
 
+void CMusicDatabase::BeginAlbumBatch(unsigned int albumsPerTransaction)
+{
+  EndAlbumBatch();
+  m_albumBatchSize = albumsPerTransaction;
+}
+
+void CMusicDatabase::CommitAlbumBatch()
+{
+  if (m_albumsInBatch == 0)
+    return;
+
+  CommitTransaction();
+  m_albumsInBatch = 0;
+}
+
+void CMusicDatabase::EndAlbumBatch()
+{
+  CommitAlbumBatch();
+  m_albumBatchSize = 0;
+  // the cache is only kept up to date while we're the only writer
+  m_artistCache.clear();
+}
+
 bool CMusicDatabase::UpdateAlbum(CAlbum& album, bool OverrideTagData /* = true*/)
 {
   BeginTransaction();
@@ -1174,6 +1203,17 @@ int CMusicDatabase::AddArtist(const std::string& strArtist, const std::string& s
     if (NULL == m_pDB.get()) return -1;
     if (NULL == m_pDS.get()) return -1;
 
+    // while batching, artists without a MusicBrainz ID are looked up by name only once
+    std::string cacheKey;
+    if (m_albumBatchSize > 0 && strMusicBrainzArtistID.empty())
+    {
+      cacheKey = strArtist;
+      StringUtils::ToLower(cacheKey);
+      std::map<std::string, int>::const_iterator it = m_artistCache.find(cacheKey);
+      if (it != m_artistCache.end())
+        return it->second;
+    }
+
     // 1) MusicBrainz
     if (!strMusicBrainzArtistID.empty())
     {
@@ -1228,6 +1268,8 @@ int CMusicDatabase::AddArtist(const std::string& strArtist, const std::string& s
       {
         int idArtist = (int)m_pDS->fv("idArtist").get_asInt();
         m_pDS->close();
+        if (!cacheKey.empty())
+          m_artistCache.insert(std::make_pair(cacheKey, idArtist));
         return idArtist;
       }
       m_pDS->close();
@@ -1244,6 +1286,8 @@ int CMusicDatabase::AddArtist(const std::string& strArtist, const std::string& s
 
     m_pDS->exec(strSQL);
     int idArtist = (int)m_pDS->lastinsertid();
+    if (!cacheKey.empty())
+      m_artistCache.insert(std::make_pair(cacheKey, idArtist));
     return idArtist;
   }
   catch (...)
@@ -202,6 +202,23 @@ public:
   // Album
   /////////////////////////////////////////////////
   bool AddAlbum(CAlbum& album);
+
+  /*! \brief Group the writes of the following albums into larger transactions
+   Until EndAlbumBatch() is called AddAlbum() only commits every albumsPerTransaction
+   albums, and artists are looked up by name once per batch.
+   \param albumsPerTransaction number of albums to write per transaction
+   \sa CommitAlbumBatch, EndAlbumBatch
+   */
+  void BeginAlbumBatch(unsigned int albumsPerTransaction);
+
+  /*! \brief Commit the albums added so far, the batch stays open
+   Needs to be called before any method that uses a transaction of its own.
+   */
+  void CommitAlbumBatch();
+
+  /*! \brief Commit the albums added so far and return to one transaction per album
+   */
+  void EndAlbumBatch();
   /*! \brief Update an album and all its nested entities (artists, songs, infoSongs, etc)
    \param album the album to update
    \param OverrideTagData whether or not to replace the artist and song data, defaults to true.
@@ -485,6 +502,9 @@ protected:
   typedef std::map<std::string, std::string> CueCache;
   CueCache m_cueCache;
 
+  unsigned int m_albumBatchSize;   ///< albums per transaction, 0 when not batching
+  unsigned int m_albumsInBatch;    ///< albums written since the batch transaction began
+
   virtual void CreateTables();
   virtual void CreateAnalytics();
   virtual int GetMinSchemaVersion() const { return 32; }
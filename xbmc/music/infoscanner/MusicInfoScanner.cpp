@@ -64,6 +64,9 @@ using namespace MUSICDATABASEDIRECTORY;
 using namespace MUSIC_GRABBER;
 using namespace ADDON;
 
+// number of albums written to the database in one transaction
+#define ALBUMS_PER_TRANSACTION 25
+
 CMusicInfoScanner::CMusicInfoScanner() : CThread("MusicInfoScanner"), m_fileCountReader(this, "MusicFileCounter")
 {
   m_bRunning = false;
@@ -72,6 +75,7 @@ CMusicInfoScanner::CMusicInfoScanner() : CThread("MusicInfoScanner"), m_fileCoun
   m_bCanInterrupt = false;
   m_currentItem=0;
   m_itemCount=0;
+  m_songsAdded = 0;
   m_flags = 0;
 }
 
@@ -118,6 +122,7 @@ void CMusicInfoScanner::Process()
       // Reset progress vars
       m_currentItem=0;
       m_itemCount=-1;
+      m_songsAdded = 0;
 
       // Create the thread to count all files to be scanned
       SetPriority( GetMinPriority() );
@@ -130,6 +135,8 @@ void CMusicInfoScanner::Process()
       m_bCanInterrupt = false;
       m_needsCleanup = false;
 
+      m_musicDatabase.BeginAlbumBatch(ALBUMS_PER_TRANSACTION);
+
       bool commit = true;
       for (std::set<std::string>::const_iterator it = m_pathsToScan.begin(); it != m_pathsToScan.end(); ++it)
       {
@@ -152,6 +159,8 @@ void CMusicInfoScanner::Process()
         }
       }
 
+      m_musicDatabase.EndAlbumBatch();
+
       if (commit)
       {
         g_infoManager.ResetLibraryBools();
@@ -179,6 +188,7 @@ void CMusicInfoScanner::Process()
       
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "My Music: Scanning for music info using worker thread, operation took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      CLog::Log(LOGNOTICE, "My Music: Added %u songs, %.1f songs/s", m_songsAdded, tick ? m_songsAdded * 1000.0f / tick : 0.0f);
     }
     if (m_scanType == 1) // load album info
     {
@@ -790,11 +800,16 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
       }
     }
 
+    m_songsAdded += album->songs.size();
+
     if ((m_flags & SCAN_ONLINE))
     {
       if (!albumScraper || !artistScraper)
         continue;
 
+      // scraping writes in transactions of its own
+      m_musicDatabase.CommitAlbumBatch();
+
       INFO_RET albumScrapeStatus = INFO_NOT_FOUND;
       if (!m_musicDatabase.HasAlbumBeenScraped(album->idAlbum))
         albumScrapeStatus = UpdateDatabaseAlbumInfo(*album, albumScraper, false);
@@ -1252,7 +1267,7 @@ void CMusicInfoScanner::GetAlbumArtwork(long id, const CAlbum &album)
       std::string thumb = CScraperUrl::GetThumbURL(album.thumbURL.GetFirstThumb());
       if (!thumb.empty())
       {
-        CTextureCache::GetInstance().BackgroundCacheImage(thumb);
+        CTextureCache::GetInstance().PrecacheImage(thumb);
         m_musicDatabase.SetArtForItem(id, MediaTypeAlbum, "thumb", thumb);
       }
     }
@@ -1468,7 +1483,7 @@ std::map<std::string, std::string> CMusicInfoScanner::GetArtistArtwork(const CAr
     thumb = CScraperUrl::GetThumbURL(artist.thumbURL.GetFirstThumb());
   if (!thumb.empty())
   {
-    CTextureCache::GetInstance().BackgroundCacheImage(thumb);
+    CTextureCache::GetInstance().PrecacheImage(thumb);
     artwork.insert(make_pair("thumb", thumb));
   }
 
@@ -1488,7 +1503,7 @@ std::map<std::string, std::string> CMusicInfoScanner::GetArtistArtwork(const CAr
     fanart = artist.fanart.GetImageURL();
   if (!fanart.empty())
   {
-    CTextureCache::GetInstance().BackgroundCacheImage(fanart);
+    CTextureCache::GetInstance().PrecacheImage(fanart);
     artwork.insert(make_pair("fanart", fanart));
   }
 
@@ -209,6 +209,7 @@ protected:
   CGUIDialogProgressBarHandle* m_handle;
   int m_currentItem;
   int m_itemCount;
+  unsigned int m_songsAdded;
   bool m_bRunning;
   bool m_bCanInterrupt;
   bool m_bClean;
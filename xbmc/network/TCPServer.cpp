@@ -28,6 +28,7 @@
 #include "settings/AdvancedSettings.h"
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "interfaces/AnnouncementManager.h"
+#include "utils/JSONVariantWriter.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
 #include "threads/SingleLock.h"
@@ -57,6 +58,7 @@ using namespace JSONRPC;
 using namespace ANNOUNCEMENT;
 
 #define RECEIVEBUFFER 1024
+#define SENDFRAGMENT 16384
 
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
@@ -235,11 +237,11 @@ void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char
 
   for (unsigned int i = 0; i < m_connections.size(); i++)
   {
-    {
-      CSingleLock lock (m_connections[i]->m_critSection);
-      if ((m_connections[i]->GetAnnouncementFlags() & flag) == 0)
-        continue;
-    }
+    // hold the send lock for the whole announcement so it can't end up
+    // between the fragments of a response streamed to the same client
+    CSingleLock lock (m_connections[i]->m_critSection);
+    if ((m_connections[i]->GetAnnouncementFlags() & flag) == 0)
+      continue;
 
     m_connections[i]->Send(str.c_str(), str.size());
   }
@@ -531,6 +533,32 @@ void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
   } while (sent < size);
 }
 
+void CTCPServer::CTCPClient::SendFragment(const char *data, unsigned int size, bool first, bool final)
+{
+  Send(data, size);
+}
+
+void CTCPServer::CTCPClient::SendResponse(const CVariant &response)
+{
+  // serialize the response straight into the fragments being sent
+  CJSONVariantStreamWriter writer(response, g_advancedSettings.m_jsonOutputCompact);
+  char buffer[SENDFRAGMENT];
+  bool first = true;
+
+  // no announcement may be sent while the fragments of a response are
+  // going out, keep the client locked until the last one was sent
+  CSingleLock lock (m_critSection);
+  do
+  {
+    size_t size = writer.Read(buffer, sizeof(buffer));
+    SendFragment(buffer, (unsigned int)size, first, writer.IsEnd());
+    first = false;
+  } while (!writer.IsEnd());
+
+  if (writer.HasFailed())
+    CLog::Log(LOGERROR, "JSONRPC Server: failed to serialize the response");
+}
+
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
 {
   m_new = false;
@@ -559,8 +587,11 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
         m_endBrackets++;
       if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        Send(line.c_str(), line.size());
+        CVariant response;
+        if (CJSONRPC::MethodCall(m_buffer, host, this, response))
+          SendResponse(response);
+        else
+          Send("", 0);
         m_beginChar = m_beginBrackets = m_endBrackets = 0;
         m_buffer.clear();
       }
@@ -626,6 +657,7 @@ CTCPServer::CWebSocketClient& CTCPServer::CWebSocketClient::operator=(const CWeb
 
 void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
 {
+  CSingleLock lock (m_critSection);
   const CWebSocketMessage *msg = m_websocket->Send(WebSocketTextFrame, data, size);
   if (msg == NULL || !msg->IsComplete())
     return;
@@ -635,6 +667,17 @@ void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
     CTCPClient::Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
 }
 
+void CTCPServer::CWebSocketClient::SendFragment(const char *data, unsigned int size, bool first, bool final)
+{
+  // the caller (SendResponse) holds m_critSection across all fragments
+  const CWebSocketFrame *frame = m_websocket->Fragment(WebSocketTextFrame, data, size, first, final);
+  if (frame == NULL)
+    return;
+
+  CTCPClient::Send(frame->GetFrameData(), (unsigned int)frame->GetFrameLength());
+  delete frame;
+}
+
 void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
 {
   bool send;
@@ -70,9 +70,12 @@ namespace JSONRPC
       virtual bool SetAnnouncementFlags(int flags);
 
       virtual void Send(const char *data, unsigned int size);
+      virtual void SendFragment(const char *data, unsigned int size, bool first, bool final);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
+      void SendResponse(const CVariant &response);
+
       virtual bool IsNew() const { return m_new; }
       virtual bool Closing() const { return false; }
 
@@ -101,6 +104,7 @@ namespace JSONRPC
       ~CWebSocketClient();
 
       virtual void Send(const char *data, unsigned int size);
+      virtual void SendFragment(const char *data, unsigned int size, bool first, bool final);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
@@ -63,6 +63,10 @@
 
 #define HEADER_NEWLINE        "\r\n"
 
+#ifndef MHD_SIZE_UNKNOWN
+#define MHD_SIZE_UNKNOWN  -1
+#endif
+
 typedef struct ConnectionHandler
 {
   std::string fullUri;
@@ -92,6 +96,10 @@ typedef struct {
   uint64_t writePosition;
 } HttpFileDownloadContext;
 
+typedef struct {
+  std::shared_ptr<IHTTPRequestHandler> handler;
+} HttpStreamDownloadContext;
+
 std::vector<IHTTPRequestHandler *> CWebServer::m_requestHandlers;
 
 CWebServer::CWebServer()
@@ -502,6 +510,10 @@ int CWebServer::HandleRequest(const std::shared_ptr<IHTTPRequestHandler>& handle
       ret = CreateFileDownloadResponse(handler, response);
       break;
 
+    case HTTPStreamDownload:
+      ret = CreateStreamDownloadResponse(handler, response);
+      break;
+
     case HTTPMemoryDownloadNoFreeNoCopy:
     case HTTPMemoryDownloadNoFreeCopy:
     case HTTPMemoryDownloadFreeNoCopy:
@@ -892,6 +904,46 @@ int CWebServer::CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHan
   return MHD_YES;
 }
 
+int CWebServer::CreateStreamDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response *&response)
+{
+  if (handler == nullptr)
+    return MHD_NO;
+
+  const HTTPRequest &request = handler->GetRequest();
+
+  if (request.method == HEAD)
+  {
+    response = MHD_create_response_from_data(0, nullptr, MHD_NO, MHD_NO);
+    if (response == nullptr)
+    {
+      CLog::Log(LOGERROR, "CWebServer: failed to create a HTTP HEAD response for %s", request.pathUrl.c_str());
+      return MHD_NO;
+    }
+
+    return MHD_YES;
+  }
+
+  // the context keeps the request handler and its response data alive until
+  // mhd has sent everything
+  std::unique_ptr<HttpStreamDownloadContext> context(new HttpStreamDownloadContext());
+  context->handler = handler;
+
+  // without a known length mhd uses chunked transfer encoding
+  response = MHD_create_response_from_callback(MHD_SIZE_UNKNOWN, 16 * 1024,
+                                                &CWebServer::StreamReaderCallback,
+                                                context.get(),
+                                                &CWebServer::StreamReaderFreeCallback);
+  if (response == nullptr)
+  {
+    CLog::Log(LOGERROR, "CWebServer: failed to create a HTTP response for %s to be streamed", request.pathUrl.c_str());
+    return MHD_NO;
+  }
+
+  context.release(); // ownership was passed to mhd
+
+  return MHD_YES;
+}
+
 int CWebServer::CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response)
 {
   size_t payloadSize = 0;
@@ -1076,6 +1128,41 @@ void CWebServer::ContentReaderFreeCallback(void *cls)
 #endif
 }
 
+#if (MHD_VERSION >= 0x00090200)
+ssize_t CWebServer::StreamReaderCallback(void *cls, uint64_t pos, char *buf, size_t max)
+#elif (MHD_VERSION >= 0x00040001)
+int CWebServer::StreamReaderCallback(void *cls, uint64_t pos, char *buf, int max)
+#else   //libmicrohttpd < 0.4.0
+int CWebServer::StreamReaderCallback(void *cls, size_t pos, char *buf, int max)
+#endif
+{
+  HttpStreamDownloadContext *context = (HttpStreamDownloadContext *)cls;
+  if (context == nullptr || context->handler == nullptr || max <= 0)
+    return -1;
+
+  size_t written = context->handler->ReadResponseStream(buf, static_cast<size_t>(max));
+
+#ifdef WEBSERVER_DEBUG
+  CLog::Log(LOGDEBUG, "webserver [OUT] streamed %d bytes at %" PRIu64, (int)written, (uint64_t)pos);
+#endif
+
+  // end of stream
+  if (written == 0)
+    return -1;
+
+  return written;
+}
+
+void CWebServer::StreamReaderFreeCallback(void *cls)
+{
+  HttpStreamDownloadContext *context = (HttpStreamDownloadContext *)cls;
+  delete context;
+
+#ifdef WEBSERVER_DEBUG
+  CLog::Log(LOGDEBUG, "webserver [OUT] done");
+#endif
+}
+
 // local helper
 static void panicHandlerForMHD(void* unused, const char* file, unsigned int line, const char *reason)
 {
@@ -77,6 +77,15 @@ private:
 #endif
   static void ContentReaderFreeCallback(void *cls);
 
+#if (MHD_VERSION >= 0x00090200)
+  static ssize_t StreamReaderCallback (void *cls, uint64_t pos, char *buf, size_t max);
+#elif (MHD_VERSION >= 0x00040001)
+  static int StreamReaderCallback (void *cls, uint64_t pos, char *buf, int max);
+#else
+  static int StreamReaderCallback (void *cls, size_t pos, char *buf, int max);
+#endif
+  static void StreamReaderFreeCallback(void *cls);
+
 #if (MHD_VERSION >= 0x00040001)
   static int AnswerToConnection (void *cls, struct MHD_Connection *connection,
                         const char *url, const char *method,
@@ -104,6 +113,7 @@ private:
 
   static int CreateRedirect(struct MHD_Connection *connection, const std::string &strURL, struct MHD_Response *&response);
   static int CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response *&response);
+  static int CreateStreamDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response *&response);
   static int CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response);
   static int CreateMemoryDownloadResponse(struct MHD_Connection *connection, const void *data, size_t size, bool free, bool copy, struct MHD_Response *&response);
 
@@ -18,16 +18,34 @@
  *
  */
 
+#include <algorithm>
+#include <cstring>
+
 #include "HTTPJsonRpcHandler.h"
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "interfaces/json-rpc/JSONServiceDescription.h"
 #include "interfaces/json-rpc/JSONUtils.h"
 #include "network/WebServer.h"
+#include "settings/AdvancedSettings.h"
 #include "utils/JSONVariantWriter.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
 
 #define MAX_HTTP_POST_SIZE 65536
+// responses that don't fit are sent with chunked transfer encoding
+#define MAX_HTTP_RESPONSE_BUFFER_SIZE 65536
+
+CHTTPJsonRpcHandler::CHTTPJsonRpcHandler()
+  : m_responseDataOffset(0)
+{ }
+
+CHTTPJsonRpcHandler::CHTTPJsonRpcHandler(const HTTPRequest &request)
+  : IHTTPRequestHandler(request),
+    m_responseDataOffset(0)
+{ }
+
+CHTTPJsonRpcHandler::~CHTTPJsonRpcHandler()
+{ }
 
 bool CHTTPJsonRpcHandler::CanHandleRequest(const HTTPRequest &request)
 {
@@ -81,17 +99,21 @@ int CHTTPJsonRpcHandler::HandleRequest()
 
   if (isRequest)
   {
-    m_responseData = JSONRPC::CJSONRPC::MethodCall(m_requestData, m_request.webserver, &client);
-
-    if (!jsonpCallback.empty())
-      m_responseData = jsonpCallback + "(" + m_responseData + ");";
+    if (JSONRPC::CJSONRPC::MethodCall(m_requestData, m_request.webserver, &client, m_responseValue))
+    {
+      if (!jsonpCallback.empty())
+        SetResponseStream(jsonpCallback + "(", ");", g_advancedSettings.m_jsonOutputCompact);
+      else
+        SetResponseStream("", "", g_advancedSettings.m_jsonOutputCompact);
+    }
+    else if (!jsonpCallback.empty())
+      m_responseData = jsonpCallback + "();";
   }
   else if (jsonpCallback.empty())
   {
     // get the whole output of JSONRPC.Introspect
-    CVariant result;
-    JSONRPC::CJSONServiceDescription::Print(result, m_request.webserver, &client);
-    m_responseData = CJSONVariantWriter::Write(result, false);
+    JSONRPC::CJSONServiceDescription::Print(m_responseValue, m_request.webserver, &client);
+    SetResponseStream("", "", false);
   }
   else
   {
@@ -103,6 +125,28 @@ int CHTTPJsonRpcHandler::HandleRequest()
 
   m_requestData.clear();
 
+  if (m_responseWriter)
+  {
+    // serialize the beginning right away, small responses are sent as a whole
+    size_t length = m_responseData.size();
+    m_responseData.resize(length + MAX_HTTP_RESPONSE_BUFFER_SIZE);
+    length += m_responseWriter->Read(&m_responseData[length], MAX_HTTP_RESPONSE_BUFFER_SIZE);
+    m_responseData.resize(length);
+
+    if (!m_responseWriter->IsEnd())
+    {
+      m_response.type = HTTPStreamDownload;
+      m_response.status = MHD_HTTP_OK;
+      m_response.contentType = "application/json";
+
+      return MHD_YES;
+    }
+
+    m_responseWriter.reset();
+    m_responseValue.clear();
+    m_responseData += m_responseSuffix;
+  }
+
   m_responseRange.SetData(m_responseData.c_str(), m_responseData.size());
 
   m_response.type = HTTPMemoryDownloadNoFreeCopy;
@@ -121,6 +165,48 @@ HttpResponseRanges CHTTPJsonRpcHandler::GetResponseData() const
   return ranges;
 }
 
+size_t CHTTPJsonRpcHandler::ReadResponseStream(char *buffer, size_t size)
+{
+  size_t written = 0;
+  while (written < size)
+  {
+    // already serialized data and the jsonp suffix
+    if (m_responseDataOffset < m_responseData.size())
+    {
+      size_t length = std::min(size - written, m_responseData.size() - m_responseDataOffset);
+      memcpy(buffer + written, m_responseData.c_str() + m_responseDataOffset, length);
+      m_responseDataOffset += length;
+      written += length;
+      continue;
+    }
+
+    if (!m_responseWriter)
+      break;
+
+    written += m_responseWriter->Read(buffer + written, size - written);
+    if (m_responseWriter->IsEnd())
+    {
+      if (m_responseWriter->HasFailed())
+        CLog::Log(LOGERROR, "JSONRPC: failed to serialize the response");
+
+      m_responseWriter.reset();
+      m_responseValue.clear();
+      m_responseData = m_responseSuffix;
+      m_responseDataOffset = 0;
+    }
+  }
+
+  return written;
+}
+
+void CHTTPJsonRpcHandler::SetResponseStream(const std::string &prefix, const std::string &suffix, bool compact)
+{
+  m_responseData = prefix;
+  m_responseDataOffset = 0;
+  m_responseSuffix = suffix;
+  m_responseWriter.reset(new CJSONVariantStreamWriter(m_responseValue, compact));
+}
+
 #if (MHD_VERSION >= 0x00040001)
 bool CHTTPJsonRpcHandler::appendPostData(const char *data, size_t size)
 #else
@@ -19,16 +19,20 @@
  *
  */
 
+#include <memory>
 #include <string>
 
 #include "interfaces/json-rpc/IClient.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
+#include "utils/Variant.h"
+
+class CJSONVariantStreamWriter;
 
 class CHTTPJsonRpcHandler : public IHTTPRequestHandler
 {
 public:
-  CHTTPJsonRpcHandler() { }
-  virtual ~CHTTPJsonRpcHandler() { }
+  CHTTPJsonRpcHandler();
+  virtual ~CHTTPJsonRpcHandler();
   
   virtual IHTTPRequestHandler* Create(const HTTPRequest &request) { return new CHTTPJsonRpcHandler(request); }
   virtual bool CanHandleRequest(const HTTPRequest &request);
@@ -36,13 +40,12 @@ public:
   virtual int HandleRequest();
 
   virtual HttpResponseRanges GetResponseData() const;
+  virtual size_t ReadResponseStream(char *buffer, size_t size);
 
   virtual int GetPriority() const { return 5; }
 
 protected:
-  explicit CHTTPJsonRpcHandler(const HTTPRequest &request)
-    : IHTTPRequestHandler(request)
-  { }
+  explicit CHTTPJsonRpcHandler(const HTTPRequest &request);
 
 #if (MHD_VERSION >= 0x00040001)
   virtual bool appendPostData(const char *data, size_t size);
@@ -55,6 +58,14 @@ private:
   std::string m_responseData;
   CHttpResponseRange m_responseRange;
 
+  // large responses are serialized while they are being sent
+  CVariant m_responseValue;
+  std::unique_ptr<CJSONVariantStreamWriter> m_responseWriter;
+  size_t m_responseDataOffset;
+  std::string m_responseSuffix;
+
+  void SetResponseStream(const std::string &prefix, const std::string &suffix, bool compact);
+
   class CHTTPClient : public JSONRPC::IClient
   {
   public:
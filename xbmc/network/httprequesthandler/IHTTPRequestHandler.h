@@ -62,7 +62,10 @@ typedef enum HTTPResponseType
   HTTPMemoryDownloadFreeNoCopy,
   // creates a HTTP response from a buffer by copying followed by freeing the buffer
   // the buffer must have been malloc'ed and not new'ed
-  HTTPMemoryDownloadFreeCopy
+  HTTPMemoryDownloadFreeCopy,
+  // creates a HTTP response of unknown length (chunked) whose content is
+  // pulled from the request handler while it is being sent
+  HTTPStreamDownload
 } HTTPResponseType;
 
 typedef struct HTTPRequest
@@ -169,6 +172,14 @@ public:
   */
   virtual std::string GetResponseFile() const { return ""; }
 
+  /*!
+  * \brief Writes the next part of the response data to the given buffer.
+  *
+  * \details This is only used if the response type is HTTPStreamDownload.
+  * \return Number of bytes written, 0 once the response is complete.
+  */
+  virtual size_t ReadResponseStream(char *buffer, size_t size) { return 0; }
+
   /*!
   * \brief Returns the HTTP request handled by the HTTP request handler.
   */
@@ -441,3 +441,16 @@ const CWebSocketMessage* CWebSocket::Send(WebSocketFrameOpcode opcode, const cha
 
   return NULL;
 }
+
+const CWebSocketFrame* CWebSocket::Fragment(WebSocketFrameOpcode opcode, const char* data, uint32_t length, bool first, bool final)
+{
+  CWebSocketFrame *frame = GetFrame(first ? opcode : WebSocketContinuationFrame, data, length, final);
+  if (frame == NULL || !frame->IsValid())
+  {
+    CLog::Log(LOGINFO, "WebSocket: Trying to send an invalid frame");
+    delete frame;
+    return NULL;
+  }
+
+  return frame;
+}
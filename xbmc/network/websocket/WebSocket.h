@@ -124,6 +124,11 @@ public:
   virtual bool Handshake(const char* data, size_t length, std::string &response) = 0;
   virtual const CWebSocketMessage* Handle(const char* &buffer, size_t &length, bool &send);
   virtual const CWebSocketMessage* Send(WebSocketFrameOpcode opcode, const char* data = NULL, uint32_t length = 0);
+  /*!
+   \brief Creates one frame of a fragmented message, the first one with the given opcode and
+   the following ones as continuation frames. The caller owns the returned frame.
+   */
+  virtual const CWebSocketFrame* Fragment(WebSocketFrameOpcode opcode, const char* data, uint32_t length, bool first, bool final);
   virtual const CWebSocketFrame* Ping(const char* data = NULL) const = 0;
   virtual const CWebSocketFrame* Pong(const char* data = NULL) const = 0;
   virtual const CWebSocketFrame* Close(WebSocketCloseReason reason = WebSocketCloseNormal, const std::string &message = "") = 0;
@@ -32,6 +32,7 @@
 #include "filesystem/File.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
+#include "guilib/DDSImage.h"
 #include "guilib/Texture.h"
 #include "guilib/imagefactory.h"
 #include "cores/FFmpeg.h"
@@ -99,6 +100,34 @@ bool CPicture::CreateThumbnailFromSurface(const unsigned char *buffer, int width
   return ret;
 }
 
+std::string CPicture::GetCompressedCachePath(const std::string &cachedFile)
+{
+  return URIUtils::ReplaceExtension(cachedFile, ".dds");
+}
+
+bool CPicture::CreateCompressedThumbnail(const unsigned char *buffer, int width, int height, int stride, const std::string &thumbFile)
+{
+  // the DDS sits next to the JPG/PNG so it is refreshed and removed along with it
+  std::string compressedFile = GetCompressedCachePath(thumbFile);
+  if (!g_advancedSettings.m_imageCacheCompressed)
+  {
+    // recached with the setting turned off, don't leave the old texture behind
+    if (CFile::Exists(compressedFile))
+      CFile::Delete(compressedFile);
+    return false;
+  }
+
+  CDDSImage image;
+  if (!image.Compress(width, height, stride, buffer, true) || !image.WriteFile(compressedFile))
+  {
+    CLog::Log(LOGERROR, "%s - failed to create compressed texture for %s", __FUNCTION__, thumbFile.c_str());
+    if (CFile::Exists(compressedFile))
+      CFile::Delete(compressedFile);
+    return false;
+  }
+  return true;
+}
+
 CThumbnailWriter::CThumbnailWriter(unsigned char* buffer, int width, int height, int stride, const std::string& thumbFile):
   m_thumbFile(thumbFile)
 {
@@ -210,6 +239,13 @@ bool CPicture::CacheTexture(CBaseTexture *texture, uint32_t &dest_width, uint32_
                       texture->GetOrientation(), dest_width, dest_height, dest, scalingAlgorithm);
 }
 
+void CPicture::GetMaxCacheSize(uint32_t &width, uint32_t &height)
+{
+  // matches the limits applied in CacheTexture, fanart res only applies to 16x9 images
+  height = std::max(g_advancedSettings.m_imageRes, g_advancedSettings.m_fanartRes);
+  width = height * 16/9;
+}
+
 bool CPicture::CacheTexture(uint8_t *pixels, uint32_t width, uint32_t height, uint32_t pitch, int orientation,
   uint32_t &dest_width, uint32_t &dest_height, const std::string &dest,
   CPictureScalingAlgorithm::Algorithm scalingAlgorithm /* = CPictureScalingAlgorithm::NoAlgorithm */)
@@ -254,6 +290,8 @@ bool CPicture::CacheTexture(uint8_t *pixels, uint32_t width, uint32_t height, ui
         if (!orientation || OrientateImage(buffer, dest_width, dest_height, orientation))
         {
           success = CreateThumbnailFromSurface((unsigned char*)buffer, dest_width, dest_height, dest_width * 4, dest);
+          if (success)
+            CreateCompressedThumbnail((unsigned char*)buffer, dest_width, dest_height, dest_width * 4, dest);
         }
       }
       delete[] buffer;
@@ -264,7 +302,10 @@ bool CPicture::CacheTexture(uint8_t *pixels, uint32_t width, uint32_t height, ui
   { // no orientation needed
     dest_width = width;
     dest_height = height;
-    return CreateThumbnailFromSurface(pixels, width, height, pitch, dest);
+    if (!CreateThumbnailFromSurface(pixels, width, height, pitch, dest))
+      return false;
+    CreateCompressedThumbnail(pixels, width, height, pitch, dest);
+    return true;
   }
   return false;
 }
@@ -59,7 +59,21 @@ public:
     uint32_t &dest_width, uint32_t &dest_height, const std::string &dest,
     CPictureScalingAlgorithm::Algorithm scalingAlgorithm = CPictureScalingAlgorithm::NoAlgorithm);
 
+  /*! \brief Get the largest size CacheTexture will store an image at
+   Loading the texture at (at most) this size lets the decoder skip work for large images.
+   \param width [out] maximum width in pixels of any cached image
+   \param height [out] maximum height in pixels of any cached image
+   */
+  static void GetMaxCacheSize(uint32_t &width, uint32_t &height);
+
+  /*! \brief Get the compressed texture cached alongside a cached image
+   \param cachedFile the cached JPG or PNG
+   \return the path of its mip-mapped DXT version in a DDS container
+   */
+  static std::string GetCompressedCachePath(const std::string &cachedFile);
+
 private:
+  static bool CreateCompressedThumbnail(const unsigned char* buffer, int width, int height, int stride, const std::string &thumbFile);
   static void GetScale(unsigned int width, unsigned int height, unsigned int &out_width, unsigned int &out_height);
   static bool ScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned int in_height, unsigned int in_pitch,
                          uint8_t *out_pixels, unsigned int out_width, unsigned int out_height, unsigned int out_pitch,
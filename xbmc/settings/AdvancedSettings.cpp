@@ -117,6 +117,7 @@ void CAdvancedSettings::Initialize()
   //default hold time of 25 ms, this allows a 20 hertz sine to pass undistorted
   m_limiterHold = 0.025f;
   m_limiterRelease = 0.1f;
+  m_audioDSPPipelineStages = 1;
 
   m_seekSteps = { 10, 30, 60, 180, 300, 600, 1800 };
 
@@ -262,6 +263,7 @@ void CAdvancedSettings::Initialize()
   m_fanartRes = 1080;
   m_imageRes = 720;
   m_imageScalingAlgorithm = CPictureScalingAlgorithm::Default;
+  m_imageCacheCompressed = false;
 
   m_sambaclienttimeout = 10;
   m_sambadoscodepage = "";
@@ -291,6 +293,7 @@ void CAdvancedSettings::Initialize()
   m_bVideoLibraryImportWatchedState = false;
   m_bVideoLibraryImportResumePoint = false;
   m_bVideoScannerIgnoreErrors = false;
+  m_iVideoScannerReadAhead = 0;
   m_iVideoLibraryDateAdded = 1; // prefer mtime over ctime and current time
 
   m_iEpgLingerTime = 60 * 24;           /* keep 24 hours by default */
@@ -356,6 +359,8 @@ void CAdvancedSettings::Initialize()
   m_iPVRNumericChannelSwitchTimeout = 1000;
 
   m_cacheMemBufferSize = 1024 * 1024 * 20;
+  m_cacheDiskBufferSize = 0;
+  m_directoryCacheTTL.clear();
   m_networkBufferMode = 0; // Default (buffer all internet streams/filesystems)
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
@@ -375,6 +380,8 @@ void CAdvancedSettings::Initialize()
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 3;
   m_guiDirtyRegionNoFlipTimeout = 0;
+  m_guiTextureCacheSize = 32;
+  m_guiSkinXMLCache = true;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
 
@@ -489,6 +496,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
 
     XMLUtils::GetFloat(pElement, "limiterhold", m_limiterHold, 0.0f, 100.0f);
     XMLUtils::GetFloat(pElement, "limiterrelease", m_limiterRelease, 0.001f, 100.0f);
+    XMLUtils::GetInt(pElement, "dsppipelinestages", m_audioDSPPipelineStages, 1, 3);
   }
 
   pElement = pRootElement->FirstChildElement("omx");
@@ -719,6 +727,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   if (pElement)
   {
     XMLUtils::GetBoolean(pElement, "ignoreerrors", m_bVideoScannerIgnoreErrors);
+    XMLUtils::GetInt(pElement, "readahead", m_iVideoScannerReadAhead, 0, 32);
   }
 
   // Backward-compatibility of ExternalPlayer config
@@ -743,8 +752,25 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
     XMLUtils::GetUInt(pElement, "cachemembuffersize", m_cacheMemBufferSize);
+    XMLUtils::GetUInt(pElement, "cachediskbuffersize", m_cacheDiskBufferSize);
     XMLUtils::GetUInt(pElement, "buffermode", m_networkBufferMode, 0, 3);
     XMLUtils::GetFloat(pElement, "readbufferfactor", m_readBufferFactor);
+
+    TiXmlElement* pDirCache = pElement->FirstChildElement("directorycache");
+    if (pDirCache)
+    {
+      TiXmlElement* pTTL = pDirCache->FirstChildElement("ttl");
+      while (pTTL)
+      {
+        std::string protocol = XMLUtils::GetAttribute(pTTL, "protocol");
+        if (!protocol.empty() && pTTL->FirstChild())
+        {
+          StringUtils::ToLower(protocol);
+          m_directoryCacheTTL[protocol] = std::max(0, atoi(pTTL->FirstChild()->Value()));
+        }
+        pTTL = pTTL->NextSiblingElement("ttl");
+      }
+    }
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -962,6 +988,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   XMLUtils::GetUInt(pRootElement, "imageres", m_imageRes, 0, 1080);
   if (XMLUtils::GetString(pRootElement, "imagescalingalgorithm", tmp))
     m_imageScalingAlgorithm = CPictureScalingAlgorithm::FromString(tmp);
+  XMLUtils::GetBoolean(pRootElement, "imagecachecompressed", m_imageCacheCompressed);
   XMLUtils::GetBoolean(pRootElement, "playlistasfolders", m_playlistAsFolders);
   XMLUtils::GetBoolean(pRootElement, "detectasudf", m_detectAsUdf);
 
@@ -1117,6 +1144,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
     XMLUtils::GetInt(pElement, "nofliptimeout",             m_guiDirtyRegionNoFlipTimeout);
+    XMLUtils::GetUInt(pElement, "texturecachesize",         m_guiTextureCacheSize);
+    XMLUtils::GetBoolean(pElement, "skinxmlcache",          m_guiSkinXMLCache);
   }
 
   std::string seekSteps;
@@ -19,6 +19,7 @@
  *
  */
 
+#include <map>
 #include <set>
 #include <string>
 #include <utility>
@@ -136,6 +137,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_VideoPlayerIgnoreDTSinWAV;
     float m_limiterHold;
     float m_limiterRelease;
+    int m_audioDSPPipelineStages; ///< \brief threads the dsp chain of a stream may run on, at most; segments served by the same addon are never split, so fewer may be used
 
     bool  m_omxDecodeStartWithValidFrame;
 
@@ -239,6 +241,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
      */
     unsigned int GetThumbSize() const { return m_imageRes / 2; };
     CPictureScalingAlgorithm::Algorithm m_imageScalingAlgorithm;
+    bool m_imageCacheCompressed; ///< \brief also cache images as mip-mapped DXT textures, uploaded without decoding
 
     int m_sambaclienttimeout;
     std::string m_sambadoscodepage;
@@ -270,6 +273,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bVideoLibraryImportResumePoint;
 
     bool m_bVideoScannerIgnoreErrors;
+    int m_iVideoScannerReadAhead;
     int m_iVideoLibraryDateAdded;
 
     std::set<std::string> m_vecTokens;
@@ -338,9 +342,13 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     int  m_guiDirtyRegionNoFlipTimeout;
+    unsigned int m_guiTextureCacheSize; // MB of released GUI textures kept for reuse
+    bool m_guiSkinXMLCache; // cache window xml with the includes resolved
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemBufferSize;
+    unsigned int m_cacheDiskBufferSize;
+    std::map<std::string, int> m_directoryCacheTTL; ///< seconds a persisted listing is trusted, per protocol
     unsigned int m_networkBufferMode;
     float m_readBufferFactor;
 
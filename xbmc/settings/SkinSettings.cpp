@@ -59,6 +59,7 @@ const std::string& CSkinSettings::GetString(int setting) const
 void CSkinSettings::SetString(int setting, const std::string &label)
 {
   g_SkinInfo->SetString(setting, label);
+  g_infoManager.ResetCache(INFO::INFO_SOURCE_SKIN_SETTINGS);
 }
 
 int CSkinSettings::TranslateBool(const std::string &setting)
@@ -74,11 +75,13 @@ bool CSkinSettings::GetBool(int setting) const
 void CSkinSettings::SetBool(int setting, bool set)
 {
   g_SkinInfo->SetBool(setting, set);
+  g_infoManager.ResetCache(INFO::INFO_SOURCE_SKIN_SETTINGS);
 }
 
 void CSkinSettings::Reset(const std::string &setting)
 {
   g_SkinInfo->Reset(setting);
+  g_infoManager.ResetCache(INFO::INFO_SOURCE_SKIN_SETTINGS);
 }
 
 void CSkinSettings::Reset()
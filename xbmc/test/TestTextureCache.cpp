@@ -0,0 +1,97 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TextureCache.h"
+#include "threads/Event.h"
+#include "utils/JobManager.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+// stands in for the library scan, holds a LOW worker until released
+class CHoldJob : public CJob
+{
+public:
+  CHoldJob(CEvent &release) : m_release(release) {}
+  virtual bool DoWork() { m_release.Wait(); return true; }
+private:
+  CEvent &m_release;
+};
+
+// stands in for a precache stage, waits a while for the other stage to run alongside
+class CStageJob : public CJob
+{
+public:
+  CStageJob(std::atomic<int> &running, std::atomic<int> &maxRunning, std::atomic<int> &finished)
+    : m_running(running), m_maxRunning(maxRunning), m_finished(finished) {}
+
+  virtual bool DoWork()
+  {
+    int running = ++m_running;
+    int maxRunning = m_maxRunning;
+    while (running > maxRunning && !m_maxRunning.compare_exchange_weak(maxRunning, running));
+
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (m_maxRunning < 2 && std::chrono::steady_clock::now() < end)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    --m_running;
+    ++m_finished;
+    return true;
+  }
+
+private:
+  std::atomic<int> &m_running;
+  std::atomic<int> &m_maxRunning;
+  std::atomic<int> &m_finished;
+};
+}
+
+TEST(TestTextureCache, PrecacheStagesOverlapScan)
+{
+  CEvent scanDone(true);
+  ASSERT_NE(0u, CJobManager::GetInstance().AddJob(new CHoldJob(scanDone), NULL, CJob::PRIORITY_LOW));
+
+  std::atomic<int> running(0), maxRunning(0), finished(0);
+  {
+    CJobQueue fetch(false, CTextureCache::PRECACHE_FETCH_JOBS, CTextureCache::PRECACHE_PRIORITY);
+    CJobQueue decode(false, CTextureCache::PRECACHE_DECODE_JOBS, CTextureCache::PRECACHE_PRIORITY);
+    fetch.AddJob(new CStageJob(running, maxRunning, finished));
+    decode.AddJob(new CStageJob(running, maxRunning, finished));
+
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (finished < 2 && std::chrono::steady_clock::now() < end)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    scanDone.Set();
+    ASSERT_EQ(2, finished);
+  }
+
+  // a fetch and a decode ran at the same time while the scan held its worker
+  EXPECT_EQ(2, maxRunning);
+
+  // let the idle workers go
+  CJobManager::GetInstance().CancelJobs();
+  CJobManager::GetInstance().Restart();
+}
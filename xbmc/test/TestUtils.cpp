@@ -358,3 +358,42 @@ std::string CXBMCTestUtils::getNewLineCharacters() const
   return "\n";
 #endif
 }
+
+namespace
+{
+// simple LCG, good enough for test data and the same on every platform
+unsigned int NextRandom(unsigned int &seed)
+{
+  seed = seed * 1103515245 + 12345;
+  return seed;
+}
+}
+
+std::vector<unsigned char> CXBMCTestUtils::CreateTestSurface(unsigned int width, unsigned int height,
+                                                             unsigned char alpha) const
+{
+  std::vector<unsigned char> pixels(width * height * 4);
+  unsigned int seed = 12345;
+  for (unsigned int y = 0; y < height; y++)
+  {
+    unsigned char *row = &pixels[y * width * 4];
+    for (unsigned int x = 0; x < width; x++)
+    {
+      unsigned char noise = (NextRandom(seed) >> 16) & 0x0f;
+      row[x * 4 + 0] = (unsigned char)(x * 255 / width) ^ noise;
+      row[x * 4 + 1] = (unsigned char)(y * 255 / height) ^ noise;
+      row[x * 4 + 2] = (unsigned char)((x + y) & 0xff);
+      row[x * 4 + 3] = alpha;
+    }
+  }
+  return pixels;
+}
+
+std::vector<float> CXBMCTestUtils::CreateTestSamples(unsigned int count, float range) const
+{
+  std::vector<float> samples(count);
+  unsigned int seed = 12345;
+  for (unsigned int i = 0; i < count; i++)
+    samples[i] = ((NextRandom(seed) >> 8) & 0xffff) / 32768.0f * range - range;
+  return samples;
+}
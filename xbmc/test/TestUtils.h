@@ -90,6 +90,18 @@ public:
 
   /* Function to return the newline characters for this platform */
   std::string getNewLineCharacters() const;
+
+  /* Function to create a width x height A8R8G8B8 surface, gradients with
+   * some noise so image encoders can't cheat too much. The same seed is
+   * used for every call so results are reproducible.
+   */
+  std::vector<unsigned char> CreateTestSurface(unsigned int width, unsigned int height,
+                                               unsigned char alpha = 0xff) const;
+
+  /* Function to create count reproducible pseudo random samples in the
+   * range [-range, range).
+   */
+  std::vector<float> CreateTestSamples(unsigned int count, float range) const;
 private:
   CXBMCTestUtils();
   CXBMCTestUtils(CXBMCTestUtils const&);
@@ -22,24 +22,53 @@
 
 using namespace Actor;
 
-void Message::Release()
+Message::Message() : next(NULL), extBuffer(NULL), extBufferSize(0), syncEvent(NULL)
 {
-  bool skip;
-  origin->Lock();
-  skip = isSync ? !isSyncFini : false;
-  isSyncFini = true;
-  origin->Unlock();
+  isSync = false;
+  data = NULL;
+  event = NULL;
+  replyMessage = NULL;
+}
 
-  if (skip)
-    return;
+Message::~Message()
+{
+  delete [] extBuffer;
+  delete syncEvent;
+}
 
-  // free data buffer
-  if (data != buffer)
-    delete [] data;
+void Message::SetData(void *payload, int size)
+{
+  if (size > MSG_INTERNAL_BUFFER_SIZE)
+  {
+    if (size > extBufferSize)
+    {
+      delete [] extBuffer;
+      extBuffer = new uint8_t[size];
+      extBufferSize = size;
+      origin->allocations++;
+    }
+    data = extBuffer;
+  }
+  else
+    data = buffer;
+  memcpy(data, payload, size);
+  payloadSize = size;
+}
 
-  // delete event in case of sync message
-  if (event)
-    delete event;
+void Message::Release()
+{
+  // a sync message is released by sender and receiver, the last one returns it
+  if (isSync)
+  {
+    bool skip;
+    origin->Lock();
+    skip = !isSyncFini;
+    isSyncFini = true;
+    origin->Unlock();
+
+    if (skip)
+      return;
+  }
 
   origin->ReturnMessage(this);
 }
@@ -63,13 +92,7 @@ bool Message::Reply(int sig, void *data /* = NULL*/, int size /* = 0 */)
     msg->isOut = !isOut;
     replyMessage = msg;
     if (data)
-    {
-      if (size > MSG_INTERNAL_BUFFER_SIZE)
-        msg->data = new uint8_t[size];
-      else
-        msg->data = msg->buffer;
-      memcpy(msg->data, data, size);
-    }
+      msg->SetData(data, size);
   }
 
   origin->Unlock();
@@ -80,16 +103,36 @@ bool Message::Reply(int sig, void *data /* = NULL*/, int size /* = 0 */)
   return true;
 }
 
+void MessageQueue::push(Message *msg)
+{
+  msg->next = NULL;
+  if (tail)
+    tail->next = msg;
+  else
+    head = msg;
+  tail = msg;
+  count++;
+}
+
+Message *MessageQueue::pop()
+{
+  Message *msg = head;
+  if (!msg)
+    return NULL;
+  head = msg->next;
+  if (!head)
+    tail = NULL;
+  msg->next = NULL;
+  count--;
+  return msg;
+}
+
 Protocol::~Protocol()
 {
   Message *msg;
   Purge();
-  while (!freeMessageQueue.empty())
-  {
-    msg = freeMessageQueue.front();
-    freeMessageQueue.pop();
+  while ((msg = freeMessages.pop()) != NULL)
     delete msg;
-  }
 }
 
 Message *Protocol::GetMessage()
@@ -98,13 +141,12 @@ Message *Protocol::GetMessage()
 
   CSingleLock lock(criticalSection);
 
-  if (!freeMessageQueue.empty())
+  msg = freeMessages.pop();
+  if (!msg)
   {
-    msg = freeMessageQueue.front();
-    freeMessageQueue.pop();
-  }
-  else
     msg = new Message();
+    allocations++;
+  }
 
   msg->isSync = false;
   msg->isSyncFini = false;
@@ -120,9 +162,15 @@ Message *Protocol::GetMessage()
 
 void Protocol::ReturnMessage(Message *msg)
 {
-  CSingleLock lock(criticalSection);
-
-  freeMessageQueue.push(msg);
+  {
+    CSingleLock lock(criticalSection);
+    if (freeMessages.size() < MSG_POOL_SIZE)
+    {
+      freeMessages.push(msg);
+      return;
+    }
+  }
+  delete msg;
 }
 
 bool Protocol::SendOutMessage(int signal, void *data /* = NULL */, int size /* = 0 */, Message *outMsg /* = NULL */)
@@ -137,13 +185,7 @@ bool Protocol::SendOutMessage(int signal, void *data /* = NULL */, int size /* =
   msg->isOut = true;
 
   if (data)
-  {
-    if (size > MSG_INTERNAL_BUFFER_SIZE)
-      msg->data = new uint8_t[size];
-    else
-      msg->data = msg->buffer;
-    memcpy(msg->data, data, size);
-  }
+    msg->SetData(data, size);
 
   { CSingleLock lock(criticalSection);
     outMessages.push(msg);
@@ -165,13 +207,7 @@ bool Protocol::SendInMessage(int signal, void *data /* = NULL */, int size /* =
   msg->isOut = false;
 
   if (data)
-  {
-    if (size > MSG_INTERNAL_BUFFER_SIZE)
-      msg->data = new uint8_t[size];
-    else
-      msg->data = msg->buffer;
-    memcpy(msg->data, data, size);
-  }
+    msg->SetData(data, size);
 
   { CSingleLock lock(criticalSection);
     inMessages.push(msg);
@@ -187,7 +223,12 @@ bool Protocol::SendOutMessageSync(int signal, Message **retMsg, int timeout, voi
   Message *msg = GetMessage();
   msg->isOut = true;
   msg->isSync = true;
-  msg->event = new CEvent;
+  if (!msg->syncEvent)
+  {
+    msg->syncEvent = new CEvent;
+    allocations++;
+  }
+  msg->event = msg->syncEvent;
   msg->event->Reset();
   SendOutMessage(signal, data, size, msg);
 
@@ -221,8 +262,7 @@ bool Protocol::ReceiveOutMessage(Message **msg)
   if (outMessages.empty() || outDefered)
     return false;
 
-  *msg = outMessages.front();
-  outMessages.pop();
+  *msg = outMessages.pop();
 
   return true;
 }
@@ -234,8 +274,7 @@ bool Protocol::ReceiveInMessage(Message **msg)
   if (inMessages.empty() || inDefered)
     return false;
 
-  *msg = inMessages.front();
-  inMessages.pop();
+  *msg = inMessages.pop();
 
   return true;
 }
@@ -255,43 +294,31 @@ void Protocol::Purge()
 void Protocol::PurgeIn(int signal)
 {
   Message *msg;
-  std::queue<Message*> msgs;
+  MessageQueue msgs;
 
   CSingleLock lock(criticalSection);
 
-  while (!inMessages.empty())
+  while ((msg = inMessages.pop()) != NULL)
   {
-    msg = inMessages.front();
-    inMessages.pop();
     if (msg->signal != signal)
       msgs.push(msg);
   }
-  while (!msgs.empty())
-  {
-    msg = msgs.front();
-    msgs.pop();
+  while ((msg = msgs.pop()) != NULL)
     inMessages.push(msg);
-  }
 }
 
 void Protocol::PurgeOut(int signal)
 {
   Message *msg;
-  std::queue<Message*> msgs;
+  MessageQueue msgs;
 
   CSingleLock lock(criticalSection);
 
-  while (!outMessages.empty())
+  while ((msg = outMessages.pop()) != NULL)
   {
-    msg = outMessages.front();
-    outMessages.pop();
     if (msg->signal != signal)
       msgs.push(msg);
   }
-  while (!msgs.empty())
-  {
-    msg = msgs.front();
-    msgs.pop();
+  while ((msg = msgs.pop()) != NULL)
     outMessages.push(msg);
-  }
 }
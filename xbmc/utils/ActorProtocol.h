@@ -21,10 +21,11 @@
 #pragma once
 
 #include "threads/Thread.h"
-#include <queue>
+#include <atomic>
 #include "memory.h"
 
 #define MSG_INTERNAL_BUFFER_SIZE 32
+#define MSG_POOL_SIZE 128
 
 namespace Actor
 {
@@ -34,6 +35,7 @@ class Protocol;
 class Message
 {
   friend class Protocol;
+  friend class MessageQueue;
 public:
   int signal;
   bool isSync;
@@ -51,14 +53,38 @@ public:
   bool Reply(int sig, void *data = NULL, int size = 0);
 
 private:
-  Message() {isSync = false; data = NULL; event = NULL; replyMessage = NULL;};
+  Message();
+  ~Message();
+  void SetData(void *payload, int size);
+
+  Message *next;             // free list or message queue of the port
+  uint8_t *extBuffer;        // payloads larger than buffer, kept while the message is pooled
+  int extBufferSize;
+  CEvent *syncEvent;         // event of sync messages, kept while the message is pooled
+};
+
+/*!
+ \brief Messages linked through Message::next, no allocation when queued
+ */
+class MessageQueue
+{
+public:
+  MessageQueue() : head(NULL), tail(NULL), count(0) {};
+  bool empty() const { return head == NULL; };
+  unsigned int size() const { return count; };
+  void push(Message *msg);
+  Message *pop();
+
+protected:
+  Message *head, *tail;
+  unsigned int count;
 };
 
 class Protocol
 {
 public:
   Protocol(std::string name, CEvent* inEvent, CEvent *outEvent)
-    : portName(name), inDefered(false), outDefered(false) {containerInEvent = inEvent; containerOutEvent = outEvent;};
+    : portName(name), allocations(0), inDefered(false), outDefered(false) {containerInEvent = inEvent; containerOutEvent = outEvent;};
   virtual ~Protocol();
   Message *GetMessage();
   void ReturnMessage(Message *msg);
@@ -74,14 +100,17 @@ public:
   void DeferOut(bool value) {outDefered = value;};
   void Lock() {criticalSection.lock();};
   void Unlock() {criticalSection.unlock();};
+  unsigned int GetAllocations() const {return allocations;};
   std::string portName;
 
 protected:
+  friend class Message;
   CEvent *containerInEvent, *containerOutEvent;
   CCriticalSection criticalSection;
-  std::queue<Message*> outMessages;
-  std::queue<Message*> inMessages;
-  std::queue<Message*> freeMessageQueue;
+  MessageQueue outMessages;
+  MessageQueue inMessages;
+  MessageQueue freeMessages;          // at most MSG_POOL_SIZE, the rest is deleted when returned
+  std::atomic<unsigned int> allocations; // messages, payloads and events allocated by the port
   bool inDefered, outDefered;
 };
 
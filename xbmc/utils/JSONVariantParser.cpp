@@ -37,6 +37,7 @@ yajl_callbacks CJSONVariantParser::callbacks = {
 CJSONVariantParser::CJSONVariantParser(IParseCallback *callback)
 {
   m_callback = callback;
+  m_output = NULL;
 
   m_handler = yajl_alloc(&callbacks, NULL, this);
 
@@ -57,21 +58,52 @@ void CJSONVariantParser::push_buffer(const unsigned char *buffer, unsigned int l
   yajl_parse(m_handler, buffer, length);
 }
 
+CJSONVariantParser::CJSONVariantParser(CVariant *output)
+{
+  m_callback = NULL;
+  m_output = output;
+
+  m_handler = yajl_alloc(&callbacks, NULL, this);
+
+  yajl_config(m_handler, yajl_allow_comments, 1);
+  yajl_config(m_handler, yajl_dont_validate_strings, 0);
+
+  m_status = ParseVariable;
+}
+
 CVariant CJSONVariantParser::Parse(const unsigned char *json, unsigned int length)
 {
-  CSimpleParseCallback callback;
-  CJSONVariantParser parser(&callback);
+  CVariant output;
+  Parse(reinterpret_cast<const char *>(json), length, output);
 
-  parser.push_buffer(json, length);
+  return output;
+}
 
-  return callback.GetOutput();
+bool CJSONVariantParser::Parse(const char *json, size_t length, CVariant &output)
+{
+  output = CVariant::VariantTypeNull;
+
+  CJSONVariantParser parser(&output);
+  bool success = yajl_parse(parser.m_handler, reinterpret_cast<const unsigned char *>(json), length) == yajl_status_ok &&
+                 yajl_complete_parse(parser.m_handler) == yajl_status_ok;
+
+  if (!parser.m_parse.empty())
+  {
+    // don't hand out a partially parsed value
+    parser.m_parse.clear();
+    parser.m_status = ParseVariable;
+    output = CVariant::VariantTypeNull;
+    return false;
+  }
+
+  return success;
 }
 
 int CJSONVariantParser::ParseNull(void * ctx)
 {
   CJSONVariantParser *parser = (CJSONVariantParser *)ctx;
 
-  parser->PushObject(CVariant::VariantTypeNull);
+  parser->PushObject(CVariant(CVariant::VariantTypeNull));
   parser->PopObject();
 
   return 1;
@@ -121,7 +153,7 @@ int CJSONVariantParser::ParseMapStart(void * ctx)
 {
   CJSONVariantParser *parser = (CJSONVariantParser *)ctx;
 
-  parser->PushObject(CVariant::VariantTypeObject);
+  parser->PushObject(CVariant(CVariant::VariantTypeObject));
 
   return 1;
 }
@@ -130,7 +162,7 @@ int CJSONVariantParser::ParseMapKey(void * ctx, const unsigned char * stringVal,
 {
   CJSONVariantParser *parser = (CJSONVariantParser *)ctx;
 
-  parser->m_key = std::string((const char *)stringVal, 0, stringLen);
+  parser->m_key.assign((const char *)stringVal, stringLen);
 
   return 1;
 }
@@ -148,7 +180,7 @@ int CJSONVariantParser::ParseArrayStart(void * ctx)
 {
   CJSONVariantParser *parser = (CJSONVariantParser *)ctx;
 
-  parser->PushObject(CVariant::VariantTypeArray);
+  parser->PushObject(CVariant(CVariant::VariantTypeArray));
 
   return 1;
 }
@@ -162,27 +194,40 @@ int CJSONVariantParser::ParseArrayEnd(void * ctx)
   return 1;
 }
 
-void CJSONVariantParser::PushObject(CVariant variant)
+void CJSONVariantParser::PushObject(CVariant &&variant)
 {
+  // the value is moved into its place in the tree and containers are then
+  // filled in place
+  CVariant *value;
   if (m_status == ParseObject)
   {
-    (*m_parse[m_parse.size() - 1])[m_key] = variant;
-    m_parse.push_back(&(*m_parse[m_parse.size() - 1])[m_key]);
+    value = &(*m_parse.back())[m_key];
+    *value = std::move(variant);
   }
   else if (m_status == ParseArray)
   {
-    CVariant *temp = m_parse[m_parse.size() - 1];
-    temp->push_back(variant);
-    m_parse.push_back(&(*temp)[temp->size() - 1]);
+    CVariant *temp = m_parse.back();
+    temp->push_back(std::move(variant));
+    value = &(*temp)[temp->size() - 1];
   }
   else if (m_parse.empty())
   {
-    m_parse.push_back(new CVariant(variant));
+    if (m_output)
+    {
+      value = m_output;
+      *value = std::move(variant);
+    }
+    else
+      value = new CVariant(std::move(variant));
   }
+  else
+    return;
 
-  if (variant.isObject())
+  m_parse.push_back(value);
+
+  if (value->isObject())
     m_status = ParseObject;
-  else if (variant.isArray())
+  else if (value->isArray())
     m_status = ParseArray;
   else
     m_status = ParseVariable;
@@ -203,10 +248,14 @@ void CJSONVariantParser::PopObject()
     else
       m_status = ParseVariable;
   }
-  else if (m_callback)
+  else
   {
-    m_callback->onParsed(variant);
-    delete variant;
+    if (variant != m_output)
+    {
+      if (m_callback)
+        m_callback->onParsed(variant);
+      delete variant;
+    }
 
     m_parse.clear();
     m_status = ParseVariable;
@@ -34,7 +34,7 @@ public:
 class CSimpleParseCallback : public IParseCallback
 {
 public:
-  virtual void onParsed(CVariant *variant) { m_parsed = *variant; }
+  virtual void onParsed(CVariant *variant) { m_parsed.swap(*variant); }
   CVariant &GetOutput() { return m_parsed; }
 
 private:
@@ -51,6 +51,15 @@ public:
 
   static CVariant Parse(const unsigned char *json, unsigned int length);
 
+  /*!
+   \brief Parses the given JSON straight into output without intermediate copies.
+   \param json JSON text to parse
+   \param length Length of the JSON text
+   \param output Variant the parsed value is built in
+   \return True if the JSON text was parsed completely, false otherwise.
+   */
+  static bool Parse(const char *json, size_t length, CVariant &output);
+
 private:
   static int ParseNull(void * ctx);
   static int ParseBoolean(void * ctx, int boolean);
@@ -63,15 +72,17 @@ private:
   static int ParseArrayStart(void * ctx);
   static int ParseArrayEnd(void * ctx);
 
-  void PushObject(CVariant variant);
+  explicit CJSONVariantParser(CVariant *output);
+
+  void PushObject(CVariant &&variant);
   void PopObject();
 
   static yajl_callbacks callbacks;
 
   IParseCallback *m_callback;
+  CVariant *m_output;
   yajl_handle m_handler;
 
-  CVariant m_parsedObject;
   std::vector<CVariant *> m_parse;
   std::string m_key;
 
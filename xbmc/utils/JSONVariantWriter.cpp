@@ -18,11 +18,60 @@
  *
  */
 
+#include <algorithm>
+#include <cstring>
 #include <locale>
 
 #include "JSONVariantWriter.h"
 #include "utils/Variant.h"
 
+namespace
+{
+// Sets the numeric locale to classic ("C") for the lifetime of the object
+// to ensure valid JSON numbers
+class CClassicNumericLocale
+{
+public:
+  CClassicNumericLocale()
+  {
+#ifndef TARGET_WINDOWS
+    const char *currentLocale = setlocale(LC_NUMERIC, NULL);
+    if (currentLocale != NULL && (currentLocale[0] != 'C' || currentLocale[1] != 0))
+    {
+      m_backupLocale = currentLocale;
+      setlocale(LC_NUMERIC, "C");
+    }
+#else  // TARGET_WINDOWS
+    const wchar_t* const currentLocale = _wsetlocale(LC_NUMERIC, NULL);
+    if (currentLocale != NULL && (currentLocale[0] != L'C' || currentLocale[1] != 0))
+    {
+      m_backupLocale = currentLocale;
+      _wsetlocale(LC_NUMERIC, L"C");
+    }
+#endif // TARGET_WINDOWS
+  }
+
+  ~CClassicNumericLocale()
+  {
+    // Re-set locale to what it was before using yajl
+#ifndef TARGET_WINDOWS
+    if (!m_backupLocale.empty())
+      setlocale(LC_NUMERIC, m_backupLocale.c_str());
+#else  // TARGET_WINDOWS
+    if (!m_backupLocale.empty())
+      _wsetlocale(LC_NUMERIC, m_backupLocale.c_str());
+#endif // TARGET_WINDOWS
+  }
+
+private:
+#ifndef TARGET_WINDOWS
+  std::string m_backupLocale;
+#else  // TARGET_WINDOWS
+  std::wstring m_backupLocale;
+#endif // TARGET_WINDOWS
+};
+}
+
 std::string CJSONVariantWriter::Write(const CVariant &value, bool compact)
 {
   std::string output;
@@ -31,43 +80,19 @@ std::string CJSONVariantWriter::Write(const CVariant &value, bool compact)
   yajl_gen_config(g, yajl_gen_beautify, compact ? 0 : 1);
   yajl_gen_config(g, yajl_gen_indent_string, "\t");
 
-  // Set locale to classic ("C") to ensure valid JSON numbers
-#ifndef TARGET_WINDOWS
-  const char *currentLocale = setlocale(LC_NUMERIC, NULL);
-  std::string backupLocale;
-  if (currentLocale != NULL && (currentLocale[0] != 'C' || currentLocale[1] != 0))
-  {
-    backupLocale = currentLocale;
-    setlocale(LC_NUMERIC, "C");
-  }
-#else  // TARGET_WINDOWS
-  const wchar_t* const currentLocale = _wsetlocale(LC_NUMERIC, NULL);
-  std::wstring backupLocale;
-  if (currentLocale != NULL && (currentLocale[0] != L'C' || currentLocale[1] != 0))
   {
-    backupLocale = currentLocale;
-    _wsetlocale(LC_NUMERIC, L"C");
-  }
-#endif // TARGET_WINDOWS
+    CClassicNumericLocale locale;
 
-  if (InternalWrite(g, value))
-  {
-    const unsigned char * buffer;
+    if (InternalWrite(g, value))
+    {
+      const unsigned char * buffer;
 
-    size_t length;
-    yajl_gen_get_buf(g, &buffer, &length);
-    output = std::string((const char *)buffer, length);
+      size_t length;
+      yajl_gen_get_buf(g, &buffer, &length);
+      output = std::string((const char *)buffer, length);
+    }
   }
 
-  // Re-set locale to what it was before using yajl
-#ifndef TARGET_WINDOWS
-  if (!backupLocale.empty())
-    setlocale(LC_NUMERIC, backupLocale.c_str());
-#else  // TARGET_WINDOWS
-  if (!backupLocale.empty())
-    _wsetlocale(LC_NUMERIC, backupLocale.c_str());
-#endif // TARGET_WINDOWS
-
   yajl_gen_clear(g);
   yajl_gen_free(g);
 
@@ -128,3 +153,127 @@ bool CJSONVariantWriter::InternalWrite(yajl_gen g, const CVariant &value)
 
   return success;
 }
+
+CJSONVariantStreamWriter::CJSONVariantStreamWriter(const CVariant &value, bool compact)
+  : m_value(value),
+    m_pending(NULL),
+    m_pendingLength(0),
+    m_pendingOffset(0),
+    m_started(false),
+    m_done(false),
+    m_failed(false)
+{
+  m_gen = yajl_gen_alloc(NULL);
+  yajl_gen_config(m_gen, yajl_gen_beautify, compact ? 0 : 1);
+  yajl_gen_config(m_gen, yajl_gen_indent_string, "\t");
+}
+
+CJSONVariantStreamWriter::~CJSONVariantStreamWriter()
+{
+  yajl_gen_free(m_gen);
+}
+
+size_t CJSONVariantStreamWriter::Read(char *buffer, size_t size)
+{
+  CClassicNumericLocale locale;
+  size_t written = 0;
+
+  while (written < size)
+  {
+    // hand out what yajl has generated so far
+    if (m_pendingOffset < m_pendingLength)
+    {
+      size_t length = std::min(size - written, m_pendingLength - m_pendingOffset);
+      memcpy(buffer + written, m_pending + m_pendingOffset, length);
+      m_pendingOffset += length;
+      written += length;
+      continue;
+    }
+
+    if (m_pendingLength > 0)
+    {
+      yajl_gen_clear(m_gen);
+      m_pending = NULL;
+      m_pendingLength = m_pendingOffset = 0;
+    }
+
+    if (m_done)
+      break;
+
+    // generate at least enough to fill the rest of the buffer
+    size_t length = 0;
+    while (!m_done && length < size - written)
+    {
+      if (!Step())
+      {
+        m_failed = true;
+        m_done = true;
+      }
+      yajl_gen_get_buf(m_gen, &m_pending, &length);
+    }
+    yajl_gen_get_buf(m_gen, &m_pending, &m_pendingLength);
+  }
+
+  return written;
+}
+
+bool CJSONVariantStreamWriter::Step()
+{
+  if (m_stack.empty())
+  {
+    if (m_started)
+    {
+      m_done = true;
+      return true;
+    }
+
+    m_started = true;
+    return Open(m_value);
+  }
+
+  Frame &frame = m_stack.back();
+  if (frame.value->isArray())
+  {
+    if (frame.item == frame.value->end_array())
+    {
+      m_stack.pop_back();
+      return yajl_gen_status_ok == yajl_gen_array_close(m_gen);
+    }
+
+    const CVariant &item = *frame.item++;
+    return Open(item);
+  }
+
+  if (frame.member == frame.value->end_map())
+  {
+    m_stack.pop_back();
+    return yajl_gen_status_ok == yajl_gen_map_close(m_gen);
+  }
+
+  CVariant::const_iterator_map member = frame.member++;
+  if (yajl_gen_status_ok != yajl_gen_string(m_gen, (const unsigned char*)member->first.c_str(), (size_t)member->first.length()))
+    return false;
+  return Open(member->second);
+}
+
+bool CJSONVariantStreamWriter::Open(const CVariant &value)
+{
+  Frame frame;
+  frame.value = &value;
+
+  switch (value.type())
+  {
+  case CVariant::VariantTypeArray:
+    frame.item = value.begin_array();
+    m_stack.push_back(frame);
+    return yajl_gen_status_ok == yajl_gen_array_open(m_gen);
+
+  case CVariant::VariantTypeObject:
+    frame.member = value.begin_map();
+    m_stack.push_back(frame);
+    return yajl_gen_status_ok == yajl_gen_map_open(m_gen);
+
+  default:
+    return CJSONVariantWriter::InternalWrite(m_gen, value);
+  }
+}
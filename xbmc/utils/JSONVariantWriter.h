@@ -21,13 +21,71 @@
 
 #include <yajl/yajl_gen.h>
 #include <string>
+#include <vector>
 
-class CVariant;
+#include "utils/Variant.h"
 
 class CJSONVariantWriter
 {
+  friend class CJSONVariantStreamWriter;
 public:
   static std::string Write(const CVariant &value, bool compact);
 private:
   static bool InternalWrite(yajl_gen g, const CVariant &value);
 };
+
+/*!
+ \brief Serializes a CVariant to JSON piece by piece.
+
+ The output is produced as the caller reads it, so a large value can be
+ handed to a transport in chunks without building the complete string
+ first. The value must stay alive and unchanged while it is being read.
+ */
+class CJSONVariantStreamWriter
+{
+public:
+  CJSONVariantStreamWriter(const CVariant &value, bool compact);
+  ~CJSONVariantStreamWriter();
+
+  /*!
+   \brief Writes the next part of the JSON output to the given buffer.
+   \param buffer Buffer to write to
+   \param size Size of the buffer
+   \return Number of bytes written, less than size only at the end of the output
+   */
+  size_t Read(char *buffer, size_t size);
+
+  /*!
+   \brief Whether all of the output has been read.
+   */
+  bool IsEnd() const { return m_done && m_pendingOffset >= m_pendingLength; }
+
+  /*!
+   \brief Whether serializing failed, in which case the output is incomplete.
+   */
+  bool HasFailed() const { return m_failed; }
+
+private:
+  CJSONVariantStreamWriter(const CJSONVariantStreamWriter&);
+  CJSONVariantStreamWriter& operator=(const CJSONVariantStreamWriter&);
+
+  bool Step();
+  bool Open(const CVariant &value);
+
+  struct Frame
+  {
+    const CVariant *value;
+    CVariant::const_iterator_array item;
+    CVariant::const_iterator_map member;
+  };
+
+  const CVariant &m_value;
+  yajl_gen m_gen;
+  std::vector<Frame> m_stack;
+  const unsigned char *m_pending;
+  size_t m_pendingLength;
+  size_t m_pendingOffset;
+  bool m_started;
+  bool m_done;
+  bool m_failed;
+};
@@ -34,9 +34,10 @@ bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
   return false;
 }
 
-CJobWorker::CJobWorker(CJobManager *manager) : CThread("JobWorker")
+CJobWorker::CJobWorker(CJobManager *manager, unsigned int lane) : CThread("JobWorker")
 {
   m_jobManager = manager;
+  m_lane = lane;
   Create(true); // start work immediately, and kill ourselves when we're done
 }
 
@@ -179,6 +180,10 @@ CJobManager &CJobManager::GetInstance()
 CJobManager::CJobManager()
 {
   m_jobCounter = 0;
+  m_nextLane = 0;
+  m_processingCount = 0;
+  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
+    m_queuedCount[priority] = 0;
   m_running = true;
   m_pauseJobs = false;
 }
@@ -197,15 +202,22 @@ void CJobManager::CancelJobs()
   CSingleLock lock(m_section);
   m_running = false;
 
-  // clear any pending jobs
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
+  for (unsigned int lane = 0; lane < MAX_WORKERS; ++lane)
   {
-    for_each(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), std::mem_fun_ref(&CWorkItem::FreeJob));
-    m_jobQueue[priority].clear();
-  }
+    CSingleLock laneLock(m_lanes[lane].m_section);
 
-  // cancel any callbacks on jobs still processing
-  for_each(m_processing.begin(), m_processing.end(), std::mem_fun_ref(&CWorkItem::Cancel));
+    // clear any pending jobs
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
+    {
+      JobQueue &queue = m_lanes[lane].m_jobQueue[priority];
+      m_queuedCount[priority] -= queue.size();
+      for_each(queue.begin(), queue.end(), std::mem_fun_ref(&CWorkItem::FreeJob));
+      queue.clear();
+    }
+
+    // cancel any callbacks on jobs still processing
+    for_each(m_lanes[lane].m_processing.begin(), m_lanes[lane].m_processing.end(), std::mem_fun_ref(&CWorkItem::Cancel));
+  }
 
   // tell our workers to finish
   while (m_workers.size())
@@ -223,43 +235,66 @@ CJobManager::~CJobManager()
 
 unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
 {
+  // held until the job is queued, so CancelJobs can't clear the lanes in between
   CSingleLock lock(m_section);
 
   if (!m_running)
     return 0;
 
   // increment the job counter, ensuring 0 (invalid job) is never hit
-  m_jobCounter++;
-  if (m_jobCounter == 0)
-    m_jobCounter++;
+  unsigned int id = ++m_jobCounter;
+  if (id == 0)
+    id = ++m_jobCounter;
 
   // create a work item for this job
-  CWorkItem work(job, m_jobCounter, priority, callback);
-  m_jobQueue[priority].push_back(work);
+  CWorkItem work(job, id, priority, callback);
+  {
+    CJobLane &lane = m_lanes[GetAddLane()];
+    CSingleLock laneLock(lane.m_section);
+    lane.m_jobQueue[priority].push_back(work);
+    ++m_queuedCount[priority];
+  }
 
   StartWorkers(priority);
   return work.m_id;
 }
 
-void CJobManager::CancelJob(unsigned int jobID)
+unsigned int CJobManager::GetAddLane()
 {
-  CSingleLock lock(m_section);
+  // keep jobs spawned by a job on the lane of the worker running it
+  CJobWorker *worker = dynamic_cast<CJobWorker*>(CThread::GetCurrentThread());
+  if (worker)
+    return worker->GetLane();
+  return m_nextLane++ % MAX_WORKERS;
+}
 
-  // check whether we have this job in the queue
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
+void CJobManager::CancelJob(unsigned int jobID)
+{
+  for (unsigned int lane = 0; lane < MAX_WORKERS; ++lane)
   {
-    JobQueue::iterator i = find(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), jobID);
-    if (i != m_jobQueue[priority].end())
+    CSingleLock lock(m_lanes[lane].m_section);
+
+    // check whether we have this job in the queue
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
     {
-      delete i->m_job;
-      m_jobQueue[priority].erase(i);
+      JobQueue &queue = m_lanes[lane].m_jobQueue[priority];
+      JobQueue::iterator i = find(queue.begin(), queue.end(), jobID);
+      if (i != queue.end())
+      {
+        delete i->m_job;
+        queue.erase(i);
+        --m_queuedCount[priority];
+        return;
+      }
+    }
+    // or if we're processing it
+    Processing::iterator it = find(m_lanes[lane].m_processing.begin(), m_lanes[lane].m_processing.end(), jobID);
+    if (it != m_lanes[lane].m_processing.end())
+    {
+      it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
       return;
     }
   }
-  // or if we're processing it
-  Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
-  if (it != m_processing.end())
-    it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
 }
 
 void CJobManager::StartWorkers(CJob::PRIORITY priority)
@@ -267,67 +302,109 @@ void CJobManager::StartWorkers(CJob::PRIORITY priority)
   CSingleLock lock(m_section);
 
   // check how many free threads we have
-  if (m_processing.size() >= GetMaxWorkers(priority))
+  if (m_processingCount >= GetMaxWorkers(priority))
     return;
 
-  // do we have any sleeping threads?
-  if (m_processing.size() < m_workers.size())
+  // do we have any sleeping threads? A worker that was just started or woken
+  // may not have taken its job yet, so only count those that aren't spoken for
+  if (m_processingCount + GetRunnableCount() <= m_workers.size() || m_workers.size() >= MAX_WORKERS)
   {
     m_jobEvent.Set();
     return;
   }
 
   // everyone is busy - we need more workers
-  m_workers.push_back(new CJobWorker(this));
+  m_workers.push_back(new CJobWorker(this, m_nextLane++ % MAX_WORKERS));
 }
 
-CJob *CJobManager::PopJob()
+unsigned int CJobManager::GetRunnableCount() const
+{
+  unsigned int runnable = 0;
+  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
+  {
+    if (priority != CJob::PRIORITY_LOW_PAUSABLE || !m_pauseJobs)
+      runnable += m_queuedCount[priority];
+  }
+  return runnable;
+}
+
+bool CJobManager::ReserveWorker(CJob::PRIORITY priority)
+{
+  unsigned int processing = m_processingCount;
+  while (processing < GetMaxWorkers(priority))
+  {
+    if (m_processingCount.compare_exchange_weak(processing, processing + 1))
+      return true;
+  }
+  return false;
+}
+
+CJob *CJobManager::PopJob(const CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
   for (int priority = CJob::PRIORITY_HIGH; priority >= CJob::PRIORITY_LOW_PAUSABLE; --priority)
   {
     // Check whether we're pausing pausable jobs
     if (priority == CJob::PRIORITY_LOW_PAUSABLE && m_pauseJobs)
       continue;
 
-    if (m_jobQueue[priority].size() && m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
+    if (!m_queuedCount[priority] || !ReserveWorker(CJob::PRIORITY(priority)))
+      continue;
+
+    // start with our own lane, then steal from the others
+    for (unsigned int i = 0; i < MAX_WORKERS; ++i)
     {
-      // pop the job off the queue
-      CWorkItem job = m_jobQueue[priority].front();
-      m_jobQueue[priority].pop_front();
-
-      // add to the processing vector
-      m_processing.push_back(job);
-      job.m_job->m_callback = this;
-      return job.m_job;
+      CJobLane &lane = m_lanes[(worker->GetLane() + i) % MAX_WORKERS];
+      CSingleLock lock(lane.m_section);
+      JobQueue &queue = lane.m_jobQueue[priority];
+      if (queue.size())
+      {
+        // pop the job off the queue
+        CWorkItem job = queue.front();
+        queue.pop_front();
+        --m_queuedCount[priority];
+
+        // add to the processing vector
+        lane.m_processing.push_back(job);
+        job.m_job->m_callback = this;
+
+        // the event only wakes one worker, pass it on while there's more to do
+        if (GetRunnableCount())
+          m_jobEvent.Set();
+        return job.m_job;
+      }
     }
+
+    // another worker got there first. Wake a worker in case a job was added
+    // while we held the slot and StartWorkers() thought we were all busy
+    --m_processingCount;
+    m_jobEvent.Set();
   }
   return NULL;
 }
 
 void CJobManager::PauseJobs()
 {
-  CSingleLock lock(m_section);
   m_pauseJobs = true;
 }
 
 void CJobManager::UnPauseJobs()
 {
-  CSingleLock lock(m_section);
   m_pauseJobs = false;
 }
 
 bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
 {
-  CSingleLock lock(m_section);
-
   if (m_pauseJobs)
     return false;
 
-  for(Processing::const_iterator it = m_processing.begin(); it < m_processing.end(); ++it)
+  for (unsigned int lane = 0; lane < MAX_WORKERS; ++lane)
   {
-    if (priority == it->m_priority)
-      return true;
+    CSingleLock lock(m_lanes[lane].m_section);
+    for(Processing::const_iterator it = m_lanes[lane].m_processing.begin(); it < m_lanes[lane].m_processing.end(); ++it)
+    {
+      if (priority == it->m_priority)
+        return true;
+    }
   }
   return false;
 }
@@ -335,38 +412,38 @@ bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
 int CJobManager::IsProcessing(const std::string &type) const
 {
   int jobsMatched = 0;
-  CSingleLock lock(m_section);
 
   if (m_pauseJobs)
     return 0;
 
-  for(Processing::const_iterator it = m_processing.begin(); it < m_processing.end(); ++it)
+  for (unsigned int lane = 0; lane < MAX_WORKERS; ++lane)
   {
-    if (type == std::string(it->m_job->GetType()))
-      jobsMatched++;
+    CSingleLock lock(m_lanes[lane].m_section);
+    for(Processing::const_iterator it = m_lanes[lane].m_processing.begin(); it < m_lanes[lane].m_processing.end(); ++it)
+    {
+      if (type == std::string(it->m_job->GetType()))
+        jobsMatched++;
+    }
   }
   return jobsMatched;
 }
 
 CJob *CJobManager::GetNextJob(const CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
   while (m_running)
   {
     // grab a job off the queue if we have one
-    CJob *job = PopJob();
+    CJob *job = PopJob(worker);
     if (job)
       return job;
     // no jobs are left - sleep for 30 seconds to allow new jobs to come in
-    lock.Leave();
-    bool newJob = m_jobEvent.WaitMSec(30000);
-    lock.Enter();
-    if (!newJob)
+    if (!m_jobEvent.WaitMSec(30000))
       break;
   }
-  // ensure no jobs have come in during the period after
-  // timeout and before we held the lock
-  CJob *job = PopJob();
+  // ensure no jobs have come in during the period after timeout. Holding the
+  // worker lock here means StartWorkers either sees us gone or we see its job.
+  CSingleLock lock(m_section);
+  CJob *job = PopJob(worker);
   if (job)
     return job;
   // have no jobs
@@ -376,17 +453,21 @@ CJob *CJobManager::GetNextJob(const CJobWorker *worker)
 
 bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob *job) const
 {
-  CSingleLock lock(m_section);
   // find the job in the processing queue, and check whether it's cancelled (no callback)
-  Processing::const_iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  for (unsigned int lane = 0; lane < MAX_WORKERS; ++lane)
   {
-    CWorkItem item(*i);
-    lock.Leave(); // leave section prior to call
-    if (item.m_callback)
+    CSingleLock lock(m_lanes[lane].m_section);
+    Processing::const_iterator i = find(m_lanes[lane].m_processing.begin(), m_lanes[lane].m_processing.end(), job);
+    if (i != m_lanes[lane].m_processing.end())
     {
-      item.m_callback->OnJobProgress(item.m_id, progress, total, job);
-      return false;
+      CWorkItem item(*i);
+      lock.Leave(); // leave section prior to call
+      if (item.m_callback)
+      {
+        item.m_callback->OnJobProgress(item.m_id, progress, total, job);
+        return false;
+      }
+      return true;
     }
   }
   return true; // couldn't find the job, or it's been cancelled
@@ -394,29 +475,35 @@ bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const
 
 void CJobManager::OnJobComplete(bool success, CJob *job)
 {
-  CSingleLock lock(m_section);
-  // remove the job from the processing queue
-  Processing::iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  for (unsigned int lane = 0; lane < MAX_WORKERS; ++lane)
   {
-    // tell any listeners we're done with the job, then delete it
-    CWorkItem item(*i);
-    lock.Leave();
-    try
-    {
-      if (item.m_callback)
-        item.m_callback->OnJobComplete(item.m_id, success, item.m_job);
-    }
-    catch (...)
+    CSingleLock lock(m_lanes[lane].m_section);
+    Processing &processing = m_lanes[lane].m_processing;
+    // remove the job from the processing queue
+    Processing::iterator i = find(processing.begin(), processing.end(), job);
+    if (i != processing.end())
     {
-      CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item.m_job->GetType());
+      // tell any listeners we're done with the job, then delete it
+      CWorkItem item(*i);
+      lock.Leave();
+      try
+      {
+        if (item.m_callback)
+          item.m_callback->OnJobComplete(item.m_id, success, item.m_job);
+      }
+      catch (...)
+      {
+        CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item.m_job->GetType());
+      }
+      lock.Enter();
+      Processing::iterator j = find(processing.begin(), processing.end(), job);
+      if (j != processing.end())
+        processing.erase(j);
+      lock.Leave();
+      --m_processingCount;
+      item.FreeJob();
+      return;
     }
-    lock.Enter();
-    Processing::iterator j = find(m_processing.begin(), m_processing.end(), job);
-    if (j != m_processing.end())
-      m_processing.erase(j);
-    lock.Leave();
-    item.FreeJob();
   }
 }
 
@@ -431,6 +518,5 @@ void CJobManager::RemoveWorker(const CJobWorker *worker)
 
 unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority)
 {
-  static const unsigned int max_workers = 5;
-  return max_workers - (CJob::PRIORITY_HIGH - priority);
+  return MAX_WORKERS - (CJob::PRIORITY_HIGH - priority);
 }
@@ -19,6 +19,7 @@
  *
  */
 
+#include <atomic>
 #include <queue>
 #include <vector>
 #include <string>
@@ -31,12 +32,19 @@ class CJobManager;
 class CJobWorker : public CThread
 {
 public:
-  CJobWorker(CJobManager *manager);
+  CJobWorker(CJobManager *manager, unsigned int lane);
   virtual ~CJobWorker();
 
   void Process();
+
+  /*!
+   \brief The job lane this worker prefers to take work from and to which jobs added from
+   this worker are queued.
+   */
+  unsigned int GetLane() const { return m_lane; };
 private:
   CJobManager  *m_jobManager;
+  unsigned int  m_lane;
 };
 
 /*!
@@ -170,6 +178,12 @@ private:
  priority levels.  Lower priority jobs are executed only if there are sufficient
  spare worker threads free to allow for higher priority jobs that may arise.
 
+ Queued jobs are spread over a fixed number of lanes, each with its own lock and
+ one queue per priority.  Every worker prefers its own lane and steals the oldest
+ job of the highest available priority from the other lanes when its own is empty,
+ so workers and producers rarely contend on the same lock.  Jobs added from within
+ a job are queued on the lane of the worker running it.
+
  \sa CJob and IJobCallback
  */
 class CJobManager
@@ -207,6 +221,22 @@ class CJobManager
     CJob::PRIORITY m_priority;
   };
 
+  typedef std::deque<CWorkItem>    JobQueue;
+  typedef std::vector<CWorkItem>   Processing;
+  typedef std::vector<CJobWorker*> Workers;
+
+  /*!
+   \brief A lane of queued and processing jobs, guarded by its own critical section.
+   A job that is picked up by a worker stays in the processing list of the lane it was queued on.
+   */
+  class CJobLane
+  {
+  public:
+    JobQueue   m_jobQueue[CJob::PRIORITY_HIGH+1];
+    Processing m_processing;
+    CCriticalSection m_section;
+  };
+
   template<typename F>
   class CLambdaJob : public CJob
   {
@@ -335,27 +365,43 @@ private:
   CJobManager const& operator=(CJobManager const&);
   virtual ~CJobManager();
 
-  /*! \brief Pop a job off the job queue and add to the processing queue ready to process
+  /*! \brief Pop a job off the job queues and add to the processing queue ready to process
+   The worker's own lane is tried first, after which jobs are stolen from the other lanes.
+   \param worker the worker requesting the job.
    \return the job to process, NULL if no jobs are available
    */
-  CJob *PopJob();
+  CJob *PopJob(const CJobWorker *worker);
+
+  /*! \brief Reserve a processing slot for a job of the given priority
+   \return true if fewer than GetMaxWorkers(priority) jobs are processing, false otherwise
+   */
+  bool ReserveWorker(CJob::PRIORITY priority);
+
+  /*! \brief Choose the lane a new job is queued on
+   Jobs added from a job worker go to the lane of that worker, others are distributed round robin.
+   */
+  unsigned int GetAddLane();
 
   void StartWorkers(CJob::PRIORITY priority);
+
+  /*! \brief Number of queued jobs a worker could pick up right now, pausable ones don't count while paused
+   */
+  unsigned int GetRunnableCount() const;
   void RemoveWorker(const CJobWorker *worker);
   static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
 
-  unsigned int m_jobCounter;
+  static const unsigned int MAX_WORKERS = 5;
 
-  typedef std::deque<CWorkItem>    JobQueue;
-  typedef std::vector<CWorkItem>   Processing;
-  typedef std::vector<CJobWorker*> Workers;
+  std::atomic<unsigned int> m_jobCounter;
+  std::atomic<unsigned int> m_nextLane;
+  std::atomic<unsigned int> m_processingCount;
+  std::atomic<unsigned int> m_queuedCount[CJob::PRIORITY_HIGH+1];
 
-  JobQueue   m_jobQueue[CJob::PRIORITY_HIGH+1];
-  bool       m_pauseJobs;
-  Processing m_processing;
+  CJobLane   m_lanes[MAX_WORKERS];
+  std::atomic<bool> m_pauseJobs;
   Workers    m_workers;
 
-  CCriticalSection m_section;
-  CEvent           m_jobEvent;
-  bool             m_running;
+  CCriticalSection  m_section; //!< guards the list of workers and m_running
+  CEvent            m_jobEvent;
+  std::atomic<bool> m_running;
 };
@@ -0,0 +1,199 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "utils/ActorProtocol.h"
+#include "threads/Event.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+using namespace Actor;
+
+namespace
+{
+struct LargePayload
+{
+  uint8_t bytes[MSG_INTERNAL_BUFFER_SIZE * 4];
+};
+}
+
+TEST(TestActorProtocol, OrderAndPayload)
+{
+  CEvent inEvent, outEvent;
+  Protocol port("test", &inEvent, &outEvent);
+
+  LargePayload large;
+  for (unsigned int i = 0; i < sizeof(large.bytes); i++)
+    large.bytes[i] = i;
+  int small = 42;
+
+  port.SendOutMessage(1, &small, sizeof(small));
+  port.SendOutMessage(2, &large, sizeof(large));
+  port.SendOutMessage(3);
+  EXPECT_TRUE(outEvent.WaitMSec(0));
+
+  Message *msg = NULL;
+  ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+  EXPECT_EQ(1, msg->signal);
+  EXPECT_EQ(42, *(int*)msg->data);
+  msg->Release();
+
+  ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+  EXPECT_EQ(2, msg->signal);
+  EXPECT_EQ((int)sizeof(large), msg->payloadSize);
+  EXPECT_EQ(0, memcmp(large.bytes, msg->data, sizeof(large)));
+  msg->Release();
+
+  ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+  EXPECT_EQ(3, msg->signal);
+  EXPECT_EQ(NULL, msg->data);
+  msg->Release();
+
+  EXPECT_FALSE(port.ReceiveOutMessage(&msg));
+}
+
+TEST(TestActorProtocol, DeferAndPurge)
+{
+  CEvent inEvent, outEvent;
+  Protocol port("test", &inEvent, &outEvent);
+  Message *msg = NULL;
+
+  port.SendInMessage(1);
+  port.SendInMessage(2);
+  port.SendInMessage(1);
+  port.SendInMessage(3);
+
+  port.DeferIn(true);
+  EXPECT_FALSE(port.ReceiveInMessage(&msg));
+  port.DeferIn(false);
+
+  port.PurgeIn(1);
+  ASSERT_TRUE(port.ReceiveInMessage(&msg));
+  EXPECT_EQ(2, msg->signal);
+  msg->Release();
+  ASSERT_TRUE(port.ReceiveInMessage(&msg));
+  EXPECT_EQ(3, msg->signal);
+  msg->Release();
+  EXPECT_FALSE(port.ReceiveInMessage(&msg));
+
+  port.SendOutMessage(1);
+  port.SendInMessage(1);
+  port.Purge();
+  EXPECT_FALSE(port.ReceiveOutMessage(&msg));
+  EXPECT_FALSE(port.ReceiveInMessage(&msg));
+}
+
+TEST(TestActorProtocol, SyncReply)
+{
+  CEvent inEvent, outEvent;
+  Protocol port("test", &inEvent, &outEvent);
+
+  for (int i = 0; i < 3; i++)
+  {
+    std::thread actor([&port, &outEvent, i]() {
+      Message *msg = NULL;
+      while (!port.ReceiveOutMessage(&msg))
+        outEvent.WaitMSec(100);
+      int reply = *(int*)msg->data + 1;
+      msg->Reply(10 + i, &reply, sizeof(reply));
+      msg->Release();
+    });
+
+    Message *reply = NULL;
+    int value = i;
+    EXPECT_TRUE(port.SendOutMessageSync(1, &reply, 1000, &value, sizeof(value)));
+    actor.join();
+    ASSERT_TRUE(reply != NULL);
+    EXPECT_EQ(10 + i, reply->signal);
+    EXPECT_EQ(i + 1, *(int*)reply->data);
+    reply->Release();
+  }
+
+  // the message and its event are reused for the next calls
+  EXPECT_LE(port.GetAllocations(), 3u);
+}
+
+TEST(TestActorProtocol, PoolIsBounded)
+{
+  CEvent inEvent, outEvent;
+  Protocol port("test", &inEvent, &outEvent);
+  Message *msg = NULL;
+
+  for (int i = 0; i < MSG_POOL_SIZE * 2; i++)
+    port.SendOutMessage(1);
+  EXPECT_EQ((unsigned int)MSG_POOL_SIZE * 2, port.GetAllocations());
+  while (port.ReceiveOutMessage(&msg))
+    msg->Release();
+
+  // only MSG_POOL_SIZE messages were kept
+  for (int i = 0; i < MSG_POOL_SIZE * 2; i++)
+    port.SendOutMessage(1);
+  EXPECT_EQ((unsigned int)MSG_POOL_SIZE * 3, port.GetAllocations());
+  port.Purge();
+}
+
+/* Benchmark, run with --gtest_also_run_disabled_tests */
+TEST(TestActorProtocol, DISABLED_Benchmark)
+{
+  static const int messages = 200000;
+  CEvent inEvent, outEvent;
+  Protocol port("benchmark", &inEvent, &outEvent);
+  LargePayload large;
+  memset(&large, 0, sizeof(large));
+
+  // a sender and an actor thread, half of the messages carry a payload larger than the inline buffer
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::atomic<int> consumed(0);
+  std::thread sender([&port, &consumed, &large]() {
+    int small = 0;
+    for (int i = 0; i < messages; ++i)
+    {
+      while (i - consumed > MSG_POOL_SIZE / 2)
+        std::this_thread::yield();
+      if (i & 1)
+        port.SendOutMessage(1, &large, sizeof(large));
+      else
+        port.SendOutMessage(2, &small, sizeof(small));
+    }
+  });
+  while (consumed < messages)
+  {
+    Message *msg = NULL;
+    if (port.ReceiveOutMessage(&msg))
+    {
+      msg->Release();
+      consumed++;
+    }
+    else
+      outEvent.WaitMSec(100);
+  }
+  sender.join();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  double allocationsPerMessage = (double)port.GetAllocations() / messages;
+  std::cout << "actor protocol: " << static_cast<int>(messages / elapsed.count()) << " msgs/sec, "
+            << allocationsPerMessage << " allocations/msg" << std::endl;
+  EXPECT_LT(allocationsPerMessage, 0.01);
+}
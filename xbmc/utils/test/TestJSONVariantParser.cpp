@@ -32,3 +32,42 @@ TEST(TestJSONVariantParser, Parse)
   variant = CJSONVariantParser::Parse(buf, sizeof(buf));
   EXPECT_TRUE(variant.isNull());
 }
+
+TEST(TestJSONVariantParser, ParseInPlace)
+{
+  std::string json = "{\"jsonrpc\": \"2.0\", \"method\": \"VideoLibrary.GetMovies\", \"id\": 1,"
+                     " \"params\": {\"properties\": [\"title\", \"year\"], \"limits\": {\"start\": 0, \"end\": 25},"
+                     " \"sort\": {\"ignorearticle\": true, \"method\": \"label\"}, \"filter\": null, \"rating\": 7.5}}";
+  CVariant variant;
+  EXPECT_TRUE(CJSONVariantParser::Parse(json.c_str(), json.size(), variant));
+  ASSERT_TRUE(variant.isObject());
+  EXPECT_STREQ("2.0", variant["jsonrpc"].asString().c_str());
+  EXPECT_STREQ("VideoLibrary.GetMovies", variant["method"].asString().c_str());
+  EXPECT_EQ(1, variant["id"].asInteger());
+
+  const CVariant &params = variant["params"];
+  ASSERT_TRUE(params["properties"].isArray());
+  ASSERT_EQ(2U, params["properties"].size());
+  EXPECT_STREQ("year", params["properties"][1].asString().c_str());
+  EXPECT_EQ(25, params["limits"]["end"].asInteger());
+  EXPECT_TRUE(params["sort"]["ignorearticle"].asBoolean());
+  EXPECT_TRUE(params["filter"].isNull());
+  EXPECT_FLOAT_EQ(7.5f, params["rating"].asFloat());
+
+  CVariant copy = CJSONVariantParser::Parse(reinterpret_cast<const unsigned char *>(json.c_str()), json.size());
+  EXPECT_TRUE(variant["params"]["properties"] == copy["params"]["properties"]);
+  EXPECT_TRUE(variant["params"]["sort"] == copy["params"]["sort"]);
+  EXPECT_TRUE(copy["params"]["filter"].isNull());
+}
+
+TEST(TestJSONVariantParser, ParseIncomplete)
+{
+  std::string json = "{\"jsonrpc\": \"2.0\", \"method\": [1, 2";
+  CVariant variant("previous");
+  EXPECT_FALSE(CJSONVariantParser::Parse(json.c_str(), json.size(), variant));
+  EXPECT_TRUE(variant.isNull());
+
+  json = "42";
+  EXPECT_TRUE(CJSONVariantParser::Parse(json.c_str(), json.size(), variant));
+  EXPECT_EQ(42, variant.asInteger());
+}
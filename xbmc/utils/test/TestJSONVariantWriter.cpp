@@ -31,3 +31,67 @@ TEST(TestJSONVariantWriter, Write)
   str = CJSONVariantWriter::Write(variant, false);
   EXPECT_STREQ("null\n", str.c_str());
 }
+
+namespace
+{
+CVariant CreateResponse(int items)
+{
+  CVariant response(CVariant::VariantTypeObject);
+  response["id"] = 1;
+  response["jsonrpc"] = "2.0";
+  CVariant &movies = response["result"]["movies"];
+  movies = CVariant(CVariant::VariantTypeArray);
+  for (int i = 0; i < items; i++)
+  {
+    CVariant movie(CVariant::VariantTypeObject);
+    movie["movieid"] = i;
+    movie["label"] = "Movie \"" + std::to_string(i) + "\"";
+    movie["rating"] = 7.5;
+    movie["watched"] = (i % 2) == 0;
+    movie["genre"].push_back("Drama");
+    movie["genre"].push_back("Comedy");
+    movie["art"] = CVariant(CVariant::VariantTypeObject);
+    movie["tag"] = CVariant(CVariant::VariantTypeArray);
+    movies.push_back(movie);
+  }
+  response["result"]["limits"]["total"] = items;
+  return response;
+}
+
+std::string ReadAll(CJSONVariantStreamWriter &writer, size_t chunkSize)
+{
+  std::string output;
+  std::vector<char> buffer(chunkSize);
+  while (!writer.IsEnd())
+  {
+    size_t read = writer.Read(buffer.data(), buffer.size());
+    EXPECT_TRUE(read == buffer.size() || writer.IsEnd());
+    output.append(buffer.data(), read);
+  }
+  return output;
+}
+}
+
+TEST(TestJSONVariantWriter, StreamMatchesWrite)
+{
+  CVariant response = CreateResponse(200);
+
+  for (int compact = 0; compact < 2; compact++)
+  {
+    std::string expected = CJSONVariantWriter::Write(response, compact != 0);
+    for (size_t chunkSize : { 1, 7, 1024, 1024 * 1024 })
+    {
+      CJSONVariantStreamWriter writer(response, compact != 0);
+      EXPECT_EQ(expected, ReadAll(writer, chunkSize));
+      EXPECT_FALSE(writer.HasFailed());
+      EXPECT_EQ(0U, writer.Read(NULL, 0));
+    }
+  }
+}
+
+TEST(TestJSONVariantWriter, StreamScalar)
+{
+  CVariant value("text");
+  CJSONVariantStreamWriter writer(value, true);
+  EXPECT_EQ(CJSONVariantWriter::Write(value, true), ReadAll(writer, 3));
+}
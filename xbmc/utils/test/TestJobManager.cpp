@@ -22,6 +22,12 @@
 #include "settings/Settings.h"
 #include "utils/SystemInfo.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 /* CSysInfoJob::GetInternetState() will test for network connectivity. */
@@ -177,3 +183,99 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+namespace
+{
+class TimedJob : public CJob
+{
+public:
+  TimedJob(std::chrono::steady_clock::time_point queued, std::vector<double> &latencies, unsigned int slot) :
+    m_queued(queued),
+    m_latencies(latencies),
+    m_slot(slot)
+  {
+  }
+
+  bool DoWork()
+  {
+    std::chrono::duration<double, std::micro> latency = std::chrono::steady_clock::now() - m_queued;
+    m_latencies[m_slot] = latency.count();
+    return true;
+  }
+
+private:
+  std::chrono::steady_clock::time_point m_queued;
+  std::vector<double> &m_latencies;
+  unsigned int m_slot;
+};
+
+/* Keeps a fixed number of jobs in flight, adding the next job from the
+ * completion callback much like CJobQueue does. */
+class ThroughputRunner : public IJobCallback
+{
+public:
+  ThroughputRunner(unsigned int jobs, unsigned int inFlight) :
+    m_latencies(jobs),
+    m_jobs(jobs),
+    m_inFlight(inFlight),
+    m_added(0),
+    m_completed(0)
+  {
+  }
+
+  double Run()
+  {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < m_inFlight; ++i)
+      AddNext();
+    m_done.Wait();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return m_jobs / elapsed.count();
+  }
+
+  double Percentile(double percentile)
+  {
+    std::sort(m_latencies.begin(), m_latencies.end());
+    return m_latencies[static_cast<size_t>(percentile * (m_latencies.size() - 1))];
+  }
+
+  void OnJobComplete(unsigned int jobID, bool success, CJob *job)
+  {
+    if (++m_completed == m_jobs)
+      m_done.Set();
+    else
+      AddNext();
+  }
+
+private:
+  void AddNext()
+  {
+    unsigned int slot = m_added++;
+    if (slot < m_jobs)
+      CJobManager::GetInstance().AddJob(new TimedJob(std::chrono::steady_clock::now(), m_latencies, slot), this, CJob::PRIORITY_HIGH);
+  }
+
+  std::vector<double> m_latencies;
+  unsigned int m_jobs;
+  unsigned int m_inFlight;
+  std::atomic<unsigned int> m_added;
+  std::atomic<unsigned int> m_completed;
+  CEvent m_done;
+};
+}
+
+/* Benchmark, run with --gtest_also_run_disabled_tests */
+TEST_F(TestJobManager, DISABLED_Throughput)
+{
+  static const unsigned int jobs = 20000;
+  // PRIORITY_HIGH jobs may use up to 5 workers
+  for (unsigned int workers = 1; workers <= 5; ++workers)
+  {
+    ThroughputRunner runner(jobs, workers);
+    double jobsPerSec = runner.Run();
+    std::cout << workers << " worker(s): " << static_cast<unsigned int>(jobsPerSec) << " jobs/sec, latency p50 "
+              << runner.Percentile(0.5) << "us p99 " << runner.Percentile(0.99) << "us p99.9 "
+              << runner.Percentile(0.999) << "us" << std::endl;
+    EXPECT_GT(jobsPerSec, 0);
+  }
+}
@@ -507,8 +507,8 @@ int CVideoDatabase::GetPathId(const std::string& strPath)
 
     URIUtils::AddSlashAtEnd(strPath1);
 
-    strSQL=PrepareSQL("select idPath from path where strPath='%s'",strPath1.c_str());
-    m_pDS->query(strSQL);
+    strSQL = "select idPath from path where strPath=?";
+    m_pDS->query(strSQL, { strPath1.c_str() });
     if (!m_pDS->eof())
       idPath = m_pDS->fv("path.idPath").get_asInt();
 
@@ -1039,9 +1039,7 @@ int CVideoDatabase::GetFileId(const std::string& strFilenameAndPath)
     int idPath = GetPathId(strPath);
     if (idPath >= 0)
     {
-      std::string strSQL;
-      strSQL=PrepareSQL("select idFile from files where strFileName='%s' and idPath=%i", strFileName.c_str(),idPath);
-      m_pDS->query(strSQL);
+      m_pDS->query("select idFile from files where strFileName=? and idPath=?", { strFileName.c_str(), idPath });
       if (m_pDS->num_rows() > 0)
       {
         int idFile = m_pDS->fv("files.idFile").get_asInt();
@@ -3890,19 +3888,19 @@ void CVideoDatabase::GetCast(int media_id, const std::string &media_type, std::v
     if (!m_pDB.get()) return;
     if (!m_pDS2.get()) return;
 
-    std::string sql = PrepareSQL("SELECT actor.name,"
-                                 "  actor_link.role,"
-                                 "  actor_link.cast_order,"
-                                 "  actor.art_urls,"
-                                 "  art.url "
-                                 "FROM actor_link"
-                                 "  JOIN actor ON"
-                                 "    actor_link.actor_id=actor.actor_id"
-                                 "  LEFT JOIN art ON"
-                                 "    art.media_id=actor.actor_id AND art.media_type='actor' AND art.type='thumb' "
-                                 "WHERE actor_link.media_id=%i AND actor_link.media_type='%s'"
-                                 "ORDER BY actor_link.cast_order", media_id, media_type.c_str());
-    m_pDS2->query(sql);
+    std::string sql = "SELECT actor.name,"
+                      "  actor_link.role,"
+                      "  actor_link.cast_order,"
+                      "  actor.art_urls,"
+                      "  art.url "
+                      "FROM actor_link"
+                      "  JOIN actor ON"
+                      "    actor_link.actor_id=actor.actor_id"
+                      "  LEFT JOIN art ON"
+                      "    art.media_id=actor.actor_id AND art.media_type='actor' AND art.type='thumb' "
+                      "WHERE actor_link.media_id=? AND actor_link.media_type=? "
+                      "ORDER BY actor_link.cast_order";
+    m_pDS2->query(sql, { media_id, media_type.c_str() });
     while (!m_pDS2->eof())
     {
       SActorInfo info;
@@ -4148,8 +4146,7 @@ bool CVideoDatabase::GetArtForItem(int mediaId, const MediaType &mediaType, std:
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS2.get()) return false; // using dataset 2 as we're likely called in loops on dataset 1
 
-    std::string sql = PrepareSQL("SELECT type,url FROM art WHERE media_id=%i AND media_type='%s'", mediaId, mediaType.c_str());
-    m_pDS2->query(sql);
+    m_pDS2->query("SELECT type,url FROM art WHERE media_id=? AND media_type=?", { mediaId, mediaType.c_str() });
     while (!m_pDS2->eof())
     {
       art.insert(make_pair(m_pDS2->fv(0).get_asString(), m_pDS2->fv(1).get_asString()));
@@ -20,6 +20,7 @@
 
 #include "VideoInfoScanner.h"
 
+#include <atomic>
 #include <utility>
 
 #include "dialogs/GUIDialogExtendedProgressBar.h"
@@ -43,9 +44,12 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "TextureCache.h"
+#include "threads/Event.h"
 #include "threads/SystemClock.h"
 #include "URL.h"
 #include "Util.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/md5.h"
 #include "utils/RegExp.h"
@@ -62,8 +66,61 @@ using namespace KODI::MESSAGING;
 
 using KODI::MESSAGING::HELPERS::DialogResponse;
 
+// number of path hashes written to the database in one transaction
+#define PATH_HASH_BATCH 50
+
 namespace VIDEO
 {
+  /*! \brief State of a folder, as needed by DoScan()
+   The database fields are filled in on the scanner thread, the hashes and
+   listing possibly ahead of time on a job worker. Whoever claims the folder
+   first reads it, so the scanner doesn't wait for a job that hasn't started.
+   */
+  struct CVideoInfoScanner::SScanFolder
+  {
+    SScanFolder() : scan(false), foundDirectly(false), haveDbHash(false), listed(false), read(true), claimed(false) {}
+
+    bool Claim() { return !claimed.exchange(true); }
+
+    std::string directory;
+    bool scan;
+    ADDON::ScraperPtr info;
+    CONTENT_TYPE content;
+    SScanSettings settings;
+    bool foundDirectly;
+    std::vector<std::string> regexps;
+    bool haveDbHash;
+    std::string dbHash;
+
+    std::string fastHash;
+    std::string hash;
+    CFileItemList items;
+    bool listed;
+    CEvent read;
+    std::atomic<bool> claimed;
+  };
+
+  class CVideoInfoScanner::CFolderReadJob : public CJob
+  {
+  public:
+    CFolderReadJob(const ScanFolderPtr &folder) : m_folder(folder) {}
+
+    virtual bool DoWork()
+    {
+      // the scanner may have read it itself in the meantime
+      if (m_folder->Claim())
+      {
+        ReadFolder(*m_folder);
+        m_folder->read.Set();
+      }
+      return true;
+    }
+
+    virtual const char *GetType() const { return "videofolderread"; }
+
+  private:
+    ScanFolderPtr m_folder;
+  };
 
   CVideoInfoScanner::CVideoInfoScanner()
   {
@@ -76,6 +133,9 @@ namespace VIDEO
     m_itemCount = 0;
     m_bClean = false;
     m_scanAll = false;
+    m_foldersScanned = 0;
+    m_foldersUnchanged = 0;
+    m_foldersReadAhead = 0;
   }
 
   CVideoInfoScanner::~CVideoInfoScanner()
@@ -123,6 +183,13 @@ namespace VIDEO
       // Reset progress vars
       m_currentItem = 0;
       m_itemCount = -1;
+      m_foldersScanned = 0;
+      m_foldersUnchanged = 0;
+      m_foldersReadAhead = 0;
+      m_pendingHashes.clear();
+
+      // read the listings of the first folders while we're busy with the others
+      QueueReadAhead(std::vector<std::string>(m_pathsToScan.begin(), m_pathsToScan.end()), false, true);
 
       // Database operations should not be canceled
       // using Interupt() while scanning as it could
@@ -148,11 +215,17 @@ namespace VIDEO
            */
           CLog::Log(LOGWARNING, "%s directory '%s' does not exist - skipping scan%s.", __FUNCTION__, CURL::GetRedacted(directory).c_str(), m_bClean ? " and clean" : "");
           m_pathsToScan.erase(m_pathsToScan.begin());
+          TakeReadAhead(directory);
         }
         else if (!DoScan(directory))
           bCancelled = true;
       }
 
+      // anything still being read is for folders we're not going to scan
+      m_readAheadQueue.clear();
+      m_readAhead.clear();
+      FlushPathHashes();
+
       if (!bCancelled)
       {
         if (m_bClean)
@@ -170,6 +243,8 @@ namespace VIDEO
 
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "VideoInfoScanner: Finished scan. Scanning for video info took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      CLog::Log(LOGNOTICE, "VideoInfoScanner: %u folders (%u unchanged, %u read ahead), %.1f folders/s",
+                m_foldersScanned, m_foldersUnchanged, m_foldersReadAhead, tick ? m_foldersScanned * 1000.0f / tick : 0.0f);
     }
     catch (...)
     {
@@ -252,27 +327,44 @@ namespace VIDEO
     if (it != m_pathsToScan.end())
       m_pathsToScan.erase(it);
 
-    // load subfolder
-    CFileItemList items;
-    bool foundDirectly = false;
-    bool bSkip = false;
+    ScanFolderPtr folder = TakeReadAhead(strDirectory);
+    if (folder)
+    {
+      // the read job waits for a LOW worker slot, which the scan itself competes
+      // for. Rather than wait on it, read here if no worker has started it yet.
+      if (folder->scan && folder->Claim())
+        ReadFolder(*folder);
+      else
+      {
+        while (folder->scan && !folder->read.WaitMSec(100))
+        {
+          if (m_bStop)
+            return false;
+        }
+        m_foldersReadAhead++;
+      }
+    }
+    else
+    {
+      folder = PrepareFolder(strDirectory);
+      if (folder->scan)
+        ReadFolder(*folder);
+    }
 
-    SScanSettings settings;
-    ScraperPtr info = m_database.GetScraperForPath(strDirectory, settings, foundDirectly);
-    CONTENT_TYPE content = info ? info->Content() : CONTENT_NONE;
+    if (!folder->scan)
+      return true;
 
-    // exclude folders that match our exclude regexps
-    const std::vector<std::string> &regexps = content == CONTENT_TVSHOWS ? g_advancedSettings.m_tvshowExcludeFromScanRegExps
-                                                         : g_advancedSettings.m_moviesExcludeFromScanRegExps;
+    m_foldersScanned++;
 
-    if (IsExcluded(strDirectory, regexps))
-      return true;
+    CFileItemList &items = folder->items;
+    bool bSkip = false;
 
-    bool ignoreFolder = !m_scanAll && settings.noupdate;
-    if (content == CONTENT_NONE || ignoreFolder)
-      return true;
+    const SScanSettings &settings = folder->settings;
+    ScraperPtr info = folder->info;
+    CONTENT_TYPE content = folder->content;
 
-    std::string hash, dbHash;
+    std::string hash = folder->hash;
+    std::string dbHash = folder->dbHash;
     if (content == CONTENT_MOVIES ||content == CONTENT_MUSICVIDEOS)
     {
       if (m_handle)
@@ -281,29 +373,9 @@ namespace VIDEO
         m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(str).c_str(), info->Name().c_str()));
       }
 
-      std::string fastHash;
-      if (g_advancedSettings.m_bVideoLibraryUseFastHash)
-        fastHash = GetFastHash(strDirectory, regexps);
-
-      if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.empty() && fastHash == dbHash)
-      { // fast hashes match - no need to process anything
-        hash = fastHash;
-      }
-      else
-      { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.m_videoExtensions);
-        items.Stack();
-
-        // check whether to re-use previously computed fast hash
-        if (!CanFastHash(items, regexps) || fastHash.empty())
-          GetPathHash(items, hash);
-        else
-          hash = fastHash;
-      }
-
       if (hash == dbHash)
       { // hash matches - skipping
-        CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' due to no change%s", CURL::GetRedacted(strDirectory).c_str(), !fastHash.empty() ? " (fasthash)" : "");
+        CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' due to no change%s", CURL::GetRedacted(strDirectory).c_str(), !folder->fastHash.empty() ? " (fasthash)" : "");
         bSkip = true;
       }
       else if (hash.empty())
@@ -327,13 +399,10 @@ namespace VIDEO
       if (m_handle)
         m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(20319).c_str(), info->Name().c_str()));
 
-      if (foundDirectly && !settings.parent_name_root)
+      if (folder->foundDirectly && !settings.parent_name_root)
       {
-        CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.m_videoExtensions);
-        items.SetPath(strDirectory);
-        GetPathHash(items, hash);
         bSkip = true;
-        if (!m_database.GetPathHash(strDirectory, dbHash) || dbHash != hash)
+        if (!folder->haveDbHash || dbHash != hash)
           bSkip = false;
         else
           items.Clear();
@@ -348,6 +417,9 @@ namespace VIDEO
       }
     }
 
+    if (bSkip)
+      m_foldersUnchanged++;
+
     if (!bSkip)
     {
       if (RetrieveVideoInfo(items, settings.parent_name_root, content))
@@ -369,30 +441,170 @@ namespace VIDEO
     }
     else if (hash != dbHash && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
     { // update the hash either way - we may have changed the hash to a fast version
-      m_database.SetPathHash(strDirectory, hash);
+      SetPathHash(strDirectory, hash);
     }
 
     if (m_handle)
       OnDirectoryScanned(strDirectory);
 
+    // if we have a directory item (non-playlist) we then recurse into that folder
+    // do not recurse for tv shows - we have already looked recursively for episodes
+    std::vector<std::string> subFolders;
     for (int i = 0; i < items.Size(); ++i)
     {
       CFileItemPtr pItem = items[i];
+      if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList() && settings.recurse > 0 && content != CONTENT_TVSHOWS)
+        subFolders.push_back(pItem->GetPath());
+    }
+    QueueReadAhead(subFolders, true, false);
 
+    for (std::vector<std::string>::const_iterator it = subFolders.begin(); it != subFolders.end(); ++it)
+    {
       if (m_bStop)
         break;
 
-      // if we have a directory item (non-playlist) we then recurse into that folder
-      // do not recurse for tv shows - we have already looked recursively for episodes
-      if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList() && settings.recurse > 0 && content != CONTENT_TVSHOWS)
+      if (!DoScan(*it))
+      {
+        m_bStop = true;
+      }
+    }
+    return !m_bStop;
+  }
+
+  CVideoInfoScanner::ScanFolderPtr CVideoInfoScanner::PrepareFolder(const std::string& strDirectory)
+  {
+    ScanFolderPtr folder(new SScanFolder);
+    folder->directory = strDirectory;
+
+    folder->info = m_database.GetScraperForPath(strDirectory, folder->settings, folder->foundDirectly);
+    folder->content = folder->info ? folder->info->Content() : CONTENT_NONE;
+
+    // exclude folders that match our exclude regexps
+    folder->regexps = folder->content == CONTENT_TVSHOWS ? g_advancedSettings.m_tvshowExcludeFromScanRegExps
+                                                         : g_advancedSettings.m_moviesExcludeFromScanRegExps;
+
+    if (IsExcluded(strDirectory, folder->regexps))
+      return folder;
+
+    bool ignoreFolder = !m_scanAll && folder->settings.noupdate;
+    if (folder->content == CONTENT_NONE || ignoreFolder)
+      return folder;
+
+    folder->scan = true;
+    folder->haveDbHash = m_database.GetPathHash(strDirectory, folder->dbHash);
+    return folder;
+  }
+
+  void CVideoInfoScanner::ReadFolder(SScanFolder &folder)
+  {
+    const std::string &strDirectory = folder.directory;
+    if (folder.content == CONTENT_MOVIES || folder.content == CONTENT_MUSICVIDEOS)
+    {
+      if (g_advancedSettings.m_bVideoLibraryUseFastHash)
+        folder.fastHash = GetFastHash(strDirectory, folder.regexps);
+
+      if (folder.haveDbHash && !folder.fastHash.empty() && folder.fastHash == folder.dbHash)
+      { // fast hashes match - no need to process anything
+        folder.hash = folder.fastHash;
+      }
+      else
+      { // need to fetch the folder
+        CDirectory::GetDirectory(strDirectory, folder.items, g_advancedSettings.m_videoExtensions);
+        folder.items.Stack();
+        folder.listed = true;
+
+        // check whether to re-use previously computed fast hash
+        if (!CanFastHash(folder.items, folder.regexps) || folder.fastHash.empty())
+          GetPathHash(folder.items, folder.hash);
+        else
+          folder.hash = folder.fastHash;
+      }
+    }
+    else if (folder.content == CONTENT_TVSHOWS && folder.foundDirectly && !folder.settings.parent_name_root)
+    {
+      CDirectory::GetDirectory(strDirectory, folder.items, g_advancedSettings.m_videoExtensions);
+      folder.items.SetPath(strDirectory);
+      GetPathHash(folder.items, folder.hash);
+      folder.listed = true;
+    }
+  }
+
+  void CVideoInfoScanner::QueueReadAhead(const std::vector<std::string> &directories, bool front, bool fromPathsToScan)
+  {
+    if (g_advancedSettings.m_iVideoScannerReadAhead <= 0)
+      return;
+
+    if (front)
+    {
+      for (std::vector<std::string>::const_reverse_iterator it = directories.rbegin(); it != directories.rend(); ++it)
+        m_readAheadQueue.push_front(std::make_pair(*it, fromPathsToScan));
+    }
+    else
+    {
+      for (std::vector<std::string>::const_iterator it = directories.begin(); it != directories.end(); ++it)
+        m_readAheadQueue.push_back(std::make_pair(*it, fromPathsToScan));
+    }
+    StartReadAhead();
+  }
+
+  void CVideoInfoScanner::StartReadAhead()
+  {
+    while (!m_bStop && !m_readAheadQueue.empty() &&
+           m_readAhead.size() < (size_t)g_advancedSettings.m_iVideoScannerReadAhead)
+    {
+      std::pair<std::string, bool> next = m_readAheadQueue.front();
+      m_readAheadQueue.pop_front();
+
+      // already read, or scanned via its parent in the meantime
+      if (m_readAhead.find(next.first) != m_readAhead.end() ||
+         (next.second && m_pathsToScan.find(next.first) == m_pathsToScan.end()))
+        continue;
+
+      ScanFolderPtr folder = PrepareFolder(next.first);
+      if (folder->scan)
       {
-        if (!DoScan(pItem->GetPath()))
+        CFolderReadJob *job = new CFolderReadJob(folder);
+        if (!CJobManager::GetInstance().AddJob(job, NULL, CJob::PRIORITY_LOW))
         {
-          m_bStop = true;
+          // not queued, DoScan() reads the folder when it gets there
+          delete job;
+          continue;
         }
       }
+      m_readAhead.insert(std::make_pair(next.first, folder));
     }
-    return !m_bStop;
+  }
+
+  CVideoInfoScanner::ScanFolderPtr CVideoInfoScanner::TakeReadAhead(const std::string& strDirectory)
+  {
+    ScanFolderPtr folder;
+    std::map<std::string, ScanFolderPtr>::iterator it = m_readAhead.find(strDirectory);
+    if (it != m_readAhead.end())
+    {
+      folder = it->second;
+      m_readAhead.erase(it);
+    }
+    StartReadAhead();
+    return folder;
+  }
+
+  void CVideoInfoScanner::SetPathHash(const std::string& strDirectory, const std::string& hash)
+  {
+    m_pendingHashes.push_back(std::make_pair(strDirectory, hash));
+    if (m_pendingHashes.size() >= PATH_HASH_BATCH)
+      FlushPathHashes();
+  }
+
+  void CVideoInfoScanner::FlushPathHashes()
+  {
+    if (m_pendingHashes.empty())
+      return;
+
+    m_database.BeginTransaction();
+    for (std::vector<std::pair<std::string, std::string> >::const_iterator it = m_pendingHashes.begin(); it != m_pendingHashes.end(); ++it)
+      m_database.SetPathHash(it->first, it->second);
+    m_database.CommitTransaction();
+    m_pendingHashes.clear();
   }
 
   bool CVideoInfoScanner::RetrieveVideoInfo(CFileItemList& items, bool bDirNames, CONTENT_TYPE content, bool useLocal, CScraperUrl* pURL, bool fetchEpisodes, CGUIDialogProgress* pDlgProgress)
@@ -1365,7 +1577,7 @@ namespace VIDEO
     }
 
     for (CGUIListItem::ArtMap::const_iterator i = art.begin(); i != art.end(); ++i)
-      CTextureCache::GetInstance().BackgroundCacheImage(i->second);
+      CTextureCache::GetInstance().PrecacheImage(i->second);
 
     pItem->SetArt(art);
 
@@ -1782,7 +1994,7 @@ namespace VIDEO
     return count;
   }
 
-  bool CVideoInfoScanner::CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes) const
+  bool CVideoInfoScanner::CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes)
   {
     if (!g_advancedSettings.m_bVideoLibraryUseFastHash)
       return false;
@@ -1796,7 +2008,7 @@ namespace VIDEO
   }
 
   std::string CVideoInfoScanner::GetFastHash(const std::string &directory,
-      const std::vector<std::string> &excludes) const
+      const std::vector<std::string> &excludes)
   {
     XBMC::XBMC_MD5 md5state;
 
@@ -1969,7 +2181,7 @@ namespace VIDEO
         if (i->thumb.empty() && !i->thumbUrl.GetFirstThumb().m_url.empty())
           i->thumb = CScraperUrl::GetThumbURL(i->thumbUrl.GetFirstThumb());
         if (!i->thumb.empty())
-          CTextureCache::GetInstance().BackgroundCacheImage(i->thumb);
+          CTextureCache::GetInstance().PrecacheImage(i->thumb);
       }
     }
   }
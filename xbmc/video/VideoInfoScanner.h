@@ -18,6 +18,11 @@
  *  <http://www.gnu.org/licenses/>.
  *
  */
+#include <deque>
+#include <map>
+#include <memory>
+#include <utility>
+
 #include "InfoScanner.h"
 #include "NfoFile.h"
 #include "VideoDatabase.h"
@@ -192,7 +197,7 @@ namespace VIDEO
      \param excludes string array of exclude expressions
      \return the md5 hash of the folder"
      */
-    std::string GetFastHash(const std::string &directory, const std::vector<std::string> &excludes) const;
+    static std::string GetFastHash(const std::string &directory, const std::vector<std::string> &excludes);
 
     /*! \brief Retrieve a "fast" hash of the given directory recursively (if available)
      Performs a stat() on the directory, and uses modified time to create a "fast"
@@ -214,7 +219,7 @@ namespace VIDEO
      \param excludes string array of exclude expressions
      \return true if this directory listing can be fast hashed, false otherwise
      */
-    bool CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes) const;
+    static bool CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes);
 
     /*! \brief Process a series folder, filling in episode details and adding them to the database.
      TODO: Ideally we would return INFO_HAVE_ALREADY if we don't have to update any episodes
@@ -234,6 +239,37 @@ namespace VIDEO
 
     std::string GetnfoFile(CFileItem *item, bool bGrabAny=false) const;
 
+    struct SScanFolder;
+    class CFolderReadJob;
+    typedef std::shared_ptr<SScanFolder> ScanFolderPtr;
+
+    /*! \brief Look up the scraper, settings and stored hash of a folder
+     Only touches the database, so it is run on the scanner thread.
+     \param strDirectory folder to look up
+     \return the folder state, with scan set to false if the folder is excluded or not to be updated
+     */
+    ScanFolderPtr PrepareFolder(const std::string& strDirectory);
+
+    /*! \brief Hash the folder and list it if its hash may have changed
+     Doesn't touch the database or the scanner, so it may be run on a job worker.
+     \param folder the folder state from PrepareFolder()
+     */
+    static void ReadFolder(SScanFolder &folder);
+
+    /*! \brief Queue folders to be read ahead of DoScan() on the job manager
+     \param directories folders in the order they are going to be scanned
+     \param front whether the folders are scanned before those already queued
+     \param fromPathsToScan whether the folders are entries of m_pathsToScan that may be scanned via their parent first
+     */
+    void QueueReadAhead(const std::vector<std::string> &directories, bool front, bool fromPathsToScan);
+    void StartReadAhead();
+    ScanFolderPtr TakeReadAhead(const std::string& strDirectory);
+
+    /*! \brief Store a path hash, the hashes are written out in batches
+     */
+    void SetPathHash(const std::string& strDirectory, const std::string& hash);
+    void FlushPathHashes();
+
     bool m_showDialog;
     CGUIDialogProgressBarHandle* m_handle;
     int m_currentItem;
@@ -249,6 +285,13 @@ namespace VIDEO
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
     CNfoFile m_nfoReader;
+
+    std::deque<std::pair<std::string, bool> > m_readAheadQueue;
+    std::map<std::string, ScanFolderPtr> m_readAhead;
+    std::vector<std::pair<std::string, std::string> > m_pendingHashes;
+    unsigned int m_foldersScanned;
+    unsigned int m_foldersUnchanged;
+    unsigned int m_foldersReadAhead;
   };
 }
 
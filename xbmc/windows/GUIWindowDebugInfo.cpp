@@ -31,6 +31,7 @@
 #include "guilib/GUITextLayout.h"
 #include "guilib/GUIWindowManager.h"
 #include "guilib/GUIControlProfiler.h"
+#include "guilib/TextureManager.h"
 #include "GUIInfoManager.h"
 #include "utils/Variant.h"
 #include "utils/StringUtils.h"
@@ -114,6 +115,17 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
     info = StringUtils::Format("LOG: %s%s.log\nMEM: %" PRIu64"/%" PRIu64" KB - FPS: %2.1f fps\nCPU: %s (CPU-%s %4.2f%%%s)", CSpecialProtocol::TranslatePath("special://logpath").c_str(), lcAppName.c_str(),
                                stat.ullAvailPhys/1024, stat.ullTotalPhys/1024, g_infoManager.GetFPS(), strCores.c_str(), ucAppName.c_str(), dCPU, profiling.c_str());
 #endif
+    unsigned int hits = g_TextureManager.GetCacheHits();
+    unsigned int lookups = hits + g_TextureManager.GetCacheMisses();
+    info += StringUtils::Format("\nTEX: %u KB (+%u KB unused) - hits: %u/%u (%2.1f%%)",
+                                g_TextureManager.GetMemoryUsage() / 1024, g_TextureManager.GetUnusedMemoryUsage() / 1024,
+                                hits, lookups, lookups ? 100.0f * hits / lookups : 0.0f);
+
+    unsigned int fontMisses, atlasRebuilds, atlasMemory;
+    g_fontManager.GetCacheStatistics(hits, fontMisses, atlasRebuilds, atlasMemory);
+    lookups = hits + fontMisses;
+    info += StringUtils::Format("\nFONT: %u KB atlas (%u rebuilds) - hits: %u/%u (%2.1f%%)",
+                                atlasMemory / 1024, atlasRebuilds, hits, lookups, lookups ? 100.0f * hits / lookups : 0.0f);
   }
 
   // render the skin debug info